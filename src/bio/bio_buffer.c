@@ -327,6 +327,7 @@ bio_iod_free(struct bio_desc *biod)
 		bio_sgl_fini(&biod->bd_sgls[i]);
 
 	D_FREE(biod->bd_bulk_hdls);
+	D_FREE(biod->bd_sgl_rg_end);
 
 	D_FREE(biod);
 }
@@ -548,6 +549,7 @@ iterate_biov(struct bio_desc *biod, int (*cb_fn)(struct bio_desc *, struct bio_i
 	     void            *data)
 {
 	void (*prep_fn)(struct bio_desc *, int, void *) = NULL;
+	bool map_fn                                     = false;
 	int rc                                          = 0;
 
 	if (data != NULL) {
@@ -557,15 +559,16 @@ iterate_biov(struct bio_desc *biod, int (*cb_fn)(struct bio_desc *, struct bio_i
 			prep_fn = map_one_setup;
 	}
 
+	/* Track the DMA regions mapped by each SG list for prefetch */
+	if (biod->bd_sgl_rg_end != NULL)
+		map_fn = (cb_fn == dma_map_one || cb_fn == bulk_map_one);
+
 	for (int i = 0; i < biod->bd_sgl_cnt; i++) {
 		struct bio_sglist *bsgl = &biod->bd_sgls[i];
 
 		if (prep_fn)
 			prep_fn(biod, i, data);
 
-		if (bsgl->bs_nr_out == 0)
-			continue;
-
 		for (int j = 0; j < bsgl->bs_nr_out; j++) {
 			struct bio_iov *biov = &bsgl->bs_iovs[j];
 
@@ -575,6 +578,9 @@ iterate_biov(struct bio_desc *biod, int (*cb_fn)(struct bio_desc *, struct bio_i
 		}
 		if (rc)
 			break;
+
+		if (map_fn)
+			biod->bd_sgl_rg_end[i] = biod->bd_rsrvd.brd_rg_cnt;
 	}
 
 	return rc;
@@ -1071,6 +1077,16 @@ done:
 	}
 }
 
+static void
+rw_region_completion(void *cb_arg, int err)
+{
+	struct bio_rsrvd_region	*rg = cb_arg;
+
+	D_ASSERT(rg->brr_inflights > 0);
+	rg->brr_inflights--;
+	rw_completion(rg->brr_biod, err);
+}
+
 void
 bio_memcpy(struct bio_desc *biod, uint16_t media, void *media_addr,
 	   void *addr, ssize_t n)
@@ -1188,7 +1204,17 @@ nvme_rw(struct bio_desc *biod, struct bio_rsrvd_region *rg)
 					   page2io_unit(biod->bd_ctxt, pg_idx, BIO_DMA_PAGE_SZ),
 					   page2io_unit(biod->bd_ctxt, rw_cnt, BIO_DMA_PAGE_SZ),
 					   rw_completion, biod);
-		else {
+		else if (biod->bd_prefetch) {
+			/* Track completion per region, see bio_iod_wait() */
+			rg->brr_biod = biod;
+			rg->brr_inflights++;
+			spdk_blob_io_read(blob, channel, payload,
+					  page2io_unit(biod->bd_ctxt, pg_idx, BIO_DMA_PAGE_SZ),
+					  page2io_unit(biod->bd_ctxt, rw_cnt, BIO_DMA_PAGE_SZ),
+					  rw_region_completion, rg);
+			if (DAOS_ON_VALGRIND)
+				VALGRIND_MAKE_MEM_DEFINED(payload, rw_cnt * BIO_DMA_PAGE_SZ);
+		} else {
 			spdk_blob_io_read(blob, channel, payload,
 					  page2io_unit(biod->bd_ctxt, pg_idx, BIO_DMA_PAGE_SZ),
 					  page2io_unit(biod->bd_ctxt, rw_cnt, BIO_DMA_PAGE_SZ),
@@ -1230,7 +1256,7 @@ dma_rw(struct bio_desc *biod)
 	D_ASSERT(biod->bd_inflights > 0);
 	biod->bd_inflights -= 1;
 
-	if (!biod->bd_async_post) {
+	if (!biod->bd_async_post && !biod->bd_prefetch) {
 		iod_dma_wait(biod);
 		D_DEBUG(DB_IO, "Wait DMA done, type:%d\n", biod->bd_type);
 	}
@@ -1435,6 +1461,13 @@ iod_prep_internal(struct bio_desc *biod, unsigned int type, void *bulk_ctxt,
 		arg = &bulk_arg;
 	}
 
+	if (biod->bd_prefetch && biod->bd_sgl_rg_end == NULL) {
+		D_ALLOC_ARRAY(biod->bd_sgl_rg_end, biod->bd_sgl_cnt);
+		if (biod->bd_sgl_rg_end == NULL)
+			return -DER_NOMEM;
+	}
+	biod->bd_rg_landed = 0;
+
 	rc = iod_map_iovs(biod, arg);
 	if (rc)
 		return rc;
@@ -1465,6 +1498,9 @@ iod_prep_internal(struct bio_desc *biod, unsigned int type, void *bulk_ctxt,
 		dma_rw(biod);
 
 	if (biod->bd_result) {
+		/* Some reads may have been issued for prefetch, wait them before release */
+		if (biod->bd_prefetch)
+			iod_dma_wait(biod);
 		rc = biod->bd_result;
 		goto failed;
 	}
@@ -1494,9 +1530,64 @@ bio_iod_try_prep(struct bio_desc *biod, unsigned int type, void *bulk_ctxt,
 	return iod_prep_internal(biod, type, bulk_ctxt, bulk_perm);
 }
 
+int
+bio_iod_prefetch(struct bio_desc *biod, unsigned int type, void *bulk_ctxt,
+		 unsigned int bulk_perm)
+{
+	if (biod->bd_type != BIO_IOD_TYPE_FETCH)
+		return -DER_NOTSUPPORTED;
+
+	biod->bd_prefetch = 1;
+	return iod_prep_internal(biod, type, bulk_ctxt, bulk_perm);
+}
+
+int
+bio_iod_wait(struct bio_desc *biod, int idx)
+{
+	struct bio_xs_context	*xs_ctxt = biod->bd_ctxt->bic_xs_ctxt;
+	struct bio_rsrvd_dma	*rsrvd_dma = &biod->bd_rsrvd;
+	struct bio_rsrvd_region	*rg;
+	unsigned int		 end;
+
+	if (!biod->bd_prefetch || !biod->bd_buffer_prep || rsrvd_dma->brd_rg_cnt == 0)
+		return 0;
+
+	if (idx < 0) {
+		iod_dma_wait(biod);
+		biod->bd_rg_landed = rsrvd_dma->brd_rg_cnt;
+		return biod->bd_result;
+	}
+
+	D_ASSERTF(idx < biod->bd_sgl_cnt, "Invalid sgl index %d/%d\n", idx, biod->bd_sgl_cnt);
+	end = biod->bd_sgl_rg_end[idx];
+
+	/* The regions are mapped in SG list order, wait for all the regions ahead */
+	while (biod->bd_rg_landed < end) {
+		rg = &rsrvd_dma->brd_regions[biod->bd_rg_landed];
+		if (rg->brr_inflights == 0) {
+			biod->bd_rg_landed++;
+			continue;
+		}
+
+		D_ASSERT(xs_ctxt != NULL);
+		if (xs_ctxt->bxc_self_polling)
+			spdk_thread_poll(xs_ctxt->bxc_thread, 0, 0);
+		else
+			bio_yield(NULL);
+	}
+
+	return biod->bd_result;
+}
+
 int
 bio_iod_post(struct bio_desc *biod, int err)
 {
+	/* Don't release the DMA buffer until all the prefetch reads are done */
+	if (biod->bd_prefetch) {
+		bio_iod_wait(biod, -1);
+		biod->bd_prefetch = 0;
+	}
+
 	biod->bd_dma_issued = 0;
 	biod->bd_inflights = 0;
 	biod->bd_result = err;
@@ -1561,6 +1652,7 @@ int
 bio_iod_copy(struct bio_desc *biod, d_sg_list_t *sgls, unsigned int nr_sgl)
 {
 	struct bio_copy_args arg = { 0 };
+	int rc;
 
 	if (!biod->bd_buffer_prep)
 		return -DER_INVAL;
@@ -1568,6 +1660,10 @@ bio_iod_copy(struct bio_desc *biod, d_sg_list_t *sgls, unsigned int nr_sgl)
 	if (biod->bd_sgl_cnt != nr_sgl)
 		return -DER_INVAL;
 
+	rc = bio_iod_wait(biod, -1);
+	if (rc)
+		return rc;
+
 	arg.ca_sgls = sgls;
 	arg.ca_sgl_cnt = nr_sgl;
 
@@ -415,6 +415,10 @@ struct bio_rsrvd_region {
 	uint64_t		 brr_end;
 	/* Media type this DMA region mapped to */
 	uint8_t			 brr_media;
+	/* In-flight SPDK reads of the region, used by prefetch */
+	unsigned int		 brr_inflights;
+	/* The io descriptor owning the region, used by prefetch */
+	struct bio_desc		*brr_biod;
 };
 
 /* Reserved DMA buffer for certain io descriptor */
@@ -456,7 +460,8 @@ struct bio_desc {
 				 bd_copy_dst:1,
 				 bd_in_fifo:1,
 				 bd_async_post:1,
-				 bd_non_blocking:1;
+				 bd_non_blocking:1,
+				 bd_prefetch:1;
 	/* Cached bulk handles being used by this IOD */
 	struct bio_bulk_hdl    **bd_bulk_hdls;
 	unsigned int		 bd_bulk_max;
@@ -464,6 +469,10 @@ struct bio_desc {
 	/* Customized completion callback for bio_iod_post() */
 	void			 (*bd_completion)(void *cb_arg, int err);
 	void			*bd_comp_arg;
+	/* Per SG list end (not included) index of DMA regions, used by prefetch */
+	unsigned int		*bd_sgl_rg_end;
+	/* All the DMA regions before this index are landed, used by prefetch */
+	unsigned int		 bd_rg_landed;
 	/* SG lists involved in this io descriptor */
 	unsigned int		 bd_sgl_cnt;
 	struct bio_sglist	 bd_sgls[0];
@@ -666,15 +666,39 @@ off2lba(struct wal_super_info *si, unsigned int blk_off)
 
 struct wal_tx_desc {
 	d_list_t		 td_link;
+	d_list_t		 td_grp_link;		/* Link to wal_group::wg_txs */
 	struct wal_super_info	*td_si;
-	struct bio_desc		*td_biod_tx;		/* IOD for WAL I/O */
+	struct bio_desc		*td_biod_tx;		/* IOD for WAL I/O, shared by group */
 	struct bio_desc		*td_biod_data;		/* IOD for async data I/O */
+	struct umem_wal_tx	*td_tx;
+	struct data_csum_array	*td_dc_arr;
+	struct wal_blks_desc	*td_blk_desc;
+	ABT_eventual		 td_done;		/* Set on transaction completion */
 	uint64_t		 td_id;
 	uint32_t		 td_blks;		/* Blocks used by this tx */
 	int			 td_error;
 	unsigned int		 td_wal_complete:1;	/* Indicating WAL I/O completed */
 };
 
+/*
+ * Transactions committed concurrently are gathered into a commit group and written to WAL
+ * by a single I/O. The first committer opens the group and becomes the leader, it lingers
+ * for a few yields to let other ULTs join (see wal_group_linger()), then seals the group
+ * and submits it. Members have contiguous IDs, so the on-disk layout is exactly the same
+ * as committing them one by one.
+ */
+#define WAL_GROUP_MAX_BLKS	256	/* Max blocks written by a commit group */
+#define WAL_GROUP_LINGER_MAX	8	/* Max yields of group leader */
+
+struct wal_group {
+	d_list_t		 wg_txs;	/* Member transactions, in ID order */
+	struct bio_desc		*wg_biod;	/* IOD for the group WAL I/O */
+	uint64_t		 wg_id;		/* ID of the first member */
+	uint64_t		 wg_next_id;	/* ID following the last member */
+	uint32_t		 wg_blks;	/* Blocks used by all members */
+	uint32_t		 wg_nr;		/* Number of members */
+};
+
 static inline struct wal_tx_desc *
 wal_tx_prev(struct wal_tx_desc *wal_tx)
 {
@@ -719,17 +743,14 @@ tx_completed(struct wal_tx_desc *wal_tx)
 static void
 wal_tx_completion(struct wal_tx_desc *wal_tx, bool complete_next)
 {
-	struct bio_desc		*biod_tx = wal_tx->td_biod_tx;
 	struct wal_super_info	*si = wal_tx->td_si;
 	struct wal_tx_desc	*next;
 	bool			 try_wakeup = false;
 
 	D_ASSERT(!d_list_empty(&wal_tx->td_link));
-	D_ASSERT(biod_tx != NULL);
 	D_ASSERT(si != NULL);
 
 	next = wal_tx_next(wal_tx);
-	biod_tx->bd_result = wal_tx->td_error;
 
 	if (wal_tx->td_error) {
 		/* Rollback unused ID */
@@ -758,9 +779,11 @@ wal_tx_completion(struct wal_tx_desc *wal_tx, bool complete_next)
 	D_ASSERT(si->si_pending_tx > 0);
 	si->si_pending_tx--;
 
-	/* The ABT_eventual could be NULL if WAL I/O IOD failed on DMA mapping in bio_iod_prep() */
-	if (biod_tx->bd_dma_done != ABT_EVENTUAL_NULL)
-		ABT_eventual_set(biod_tx->bd_dma_done, NULL, 0);
+	/*
+	 * The WAL IOD could be shared by other transactions in the commit group and be freed
+	 * once the group leader returns, so only the per-transaction eventual is touched here.
+	 */
+	ABT_eventual_set(wal_tx->td_done, NULL, 0);
 
 	/*
 	 * To ensure the UNDO (for failed transactions) is performed before starting new
@@ -796,6 +819,23 @@ wal_completion(void *arg, int err)
 		wal_tx_completion(wal_tx, true);
 }
 
+/* Commit group WAL I/O completion */
+static void
+wal_group_completion(void *arg, int err)
+{
+	struct wal_group	*grp = arg;
+	struct bio_desc		*biod = grp->wg_biod;
+	struct wal_tx_desc	*wal_tx, *tmp;
+
+	/* Complete members in ID order, a member could be completed along with prior ones */
+	d_list_for_each_entry_safe(wal_tx, tmp, &grp->wg_txs, td_grp_link)
+		wal_completion(wal_tx, err);
+
+	/* Wakeup the leader waiting on WAL I/O in bio_iod_post() */
+	if (biod->bd_dma_done != ABT_EVENTUAL_NULL)
+		ABT_eventual_set(biod->bd_dma_done, NULL, 0);
+}
+
 /* Transaction associated data I/O (to data blob) completion */
 static void
 data_completion(void *arg, int err)
@@ -891,16 +931,18 @@ wait_tx_committed(struct wal_tx_desc *wal_tx)
 	struct bio_xs_context	*xs_ctxt = biod_tx->bd_ctxt->bic_xs_ctxt;
 	int			 rc;
 
-	D_ASSERT(biod_tx->bd_dma_done != ABT_EVENTUAL_NULL);
 	D_ASSERT(xs_ctxt != NULL);
 
 	if (xs_ctxt->bxc_self_polling) {
 		D_DEBUG(DB_IO, "Self poll completion\n");
 		rc = xs_poll_completion(xs_ctxt, &biod_tx->bd_inflights, 0);
+		/* Data I/O could be still in-flight when WAL I/O failed on preparing */
+		if (rc == 0 && biod_data != NULL)
+			rc = xs_poll_completion(xs_ctxt, &biod_data->bd_inflights, 0);
 		if (rc)
 			D_ERROR("Self pool completion failed. "DF_RC"\n", DP_RC(rc));
-	} else if (biod_tx->bd_inflights != 0 || biod_data != NULL) {
-		rc = ABT_eventual_wait(biod_tx->bd_dma_done, NULL);
+	} else if (!d_list_empty(&wal_tx->td_link)) {
+		rc = ABT_eventual_wait(wal_tx->td_done, NULL);
 		if (rc != ABT_SUCCESS)
 			D_ERROR("ABT_eventual_wait failed. %d\n", rc);
 	}
@@ -908,22 +950,191 @@ wait_tx_committed(struct wal_tx_desc *wal_tx)
 	D_ASSERT(d_list_empty(&wal_tx->td_link));
 }
 
+static inline void
+wal_group_init(struct wal_group *grp, struct bio_desc *biod, uint64_t id)
+{
+	D_INIT_LIST_HEAD(&grp->wg_txs);
+	grp->wg_biod = biod;
+	grp->wg_id = id;
+	grp->wg_next_id = id;
+	grp->wg_blks = 0;
+	grp->wg_nr = 0;
+}
+
+static inline bool
+wal_group_joinable(struct wal_group *grp, struct wal_tx_desc *wal_tx)
+{
+	return grp->wg_next_id == wal_tx->td_id &&
+	       (grp->wg_blks + wal_tx->td_blks) <= WAL_GROUP_MAX_BLKS;
+}
+
+static inline void
+wal_group_add(struct wal_super_info *si, struct wal_group *grp, struct wal_tx_desc *wal_tx)
+{
+	D_ASSERT(grp->wg_next_id == wal_tx->td_id);
+	wal_tx->td_biod_tx = grp->wg_biod;
+	d_list_add_tail(&wal_tx->td_grp_link, &grp->wg_txs);
+	grp->wg_next_id = wal_next_id(si, wal_tx->td_id, wal_tx->td_blks);
+	grp->wg_blks += wal_tx->td_blks;
+	grp->wg_nr++;
+}
+
+/*
+ * How many yields the group leader lingers for joiners. New transactions are expected only
+ * when others are in flight, so it's bounded by the WAL tx QD, and it's adjusted by how the
+ * recent groups were filled (see wal_group_adapt()).
+ */
+static inline unsigned int
+wal_group_linger(struct wal_super_info *si)
+{
+	D_ASSERT(si->si_pending_tx > 1);
+	return min(max(si->si_group_linger, 1), si->si_pending_tx - 1);
+}
+
+static inline void
+wal_group_adapt(struct wal_super_info *si, struct wal_group *grp)
+{
+	if (grp->wg_nr > 1) {
+		if (si->si_group_linger < WAL_GROUP_LINGER_MAX)
+			si->si_group_linger++;
+	} else if (si->si_group_linger > 0) {
+		si->si_group_linger--;
+	}
+}
+
+/* Get the slice of group SGL for a member transaction, only the DMA buffers are set */
+static void
+wal_group_tx_sgl(struct bio_sglist *grp_sgl, unsigned int blk_off, unsigned int blks,
+		 unsigned int blk_sz, struct bio_sglist *bsgl)
+{
+	struct bio_iov	*biov = &bsgl->bs_iovs[0];
+	unsigned int	 iov_blks, nr;
+
+	D_ASSERT(bsgl->bs_nr == 2);
+	D_ASSERT(grp_sgl->bs_nr_out == 1 || grp_sgl->bs_nr_out == 2);
+	bsgl->bs_nr_out = 0;
+
+	iov_blks = bio_iov2len(&grp_sgl->bs_iovs[0]) / blk_sz;
+	if (blk_off < iov_blks) {
+		nr = min(blks, iov_blks - blk_off);
+		*biov = grp_sgl->bs_iovs[0];
+		biov->bi_buf += (uint64_t)blk_off * blk_sz;
+		biov->bi_data_len = (uint64_t)nr * blk_sz;
+		bsgl->bs_nr_out++;
+		biov++;
+
+		blks -= nr;
+		blk_off = 0;
+	} else {
+		blk_off -= iov_blks;
+	}
+
+	/* The transaction is wrapped or located in the second region of group */
+	if (blks > 0) {
+		D_ASSERT(grp_sgl->bs_nr_out == 2);
+		*biov = grp_sgl->bs_iovs[1];
+		biov->bi_buf += (uint64_t)blk_off * blk_sz;
+		biov->bi_data_len = (uint64_t)blks * blk_sz;
+		D_ASSERT(bio_iov2len(biov) + (uint64_t)blk_off * blk_sz <=
+			 bio_iov2len(&grp_sgl->bs_iovs[1]));
+		bsgl->bs_nr_out++;
+	}
+}
+
+/* Write all member transactions of a sealed commit group to WAL by a single I/O */
+static void
+wal_group_submit(struct bio_meta_context *mc, struct wal_group *grp)
+{
+	struct wal_super_info	*si = &mc->mc_wal_info;
+	struct bio_desc		*biod = grp->wg_biod;
+	struct wal_tx_desc	*wal_tx, *tmp;
+	struct bio_sglist	*bsgl, tx_sgl;
+	struct bio_iov		 tx_iovs[2];
+	bio_addr_t		 addr = { 0 };
+	unsigned int		 blks, start_off, blk_off;
+	unsigned int		 tot_blks = si->si_header.wh_tot_blks;
+	unsigned int		 blk_bytes = si->si_header.wh_blk_bytes;
+	int			 iov_nr, rc;
+
+	D_ASSERT(grp->wg_nr > 0 && !d_list_empty(&grp->wg_txs));
+
+	/* Figure out the regions in WAL for this group */
+	start_off = id2off(grp->wg_id);
+	D_ASSERT(start_off < tot_blks);
+	if ((start_off + grp->wg_blks) <= tot_blks) {
+		iov_nr = 1;
+		blks = grp->wg_blks;
+	} else {
+		iov_nr = 2;
+		blks = (tot_blks - start_off);
+	}
+
+	bsgl = bio_iod_sgl(biod, 0);
+	rc = bio_sgl_init(bsgl, iov_nr);
+	if (rc)
+		goto failed;
+
+	bio_addr_set(&addr, DAOS_MEDIA_NVME, off2lba(si, start_off));
+	bio_iov_set(&bsgl->bs_iovs[0], addr, (uint64_t)blks * blk_bytes);
+	if (iov_nr == 2) {
+		bio_addr_set(&addr, DAOS_MEDIA_NVME, off2lba(si, 0));
+		blks = grp->wg_blks - blks;
+		bio_iov_set(&bsgl->bs_iovs[1], addr, (uint64_t)blks * blk_bytes);
+	}
+	bsgl->bs_nr_out = iov_nr;
+
+	/*
+	 * Map the WAL regions to DMA buffer, bio_iod_prep() can guarantee FIFO order
+	 * when it has to yield and wait for DMA buffer.
+	 */
+	rc = bio_iod_prep(biod, BIO_CHK_TYPE_LOCAL, NULL, 0);
+	if (rc) {
+		D_ERROR("WAL IOD prepare failed. "DF_RC"\n", DP_RC(rc));
+		goto failed;
+	}
+
+	/* Fill DMA buffer with member transactions, each one at its own block offset */
+	tx_sgl.bs_iovs = &tx_iovs[0];
+	tx_sgl.bs_nr = 2;
+	blk_off = 0;
+	d_list_for_each_entry(wal_tx, &grp->wg_txs, td_grp_link) {
+		wal_group_tx_sgl(bsgl, blk_off, wal_tx->td_blks, blk_bytes, &tx_sgl);
+		fill_trans_blks(mc, &tx_sgl, wal_tx->td_tx, wal_tx->td_dc_arr, blk_bytes,
+				wal_tx->td_blk_desc);
+		blk_off += wal_tx->td_blks;
+	}
+	D_ASSERT(blk_off == grp->wg_blks);
+
+	D_DEBUG(DB_IO, "WAL group commit ID:"DF_U64" txs:%u blks:%u\n", grp->wg_id, grp->wg_nr,
+		grp->wg_blks);
+
+	biod->bd_completion = wal_group_completion;
+	biod->bd_comp_arg = grp;
+
+	rc = bio_iod_post_async(biod, 0);
+	if (rc)
+		D_ERROR("WAL commit failed. "DF_RC"\n", DP_RC(rc));
+	return;
+failed:
+	d_list_for_each_entry_safe(wal_tx, tmp, &grp->wg_txs, td_grp_link)
+		wal_completion(wal_tx, rc);
+}
+
 int
 bio_wal_commit(struct bio_meta_context *mc, struct umem_wal_tx *tx, struct bio_desc *biod_data,
 	       struct bio_wal_stats *stats)
 {
 	struct wal_super_info	*si = &mc->mc_wal_info;
+	struct bio_xs_context	*xs_ctxt = mc->mc_wal->bic_xs_ctxt;
 	struct bio_desc		*biod = NULL;
-	struct bio_sglist	*bsgl;
-	bio_addr_t		 addr = { 0 };
+	struct wal_group	 grp, *open_grp;
 	struct wal_tx_desc	 wal_tx = { 0 };
 	struct wal_blks_desc	 blk_desc = { 0 };
 	struct data_csum_array	 dc_arr;
-	unsigned int		 blks, unused_off;
-	unsigned int		 tot_blks = si->si_header.wh_tot_blks;
 	unsigned int		 blk_bytes = si->si_header.wh_blk_bytes;
+	unsigned int		 linger, nr, i;
 	uint64_t		 tx_id = tx->utx_id;
-	int			 iov_nr, rc;
+	int			 rc;
 
 	/* Bypass WAL commit, used for performance evaluation only */
 	if (daos_io_bypass & IOBP_WAL_COMMIT) {
@@ -952,71 +1163,53 @@ bio_wal_commit(struct bio_meta_context *mc, struct umem_wal_tx *tx, struct bio_d
 		goto out;
 	}
 
-	biod = bio_iod_alloc(mc->mc_wal, NULL, 1, BIO_IOD_TYPE_UPDATE);
-	if (biod == NULL) {
+	rc = ABT_eventual_create(0, &wal_tx.td_done);
+	if (rc != ABT_SUCCESS) {
 		rc = -DER_NOMEM;
 		goto out;
 	}
 
-	/* Figure out the regions in WAL for this transaction */
 	D_ASSERT(wal_id_cmp(si, tx_id, si->si_unused_id) == 0);
-	unused_off = id2off(si->si_unused_id);
-	D_ASSERT(unused_off < tot_blks);
-	if ((unused_off + blk_desc.bd_blks) <= tot_blks) {
-		iov_nr = 1;
-		blks = blk_desc.bd_blks;
-	} else {
-		iov_nr = 2;
-		blks = (tot_blks - unused_off);
-	}
-
-	bsgl = bio_iod_sgl(biod, 0);
-	rc = bio_sgl_init(bsgl, iov_nr);
-	if (rc)
-		goto out;
-
-	bio_addr_set(&addr, DAOS_MEDIA_NVME, off2lba(si, unused_off));
-	bio_iov_set(&bsgl->bs_iovs[0], addr, (uint64_t)blks * blk_bytes);
-	if (iov_nr == 2) {
-		bio_addr_set(&addr, DAOS_MEDIA_NVME, off2lba(si, 0));
-		blks = blk_desc.bd_blks - blks;
-		bio_iov_set(&bsgl->bs_iovs[1], addr, (uint64_t)blks * blk_bytes);
-	}
-	bsgl->bs_nr_out = iov_nr;
-
 	wal_tx.td_id = si->si_unused_id;
 	wal_tx.td_si = si;
-	wal_tx.td_biod_tx = biod;
 	wal_tx.td_biod_data = NULL;
+	wal_tx.td_tx = tx;
+	wal_tx.td_dc_arr = &dc_arr;
+	wal_tx.td_blk_desc = &blk_desc;
 	wal_tx.td_blks = blk_desc.bd_blks;
-	/* Track in pending list from now on, since it could yield in bio_iod_prep() */
+
+	/* Join the open commit group if possible, otherwise seal it and start a new group */
+	open_grp = si->si_group;
+	if (open_grp != NULL && !wal_group_joinable(open_grp, &wal_tx)) {
+		si->si_group = NULL;
+		open_grp = NULL;
+	}
+
+	if (open_grp == NULL) {
+		biod = bio_iod_alloc(mc->mc_wal, NULL, 1, BIO_IOD_TYPE_UPDATE);
+		if (biod == NULL) {
+			rc = -DER_NOMEM;
+			goto out;
+		}
+		wal_group_init(&grp, biod, wal_tx.td_id);
+		open_grp = &grp;
+	}
+	wal_group_add(si, open_grp, &wal_tx);
+
+	/* Track in pending list from now on, since it could yield before WAL I/O submitted */
 	d_list_add_tail(&wal_tx.td_link, &si->si_pending_list);
 	si->si_pending_tx++;
 
 	if (stats) {
 		stats->ws_size = (blk_desc.bd_blks - 1) * blk_bytes + blk_desc.bd_tail_off;
 		stats->ws_qd = si->si_pending_tx;
+		stats->ws_batch = 0;
 	}
 
 	/* Update next unused ID */
 	si->si_unused_id = wal_next_id(si, si->si_unused_id, blk_desc.bd_blks);
 
-	/*
-	 * Map the WAL regions to DMA buffer, bio_iod_prep() can guarantee FIFO order
-	 * when it has to yield and wait for DMA buffer.
-	 */
-	rc = bio_iod_prep(biod, BIO_CHK_TYPE_LOCAL, NULL, 0);
-	if (rc) {
-		D_ERROR("WAL IOD prepare failed. "DF_RC"\n", DP_RC(rc));
-		wal_completion(&wal_tx, rc);
-		D_ASSERT(d_list_empty(&wal_tx.td_link));
-		goto out;
-	}
-
-	/* Fill DMA buffer with transaction entries */
-	fill_trans_blks(mc, bsgl, tx, &dc_arr, blk_bytes, &blk_desc);
-
-	/* Set proper completion callbacks for data I/O & WAL I/O */
+	/* Set proper completion callback for data I/O */
 	if (biod_data != NULL) {
 		if (biod_data->bd_inflights == 0) {
 			wal_tx.td_error = biod_data->bd_result;
@@ -1026,17 +1219,42 @@ bio_wal_commit(struct bio_meta_context *mc, struct umem_wal_tx *tx, struct bio_d
 			wal_tx.td_biod_data = biod_data;
 		}
 	}
-	biod->bd_completion = wal_completion;
-	biod->bd_comp_arg = &wal_tx;
 
-	rc = bio_iod_post_async(biod, 0);
-	if (rc)
-		D_ERROR("WAL commit failed. "DF_RC"\n", DP_RC(rc));
+	/* Joined an open group, the group leader will submit WAL I/O for us */
+	if (biod == NULL)
+		goto wait;
+
+	/*
+	 * Linger for joiners when there are other transactions in flight. Self polling mode
+	 * is excluded, since the WAL I/O is polled by the caller and nobody else can join.
+	 */
+	if (!xs_ctxt->bxc_self_polling && si->si_pending_tx > 1) {
+		si->si_group = &grp;
+		linger = wal_group_linger(si);
+		for (i = 0; i < linger && si->si_group == &grp; i++) {
+			nr = grp.wg_nr;
+			bio_yield(NULL);
+			/* Nobody joined in this round, stop lingering */
+			if (grp.wg_nr == nr)
+				break;
+		}
+		if (si->si_group == &grp)
+			si->si_group = NULL;
+		wal_group_adapt(si, &grp);
+	}
+
+	if (stats)
+		stats->ws_batch = grp.wg_nr;
 
+	wal_group_submit(mc, &grp);
+wait:
 	/* Wait for WAL commit completion */
 	wait_tx_committed(&wal_tx);
+	rc = wal_tx.td_error;
 out:
 	free_data_csum(&dc_arr);
+	if (wal_tx.td_done != ABT_EVENTUAL_NULL)
+		ABT_eventual_free(&wal_tx.td_done);
 	if (biod != NULL)
 		bio_iod_free(biod);
 	return rc;
@@ -1133,7 +1351,7 @@ bio_wal_flush_header(struct bio_meta_context *mc)
 }
 
 static int
-load_wal(struct bio_meta_context *mc, char *buf, unsigned int max_blks, uint64_t tx_id)
+load_wal(struct bio_meta_context *mc, char *buf, unsigned int max_blks, unsigned int off)
 {
 	struct wal_super_info	*si = &mc->mc_wal_info;
 	unsigned int		 tot_blks = si->si_header.wh_tot_blks;
@@ -1142,7 +1360,7 @@ load_wal(struct bio_meta_context *mc, char *buf, unsigned int max_blks, uint64_t
 	struct bio_iov		*biov;
 	d_sg_list_t		 sgl;
 	d_iov_t			 iov;
-	unsigned int		 nr_blks, blks, off;
+	unsigned int		 nr_blks, blks;
 	bio_addr_t		 addr = { 0 };
 	int			 iov_nr, rc;
 
@@ -1159,7 +1377,6 @@ load_wal(struct bio_meta_context *mc, char *buf, unsigned int max_blks, uint64_t
 	if (rc)
 		return rc;
 
-	off = id2off(tx_id);
 	while (max_blks > 0) {
 		biov = &bsgl.bs_iovs[bsgl.bs_nr_out];
 
@@ -1577,6 +1794,177 @@ replay_tx(struct wal_super_info *si, char *buf,
 	return rc;
 }
 
+/*
+ * WAL read-ahead for replay. Each buffer has room for two windows of WAL_MAX_TRANS_BLKS blocks:
+ * the WAL is loaded into the second half, and the first half receives the head of a transaction
+ * straddling the end of the previous window, so that any transaction is contiguous in memory.
+ *
+ * While transactions from one buffer are being verified and replayed, the next window is loaded
+ * into the other buffer by a helper ULT, so the replay doesn't wait on WAL reads.
+ */
+struct wal_ra_buf {
+	struct wal_replay_ra	*rb_ra;
+	char			*rb_buf;
+	ABT_thread		 rb_thread;
+	unsigned int		 rb_off;	/* WAL offset of the loaded window */
+	int			 rb_rc;
+	bool			 rb_pending;
+};
+
+struct wal_replay_ra {
+	struct bio_meta_context	*ra_mc;
+	ABT_pool		 ra_pool;	/* ABT_POOL_NULL: load on wait */
+	unsigned int		 ra_win_blks;
+	unsigned int		 ra_cur;
+	struct wal_ra_buf	 ra_bufs[2];
+};
+
+static inline char *
+wal_ra_win(struct wal_ra_buf *rb)
+{
+	struct wal_super_info	*si = &rb->rb_ra->ra_mc->mc_wal_info;
+
+	return rb->rb_buf + (size_t)rb->rb_ra->ra_win_blks * si->si_header.wh_blk_bytes;
+}
+
+static void
+wal_ra_ult(void *arg)
+{
+	struct wal_ra_buf	*rb = arg;
+
+	rb->rb_rc = load_wal(rb->rb_ra->ra_mc, wal_ra_win(rb), rb->rb_ra->ra_win_blks, rb->rb_off);
+}
+
+static void
+wal_ra_start(struct wal_replay_ra *ra, struct wal_ra_buf *rb, unsigned int off)
+{
+	int	rc;
+
+	D_ASSERT(!rb->rb_pending);
+	rb->rb_off = off;
+	rb->rb_rc = 0;
+	rb->rb_pending = true;
+
+	if (ra->ra_pool == ABT_POOL_NULL)
+		return;
+
+	rc = ABT_thread_create(ra->ra_pool, wal_ra_ult, rb, ABT_THREAD_ATTR_NULL,
+			       &rb->rb_thread);
+	if (rc != ABT_SUCCESS) {
+		D_WARN("Failed to create WAL read-ahead ULT, load on demand. %d\n", rc);
+		rb->rb_thread = ABT_THREAD_NULL;
+	}
+}
+
+static int
+wal_ra_wait(struct wal_replay_ra *ra, struct wal_ra_buf *rb)
+{
+	int	rc;
+
+	if (!rb->rb_pending)
+		return 0;
+	rb->rb_pending = false;
+
+	if (rb->rb_thread == ABT_THREAD_NULL)
+		return load_wal(ra->ra_mc, wal_ra_win(rb), ra->ra_win_blks, rb->rb_off);
+
+	rc = ABT_thread_free(&rb->rb_thread);
+	if (rc != ABT_SUCCESS) {
+		D_ERROR("Failed to join WAL read-ahead ULT. %d\n", rc);
+		return -DER_INVAL;
+	}
+	return rb->rb_rc;
+}
+
+static void
+wal_ra_fini(struct wal_replay_ra *ra)
+{
+	int	i;
+
+	for (i = 0; i < 2; i++) {
+		/* Never free a buffer under an inflight read */
+		if (ra->ra_bufs[i].rb_thread != ABT_THREAD_NULL)
+			wal_ra_wait(ra, &ra->ra_bufs[i]);
+		D_FREE(ra->ra_bufs[i].rb_buf);
+	}
+}
+
+static int
+wal_ra_init(struct wal_replay_ra *ra, struct bio_meta_context *mc, unsigned int win_blks,
+	    unsigned int off)
+{
+	struct wal_super_info	*si = &mc->mc_wal_info;
+	unsigned int		 blk_bytes = si->si_header.wh_blk_bytes;
+	ABT_thread		 self;
+	int			 i, rc;
+
+	memset(ra, 0, sizeof(*ra));
+	ra->ra_mc = mc;
+	ra->ra_win_blks = win_blks;
+	ra->ra_pool = ABT_POOL_NULL;
+
+	for (i = 0; i < 2; i++) {
+		ra->ra_bufs[i].rb_ra = ra;
+		ra->ra_bufs[i].rb_thread = ABT_THREAD_NULL;
+		D_ALLOC(ra->ra_bufs[i].rb_buf, (size_t)win_blks * blk_bytes * 2);
+		if (ra->ra_bufs[i].rb_buf == NULL) {
+			wal_ra_fini(ra);
+			return -DER_NOMEM;
+		}
+	}
+
+	/* Read-ahead ULTs are created in the pool of the caller, fall back to sync loading */
+	if (ABT_thread_self(&self) != ABT_SUCCESS ||
+	    ABT_thread_get_last_pool(self, &ra->ra_pool) != ABT_SUCCESS)
+		ra->ra_pool = ABT_POOL_NULL;
+
+	/* Load the first window, and read ahead the next one */
+	wal_ra_start(ra, &ra->ra_bufs[0], off);
+	rc = wal_ra_wait(ra, &ra->ra_bufs[0]);
+	if (rc) {
+		wal_ra_fini(ra);
+		return rc;
+	}
+	wal_ra_start(ra, &ra->ra_bufs[1], (off + win_blks) % si->si_header.wh_tot_blks);
+	/* Let the read-ahead ULT submit its I/O */
+	bio_yield(NULL);
+
+	return 0;
+}
+
+/*
+ * Switch to the read-ahead window, @left blocks at the end of the current window (head of a
+ * straddling transaction) are moved in front of it. The window following it is read ahead into
+ * the buffer we are leaving. Returns the block index of the first transaction in the new buffer.
+ */
+static int
+wal_ra_switch(struct wal_replay_ra *ra, unsigned int left, char **buf, unsigned int *blk_off)
+{
+	struct wal_super_info	*si = &ra->ra_mc->mc_wal_info;
+	unsigned int		 blk_bytes = si->si_header.wh_blk_bytes;
+	unsigned int		 win_blks = ra->ra_win_blks;
+	struct wal_ra_buf	*cur = &ra->ra_bufs[ra->ra_cur];
+	struct wal_ra_buf	*next = &ra->ra_bufs[!ra->ra_cur];
+	int			 rc;
+
+	D_ASSERT(left < win_blks);
+	rc = wal_ra_wait(ra, next);
+	if (rc)
+		return rc;
+
+	if (left > 0)
+		memcpy(wal_ra_win(next) - (size_t)left * blk_bytes,
+		       wal_ra_win(cur) + (size_t)(win_blks - left) * blk_bytes,
+		       (size_t)left * blk_bytes);
+
+	wal_ra_start(ra, cur, (next->rb_off + win_blks) % si->si_header.wh_tot_blks);
+	ra->ra_cur = !ra->ra_cur;
+
+	*buf = next->rb_buf;
+	*blk_off = win_blks - left;
+	return 0;
+}
+
 static inline uint64_t
 off2lba_blk(uint64_t off)
 {
@@ -1649,10 +2037,11 @@ bio_wal_replay(struct bio_meta_context *mc, struct bio_wal_rp_stats *wrs,
 	struct wal_trans_head	*hdr;
 	unsigned int		 blk_bytes = si->si_header.wh_blk_bytes;
 	struct wal_blks_desc	 blk_desc = { 0 };
+	struct wal_replay_ra	 ra;
 	char			*buf, *dbuf = NULL;
 	struct umem_action	*act;
-	unsigned int		 max_blks = WAL_MAX_TRANS_BLKS, blk_off;
-	unsigned int		 nr_replayed = 0, tight_loop, dbuf_len = 0;
+	unsigned int		 max_blks = WAL_MAX_TRANS_BLKS, blk_off, blk_end;
+	unsigned int		 nr_replayed = 0, tight_loop = 0, dbuf_len = 0;
 	uint64_t		 tx_id, start_id, unmap_start, unmap_end;
 	int			 rc;
 	uint64_t		 total_bytes = 0, rpl_entries = 0, total_tx = 0;
@@ -1661,15 +2050,9 @@ bio_wal_replay(struct bio_meta_context *mc, struct bio_wal_rp_stats *wrs,
 	if (DAOS_FAIL_CHECK(DAOS_WAL_NO_REPLAY))
 		return 0;
 
-	D_ALLOC(buf, max_blks * blk_bytes);
-	if (buf == NULL)
-		return -DER_NOMEM;
-
 	D_ALLOC(act, sizeof(*act) + UMEM_ACT_PAYLOAD_MAX_LEN);
-	if (act == NULL) {
-		rc = -DER_NOMEM;
-		goto out;
-	}
+	if (act == NULL)
+		return -DER_NOMEM;
 
 	tx_id = wal_next_id(si, si->si_ckp_id, si->si_ckp_blks);
 	start_id = tx_id;
@@ -1678,14 +2061,15 @@ bio_wal_replay(struct bio_meta_context *mc, struct bio_wal_rp_stats *wrs,
 	if (wrs != NULL)
 		s_us = daos_getutime();
 
-load_wal:
-	tight_loop = 0;
-	blk_off = 0;
-	rc = load_wal(mc, buf, max_blks, tx_id);
+	rc = wal_ra_init(&ra, mc, max_blks, id2off(tx_id));
 	if (rc) {
 		D_ERROR("Failed to load WAL. "DF_RC"\n", DP_RC(rc));
-		goto out;
+		D_FREE(act);
+		return rc;
 	}
+	buf = ra.ra_bufs[0].rb_buf;
+	blk_off = max_blks;
+	blk_end = max_blks * 2;
 
 	while (1) {
 		/* Something went wrong, it's impossible to replay the whole WAL */
@@ -1695,6 +2079,14 @@ load_wal:
 			break;
 		}
 
+		if (blk_off == blk_end) {
+			rc = wal_ra_switch(&ra, 0, &buf, &blk_off);
+			if (rc) {
+				D_ERROR("Failed to load WAL. "DF_RC"\n", DP_RC(rc));
+				break;
+			}
+		}
+
 		hdr = (struct wal_trans_head *)(buf + blk_off * blk_bytes);
 		rc = verify_tx_hdr(si, hdr, tx_id);
 		if (rc)
@@ -1702,14 +2094,20 @@ load_wal:
 
 		calc_trans_blks(hdr->th_tot_ents, hdr->th_tot_payload, blk_bytes, &blk_desc);
 
-		if (blk_off + blk_desc.bd_blks > max_blks) {
-			if (blk_off == 0) {
-				D_ERROR("Too large tx, the WAL is corrupted\n");
-				rc = -DER_INVAL;
+		if (blk_desc.bd_blks > max_blks) {
+			D_ERROR("Too large tx, the WAL is corrupted\n");
+			rc = -DER_INVAL;
+			break;
+		}
+
+		/* The tx straddles the window end, continue in the read-ahead window */
+		if (blk_off + blk_desc.bd_blks > blk_end) {
+			rc = wal_ra_switch(&ra, blk_end - blk_off, &buf, &blk_off);
+			if (rc) {
+				D_ERROR("Failed to load WAL. "DF_RC"\n", DP_RC(rc));
 				break;
 			}
-			memset(buf, 0, max_blks * blk_bytes);
-			goto load_wal;
+			hdr = (struct wal_trans_head *)(buf + blk_off * blk_bytes);
 		}
 
 		rc = verify_tx(mc, (char *)hdr, &blk_desc, &dbuf, &dbuf_len);
@@ -1738,11 +2136,6 @@ load_wal:
 		}
 		tx_id = wal_next_id(si, tx_id, blk_desc.bd_blks);
 
-		if (blk_off == max_blks) {
-			memset(buf, 0, max_blks * blk_bytes);
-			goto load_wal;
-		}
-
 		if (tight_loop >= 20) {
 			tight_loop = 0;
 			bio_yield(NULL);
@@ -1755,7 +2148,8 @@ load_wal:
 			break;
 		}
 	}
-out:
+	wal_ra_fini(&ra);
+
 	if (rc >= 0) {
 		D_DEBUG(DB_IO, "Replayed %u WAL transactions\n", nr_replayed);
 		D_ASSERT(si->si_commit_blks == 0 || wal_id_cmp(si, tx_id, si->si_commit_id) > 0);
@@ -1800,7 +2194,6 @@ out:
 
 	D_FREE(dbuf);
 	D_FREE(act);
-	D_FREE(buf);
 	return rc;
 }
 
@@ -98,6 +98,8 @@ struct wal_super_info {
 	ABT_mutex		si_mutex;	/* For si_rsrv_wq */
 	unsigned int		si_rsrv_waiters;/* Number of waiters in reserve waitqueue */
 	unsigned int		si_pending_tx;	/* Number of pending transactions */
+	struct wal_group	*si_group;	/* Commit group open for joining */
+	unsigned int		si_group_linger;/* Yields of group leader waiting for joiners */
 	unsigned int		si_tx_failed:1;	/* Indicating some transaction failed */
 };
 
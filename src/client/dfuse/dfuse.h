@@ -96,6 +96,26 @@ struct dfuse_eq {
  * memory consumption */
 #define DFUSE_MAX_PRE_READ (1024 * 1024 * 4)
 
+/* Write coalescing.
+ *
+ * With write-back caching enabled dfuse replies to writes before they complete, however each
+ * kernel write request still becomes one dfs write so applications doing small appends are bound
+ * by the rate dfuse can issue RPCs.  If the dfuse-write-coalesce container attribute is set then
+ * writes of up to DFUSE_WB_COALESCE_MAX bytes are instead copied into a per-inode buffer of
+ * DFUSE_MAX_READ bytes, with writes that are adjacent to or overlap the buffered range being
+ * merged into it.
+ *
+ * The buffer is written to DAOS as a single dfs write when it is full, when a write arrives which
+ * cannot be merged, when it has been holding data for longer than the configured time, or from
+ * DFUSE_IE_WFLUSH() which is called on fsync, flush, close, getattr, setattr and read.  While the
+ * buffer holds data it holds a read lock on ie_wlock in the same way as an in-flight write-back
+ * write so the existing flush logic will wait for it.
+ */
+#define DFUSE_WB_COALESCE_MAX     (1024 * 64)
+
+/* Time to hold data for if the attribute is set to "on" */
+#define DFUSE_WB_COALESCE_DEFAULT 1
+
 /* Launch fuse, and do not return until complete */
 int
 dfuse_launch_fuse(struct dfuse_info *dfuse_info, struct fuse_args *args);
@@ -142,6 +162,58 @@ struct dfuse_pre_read {
 	int                 dra_rc;
 };
 
+/* Streaming read.
+ *
+ * Pre-read only covers files which fit in a single buffer, for larger files dfuse would otherwise
+ * issue one dfs read per kernel read request, so sequential reads are bound by round-trip latency
+ * rather than bandwidth.  Once an open handle has read linearly past DFUSE_STREAM_START bytes of a
+ * file larger than DFUSE_MAX_PRE_READ a stream descriptor is attached to the inode and dfuse
+ * keeps a window of extents in flight ahead of the reader, each of DFUSE_MAX_READ bytes and
+ * aligned to that size.  Kernel read requests which fall within an extent are replied to from the
+ * extent buffer, either directly if the dfs read has completed or from the read callback if not.
+ *
+ * The window starts at DFUSE_STREAM_MIN_WINDOW extents and is doubled every time the reader has
+ * to wait for an extent, up to DFUSE_STREAM_MAX_WINDOW.  If the reader finds a full window of
+ * extents already read then it's reduced by one, so the memory used tracks the rate the
+ * application is consuming data compared to the rate it can be read.
+ *
+ * The stream is shared by all open handles of the inode that are reading linearly and holds a
+ * reference on the inode, it is detached from the inode when the last handle using it is closed
+ * and freed once any outstanding reads have completed.  If the file is written to through dfuse,
+ * or has writes held in the write-back cache, then any extents are discarded and reads fall back
+ * to the regular path.
+ *
+ * The stream holds file data so is only used if data caching is enabled for the container, and
+ * extents are discarded once older than the data cache timeout.
+ */
+#define DFUSE_STREAM_START      (DFUSE_MAX_READ * 2)
+#define DFUSE_STREAM_MIN_WINDOW 2
+#define DFUSE_STREAM_MAX_WINDOW 16
+
+struct dfuse_read_stream {
+	pthread_mutex_t           drs_lock;
+	/* List of dfuse_stream_extent, sorted by offset */
+	d_list_t                  drs_extents;
+	struct dfuse_info        *drs_info;
+	struct dfuse_inode_entry *drs_ie;
+	/* Read-only duplicate of the object handle, used for all extent reads */
+	dfs_obj_t                *drs_obj;
+	/* Offset of the next extent to be read */
+	off_t                     drs_next;
+	/* Number of extents to keep ahead of the reader */
+	uint32_t                  drs_window;
+	/* Number of consecutive reads which did not have to wait */
+	uint32_t                  drs_hits;
+	/* Number of extents with dfs reads outstanding */
+	uint32_t                  drs_inflight;
+	/* Number of open handles using the stream, protected by di_lock */
+	uint32_t                  drs_users;
+	/* A short read has been seen so do not read further */
+	bool                      drs_eof;
+	/* Detached from the inode, free once all reads have completed */
+	bool                      drs_closing;
+};
+
 /** what is returned as the handle for fuse fuse_file_info on create/open/opendir */
 struct dfuse_obj_hdl {
 	/** pointer to dfs_t */
@@ -151,6 +223,8 @@ struct dfuse_obj_hdl {
 
 	struct dfuse_pre_read    *doh_readahead;
 
+	struct dfuse_read_stream *doh_stream;
+
 	/** the inode entry for the file */
 	struct dfuse_inode_entry *doh_ie;
 
@@ -403,8 +477,9 @@ struct dfuse_event {
 	d_list_t         de_list;
 	struct dfuse_eq *de_eqt;
 	union {
-		struct dfuse_obj_hdl     *de_oh;
-		struct dfuse_inode_entry *de_ie;
+		struct dfuse_obj_hdl       *de_oh;
+		struct dfuse_inode_entry   *de_ie;
+		struct dfuse_stream_extent *de_extent;
 	};
 	off_t  de_req_position; /**< The file position requested by fuse */
 	union {
@@ -473,6 +548,7 @@ struct dfuse_pool {
 	ACTION(RENAME)                                                                             \
 	ACTION(OPEN)                                                                               \
 	ACTION(PRE_READ)                                                                           \
+	ACTION(STREAM_READ)                                                                        \
 	ACTION(READ)                                                                               \
 	ACTION(WRITE)                                                                              \
 	ACTION(STATFS)
@@ -537,6 +613,8 @@ struct dfuse_cont {
 	bool                    dfc_data_otoc;
 	bool                    dfc_direct_io_disable;
 	bool                          dfc_wb_cache;
+	/** Maximum time in seconds small writes are held for coalescing, zero to disable */
+	double                  dfc_wb_coalesce;
 
 	/* Set to true if the inode was allocated to this structure, so should be kept on close*/
 	bool                    dfc_save_ino;
@@ -1011,18 +1089,30 @@ struct dfuse_inode_entry {
 
 	/* Entry on the evict list */
 	d_list_t                  ie_evict_entry;
+
+	/* Streaming read descriptor, if present.  Shared by open handles, protected by di_lock */
+	struct dfuse_read_stream *ie_stream;
+
+	/* Write coalescing buffer, allocated on first use and kept until the inode is closed */
+	struct dfuse_wb_buf *ATOMIC ie_wb;
+
+	/* Number of DFUSE_IE_WFLUSH() calls in progress, writes are not coalesced whilst set */
+	ATOMIC uint32_t           ie_wb_flushing;
 };
 
-/* Flush write-back cache writes to a inode.  It does this by waiting for and then releasing an
- * exclusive lock on the inode.  Writes take a shared lock so this will block until all pending
- * writes are complete.
+/* Flush write-back cache writes to a inode.  It does this by issuing any coalesced writes and then
+ * waiting for and releasing an exclusive lock on the inode.  Writes take a shared lock so this will
+ * block until all pending writes are complete.  Writes arriving in the meantime are not coalesced,
+ * so cannot hold the shared lock until the coalescing timeout.
  */
 
 #define DFUSE_IE_WFLUSH(_ie)                                                                       \
 	do {                                                                                       \
 		if ((_ie)->ie_dfs->dfc_wb_cache && S_ISREG((_ie)->ie_stat.st_mode)) {              \
+			dfuse_wb_flush_start(_ie);                                                 \
 			D_RWLOCK_WRLOCK(&(_ie)->ie_wlock);                                         \
 			D_RWLOCK_UNLOCK(&(_ie)->ie_wlock);                                         \
+			dfuse_wb_flush_end(_ie);                                                   \
 		}                                                                                  \
 	} while (0)
 
@@ -1173,6 +1263,28 @@ dfuse_dcache_get_valid(struct dfuse_inode_entry *ie, double max_age);
 void
 dfuse_pre_read(struct dfuse_info *dfuse_info, struct dfuse_obj_hdl *oh);
 
+/* Issue any coalesced writes for an inode and stop coalescing until the matching end call */
+void
+dfuse_wb_flush_start(struct dfuse_inode_entry *ie);
+
+void
+dfuse_wb_flush_end(struct dfuse_inode_entry *ie);
+
+/* Free the coalescing buffer, called on inode close */
+void
+dfuse_wb_free(struct dfuse_inode_entry *ie);
+
+/* Start and stop the thread which flushes coalesced writes on timeout */
+int
+dfuse_wb_thread_start(struct dfuse_info *dfuse_info);
+
+void
+dfuse_wb_thread_stop(void);
+
+/* Drop the handles use of the streaming read descriptor, called on release */
+void
+dfuse_stream_detach(struct dfuse_info *dfuse_info, struct dfuse_obj_hdl *oh);
+
 int
 check_for_uns_ep(struct dfuse_info *dfuse_info, struct dfuse_inode_entry *ie, char *attr,
 		 daos_size_t len);
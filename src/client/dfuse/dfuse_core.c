@@ -560,11 +560,12 @@ dfuse_pool_get_handle(struct dfuse_info *dfuse_info, uuid_t pool, struct dfuse_p
 	return dfuse_pool_connect(dfuse_info, uuid_str, _dfp);
 }
 
-#define ATTR_COUNT 6
+#define ATTR_COUNT 7
 
 char const *const cont_attr_names[ATTR_COUNT] = {
     "dfuse-attr-time",    "dfuse-dentry-time", "dfuse-dentry-dir-time",
-    "dfuse-ndentry-time", "dfuse-data-cache",  "dfuse-direct-io-disable"};
+    "dfuse-ndentry-time", "dfuse-data-cache",  "dfuse-direct-io-disable",
+    "dfuse-write-coalesce"};
 
 #define ATTR_TIME_INDEX              0
 #define ATTR_DENTRY_INDEX            1
@@ -572,6 +573,7 @@ char const *const cont_attr_names[ATTR_COUNT] = {
 #define ATTR_NDENTRY_INDEX           3
 #define ATTR_DATA_CACHE_INDEX        4
 #define ATTR_DIRECT_IO_DISABLE_INDEX 5
+#define ATTR_WRITE_COALESCE_INDEX    6
 
 /* Attribute values are of the form "120M", so the buffer does not need to be
  * large.
@@ -697,6 +699,24 @@ dfuse_cont_get_cache(struct dfuse_info *dfuse_info, struct dfuse_cont *dfc)
 			}
 			continue;
 		}
+		if (i == ATTR_WRITE_COALESCE_INDEX) {
+			if (dfuse_char_enabled(buff_addrs[i], sizes[i])) {
+				dfc->dfc_wb_coalesce = DFUSE_WB_COALESCE_DEFAULT;
+				DFUSE_TRA_INFO(dfc, "setting '%s' is enabled", cont_attr_names[i]);
+			} else if (dfuse_char_disabled(buff_addrs[i], sizes[i])) {
+				dfc->dfc_wb_coalesce = 0;
+				DFUSE_TRA_INFO(dfc, "setting '%s' is disabled", cont_attr_names[i]);
+			} else if (dfuse_parse_time(buff_addrs[i], sizes[i], &value) == 0) {
+				DFUSE_TRA_INFO(dfc, "setting '%s' is %u seconds",
+					       cont_attr_names[i], value);
+				dfc->dfc_wb_coalesce = value;
+			} else {
+				DFUSE_TRA_WARNING(dfc, "Failed to parse '%s' for '%s'",
+						  buff_addrs[i], cont_attr_names[i]);
+				dfc->dfc_wb_coalesce = 0;
+			}
+			continue;
+		}
 
 		rc = dfuse_parse_time(buff_addrs[i], sizes[i], &value);
 		if (rc != 0) {
@@ -733,6 +753,13 @@ dfuse_cont_get_cache(struct dfuse_info *dfuse_info, struct dfuse_cont *dfc)
 
 	if (dfc->dfc_data_timeout != 0 && dfuse_info->di_wb_cache)
 		dfc->dfc_wb_cache = true;
+
+	/* Write coalescing is part of write-back caching so requires it to be enabled */
+	if (dfc->dfc_wb_coalesce != 0 && !dfc->dfc_wb_cache) {
+		DFUSE_TRA_WARNING(dfc, "Ignoring %s as write-back caching is disabled",
+				  cont_attr_names[ATTR_WRITE_COALESCE_INDEX]);
+		dfc->dfc_wb_coalesce = 0;
+	}
 	rc = 0;
 out:
 	D_FREE(buff);
@@ -1158,8 +1185,9 @@ dfuse_fs_init(struct dfuse_info *dfuse_info)
 	if (rc != 0)
 		D_GOTO(err, rc);
 
-	rc = d_hash_table_create_inplace(D_HASH_FT_LRU | D_HASH_FT_EPHEMERAL, 16, dfuse_info,
-					 &ie_hops, &dfuse_info->dpi_iet);
+	/* The inode table grows with the namespace, 16 bits is the minimum size */
+	rc = d_hash_table_create_inplace(D_HASH_FT_LRU | D_HASH_FT_EPHEMERAL | D_HASH_FT_RESIZE, 16,
+					 dfuse_info, &ie_hops, &dfuse_info->dpi_iet);
 	if (rc != 0)
 		D_GOTO(err_pt, rc);
 
@@ -1275,6 +1303,8 @@ dfuse_ie_close(struct dfuse_info *dfuse_info, struct dfuse_inode_entry *ie)
 	D_ASSERTF(atomic_load_relaxed(&ie->ie_open_count) == 0, "open_count is %d",
 		  atomic_load_relaxed(&ie->ie_open_count));
 
+	dfuse_wb_free(ie);
+
 	if (ie->ie_obj) {
 		rc = dfs_release(ie->ie_obj);
 		if (rc)
@@ -1679,6 +1709,9 @@ dfuse_fs_stop(struct dfuse_info *dfuse_info)
 
 	DFUSE_TRA_INFO(dfuse_info, "Flushing inode table");
 
+	/* Issue any coalesced writes while the progress threads are still running */
+	dfuse_wb_thread_stop();
+
 	dfuse_info->di_shutdown = true;
 
 	for (int i = 0; i < dfuse_info->di_eq_count; i++) {
@@ -169,6 +169,9 @@ dfuse_cb_release(fuse_req_t req, fuse_ino_t ino, struct fuse_file_info *fi)
 		D_FREE(oh->doh_readahead);
 	}
 
+	if (oh->doh_stream)
+		dfuse_stream_detach(dfuse_info, oh);
+
 	/* If the file was read from then set the data cache time for future use, however if the
 	 * file was written to then evict the metadata cache.
 	 * The problem here is that if the file was written to then the contents will be in the
@@ -111,6 +111,472 @@ dfuse_readahead_reply(fuse_req_t req, size_t len, off_t position, struct dfuse_o
 	return true;
 }
 
+/* A single extent of a streaming read, the data is held in a read slab descriptor */
+struct dfuse_stream_extent {
+	d_list_t                  dse_list;
+	/* Kernel requests waiting for the dfs read to complete, list of dfuse_stream_waiter */
+	d_list_t                  dse_waiters;
+	struct dfuse_read_stream *dse_stream;
+	struct dfuse_event       *dse_ev;
+	off_t                     dse_offset;
+	/* When the read was issued, the data is not used once older than the data cache timeout */
+	struct timespec           dse_issued;
+	int                       dse_rc;
+	bool                      dse_done;
+	/* Removed from the stream, free once the read has completed */
+	bool                      dse_orphan;
+};
+
+struct dfuse_stream_waiter {
+	d_list_t              dsw_list;
+	fuse_req_t            dsw_req;
+	struct dfuse_obj_hdl *dsw_oh;
+	off_t                 dsw_position;
+	size_t                dsw_len;
+};
+
+static void
+dfuse_stream_extent_free(struct dfuse_stream_extent *dse)
+{
+	struct dfuse_event *ev = dse->dse_ev;
+
+	D_ASSERT(d_list_empty(&dse->dse_waiters));
+
+	daos_event_fini(&ev->de_ev);
+	d_slab_release(ev->de_eqt->de_read_slab, ev);
+	D_FREE(dse);
+}
+
+static void
+dfuse_stream_free(struct dfuse_read_stream *drs)
+{
+	int rc;
+
+	D_ASSERT(d_list_empty(&drs->drs_extents));
+	D_ASSERT(drs->drs_inflight == 0);
+
+	rc = dfs_release(drs->drs_obj);
+	if (rc != 0)
+		DHS_ERROR(drs->drs_ie, rc, "dfs_release() failed");
+
+	D_MUTEX_DESTROY(&drs->drs_lock);
+	dfuse_inode_decref(drs->drs_info, drs->drs_ie);
+	D_FREE(drs);
+}
+
+/* Remove all extents from the stream, must be called with drs_lock held.  Extents which have
+ * completed are freed now, any with reads outstanding are freed from the read callback.
+ */
+static void
+dfuse_stream_drop(struct dfuse_read_stream *drs)
+{
+	struct dfuse_stream_extent *dse;
+	struct dfuse_stream_extent *next;
+
+	d_list_for_each_entry_safe(dse, next, &drs->drs_extents, dse_list) {
+		d_list_del_init(&dse->dse_list);
+		if (dse->dse_done)
+			dfuse_stream_extent_free(dse);
+		else
+			dse->dse_orphan = true;
+	}
+}
+
+/* Reply to a kernel read from a completed extent.  Returns true if the extent is no longer needed,
+ * either because the request read up to the end of it or there was an error.
+ */
+static bool
+dfuse_stream_reply(struct dfuse_stream_extent *dse, struct dfuse_obj_hdl *oh, fuse_req_t req,
+		   off_t position, size_t len)
+{
+	struct dfuse_event *ev        = dse->dse_ev;
+	size_t              start     = position - dse->dse_offset;
+	size_t              reply_len = 0;
+	bool                consumed;
+
+	if (dse->dse_rc != 0) {
+		DFUSE_REPLY_ERR_RAW(oh, req, dse->dse_rc);
+		return true;
+	}
+
+	if (start < ev->de_len)
+		reply_len = min(len, ev->de_len - start);
+
+	consumed = (start + len >= DFUSE_MAX_READ);
+
+	if (reply_len == len) {
+		DFUSE_TRA_DEBUG(oh, "%#zx-%#zx read", position, position + len - 1);
+	} else {
+		DFUSE_TRA_DEBUG(oh, "%#zx-%#zx read %#zx-%#zx not read (truncated)", position,
+				position + reply_len - 1, position + reply_len, position + len - 1);
+		oh->doh_linear_read_pos = position + reply_len;
+		oh->doh_linear_read_eof = true;
+		consumed                = true;
+	}
+
+	DFUSE_IE_STAT_ADD(oh->doh_ie, DS_STREAM_READ);
+	DFUSE_REPLY_BUFQ(oh, req, ev->de_iov.iov_buf + start, reply_len);
+	return consumed;
+}
+
+static void
+dfuse_cb_stream_complete(struct dfuse_event *ev)
+{
+	struct dfuse_stream_extent *dse      = ev->de_extent;
+	struct dfuse_read_stream   *drs      = dse->dse_stream;
+	struct dfuse_stream_waiter *dsw;
+	bool                        consumed = false;
+	bool                        free_drs;
+
+	D_MUTEX_LOCK(&drs->drs_lock);
+
+	dse->dse_done = true;
+	dse->dse_rc   = ev->de_ev.ev_error;
+	drs->drs_inflight--;
+
+	/* A short read means the end of the file has been reached so stop reading ahead */
+	if (!dse->dse_orphan && dse->dse_rc == 0 && ev->de_len < DFUSE_MAX_READ)
+		drs->drs_eof = true;
+
+	while ((dsw = d_list_pop_entry(&dse->dse_waiters, struct dfuse_stream_waiter,
+				       dsw_list))) {
+		if (dfuse_stream_reply(dse, dsw->dsw_oh, dsw->dsw_req, dsw->dsw_position,
+				       dsw->dsw_len))
+			consumed = true;
+		D_FREE(dsw);
+	}
+
+	if (consumed || dse->dse_orphan) {
+		d_list_del(&dse->dse_list);
+		dfuse_stream_extent_free(dse);
+	}
+
+	free_drs = drs->drs_closing && drs->drs_inflight == 0;
+	D_MUTEX_UNLOCK(&drs->drs_lock);
+
+	if (free_drs)
+		dfuse_stream_free(drs);
+}
+
+/* Issue a read for the next extent of the stream, must be called with drs_lock held */
+static int
+dfuse_stream_issue(struct dfuse_read_stream *drs)
+{
+	struct dfuse_info          *dfuse_info = drs->drs_info;
+	struct dfuse_stream_extent *dse;
+	struct dfuse_event         *ev;
+	struct dfuse_eq            *eqt;
+	uint64_t                    eqt_idx;
+	int                         rc;
+
+	D_ALLOC_PTR(dse);
+	if (dse == NULL)
+		return ENOMEM;
+
+	eqt_idx = atomic_fetch_add_relaxed(&dfuse_info->di_eqt_idx, 1);
+	eqt     = &dfuse_info->di_eqt[eqt_idx % dfuse_info->di_eq_count];
+
+	ev = d_slab_acquire(eqt->de_read_slab);
+	if (ev == NULL)
+		D_GOTO(free, rc = ENOMEM);
+
+	D_INIT_LIST_HEAD(&dse->dse_waiters);
+	dse->dse_stream = drs;
+	dse->dse_ev     = ev;
+	dse->dse_offset = drs->drs_next;
+	clock_gettime(CLOCK_MONOTONIC_COARSE, &dse->dse_issued);
+
+	ev->de_iov.iov_len  = DFUSE_MAX_READ;
+	ev->de_req          = 0;
+	ev->de_sgl.sg_nr    = 1;
+	ev->de_extent       = dse;
+	ev->de_req_len      = DFUSE_MAX_READ;
+	ev->de_req_position = drs->drs_next;
+	ev->de_complete_cb  = dfuse_cb_stream_complete;
+
+	rc = dfs_read(drs->drs_ie->ie_dfs->dfs_ns, drs->drs_obj, &ev->de_sgl, drs->drs_next,
+		      &ev->de_len, &ev->de_ev);
+	if (rc != 0)
+		D_GOTO(release, rc);
+
+	/* The callback takes drs_lock so cannot run until this returns */
+	d_list_add_tail(&dse->dse_list, &drs->drs_extents);
+	drs->drs_inflight++;
+	drs->drs_next += DFUSE_MAX_READ;
+
+	/* Send a message to the async thread to wake it up and poll for events */
+	sem_post(&eqt->de_sem);
+
+	/* Now ensure there are more descriptors for the next request */
+	d_slab_restock(eqt->de_read_slab);
+
+	return 0;
+release:
+	daos_event_fini(&ev->de_ev);
+	d_slab_release(eqt->de_read_slab, ev);
+free:
+	D_FREE(dse);
+	return rc;
+}
+
+/* Check if an extent is older than the data cache timeout of the container */
+static bool
+dfuse_stream_expired(struct dfuse_read_stream *drs, struct dfuse_stream_extent *dse)
+{
+	double          max_age = drs->drs_ie->ie_dfs->dfc_data_timeout;
+	struct timespec now;
+	double          age;
+
+	if (max_age == -1)
+		return false;
+
+	clock_gettime(CLOCK_MONOTONIC_COARSE, &now);
+
+	age = (now.tv_sec - dse->dse_issued.tv_sec) +
+	      ((double)(now.tv_nsec - dse->dse_issued.tv_nsec) / 1000000000);
+
+	return age >= max_age;
+}
+
+/* Check if the inode has writes held in the write-back cache, or being flushed from it.  Reads from
+ * the stream would not see these so the regular read path, which flushes them first, is used.
+ */
+static bool
+dfuse_stream_wb_pending(struct dfuse_inode_entry *ie)
+{
+	return atomic_load_relaxed(&ie->ie_wb) != NULL ||
+	       atomic_load_relaxed(&ie->ie_wb_flushing) != 0;
+}
+
+/* Attempt to service a read from the stream.  Returns true if the request has been replied to or
+ * will be replied to from the read callback, false if the regular read path should be used.
+ */
+static bool
+dfuse_stream_read(fuse_req_t req, size_t len, off_t position, struct dfuse_obj_hdl *oh)
+{
+	struct dfuse_read_stream   *drs    = oh->doh_stream;
+	off_t                       offset = position - (position % DFUSE_MAX_READ);
+	struct dfuse_stream_extent *found  = NULL;
+	struct dfuse_stream_extent *dse;
+	struct dfuse_stream_waiter *dsw;
+	uint32_t                    ahead   = 0;
+	bool                        stalled = true;
+	bool                        replied = false;
+
+	/* Requests which span two extents are left to the regular path */
+	if (len == 0 || position + len > offset + DFUSE_MAX_READ)
+		return false;
+
+	D_MUTEX_LOCK(&drs->drs_lock);
+
+	/* The file has been written to through dfuse so anything already read may be stale */
+	if (atomic_load_relaxed(&oh->doh_ie->ie_open_write_count) != 0 ||
+	    dfuse_stream_wb_pending(oh->doh_ie)) {
+		DFUSE_TRA_DEBUG(oh, "Dropping stream extents");
+		dfuse_stream_drop(drs);
+		drs->drs_next = 0;
+		drs->drs_eof  = false;
+		D_GOTO(out, 0);
+	}
+
+	/* Extents are issued in order so if the first one has expired the stream starts again */
+	if (!d_list_empty(&drs->drs_extents) &&
+	    dfuse_stream_expired(drs, d_list_entry(drs->drs_extents.next,
+						   struct dfuse_stream_extent, dse_list))) {
+		DFUSE_TRA_DEBUG(oh, "Dropping expired stream extents");
+		dfuse_stream_drop(drs);
+	}
+
+	d_list_for_each_entry(dse, &drs->drs_extents, dse_list) {
+		if (dse->dse_offset < offset)
+			continue;
+		if (dse->dse_offset == offset)
+			found = dse;
+		ahead++;
+	}
+
+	if (found == NULL) {
+		/* Another handle is reading this file ahead of this one and the extent has
+		 * already been consumed.
+		 */
+		if (offset < drs->drs_next && !d_list_empty(&drs->drs_extents))
+			D_GOTO(out, 0);
+
+		/* The reader has moved past the window, restart the stream from here */
+		DFUSE_TRA_DEBUG(oh, "Starting stream at %#zx", offset);
+		dfuse_stream_drop(drs);
+		drs->drs_next   = offset;
+		drs->drs_eof    = false;
+		drs->drs_window = DFUSE_STREAM_MIN_WINDOW;
+		drs->drs_hits   = 0;
+
+		if (dfuse_stream_issue(drs) != 0)
+			D_GOTO(out, 0);
+
+		found   = d_list_entry(drs->drs_extents.prev, struct dfuse_stream_extent, dse_list);
+		ahead   = 1;
+		stalled = false;
+	}
+
+	oh->doh_linear_read_pos = max(oh->doh_linear_read_pos, position + len);
+
+	if (found->dse_done) {
+		/* The reader is not waiting on reads, reduce the window back towards the minimum
+		 * if it stays this way.
+		 */
+		if (++drs->drs_hits >= drs->drs_window && drs->drs_window > DFUSE_STREAM_MIN_WINDOW) {
+			drs->drs_window--;
+			drs->drs_hits = 0;
+		}
+
+		if (dfuse_stream_reply(found, oh, req, position, len)) {
+			d_list_del(&found->dse_list);
+			dfuse_stream_extent_free(found);
+			ahead--;
+		}
+		replied = true;
+	} else {
+		D_ALLOC_PTR(dsw);
+		if (dsw == NULL)
+			D_GOTO(out, 0);
+
+		dsw->dsw_req      = req;
+		dsw->dsw_oh       = oh;
+		dsw->dsw_position = position;
+		dsw->dsw_len      = len;
+		d_list_add_tail(&dsw->dsw_list, &found->dse_waiters);
+
+		/* The reader is waiting on the data so read further ahead */
+		if (stalled && drs->drs_window < DFUSE_STREAM_MAX_WINDOW) {
+			drs->drs_window = min(drs->drs_window * 2, DFUSE_STREAM_MAX_WINDOW);
+			DFUSE_TRA_DEBUG(oh, "Increasing stream window to %u", drs->drs_window);
+		}
+		drs->drs_hits = 0;
+		replied       = true;
+	}
+
+	while (ahead < drs->drs_window && !drs->drs_eof) {
+		if (dfuse_stream_issue(drs) != 0)
+			break;
+		ahead++;
+	}
+
+out:
+	D_MUTEX_UNLOCK(&drs->drs_lock);
+	return replied;
+}
+
+/* Attach the inode stream to an open handle, creating it if required */
+static void
+dfuse_stream_attach(struct dfuse_info *dfuse_info, struct dfuse_obj_hdl *oh)
+{
+	struct dfuse_inode_entry *ie = oh->doh_ie;
+	struct dfuse_read_stream *drs;
+	int                       rc;
+
+	D_SPIN_LOCK(&dfuse_info->di_lock);
+	if (ie->ie_stream) {
+		ie->ie_stream->drs_users++;
+		oh->doh_stream = ie->ie_stream;
+	}
+	D_SPIN_UNLOCK(&dfuse_info->di_lock);
+
+	if (oh->doh_stream)
+		return;
+
+	D_ALLOC_PTR(drs);
+	if (drs == NULL)
+		return;
+
+	rc = dfs_dup(oh->doh_dfs, oh->doh_obj, O_RDONLY, &drs->drs_obj);
+	if (rc != 0) {
+		DHS_ERROR(oh, rc, "dfs_dup() failed");
+		D_FREE(drs);
+		return;
+	}
+
+	D_MUTEX_INIT(&drs->drs_lock, 0);
+	D_INIT_LIST_HEAD(&drs->drs_extents);
+	drs->drs_info   = dfuse_info;
+	drs->drs_ie     = ie;
+	drs->drs_window = DFUSE_STREAM_MIN_WINDOW;
+	drs->drs_users  = 1;
+
+	D_SPIN_LOCK(&dfuse_info->di_lock);
+	if (ie->ie_stream) {
+		ie->ie_stream->drs_users++;
+	} else {
+		ie->ie_stream = drs;
+		atomic_fetch_add_relaxed(&ie->ie_ref, 1);
+		drs = NULL;
+	}
+	oh->doh_stream = ie->ie_stream;
+	D_SPIN_UNLOCK(&dfuse_info->di_lock);
+
+	/* Lost the race with another handle on the same inode */
+	if (drs) {
+		dfs_release(drs->drs_obj);
+		D_MUTEX_DESTROY(&drs->drs_lock);
+		D_FREE(drs);
+		return;
+	}
+
+	DFUSE_TRA_DEBUG(oh, "Created stream for %#zx byte file", ie->ie_stat.st_size);
+}
+
+void
+dfuse_stream_detach(struct dfuse_info *dfuse_info, struct dfuse_obj_hdl *oh)
+{
+	struct dfuse_read_stream *drs  = oh->doh_stream;
+	bool                      last = false;
+	bool                      free_drs;
+
+	D_SPIN_LOCK(&dfuse_info->di_lock);
+	if (--drs->drs_users == 0) {
+		oh->doh_ie->ie_stream = NULL;
+		last                  = true;
+	}
+	D_SPIN_UNLOCK(&dfuse_info->di_lock);
+
+	oh->doh_stream = NULL;
+
+	if (!last)
+		return;
+
+	D_MUTEX_LOCK(&drs->drs_lock);
+	dfuse_stream_drop(drs);
+	drs->drs_closing = true;
+	free_drs         = (drs->drs_inflight == 0);
+	D_MUTEX_UNLOCK(&drs->drs_lock);
+
+	if (free_drs)
+		dfuse_stream_free(drs);
+}
+
+/* Check if a read should start using the stream, data caching needs to be enabled for the
+ * container and the handle needs to have been reading linearly for a while, from a file which is
+ * too large for pre-read and not being written to.
+ */
+static bool
+dfuse_stream_wanted(struct dfuse_obj_hdl *oh, off_t position)
+{
+	struct dfuse_inode_entry *ie = oh->doh_ie;
+
+	if (ie->ie_dfs->dfc_data_timeout == 0)
+		return false;
+
+	if (!oh->doh_linear_read || oh->doh_readahead)
+		return false;
+
+	if (position < DFUSE_STREAM_START || position != oh->doh_linear_read_pos)
+		return false;
+
+	if (ie->ie_stat.st_size <= DFUSE_MAX_PRE_READ || ie->ie_truncated)
+		return false;
+
+	return atomic_load_relaxed(&ie->ie_open_write_count) == 0 && !dfuse_stream_wb_pending(ie);
+}
+
 void
 dfuse_cb_read(fuse_req_t req, fuse_ino_t ino, size_t len, off_t position, struct fuse_file_info *fi)
 {
@@ -157,6 +623,14 @@ dfuse_cb_read(fuse_req_t req, fuse_ino_t ino, size_t len, off_t position, struct
 			return;
 	}
 
+	if (oh->doh_stream == NULL && dfuse_stream_wanted(oh, position))
+		dfuse_stream_attach(dfuse_info, oh);
+
+	if (oh->doh_stream && oh->doh_linear_read) {
+		if (dfuse_stream_read(req, len, position, oh))
+			return;
+	}
+
 	eqt_idx = atomic_fetch_add_relaxed(&dfuse_info->di_eqt_idx, 1);
 	eqt = &dfuse_info->di_eqt[eqt_idx % dfuse_info->di_eq_count];
 
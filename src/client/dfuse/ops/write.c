@@ -22,6 +22,398 @@ dfuse_cb_write_complete(struct dfuse_event *ev)
 	d_slab_release(ev->de_eqt->de_write_slab, ev);
 }
 
+/* Per-inode write coalescing buffer, see the description in dfuse.h */
+struct dfuse_wb_buf {
+	pthread_mutex_t           dwb_lock;
+	/* Entry on wb_list whilst the buffer holds data, protected by wb_lock */
+	d_list_t                  dwb_list;
+	struct dfuse_inode_entry *dwb_ie;
+	/* Write descriptor holding the data, NULL if the buffer is empty */
+	struct dfuse_event       *dwb_ev;
+	/* Handle the buffered data will be written through */
+	struct dfuse_obj_hdl     *dwb_oh;
+	off_t                     dwb_start;
+	size_t                    dwb_len;
+	/* Time the first write was added to the buffer */
+	struct timespec           dwb_time;
+};
+
+/* List of buffers holding data, in the order they were started, used for timeouts.
+ *
+ * Locking: wb_lock may be taken with dwb_lock held, the flush thread holds wb_lock and uses trylock
+ * on dwb_lock to avoid lock inversion.
+ */
+static pthread_mutex_t wb_lock = PTHREAD_MUTEX_INITIALIZER;
+static D_LIST_HEAD(wb_list);
+static bool            wb_stop;
+static pthread_t       wb_thread;
+static sem_t           wb_sem;
+
+/* Issue a single dfs write for the buffered data, must be called with dwb_lock held and the buffer
+ * removed from wb_list.  The read lock on ie_wlock held by the buffer is released by the write
+ * callback.
+ */
+static void
+dfuse_wb_issue(struct dfuse_wb_buf *dwb)
+{
+	struct dfuse_event   *ev = dwb->dwb_ev;
+	struct dfuse_obj_hdl *oh = dwb->dwb_oh;
+	int                   rc;
+
+	dwb->dwb_ev = NULL;
+	dwb->dwb_oh = NULL;
+
+	DFUSE_TRA_DEBUG(oh, "%#zx-%#zx flushing", dwb->dwb_start,
+			dwb->dwb_start + dwb->dwb_len - 1);
+
+	ev->de_oh          = oh;
+	ev->de_req         = 0;
+	ev->de_iov.iov_len = dwb->dwb_len;
+	ev->de_len         = dwb->dwb_len;
+	ev->de_complete_cb = dfuse_cb_write_complete;
+
+	rc = dfs_write(oh->doh_dfs, oh->doh_obj, &ev->de_sgl, dwb->dwb_start, &ev->de_ev);
+	if (rc != 0) {
+		DHS_ERROR(oh, rc, "dfs_write() failed");
+		D_RWLOCK_UNLOCK(&dwb->dwb_ie->ie_wlock);
+		daos_event_fini(&ev->de_ev);
+		d_slab_release(ev->de_eqt->de_write_slab, ev);
+		return;
+	}
+
+	/* Send a message to the async thread to wake it up and poll for events */
+	sem_post(&ev->de_eqt->de_sem);
+}
+
+/* Flush the buffer if it holds data, must be called with dwb_lock held */
+static void
+dfuse_wb_flush_locked(struct dfuse_wb_buf *dwb)
+{
+	if (dwb->dwb_ev == NULL)
+		return;
+
+	D_MUTEX_LOCK(&wb_lock);
+	d_list_del_init(&dwb->dwb_list);
+	D_MUTEX_UNLOCK(&wb_lock);
+
+	dfuse_wb_issue(dwb);
+}
+
+static void
+dfuse_wb_flush(struct dfuse_inode_entry *ie)
+{
+	struct dfuse_wb_buf *dwb = atomic_load(&ie->ie_wb);
+
+	if (dwb == NULL)
+		return;
+
+	D_MUTEX_LOCK(&dwb->dwb_lock);
+	dfuse_wb_flush_locked(dwb);
+	D_MUTEX_UNLOCK(&dwb->dwb_lock);
+}
+
+/* Issue any coalesced writes and stop further writes from being coalesced until
+ * dfuse_wb_flush_end() is called, so that the caller can wait for all writes to complete without
+ * a new buffer taking the read lock in the meantime.
+ *
+ * dfuse_wb_coalesce() checks ie_wb_flushing with dwb_lock held, after ie_wb has been set, and
+ * this function sets it before reading ie_wb and flushing with dwb_lock held, so either the write
+ * sees the flag or its data is flushed here.  Both variables use sequentially consistent atomics
+ * for this to hold when ie_wb is set by the write.
+ */
+void
+dfuse_wb_flush_start(struct dfuse_inode_entry *ie)
+{
+	atomic_fetch_add(&ie->ie_wb_flushing, 1);
+	dfuse_wb_flush(ie);
+}
+
+void
+dfuse_wb_flush_end(struct dfuse_inode_entry *ie)
+{
+	atomic_fetch_sub(&ie->ie_wb_flushing, 1);
+}
+
+void
+dfuse_wb_free(struct dfuse_inode_entry *ie)
+{
+	struct dfuse_wb_buf *dwb = atomic_load(&ie->ie_wb);
+
+	if (dwb == NULL)
+		return;
+
+	/* All handles have been released, which flushes the buffer */
+	D_ASSERT(dwb->dwb_ev == NULL);
+
+	D_MUTEX_DESTROY(&dwb->dwb_lock);
+	D_FREE(dwb);
+	atomic_store(&ie->ie_wb, NULL);
+}
+
+/* Return the coalescing buffer for an inode, allocating it if required */
+static struct dfuse_wb_buf *
+dfuse_wb_get(struct dfuse_inode_entry *ie)
+{
+	struct dfuse_wb_buf *dwb;
+	struct dfuse_wb_buf *cur = NULL;
+
+	dwb = atomic_load(&ie->ie_wb);
+	if (dwb)
+		return dwb;
+
+	D_ALLOC_PTR(dwb);
+	if (dwb == NULL)
+		return NULL;
+
+	D_MUTEX_INIT(&dwb->dwb_lock, 0);
+	D_INIT_LIST_HEAD(&dwb->dwb_list);
+	dwb->dwb_ie = ie;
+
+	if (atomic_compare_exchange_strong(&ie->ie_wb, &cur, dwb))
+		return dwb;
+
+	/* Another write set it first */
+	D_MUTEX_DESTROY(&dwb->dwb_lock);
+	D_FREE(dwb);
+	return cur;
+}
+
+/* Try to add a write to the coalescing buffer.  Called with a read lock held on ie_wlock.
+ *
+ * Returns 0 if the data was buffered, in which case the read lock has either been passed to the
+ * buffer or released, EAGAIN if the write should be issued directly, or an error.  In both of the
+ * latter cases the caller still holds the read lock.
+ */
+static int
+dfuse_wb_coalesce(struct dfuse_info *dfuse_info, struct dfuse_obj_hdl *oh,
+		  struct fuse_bufvec *bufv, off_t position, size_t len)
+{
+	struct dfuse_inode_entry *ie   = oh->doh_ie;
+	struct fuse_bufvec        ibuf = FUSE_BUFVEC_INIT(len);
+	struct dfuse_wb_buf      *dwb;
+	struct dfuse_event       *ev;
+	struct dfuse_eq          *eqt;
+	uint64_t                  eqt_idx;
+	ssize_t                   copied;
+	bool                      new_buf = false;
+	bool                      wake    = false;
+	int                       rc      = 0;
+	size_t                    i;
+
+	/* Only buffer data which is already in memory, copying from a file descriptor could stop
+	 * part way and leave a mix of old and new data in a buffer that is still flushed later.
+	 */
+	for (i = bufv->idx; i < bufv->count; i++)
+		if (bufv->buf[i].flags & FUSE_BUF_IS_FD)
+			return EAGAIN;
+
+	dwb = dfuse_wb_get(ie);
+	if (dwb == NULL)
+		return EAGAIN;
+
+	D_MUTEX_LOCK(&dwb->dwb_lock);
+
+	/* A flush is waiting for all writes to complete, do not hold this one back */
+	if (atomic_load(&ie->ie_wb_flushing) != 0) {
+		dfuse_wb_flush_locked(dwb);
+		D_GOTO(out, rc = EAGAIN);
+	}
+
+	/* Flush the current contents if this write cannot be merged with them */
+	if (dwb->dwb_ev != NULL &&
+	    (position < dwb->dwb_start || position > dwb->dwb_start + dwb->dwb_len ||
+	     position + len > dwb->dwb_start + DFUSE_MAX_READ))
+		dfuse_wb_flush_locked(dwb);
+
+	if (dwb->dwb_ev == NULL) {
+		eqt_idx = atomic_fetch_add_relaxed(&dfuse_info->di_eqt_idx, 1);
+		eqt     = &dfuse_info->di_eqt[eqt_idx % dfuse_info->di_eq_count];
+
+		ev = d_slab_acquire(eqt->de_write_slab);
+		if (ev == NULL)
+			D_GOTO(out, rc = EAGAIN);
+
+		dwb->dwb_ev    = ev;
+		dwb->dwb_start = position;
+		dwb->dwb_len   = 0;
+		clock_gettime(CLOCK_MONOTONIC_COARSE, &dwb->dwb_time);
+		new_buf = true;
+	}
+
+	ibuf.buf[0].mem = dwb->dwb_ev->de_iov.iov_buf + (position - dwb->dwb_start);
+
+	copied = fuse_buf_copy(&ibuf, bufv, 0);
+	D_ASSERTF(copied == len, "copied %zd of %#zx bytes\n", copied, len);
+
+	dwb->dwb_len = max(dwb->dwb_len, position + len - dwb->dwb_start);
+	dwb->dwb_oh  = oh;
+
+	DFUSE_TRA_DEBUG(oh, "%#zx-%#zx buffered", position, position + len - 1);
+
+	if (new_buf) {
+		D_MUTEX_LOCK(&wb_lock);
+		wake = d_list_empty(&wb_list);
+		d_list_add_tail(&dwb->dwb_list, &wb_list);
+		D_MUTEX_UNLOCK(&wb_lock);
+	} else {
+		/* The buffer already holds a read lock for the data */
+		D_RWLOCK_UNLOCK(&ie->ie_wlock);
+	}
+
+	if (dwb->dwb_len == DFUSE_MAX_READ)
+		dfuse_wb_flush_locked(dwb);
+
+out:
+	D_MUTEX_UNLOCK(&dwb->dwb_lock);
+
+	if (wake)
+		sem_post(&wb_sem);
+
+	return rc;
+}
+
+/* Flush buffers which have been holding data for longer than the container timeout, or all
+ * buffers if all is set.
+ */
+static void
+dfuse_wb_expire(bool all)
+{
+	struct dfuse_wb_buf *dwb, *next;
+	struct timespec      now;
+
+	clock_gettime(CLOCK_MONOTONIC_COARSE, &now);
+
+	D_MUTEX_LOCK(&wb_lock);
+	d_list_for_each_entry_safe(dwb, next, &wb_list, dwb_list) {
+		if (!all &&
+		    now.tv_sec - dwb->dwb_time.tv_sec < dwb->dwb_ie->ie_dfs->dfc_wb_coalesce)
+			continue;
+
+		/* A write is adding to this buffer, it will be checked again on the next pass */
+		if (pthread_mutex_trylock(&dwb->dwb_lock) != 0)
+			continue;
+
+		d_list_del_init(&dwb->dwb_list);
+		dfuse_wb_issue(dwb);
+		D_MUTEX_UNLOCK(&dwb->dwb_lock);
+	}
+
+	/* On shutdown nothing may be left behind.  A buffer which could not be locked above is in
+	 * use by a write which may be waiting for wb_lock, so drop it and retry until the list is
+	 * empty.  The list is re-read each time as the buffer may have been flushed, and freed, by
+	 * then.
+	 */
+	while (all && !d_list_empty(&wb_list)) {
+		dwb = d_list_entry(wb_list.next, struct dfuse_wb_buf, dwb_list);
+		if (pthread_mutex_trylock(&dwb->dwb_lock) != 0) {
+			D_MUTEX_UNLOCK(&wb_lock);
+			sched_yield();
+			D_MUTEX_LOCK(&wb_lock);
+			continue;
+		}
+
+		d_list_del_init(&dwb->dwb_list);
+		dfuse_wb_issue(dwb);
+		D_MUTEX_UNLOCK(&dwb->dwb_lock);
+	}
+	D_MUTEX_UNLOCK(&wb_lock);
+}
+
+/* Main loop for the flush thread.  Sleeps until a buffer starts holding data then checks for
+ * expired buffers once a second until there are none left.
+ */
+static void *
+dfuse_wb_thread_fn(void *arg)
+{
+	while (1) {
+		struct timespec ts = {};
+		bool            idle;
+		int             rc;
+
+		D_MUTEX_LOCK(&wb_lock);
+		idle = d_list_empty(&wb_list);
+		D_MUTEX_UNLOCK(&wb_lock);
+
+		if (idle) {
+			rc = sem_wait(&wb_sem);
+		} else {
+			if (clock_gettime(CLOCK_REALTIME, &ts) == -1)
+				D_ERROR("Unable to set time");
+			ts.tv_sec += 1;
+
+			rc = sem_timedwait(&wb_sem, &ts);
+		}
+		if (rc != 0 && errno != ETIMEDOUT && errno != EINTR)
+			DS_ERROR(errno, "sem_wait");
+
+		if (wb_stop)
+			break;
+
+		dfuse_wb_expire(false);
+	}
+
+	dfuse_wb_expire(true);
+	return NULL;
+}
+
+int
+dfuse_wb_thread_start(struct dfuse_info *dfuse_info)
+{
+	int rc;
+
+	rc = sem_init(&wb_sem, 0, 0);
+	if (rc != 0)
+		return errno;
+
+	rc = pthread_create(&wb_thread, NULL, dfuse_wb_thread_fn, NULL);
+	if (rc != 0) {
+		sem_destroy(&wb_sem);
+		return rc;
+	}
+	pthread_setname_np(wb_thread, "dfuse wb");
+
+	return 0;
+}
+
+/* Stop the thread, flushing any buffered data.  May be called without thread_start() having been
+ * called.
+ */
+void
+dfuse_wb_thread_stop(void)
+{
+	if (!wb_thread)
+		return;
+
+	wb_stop = true;
+	sem_post(&wb_sem);
+
+	pthread_join(wb_thread, NULL);
+	wb_thread = 0;
+	sem_destroy(&wb_sem);
+}
+
+/* Update the inode for a write.  Check for potentially using readahead on this file, ie_truncated
+ * will only be set if caching is enabled so only check for the one flag rather than two here
+ */
+static void
+dfuse_write_update_ie(struct dfuse_inode_entry *ie, off_t position, size_t len)
+{
+	if (ie->ie_truncated) {
+		if (ie->ie_start_off == 0 && ie->ie_end_off == 0) {
+			ie->ie_start_off = position;
+			ie->ie_end_off   = position + len;
+		} else {
+			if (ie->ie_start_off > position)
+				ie->ie_start_off = position;
+			if (ie->ie_end_off < position + len)
+				ie->ie_end_off = position + len;
+		}
+	}
+
+	if (len + position > ie->ie_stat.st_size)
+		ie->ie_stat.st_size = len + position;
+}
+
 void
 dfuse_cb_write(fuse_req_t req, fuse_ino_t ino, struct fuse_bufvec *bufv, off_t position,
 	       struct fuse_file_info *fi)
@@ -32,7 +424,7 @@ dfuse_cb_write(fuse_req_t req, fuse_ino_t ino, struct fuse_bufvec *bufv, off_t p
 	struct fuse_bufvec    ibuf       = FUSE_BUFVEC_INIT(len);
 	struct dfuse_eq      *eqt;
 	int                   rc;
-	struct dfuse_event   *ev;
+	struct dfuse_event   *ev = NULL;
 	uint64_t              eqt_idx;
 	bool                  wb_cache = false;
 
@@ -59,6 +451,22 @@ dfuse_cb_write(fuse_req_t req, fuse_ino_t ino, struct fuse_bufvec *bufv, off_t p
 		}
 	}
 
+	if (wb_cache) {
+		if (oh->doh_ie->ie_dfs->dfc_wb_coalesce != 0 && len <= DFUSE_WB_COALESCE_MAX) {
+			rc = dfuse_wb_coalesce(dfuse_info, oh, bufv, position, len);
+			if (rc == 0) {
+				dfuse_write_update_ie(oh->doh_ie, position, len);
+				DFUSE_REPLY_WRITE(oh, req, len);
+				return;
+			}
+			if (rc != EAGAIN)
+				D_GOTO(err, rc);
+		}
+
+		/* Issue anything already buffered first so writes are sent in order */
+		dfuse_wb_flush(oh->doh_ie);
+	}
+
 	ev = d_slab_acquire(eqt->de_write_slab);
 	if (ev == NULL)
 		D_GOTO(err, rc = ENOMEM);
@@ -82,24 +490,7 @@ dfuse_cb_write(fuse_req_t req, fuse_ino_t ino, struct fuse_bufvec *bufv, off_t p
 	ev->de_len         = len;
 	ev->de_complete_cb = dfuse_cb_write_complete;
 
-	/* Check for potentially using readahead on this file, ie_truncated
-	 * will only be set if caching is enabled so only check for the one
-	 * flag rather than two here
-	 */
-	if (oh->doh_ie->ie_truncated) {
-		if (oh->doh_ie->ie_start_off == 0 && oh->doh_ie->ie_end_off == 0) {
-			oh->doh_ie->ie_start_off = position;
-			oh->doh_ie->ie_end_off   = position + len;
-		} else {
-			if (oh->doh_ie->ie_start_off > position)
-				oh->doh_ie->ie_start_off = position;
-			if (oh->doh_ie->ie_end_off < position + len)
-				oh->doh_ie->ie_end_off = position + len;
-		}
-	}
-
-	if (len + position > oh->doh_ie->ie_stat.st_size)
-		oh->doh_ie->ie_stat.st_size = len + position;
+	dfuse_write_update_ie(oh->doh_ie, position, len);
 
 	rc = dfs_write(oh->doh_dfs, oh->doh_obj, &ev->de_sgl, position, &ev->de_ev);
 	if (rc != 0)
@@ -15,6 +15,9 @@
 #include <daos_errno.h>
 #include <daos/btree.h>
 #include <daos/dtx.h>
+#if defined(__x86_64__)
+#include <immintrin.h>
+#endif
 
 #define BTR_EXT_FEAT_MASK (BTR_FEAT_MASK ^ BTR_FEAT_EMBEDDED)
 
@@ -1574,6 +1577,136 @@ btr_cmp(struct btr_context *tcx, umem_off_t nd_off,
 	return cmp;
 }
 
+/** record size of integer key tree, see btr_rec_size() */
+#define BTR_UINT_REC_SIZE	(sizeof(struct btr_record) + sizeof(uint64_t))
+D_CASSERT(BTR_UINT_REC_SIZE == 16);
+
+/** Scalar part of the search, starting from record \a i */
+static inline int
+btr_uint_count_lt_from(const char *buf, int i, int rec_nr, uint64_t key)
+{
+	const struct btr_record	*rec;
+
+	for (; i < rec_nr; i++) {
+		rec = (const struct btr_record *)(buf + i * BTR_UINT_REC_SIZE);
+		if (rec->rec_ukey[0] >= key)
+			break;
+	}
+	return i;
+}
+
+/*
+ * Each record is 16 bytes (offset + key), the vectorized versions compare
+ * the keys of several records at once and mask off the offset lanes. They
+ * are built for their instruction sets regardless of the compiler flags and
+ * picked at runtime by btr_uint_search_init().
+ */
+#if defined(__x86_64__)
+static __attribute__((target("avx512f"))) int
+btr_uint_count_lt_avx512(const char *buf, int rec_nr, uint64_t key)
+{
+	const __m512i	probe = _mm512_set1_epi64(key);
+	__mmask8	lt;
+	int		i;
+
+	for (i = 0; i + 4 <= rec_nr; i += 4) {
+		lt = _mm512_cmplt_epu64_mask(
+			_mm512_loadu_si512(buf + i * BTR_UINT_REC_SIZE), probe);
+		lt &= 0xaa; /* key lanes only */
+		if (lt != 0xaa)
+			return i + __builtin_popcount(lt);
+	}
+	return btr_uint_count_lt_from(buf, i, rec_nr, key);
+}
+
+static __attribute__((target("avx2"))) int
+btr_uint_count_lt_avx2(const char *buf, int rec_nr, uint64_t key)
+{
+	/* AVX2 has no unsigned 64-bit comparison, flip the sign bits */
+	const __m256i	bias  = _mm256_set1_epi64x(INT64_MIN);
+	const __m256i	probe = _mm256_xor_si256(_mm256_set1_epi64x(key), bias);
+	__m256i		recs;
+	int		lt;
+	int		i;
+
+	for (i = 0; i + 2 <= rec_nr; i += 2) {
+		recs = _mm256_loadu_si256((const __m256i *)(buf + i * BTR_UINT_REC_SIZE));
+		recs = _mm256_cmpgt_epi64(probe, _mm256_xor_si256(recs, bias));
+		lt   = _mm256_movemask_pd(_mm256_castsi256_pd(recs)) & 0xa;
+		if (lt != 0xa)
+			return i + __builtin_popcount(lt);
+	}
+	return btr_uint_count_lt_from(buf, i, rec_nr, key);
+}
+#endif
+
+/**
+ * Vectorized search supported by this CPU, NULL if there is none, in which
+ * case btr_probe() keeps the binary search, which beats a scalar linear scan.
+ */
+static int (*btr_uint_count_lt)(const char *buf, int rec_nr, uint64_t key);
+
+static __attribute__((constructor)) void
+btr_uint_search_init(void)
+{
+#if defined(__x86_64__)
+	__builtin_cpu_init();
+	if (__builtin_cpu_supports("avx512f"))
+		btr_uint_count_lt = btr_uint_count_lt_avx512;
+	else if (__builtin_cpu_supports("avx2"))
+		btr_uint_count_lt = btr_uint_count_lt_avx2;
+#endif
+}
+
+int
+dbtree_uint_count_lt(const void *recs, int rec_nr, uint64_t key)
+{
+	if (btr_uint_count_lt != NULL)
+		return btr_uint_count_lt(recs, rec_nr, key);
+	return btr_uint_count_lt_from(recs, 0, rec_nr, key);
+}
+
+/**
+ * Search a node of integer key tree for \a hkey, it compares the probed key
+ * with all keys of the node in one pass instead of binary search through
+ * btr_cmp(), which is faster for the short sorted arrays of tree nodes.
+ *
+ * The returned position and \a cmp_p match the final position and result
+ * of the binary search in btr_probe():
+ * - BTR_CMP_EQ if the key is found at the returned position.
+ * - BTR_CMP_GT if the record at the returned position is the first one
+ *   greater than the key.
+ * - BTR_CMP_LT if all records of the node are less than the key, the
+ *   returned position is the last record.
+ */
+static int
+btr_node_search_uint(struct btr_context *tcx, umem_off_t nd_off,
+		     char *hkey, int *cmp_p)
+{
+	struct btr_node		*nd = btr_off2ptr(tcx, nd_off);
+	struct btr_record	*rec;
+	uint64_t		 key = *(uint64_t *)hkey;
+	int			 at;
+
+	D_ASSERT(btr_rec_size(tcx) == BTR_UINT_REC_SIZE);
+	D_ASSERT(nd->tn_keyn > 0);
+
+	D_ASSERT(btr_uint_count_lt != NULL);
+
+	at = btr_uint_count_lt((char *)&nd[1], nd->tn_keyn, key);
+	if (at == nd->tn_keyn) {
+		*cmp_p = BTR_CMP_LT;
+		return at - 1;
+	}
+
+	rec = btr_node_rec_at(tcx, nd_off, at);
+	*cmp_p = rec->rec_ukey[0] == key ? BTR_CMP_EQ : BTR_CMP_GT;
+
+	D_DEBUG(DB_TRACE, "searched node "DF_X64", at %d, cmp %d\n", nd_off,
+		at, *cmp_p);
+	return at;
+}
+
 bool
 btr_probe_valid(dbtree_probe_opc_t opc)
 {
@@ -1731,6 +1864,12 @@ btr_probe(struct btr_context *tcx, dbtree_probe_opc_t probe_opc,
 		} else if (probe_opc == BTR_PROBE_LAST) {
 			at = start = end;
 			cmp = BTR_CMP_LT;
+
+		} else if (btr_is_int_key(tcx) && hkey != NULL && btr_uint_count_lt != NULL) {
+			D_ASSERT(probe_opc & BTR_PROBE_SPEC);
+			/* search the whole node in one pass */
+			at = btr_node_search_uint(tcx, nd_off, hkey, &cmp);
+			start = end = at;
 		} else {
 			D_ASSERT(probe_opc & BTR_PROBE_SPEC);
 			/* binary search */
@@ -459,6 +459,37 @@ done:
 	return rc;
 }
 
+/**
+ * Copy the checksum of the next \a bytes of the sgl into \a csum_buf if it was
+ * already calculated (see struct dcs_precalc). The bytes must be contiguous in
+ * one iov to be looked up. The sgl index is only moved on a hit.
+ */
+static bool
+csum_precalc_reuse(struct daos_csummer *obj, d_sg_list_t *sgl,
+		   struct daos_sgl_idx *idx, daos_size_t bytes,
+		   uint8_t *csum_buf)
+{
+	struct daos_sgl_idx	 peek = *idx;
+	uint8_t			*buf = NULL;
+	uint8_t			*csum;
+	size_t			 len = 0;
+
+	if (obj->dcs_precalc == NULL || obj->dcs_precalc->dp_nr == 0)
+		return false;
+
+	daos_sgl_get_bytes(sgl, false, &peek, bytes, &buf, &len);
+	if (buf == NULL || len != bytes)
+		return false;
+
+	csum = dcs_precalc_find(obj->dcs_precalc, buf, len);
+	if (csum == NULL)
+		return false;
+
+	memcpy(csum_buf, csum, obj->dcs_precalc->dp_csum_len);
+	*idx = peek;
+	return true;
+}
+
 static int
 calc_csum_recx_with_no_map(struct daos_csummer *obj, size_t csum_nr,
 			   daos_recx_t *recx,
@@ -475,13 +506,15 @@ calc_csum_recx_with_no_map(struct daos_csummer *obj, size_t csum_nr,
 
 	for (i = 0; i < csum_nr; i++) {
 		buf = ci_idx2csum(csum_info, i);
-		daos_csummer_set_buffer(obj, buf, csum_info->cs_len);
-		daos_csummer_reset(obj);
-
 		chunk = csum_recx_chunkidx2range(recx, rec_len,
 						 rec_chunksize, i);
 
 		bytes_for_csum = chunk.dcr_nr * rec_len;
+		if (csum_precalc_reuse(obj, sgl, idx, bytes_for_csum, buf))
+			continue;
+
+		daos_csummer_set_buffer(obj, buf, csum_info->cs_len);
+		daos_csummer_reset(obj);
 		rc = daos_sgl_processor(sgl, false, idx, bytes_for_csum,
 					checksum_sgl_cb, obj);
 		if (rc != 0) {
@@ -1345,6 +1378,102 @@ dcs_csum_info_save(struct dcs_ci_list *list, struct dcs_csum_info *info)
 	return 0;
 }
 
+int
+dcs_precalc_init(struct dcs_precalc *pc, struct daos_csummer *csummer, uint32_t nr)
+{
+	D_ASSERT(pc != NULL);
+
+	memset(pc, 0, sizeof(*pc));
+	if (nr == 0 || !daos_csummer_initialized(csummer))
+		return 0;
+
+	pc->dp_csummer = daos_csummer_copy(csummer);
+	if (pc->dp_csummer == NULL)
+		return -DER_NOMEM;
+
+	pc->dp_csum_len = daos_csummer_get_csum_len(csummer);
+	D_ALLOC_ARRAY(pc->dp_ents, nr);
+	D_ALLOC(pc->dp_csums, (daos_size_t)nr * pc->dp_csum_len);
+	if (pc->dp_ents == NULL || pc->dp_csums == NULL) {
+		dcs_precalc_fini(pc);
+		return -DER_NOMEM;
+	}
+	pc->dp_cap = nr;
+
+	return 0;
+}
+
+void
+dcs_precalc_fini(struct dcs_precalc *pc)
+{
+	daos_csummer_destroy(&pc->dp_csummer);
+	D_FREE(pc->dp_ents);
+	D_FREE(pc->dp_csums);
+	memset(pc, 0, sizeof(*pc));
+}
+
+int
+dcs_precalc_add(struct dcs_precalc *pc, uint8_t *buf, uint64_t len)
+{
+	struct daos_csummer	*csummer = pc->dp_csummer;
+	struct dcs_precalc_ent	*ent;
+	int			 rc;
+
+	if (pc->dp_nr >= pc->dp_cap)
+		return -DER_OVERFLOW;
+
+	ent = &pc->dp_ents[pc->dp_nr];
+	ent->pe_buf = buf;
+	ent->pe_len = len;
+	ent->pe_csum_off = pc->dp_nr * pc->dp_csum_len;
+
+	daos_csummer_set_buffer(csummer, pc->dp_csums + ent->pe_csum_off, pc->dp_csum_len);
+	daos_csummer_reset(csummer);
+	rc = daos_csummer_update(csummer, buf, len);
+	if (rc != 0)
+		return rc;
+	rc = daos_csummer_finish(csummer);
+	if (rc != 0)
+		return rc;
+
+	pc->dp_nr++;
+	pc->dp_sorted = false;
+	return 0;
+}
+
+static int
+precalc_ent_cmp(const void *a, const void *b)
+{
+	const struct dcs_precalc_ent *ea = a;
+	const struct dcs_precalc_ent *eb = b;
+
+	if (ea->pe_buf != eb->pe_buf)
+		return ea->pe_buf < eb->pe_buf ? -1 : 1;
+	if (ea->pe_len != eb->pe_len)
+		return ea->pe_len < eb->pe_len ? -1 : 1;
+	return 0;
+}
+
+uint8_t *
+dcs_precalc_find(struct dcs_precalc *pc, uint8_t *buf, uint64_t len)
+{
+	struct dcs_precalc_ent	 key = { .pe_buf = buf, .pe_len = len };
+	struct dcs_precalc_ent	*ent;
+
+	if (pc == NULL || pc->dp_nr == 0)
+		return NULL;
+
+	/** entries are added in stripe order, sort them once on first lookup */
+	if (!pc->dp_sorted) {
+		qsort(pc->dp_ents, pc->dp_nr, sizeof(*pc->dp_ents), precalc_ent_cmp);
+		pc->dp_sorted = true;
+	}
+
+	ent = bsearch(&key, pc->dp_ents, pc->dp_nr, sizeof(*pc->dp_ents), precalc_ent_cmp);
+
+	return ent == NULL ? NULL : pc->dp_csums + ent->pe_csum_off;
+}
+
 /** helper for printing csum as a 64bit value */
 uint64_t
 ci2csum(struct dcs_csum_info ci)
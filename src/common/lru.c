@@ -121,6 +121,87 @@ out:
 	return rc;
 }
 
+/* Remove item from front cache and put the refcount held by front cache */
+static inline void
+lru_front_remove(struct daos_lru_cache *lcache, struct daos_llink *llink)
+{
+	D_ASSERT(llink->ll_front);
+	D_ASSERT(llink->ll_ref > 1);
+	D_ASSERT(lcache->dlc_front[llink->ll_front_idx] == llink);
+
+	lcache->dlc_front[llink->ll_front_idx] = NULL;
+	llink->ll_front = 0;
+	llink->ll_ref--;
+}
+
+int
+daos_lru_front_create(struct daos_lru_cache *lcache, int bits)
+{
+	uint32_t	size;
+
+	D_ASSERT(lcache->dlc_front == NULL);
+	if (bits < 0 || bits > 16)
+		return -DER_INVAL;
+
+	size = 1U << bits;
+	D_ALLOC_ARRAY(lcache->dlc_front, size);
+	if (lcache->dlc_front == NULL)
+		return -DER_NOMEM;
+
+	lcache->dlc_front_mask = size - 1;
+	D_DEBUG(DB_TRACE, "Created LRU front cache of size %u\n", size);
+	return 0;
+}
+
+bool
+daos_lru_front_insert(struct daos_lru_cache *lcache, uint32_t hint,
+		      struct daos_llink *llink)
+{
+	struct daos_llink	*old;
+	uint32_t		 idx;
+
+	D_ASSERT(llink->ll_ref > 1 && !llink->ll_evicted);
+	/* LRU disabled, or the front cache not created */
+	if (lcache->dlc_front == NULL || lcache->dlc_csize == 0)
+		return false;
+
+	idx = hint & lcache->dlc_front_mask;
+	old = lcache->dlc_front[idx];
+	if (old == llink)
+		return false;
+
+	D_ASSERT(!llink->ll_front);
+	llink->ll_ref++;
+	llink->ll_front = 1;
+	llink->ll_front_idx = idx;
+	lcache->dlc_front[idx] = llink;
+
+	if (old == NULL)
+		return false;
+
+	/* Demote the replaced item, it's moved to LRU list if nobody is using it */
+	old->ll_front = 0;
+	daos_lru_ref_release(lcache, old);
+	return true;
+}
+
+static void
+lru_front_destroy(struct daos_lru_cache *lcache)
+{
+	struct daos_llink	*llink;
+	uint32_t		 i;
+
+	if (lcache->dlc_front == NULL)
+		return;
+
+	for (i = 0; i <= lcache->dlc_front_mask; i++) {
+		llink = lcache->dlc_front[i];
+		if (llink != NULL)
+			lru_front_remove(lcache, llink);
+	}
+	D_FREE(lcache->dlc_front);
+}
+
 void
 daos_lru_cache_destroy(struct daos_lru_cache *lcache)
 {
@@ -128,12 +209,14 @@ daos_lru_cache_destroy(struct daos_lru_cache *lcache)
 		return;
 
 	D_DEBUG(DB_TRACE, "Destroying LRU cache\n");
+	lru_front_destroy(lcache);
 	d_hash_table_debug(&lcache->dlc_htable);
 	d_hash_table_destroy_inplace(&lcache->dlc_htable, true);
 	D_FREE(lcache);
 }
 
 struct lru_evict_arg {
+	struct daos_lru_cache	*lcache;
 	daos_lru_cond_cb_t	 cb;
 	void			*arg;
 	d_list_t		 list;
@@ -147,6 +230,8 @@ lru_evict_cb(d_list_t *link, void *arg)
 
 	if (llink->ll_evicted || cb_arg->cb == NULL ||
 	    cb_arg->cb(llink, cb_arg->arg)) {
+		if (llink->ll_front)
+			lru_front_remove(cb_arg->lcache, llink);
 		llink->ll_evicted = 1;
 		if (llink->ll_ref == 1) /* the last refcount */
 			d_list_move(&llink->ll_qlink, &cb_arg->list);
@@ -170,7 +255,7 @@ void
 daos_lru_cache_evict(struct daos_lru_cache *lcache,
 		     daos_lru_cond_cb_t cond, void *arg)
 {
-	struct lru_evict_arg	 cb_arg = { .cb = cond, .arg = arg };
+	struct lru_evict_arg	 cb_arg = { .lcache = lcache, .cb = cond, .arg = arg };
 	struct daos_llink	*llink;
 	struct daos_llink	*tmp;
 	unsigned int		 count = 0;
@@ -222,9 +307,11 @@ daos_lru_ref_hold(struct daos_lru_cache *lcache, void *key,
 		D_GOTO(out, rc);
 
 	D_DEBUG(DB_TRACE, "Inserting %p item into LRU Hash table\n", llink);
-	llink->ll_evicted = 0;
-	llink->ll_ref	  = 1; /* 1 for caller */
-	llink->ll_ops	  = lcache->dlc_ops;
+	llink->ll_evicted   = 0;
+	llink->ll_front     = 0;
+	llink->ll_front_idx = 0;
+	llink->ll_ref	    = 1; /* 1 for caller */
+	llink->ll_ops	    = lcache->dlc_ops;
 	D_INIT_LIST_HEAD(&llink->ll_qlink);
 
 	rc = d_hash_rec_insert(&lcache->dlc_htable, key, key_size,
@@ -0,0 +1,160 @@
+/**
+ * (C) Copyright 2024 Intel Corporation.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause-Patent
+ */
+
+/**
+ * Unit tests for the node search of integer key trees, which compares the
+ * vectorized search picked for this CPU with a binary search.
+ */
+
+#include <stdarg.h>
+#include <stdlib.h>
+#include <setjmp.h>
+#include <cmocka.h>
+
+#include <daos/tests_lib.h>
+#include <daos/btree.h>
+
+/** Layout of a record of an integer key tree node */
+struct tst_uint_rec {
+	umem_off_t	tr_off;
+	uint64_t	tr_key;
+};
+
+#define TST_NODE_MAX	64
+#define TST_LOOPS	2000
+
+/** Same ordering as btr_hkey_cmp() of integer key trees */
+static int
+tst_rec_cmp(struct tst_uint_rec *rec, uint64_t key)
+{
+	if (rec->tr_key < key)
+		return BTR_CMP_LT;
+	if (rec->tr_key > key)
+		return BTR_CMP_GT;
+	return BTR_CMP_EQ;
+}
+
+/** Binary search for the first record not less than key */
+static int
+tst_bsearch(struct tst_uint_rec *recs, int rec_nr, uint64_t key)
+{
+	int	start = 0;
+	int	end = rec_nr;
+	int	at;
+
+	while (start < end) {
+		at = (start + end) / 2;
+		if (tst_rec_cmp(&recs[at], key) & BTR_CMP_LT)
+			start = at + 1;
+		else
+			end = at;
+	}
+	return start;
+}
+
+static uint64_t
+tst_rand64(void)
+{
+	return ((uint64_t)rand() << 33) ^ ((uint64_t)rand() << 11) ^ rand();
+}
+
+static int
+tst_key_cmp(const void *a, const void *b)
+{
+	uint64_t ka = ((const struct tst_uint_rec *)a)->tr_key;
+	uint64_t kb = ((const struct tst_uint_rec *)b)->tr_key;
+
+	return ka < kb ? -1 : ka > kb;
+}
+
+static void
+tst_check(struct tst_uint_rec *recs, int rec_nr, uint64_t key)
+{
+	int	exp = tst_bsearch(recs, rec_nr, key);
+	int	got = dbtree_uint_count_lt(recs, rec_nr, key);
+
+	if (got != exp)
+		print_message("rec_nr %d key "DF_X64": got %d, expected %d\n", rec_nr, key, got,
+			      exp);
+	assert_int_equal(got, exp);
+}
+
+/**
+ * Fill a node with sorted keys. The key range is narrowed every other time
+ * to get duplicate keys, keys with the sign bit set are always in.
+ */
+static void
+tst_fill(struct tst_uint_rec *recs, int rec_nr, bool dup)
+{
+	uint64_t	mask = dup ? 0x7 : UINT64_MAX;
+	int		i;
+
+	for (i = 0; i < rec_nr; i++) {
+		recs[i].tr_off = tst_rand64();
+		recs[i].tr_key = tst_rand64() & mask;
+		if (i % 3 == 0)
+			recs[i].tr_key |= 1ULL << 63;
+	}
+	qsort(recs, rec_nr, sizeof(*recs), tst_key_cmp);
+}
+
+static void
+test_uint_search_random(void **state)
+{
+	struct tst_uint_rec	recs[TST_NODE_MAX];
+	int			rec_nr;
+	int			loop;
+	int			i;
+
+	for (loop = 0; loop < TST_LOOPS; loop++) {
+		rec_nr = 1 + rand() % TST_NODE_MAX;
+		tst_fill(recs, rec_nr, loop % 2);
+
+		/* boundary keys */
+		tst_check(recs, rec_nr, 0);
+		tst_check(recs, rec_nr, UINT64_MAX);
+		tst_check(recs, rec_nr, 1ULL << 63);
+		tst_check(recs, rec_nr, (1ULL << 63) - 1);
+
+		for (i = 0; i < rec_nr; i++) {
+			tst_check(recs, rec_nr, recs[i].tr_key);
+			tst_check(recs, rec_nr, recs[i].tr_key - 1);
+			tst_check(recs, rec_nr, recs[i].tr_key + 1);
+		}
+		tst_check(recs, rec_nr, tst_rand64());
+	}
+}
+
+static void
+test_uint_search_equal(void **state)
+{
+	struct tst_uint_rec	recs[TST_NODE_MAX];
+	int			rec_nr;
+	int			i;
+
+	/* all keys equal, the offsets must not be taken as keys */
+	for (rec_nr = 1; rec_nr <= TST_NODE_MAX; rec_nr++) {
+		for (i = 0; i < rec_nr; i++) {
+			recs[i].tr_off = i % 2 ? 0 : UINT64_MAX;
+			recs[i].tr_key = 42;
+		}
+		tst_check(recs, rec_nr, 41);
+		tst_check(recs, rec_nr, 42);
+		tst_check(recs, rec_nr, 43);
+	}
+}
+
+int
+main(void)
+{
+	const struct CMUnitTest tests[] = {
+		cmocka_unit_test(test_uint_search_random),
+		cmocka_unit_test(test_uint_search_equal),
+	};
+
+	srand(time(NULL));
+	return cmocka_run_group_tests_name("common_btree_uint", tests, NULL, NULL);
+}
@@ -691,6 +691,74 @@ test_csum_info_list_handle_many(void **state)
 		D_FREE(info[i].cs_csum);
 }
 
+static void
+test_csum_precalc(void **state)
+{
+	struct daos_csummer	*csummer;
+	struct dcs_precalc	 pc = {0};
+	struct dcs_iod_csums	*expected;
+	struct dcs_iod_csums	*actual;
+	d_sg_list_t		 sgl;
+	daos_recx_t		 recx;
+	daos_iod_t		 iod = {0};
+	uint8_t			*buf;
+	uint8_t			*csum;
+	uint32_t		 csum_len;
+
+	assert_success(daos_csummer_init_with_type(&csummer, HASH_TYPE_CRC32, 4, 0));
+	csum_len = daos_csummer_get_csum_len(csummer);
+	dts_sgl_init_with_strings(&sgl, 1, "0123456789abcdef");
+	buf = sgl.sg_iovs[0].iov_buf;
+
+	recx.rx_idx = 0;
+	recx.rx_nr = 16;
+	iod.iod_nr = 1;
+	iod.iod_recxs = &recx;
+	iod.iod_size = 1;
+	iod.iod_type = DAOS_IOD_ARRAY;
+
+	assert_success(daos_csummer_calc_iods(csummer, &sgl, &iod, NULL, 1, 0, NULL, 0,
+					      &expected));
+
+	/* precalculate all chunks but the third one, added out of order */
+	assert_success(dcs_precalc_init(&pc, csummer, 3));
+	assert_success(dcs_precalc_add(&pc, buf + 12, 4));
+	assert_success(dcs_precalc_add(&pc, buf, 4));
+	assert_success(dcs_precalc_add(&pc, buf + 4, 4));
+	assert_rc_equal(-DER_OVERFLOW, dcs_precalc_add(&pc, buf + 8, 4));
+
+	assert_null(dcs_precalc_find(&pc, buf + 8, 4));
+	assert_null(dcs_precalc_find(&pc, buf, 8));
+	csum = dcs_precalc_find(&pc, buf + 4, 4);
+	assert_non_null(csum);
+	assert_memory_equal(ci_idx2csum(expected->ic_data, 1), csum, csum_len);
+
+	/* precalculated checksums are reused, others are calculated */
+	csummer->dcs_precalc = &pc;
+	assert_success(daos_csummer_calc_iods(csummer, &sgl, &iod, NULL, 1, 0, NULL, 0,
+					      &actual));
+	assert_true(daos_csummer_compare_csum_info(csummer, expected->ic_data,
+						   actual->ic_data));
+	daos_csummer_free_ic(csummer, &actual);
+
+	/* prove the recorded checksum is what's used */
+	csum[0]++;
+	assert_success(daos_csummer_calc_iods(csummer, &sgl, &iod, NULL, 1, 0, NULL, 0,
+					      &actual));
+	assert_memory_not_equal(ci_idx2csum(expected->ic_data, 1),
+				ci_idx2csum(actual->ic_data, 1), csum_len);
+	assert_memory_equal(ci_idx2csum(expected->ic_data, 2),
+			    ci_idx2csum(actual->ic_data, 2), csum_len);
+	daos_csummer_free_ic(csummer, &actual);
+
+	csummer->dcs_precalc = NULL;
+	dcs_precalc_fini(&pc);
+	assert_null(pc.dp_ents);
+	d_sgl_fini(&sgl, true);
+	daos_csummer_free_ic(csummer, &expected);
+	daos_csummer_destroy(&csummer);
+}
+
 #define MAP_MAX 10
 #define	HOLES_TESTCASE(...) \
 	holes_test_case(&(struct holes_test_args)__VA_ARGS__)
@@ -2046,6 +2114,7 @@ static const struct CMUnitTest tests[] = {
 	     test_skip_csum_calculations_when_skip_set),
 	TEST("CSUM30: csum_info list basic handling", test_csum_info_list_handling),
 	TEST("CSUM30.1: csum_info list handle many", test_csum_info_list_handle_many),
+	TEST("CSUM31: Reuse precalculated chunk checksums", test_csum_precalc),
 	TEST("CSUM_HOLES01: With 2 mapped extents that leave a hole "
 	     "at the beginning, in between and "
 	     "at the end, all within a single chunk.", holes_1),
@@ -175,6 +175,27 @@ main(int argc, char **argv)
 		D_PRINT("Completed ref release for key: %d\n", j);
 	}
 
+	/** Front cache: held items are found by slot hint */
+	rc = daos_lru_front_create(tcache, 2);
+	if (rc)
+		D_GOTO(exit, rc);
+
+	D_ASSERT(!daos_lru_front_insert(tcache, 0, link_ret[0]));
+	link_ret[2] = daos_lru_front_hold(tcache, 0, &keys[0], sizeof(uint64_t));
+	D_ASSERT(link_ret[2] == link_ret[0]);
+	daos_lru_ref_release(tcache, link_ret[2]);
+	D_ASSERT(daos_lru_front_hold(tcache, 1, &keys[0], sizeof(uint64_t)) == NULL);
+
+	/** Same slot, the previous item is replaced */
+	D_ASSERT(daos_lru_front_insert(tcache, 4, link_ret[1]));
+	D_ASSERT(daos_lru_front_hold(tcache, 0, &keys[0], sizeof(uint64_t)) == NULL);
+	D_ASSERT(daos_lru_is_last_user(link_ret[1]));
+
+	/** Evicted item is dropped from front cache */
+	daos_lru_ref_evict(tcache, link_ret[1]);
+	D_ASSERT(daos_lru_front_hold(tcache, 0, &keys[1], sizeof(uint64_t)) == NULL);
+	D_PRINT("Completed front cache test\n");
+
 	daos_lru_ref_release(tcache, link_ret[0]);
 	D_PRINT("Completed ref release for key: %"PRIu64"\n",
 		keys[0]);
@@ -23,6 +23,7 @@ uint32_t dtx_agg_thd_cnt_lo;
 uint32_t dtx_agg_thd_age_up;
 uint32_t dtx_agg_thd_age_lo;
 uint32_t dtx_batched_ult_max;
+uint32_t dtx_batch_cont_max;
 
 struct dtx_batched_pool_args {
 	/* Link to dss_module_info::dmi_dtx_batched_pool_list. */
@@ -41,6 +42,8 @@ struct dtx_batched_cont_args {
 	d_list_t			 dbca_sys_link;
 	/* Link to dtx_batched_pool_args::dbpa_cont_list. */
 	d_list_t			 dbca_pool_link;
+	/* Link to the list of the containers queued for batched commit across containers. */
+	d_list_t			 dbca_batch_link;
 	uint64_t			 dbca_agg_gen;
 	struct sched_request		*dbca_cleanup_req;
 	struct sched_request		*dbca_commit_req;
@@ -52,7 +55,14 @@ struct dtx_batched_cont_args {
 	uint32_t			 dbca_deregister:1,
 					 dbca_cleanup_done:1,
 					 dbca_commit_done:1,
-					 dbca_agg_done:1;
+					 dbca_agg_done:1,
+					 dbca_batched:1;
+};
+
+/* The containers to be committed together via dtx_batched_commit_multi(). */
+struct dtx_batched_multi_args {
+	d_list_t			 dbma_cont_list;
+	int				 dbma_cont_cnt;
 };
 
 struct dtx_partial_cmt_item {
@@ -602,6 +612,34 @@ dtx_aggregation_main(void *arg)
 	dmi->dmi_dtx_agg_req = NULL;
 }
 
+/* Whether the container has enough committable DTX entries to commit them now. */
+static inline bool
+dtx_cont_need_commit(struct dtx_stat *stat)
+{
+	return stat->dtx_committable_count > DTX_THRESHOLD_COUNT ||
+	       stat->dtx_committable_coll_count > 0 ||
+	       (stat->dtx_oldest_committable_time != 0 &&
+		d_hlc_age2sec(stat->dtx_oldest_committable_time) >= DTX_COMMIT_THRESHOLD_AGE);
+}
+
+/*
+ * Wake up DTX aggregation if the pool has too many committed DTX entries after a batched commit,
+ * and return whether the container still has enough committable DTX entries to go on with.
+ */
+static bool
+dtx_batched_commit_check(struct dss_module_info *dmi, struct dtx_batched_cont_args *dbca)
+{
+	struct dtx_stat	stat = { 0 };
+
+	dtx_stat(dbca->dbca_cont, &stat);
+
+	if (stat.dtx_pool_cmt_count >= dtx_agg_thd_cnt_up &&
+	    dbca->dbca_pool->dbpa_aggregating == 0)
+		sched_req_wakeup(dmi->dmi_dtx_agg_req);
+
+	return dtx_cont_need_commit(&stat);
+}
+
 static void
 dtx_batched_commit_one(void *arg)
 {
@@ -621,7 +659,6 @@ dtx_batched_commit_one(void *arg)
 		struct dtx_entry	**dtes = NULL;
 		struct dtx_cos_key	 *dcks = NULL;
 		struct dtx_coll_entry	 *dce = NULL;
-		struct dtx_stat		  stat = { 0 };
 		int			  cnt;
 		int			  rc;
 
@@ -651,17 +688,7 @@ dtx_batched_commit_one(void *arg)
 			break;
 		}
 
-		dtx_stat(cont, &stat);
-
-		if (stat.dtx_pool_cmt_count >= dtx_agg_thd_cnt_up &&
-		    dbca->dbca_pool->dbpa_aggregating == 0)
-			sched_req_wakeup(dmi->dmi_dtx_agg_req);
-
-		if ((stat.dtx_committable_count <= DTX_THRESHOLD_COUNT) &&
-		    (stat.dtx_committable_coll_count == 0) &&
-		    (stat.dtx_oldest_committable_time == 0 ||
-		     d_hlc_age2sec(stat.dtx_oldest_committable_time) <
-		     DTX_COMMIT_THRESHOLD_AGE))
+		if (!dtx_batched_commit_check(dmi, dbca))
 			break;
 	}
 
@@ -672,6 +699,204 @@ out:
 	dtx_put_dbca(dbca);
 }
 
+static void
+dtx_batched_commit_multi(void *arg)
+{
+	struct dss_module_info		 *dmi = dss_get_module_info();
+	struct dtx_tls			 *tls = dtx_tls_get();
+	struct dtx_batched_multi_args	 *dbma = arg;
+	struct dtx_batched_cont_args	 *dbca;
+	struct dtx_batched_cont_args	**pending = NULL;
+	struct dtx_batched_cont_args	**dbcas = NULL;
+	struct dtx_batch_cont		 *dbcs = NULL;
+	struct ds_cont_child		 *cont;
+	int				  pending_cnt = 0;
+	int				  round = 0;
+	int				  rpc_cnt;
+	int				  pair_cnt;
+	int				  cnt;
+	int				  rc;
+	int				  i;
+	int				  j;
+
+	tls->dt_batched_ult_cnt++;
+
+	D_ALLOC_ARRAY(pending, dbma->dbma_cont_cnt);
+	D_ALLOC_ARRAY(dbcas, dbma->dbma_cont_cnt);
+	D_ALLOC_ARRAY(dbcs, dbma->dbma_cont_cnt);
+	if (pending == NULL || dbcas == NULL || dbcs == NULL)
+		goto out;
+
+	d_list_for_each_entry(dbca, &dbma->dbma_cont_list, dbca_batch_link)
+		pending[pending_cnt++] = dbca;
+
+	/*
+	 * Similar as dtx_batched_commit_one(), keep committing until none of the containers has
+	 * enough committable DTX entries left. Otherwise, a container with backlog would have to
+	 * wait to be queued again for each DTX_THRESHOLD_COUNT entries.
+	 */
+	while (pending_cnt > 0 && !dss_xstream_exiting(dmi->dmi_xstream)) {
+		rpc_cnt = 0;
+		pair_cnt = 0;
+		cnt = 0;
+		round++;
+
+		for (i = 0, j = 0; i < pending_cnt; i++) {
+			struct dtx_entry	**dtes = NULL;
+			struct dtx_cos_key	 *dcks = NULL;
+			struct dtx_coll_entry	 *dce = NULL;
+			int			  n;
+
+			dbca = pending[i];
+			cont = dbca->dbca_cont;
+			/* dbca_reg_gen != sc_dtx_batched_gen means someone reopen the container. */
+			if (dbca->dbca_reg_gen != cont->sc_dtx_batched_gen || !dtx_cont_opened(cont))
+				continue;
+
+			n = dtx_fetch_committable(cont, DTX_THRESHOLD_COUNT, NULL, DAOS_EPOCH_MAX,
+						  &dtes, &dcks, &dce);
+			if (n == 0)
+				continue;
+
+			if (n < 0) {
+				D_WARN("Fail to fetch committable for "DF_UUID": "DF_RC"\n",
+				       DP_UUID(cont->sc_uuid), DP_RC(n));
+				continue;
+			}
+
+			if (dce != NULL) {
+				/* Currently, commit collective DTX one by one. */
+				D_ASSERT(n == 1);
+
+				rc = dtx_coll_commit(cont, dce, dcks);
+				dtx_free_committable(dtes, dcks, dce, n);
+				if (rc != 0)
+					D_WARN("Fail to commit collective DTX for "DF_UUID": "DF_RC
+					       "\n", DP_UUID(cont->sc_uuid), DP_RC(rc));
+				else if (dtx_batched_commit_check(dmi, dbca))
+					pending[j++] = dbca;
+				continue;
+			}
+
+			dbcs[cnt].dbc_cont = cont;
+			dbcs[cnt].dbc_dtes = dtes;
+			dbcs[cnt].dbc_dcks = dcks;
+			dbcs[cnt].dbc_count = n;
+			dbcas[cnt++] = dbca;
+		}
+
+		if (cnt > 1) {
+			dtx_commit_batch(dbcs, cnt, &rpc_cnt, &pair_cnt);
+
+			/*
+			 * If the containers share the RPCs well, then hold the queued containers
+			 * for longer time to pack more; otherwise, shorten the interval to reduce
+			 * latency.
+			 */
+			if (rpc_cnt > 0) {
+				if (pair_cnt >= rpc_cnt * 2)
+					tls->dt_batch_interval = min(tls->dt_batch_interval * 2,
+								     DTX_BATCH_FLUSH_MAX);
+				else
+					tls->dt_batch_interval = max(tls->dt_batch_interval / 2,
+								     DTX_BATCH_FLUSH_MIN);
+			}
+		} else if (cnt == 1) {
+			dbcs[0].dbc_result = dtx_commit(dbcs[0].dbc_cont, dbcs[0].dbc_dtes,
+							dbcs[0].dbc_dcks, dbcs[0].dbc_count);
+		}
+
+		for (i = 0; i < cnt; i++) {
+			cont = dbcs[i].dbc_cont;
+			dtx_free_committable(dbcs[i].dbc_dtes, dbcs[i].dbc_dcks, NULL,
+					     dbcs[i].dbc_count);
+
+			/* The failed container will be committed when it is queued next time. */
+			if (dbcs[i].dbc_result != 0)
+				D_WARN("Fail to batched commit %d entries for "DF_UUID": "DF_RC"\n",
+				       dbcs[i].dbc_count, DP_UUID(cont->sc_uuid),
+				       DP_RC(dbcs[i].dbc_result));
+			else if (dtx_batched_commit_check(dmi, dbcas[i]))
+				pending[j++] = dbcas[i];
+		}
+
+		D_DEBUG(DB_TRACE, "DTX batched commit round %d for %d/%d containers via %d RPCs "
+			"(%d pairs), %d containers left, next interval %u ms\n", round, cnt,
+			dbma->dbma_cont_cnt, rpc_cnt, pair_cnt, j, tls->dt_batch_interval);
+
+		pending_cnt = j;
+	}
+
+out:
+	tls->dt_batched_ult_cnt--;
+
+	while ((dbca = d_list_pop_entry(&dbma->dbma_cont_list, struct dtx_batched_cont_args,
+					dbca_batch_link)) != NULL) {
+		dbca->dbca_batched = 0;
+		dtx_put_dbca(dbca);
+	}
+
+	D_FREE(dbcs);
+	D_FREE(dbcas);
+	D_FREE(pending);
+	D_FREE(dbma);
+}
+
+static void
+dtx_batched_commit_flush(d_list_t *list, int cnt)
+{
+	struct dtx_tls			*tls = dtx_tls_get();
+	struct dtx_batched_multi_args	*dbma = NULL;
+	struct dtx_batched_cont_args	*dbca;
+	struct ds_cont_child		*cont;
+	struct sched_req_attr		 attr;
+	int				 rc;
+
+	if (cnt > 1) {
+		D_ALLOC_PTR(dbma);
+		if (dbma != NULL) {
+			D_INIT_LIST_HEAD(&dbma->dbma_cont_list);
+			d_list_splice_init(list, &dbma->dbma_cont_list);
+			dbma->dbma_cont_cnt = cnt;
+
+			rc = dss_ult_create(dtx_batched_commit_multi, dbma, DSS_XS_SELF, 0, 0, NULL);
+			if (rc == 0)
+				return;
+
+			D_WARN("Fail to start DTX ULT for %d containers: "DF_RC"\n",
+			       cnt, DP_RC(rc));
+			d_list_splice_init(&dbma->dbma_cont_list, list);
+			D_FREE(dbma);
+		}
+	} else {
+		/* Nothing to be packed with, shorten the interval to reduce latency. */
+		tls->dt_batch_interval = max(tls->dt_batch_interval / 2, DTX_BATCH_FLUSH_MIN);
+	}
+
+	/*
+	 * Commit the container via dedicated ULT as before. The reference held by the queue
+	 * is transferred to the dtx_batched_commit_one ULT.
+	 */
+	while ((dbca = d_list_pop_entry(list, struct dtx_batched_cont_args,
+					dbca_batch_link)) != NULL) {
+		dbca->dbca_batched = 0;
+		cont = dbca->dbca_cont;
+
+		if (!dtx_cont_opened(cont) || dbca->dbca_deregister ||
+		    dbca->dbca_commit_req != NULL) {
+			dtx_put_dbca(dbca);
+			continue;
+		}
+
+		sched_req_attr_init(&attr, SCHED_REQ_GC, &cont->sc_pool_uuid);
+		dbca->dbca_commit_req = sched_create_ult(&attr, dtx_batched_commit_one, dbca, 0);
+		if (dbca->dbca_commit_req == NULL) {
+			D_WARN("Fail to start DTX ULT (1) for "DF_UUID"\n", DP_UUID(cont->sc_uuid));
+			dtx_put_dbca(dbca);
+		}
+	}
+}
+
 void
 dtx_batched_commit(void *arg)
 {
@@ -679,8 +904,13 @@ dtx_batched_commit(void *arg)
 	struct dtx_tls			*tls = dtx_tls_get();
 	struct dtx_batched_cont_args	*dbca;
 	struct sched_req_attr		 attr;
+	d_list_t			 batch_list;
+	uint64_t			 batch_start = 0;
+	int				 batch_cnt = 0;
 	uuid_t				 anonym_uuid;
 
+	D_INIT_LIST_HEAD(&batch_list);
+	tls->dt_batch_interval = DTX_BATCH_FLUSH_MIN;
 	uuid_clear(anonym_uuid);
 	sched_req_attr_init(&attr, SCHED_REQ_ANONYM, &anonym_uuid);
 
@@ -723,17 +953,26 @@ dtx_batched_commit(void *arg)
 			dbca->dbca_commit_done = 0;
 		}
 
-		if (dtx_cont_opened(cont) && dbca->dbca_commit_req == NULL &&
+		if (dtx_cont_opened(cont) && dbca->dbca_commit_req == NULL && !dbca->dbca_batched &&
 		    (dtx_batched_ult_max != 0 && tls->dt_batched_ult_cnt < dtx_batched_ult_max) &&
-		    ((stat.dtx_committable_count > DTX_THRESHOLD_COUNT) ||
-		     (stat.dtx_committable_coll_count > 0) ||
-		     (stat.dtx_oldest_committable_time != 0 &&
-		      d_hlc_age2sec(stat.dtx_oldest_committable_time) >=
-		      DTX_COMMIT_THRESHOLD_AGE))) {
+		    dtx_cont_need_commit(&stat)) {
 			D_ASSERT(!dbca->dbca_commit_done);
 			sleep_time = 0;
 			dtx_get_dbca(dbca);
 
+			/*
+			 * Queue the container for a while, then its committable DTX entries can
+			 * be packed with the ones from other containers for the same targets.
+			 */
+			if (dtx_batch_cont_max > 1 && batch_cnt < dtx_batch_cont_max &&
+			    stat.dtx_committable_coll_count == 0) {
+				if (batch_cnt++ == 0)
+					batch_start = daos_getmtime_coarse();
+				dbca->dbca_batched = 1;
+				d_list_add_tail(&dbca->dbca_batch_link, &batch_list);
+				goto cleanup;
+			}
+
 			D_ASSERT(dbca->dbca_cont);
 			sched_req_attr_init(&attr, SCHED_REQ_GC, &dbca->dbca_cont->sc_pool_uuid);
 			dbca->dbca_commit_req = sched_create_ult(&attr, dtx_batched_commit_one,
@@ -745,6 +984,7 @@ dtx_batched_commit(void *arg)
 			}
 		}
 
+cleanup:
 		if (dbca->dbca_cleanup_req != NULL && dbca->dbca_cleanup_done) {
 			sched_req_put(dbca->dbca_cleanup_req);
 			dbca->dbca_cleanup_req = NULL;
@@ -771,6 +1011,18 @@ dtx_batched_commit(void *arg)
 		dtx_put_dbca(dbca);
 
 check:
+		if (batch_cnt > 0) {
+			uint64_t	age = daos_getmtime_coarse() - batch_start;
+
+			if (batch_cnt >= dtx_batch_cont_max || age >= tls->dt_batch_interval ||
+			    dss_xstream_exiting(dmi->dmi_xstream)) {
+				dtx_batched_commit_flush(&batch_list, batch_cnt);
+				batch_cnt = 0;
+			} else if (sleep_time > tls->dt_batch_interval - age) {
+				sleep_time = tls->dt_batch_interval - age;
+			}
+		}
+
 		if (dss_xstream_exiting(dmi->dmi_xstream))
 			break;
 
@@ -22,7 +22,7 @@
  * These are for daos_rpc::dr_opc and DAOS_RPC_OPCODE(opc, ...) rather than
  * crt_req_create(..., opc, ...). See src/include/daos/rpc.h.
  */
-#define DAOS_DTX_VERSION	4
+#define DAOS_DTX_VERSION	5
 
 /** VOS reserves highest two minor epoch values for internal use so we must
  *  limit the number of dtx sub modifications to avoid conflict.
@@ -46,7 +46,9 @@
 	X(DTX_COLL_ABORT,	0,	&CQF_dtx_coll,	dtx_coll_handler,	\
 	  &dtx_coll_abort_co_ops, "dtx_coll_abort")				\
 	X(DTX_COLL_CHECK,	0,	&CQF_dtx_coll,	dtx_coll_handler,	\
-	  &dtx_coll_check_co_ops, "dtx_coll_check")
+	  &dtx_coll_check_co_ops, "dtx_coll_check")				\
+	X(DTX_BATCH_COMMIT,	0,	&CQF_dtx_batch,	dtx_batch_handler,	\
+	  NULL,			"dtx_batch_commit")
 
 #define X(a, b, c, d, e, f) a,
 enum dtx_operation {
@@ -92,6 +94,27 @@ CRT_RPC_DECLARE(dtx, DAOS_ISEQ_DTX, DAOS_OSEQ_DTX);
 
 CRT_RPC_DECLARE(dtx_coll, DAOS_ISEQ_COLL_DTX, DAOS_OSEQ_COLL_DTX);
 
+/*
+ * DTX batched commit RPC input fields
+ * Commit DTX entries that belong to several containers (maybe in different pools) on the same
+ * target via single RPC. dbi_dtx_cnts[i] is the count of the DTX entries in dbi_dtx_array for
+ * the container dbi_co_uuids[i] of the pool dbi_po_uuids[i]. The DTX entries for the same
+ * container are contiguous in dbi_dtx_array and follow the containers order.
+ */
+#define DAOS_ISEQ_BATCH_DTX						\
+	((uuid_t)		(dbi_po_uuids)		CRT_ARRAY)	\
+	((uuid_t)		(dbi_co_uuids)		CRT_ARRAY)	\
+	((uint32_t)		(dbi_dtx_cnts)		CRT_ARRAY)	\
+	((struct dtx_id)	(dbi_dtx_array)		CRT_ARRAY)
+
+/* DTX batched commit RPC output fields, dbo_sub_rets is the commit result per container. */
+#define DAOS_OSEQ_BATCH_DTX						\
+	((int32_t)		(dbo_status)		CRT_VAR)	\
+	((int32_t)		(dbo_misc)		CRT_VAR)	\
+	((int32_t)		(dbo_sub_rets)		CRT_ARRAY)
+
+CRT_RPC_DECLARE(dtx_batch, DAOS_ISEQ_BATCH_DTX, DAOS_OSEQ_BATCH_DTX);
+
 #define DTX_YIELD_CYCLE		(DTX_THRESHOLD_COUNT >> 3)
 
 /* The time threshold for triggering DTX cleanup of stale entries.
@@ -178,6 +201,28 @@ extern uint32_t dtx_agg_thd_age_lo;
  */
 extern uint32_t dtx_batched_ult_max;
 
+/* The default max count of containers whose DTX entries can be packed into the same RPC. */
+#define DTX_BATCH_CONT_DEF	16
+
+/*
+ * The containers on the same target that become committable around the same time are queued,
+ * and then the committable DTX entries from all of them that are destined for the same remote
+ * target are sent via single DTX_BATCH_COMMIT RPC. It is the max count of the queued containers
+ * before flushing them, can be adjusted via the environment "DAOS_DTX_BATCH_CONT_MAX".
+ *
+ * Zero or one:		disable DTX batched commit across containers.
+ */
+extern uint32_t dtx_batch_cont_max;
+
+/*
+ * The interval (in ms) for holding the queued containers before flushing them. It is adjusted
+ * between the min and max values according to how many containers share the same RPC, so the
+ * packing is attempted harder if the workload benefits from it; otherwise the commit latency
+ * is reduced.
+ */
+#define DTX_BATCH_FLUSH_MIN	10
+#define DTX_BATCH_FLUSH_MAX	200
+
 /*
  * If the size of dtx_memberships exceeds DTX_INLINE_MBS_SIZE, then load it (DTX mbs)
  * dynamically when use it to avoid holding a lot of DRAM resource for long time that
@@ -218,6 +263,8 @@ struct dtx_tls {
 	struct d_tm_node_t	*dt_dtx_leader_total;
 	uint64_t		 dt_agg_gen;
 	uint32_t		 dt_batched_ult_cnt;
+	/* The interval (in ms) for flushing the queued containers for batched commit. */
+	uint32_t		 dt_batch_interval;
 };
 
 extern struct dss_module_key dtx_module_key;
@@ -253,6 +300,10 @@ void dtx_merge_check_result(int *tgt, int src);
 int dtx_leader_get(struct ds_pool *pool, struct dtx_memberships *mbs,
 		   daos_unit_oid_t *oid, uint32_t version, struct pool_target **p_tgt);
 
+/* dtx_srv.c */
+int dtx_batch_in_check(struct dtx_batch_in *dbi);
+int dtx_batch_commit_conts(struct dtx_batch_in *dbi, int32_t *sub_rets);
+
 /* dtx_cos.c */
 int dtx_fetch_committable(struct ds_cont_child *cont, uint32_t max_cnt,
 			  daos_unit_oid_t *oid, daos_epoch_t epoch,
@@ -264,7 +315,64 @@ int dtx_del_cos(struct ds_cont_child *cont, struct dtx_id *xid,
 		daos_unit_oid_t *oid, uint64_t dkey_hash);
 uint64_t dtx_cos_oldest(struct ds_cont_child *cont);
 
+/* The committable DTX entries of one container for batched commit across containers. */
+struct dtx_batch_cont {
+	struct ds_cont_child	 *dbc_cont;
+	struct dtx_entry	**dbc_dtes;
+	struct dtx_cos_key	 *dbc_dcks;
+	int			  dbc_count;
+	/* The count of DTX entries that have been committed on remote targets. */
+	int			  dbc_committed;
+	/* The commit result for the container. */
+	int			  dbc_result;
+};
+
+/* The shard of some DTX on some remote target for committing DTX across containers. */
+struct dtx_batch_shard {
+	/* The remote target, rank + tag. */
+	uint64_t		 dbs_key;
+	/* The index of the container in the dtx_batch_cont array. */
+	uint32_t		 dbs_cont;
+	/* The index of the DTX in dtx_batch_cont::dbc_dtes. */
+	uint32_t		 dbs_dte;
+};
+
+/* The DTX_BATCH_COMMIT RPC args for one remote target. */
+struct dtx_batch_req {
+	ABT_future		 dbr_future;
+	struct dtx_batch_cont	*dbr_conts;
+	d_rank_t		 dbr_rank;
+	uint32_t		 dbr_tag;
+	int			 dbr_cont_cnt;
+	int			 dbr_dti_cnt;
+	uint32_t		 dbr_comp:1;
+	/* The indexes of related containers in the dbr_conts array. */
+	uint32_t		*dbr_cont_idx;
+	uuid_t			*dbr_po_uuids;
+	uuid_t			*dbr_co_uuids;
+	uint32_t		*dbr_dtx_cnts;
+	struct dtx_id		*dbr_dtis;
+};
+
+/* The DTX_BATCH_COMMIT requests packed from the shards of DTX entries across containers. */
+struct dtx_batch_pack {
+	struct dtx_batch_req	*dbp_reqs;
+	int			 dbp_req_cnt;
+	/* The count of the (container, target) pairs in all the requests. */
+	int			 dbp_pair_cnt;
+	/* The buffers shared by all the requests. */
+	struct dtx_id		*dbp_dtis;
+	uint32_t		*dbp_cont_idx;
+	uint32_t		*dbp_dtx_cnts;
+	uuid_t			*dbp_po_uuids;
+	uuid_t			*dbp_co_uuids;
+};
+
 /* dtx_rpc.c */
+int dtx_commit_batch(struct dtx_batch_cont *dbcs, int cont_cnt, int *rpc_cnt, int *pair_cnt);
+int dtx_batch_pack_build(struct dtx_batch_cont *dbcs, struct dtx_id **dtis,
+			 struct dtx_batch_shard *shards, int shard_cnt, struct dtx_batch_pack *dbp);
+void dtx_batch_pack_free(struct dtx_batch_pack *dbp);
 int dtx_check(struct ds_cont_child *cont, struct dtx_entry *dte,
 	      daos_epoch_t epoch);
 int dtx_coll_check(struct ds_cont_child *cont, struct dtx_coll_entry *dce, daos_epoch_t epoch);
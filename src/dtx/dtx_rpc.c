@@ -21,6 +21,7 @@
 
 CRT_RPC_DEFINE(dtx, DAOS_ISEQ_DTX, DAOS_OSEQ_DTX);
 CRT_RPC_DEFINE(dtx_coll, DAOS_ISEQ_COLL_DTX, DAOS_OSEQ_COLL_DTX);
+CRT_RPC_DEFINE(dtx_batch, DAOS_ISEQ_BATCH_DTX, DAOS_OSEQ_BATCH_DTX);
 
 #define X(a, b, c, d, e, f)	\
 {				\
@@ -514,6 +515,27 @@ btr_ops_t dbtree_dtx_cf_ops = {
 
 #define DTX_CF_BTREE_ORDER	20
 
+static inline bool
+dtx_classify_skip(struct pool_target *target, struct dtx_entry *dte, d_rank_t my_rank,
+		  uint32_t my_tgtid)
+{
+	/* Skip the target that (re-)joined the system after the DTX. */
+	if (target->ta_comp.co_ver > dte->dte_ver)
+		return true;
+
+	/* Skip non-healthy one. */
+	if (target->ta_comp.co_status != PO_COMP_ST_UP &&
+	    target->ta_comp.co_status != PO_COMP_ST_UPIN &&
+	    target->ta_comp.co_status != PO_COMP_ST_DRAIN)
+		return true;
+
+	/* Skip myself. */
+	if (my_rank == target->ta_comp.co_rank && my_tgtid == target->ta_comp.co_index)
+		return true;
+
+	return false;
+}
+
 static int
 dtx_classify_one(struct ds_pool *pool, daos_handle_t tree, d_list_t *head, int *length,
 		 struct dtx_entry *dte, int count, d_rank_t my_rank, uint32_t my_tgtid,
@@ -550,18 +572,7 @@ dtx_classify_one(struct ds_pool *pool, daos_handle_t tree, d_list_t *head, int *
 			D_GOTO(out, rc = -DER_UNINIT);
 		}
 
-		/* Skip the target that (re-)joined the system after the DTX. */
-		if (target->ta_comp.co_ver > dte->dte_ver)
-			continue;
-
-		/* Skip non-healthy one. */
-		if (target->ta_comp.co_status != PO_COMP_ST_UP &&
-		    target->ta_comp.co_status != PO_COMP_ST_UPIN &&
-		    target->ta_comp.co_status != PO_COMP_ST_DRAIN)
-			continue;
-
-		/* Skip myself. */
-		if (my_rank == target->ta_comp.co_rank && my_tgtid == target->ta_comp.co_index)
+		if (dtx_classify_skip(target, dte, my_rank, my_tgtid))
 			continue;
 
 		if (daos_handle_is_valid(tree)) {
@@ -770,6 +781,64 @@ dtx_rpc_post(struct dtx_common_args *dca, int ret, bool keep_head)
 	return ret != 0 ? ret : rc;
 }
 
+/*
+ * Commit the DTX entries locally after the remote participants have committed them. If the
+ * remote commit failed, then mark them as partial committed instead for re-commit later.
+ */
+static int
+dtx_commit_local(struct ds_cont_child *cont, struct dtx_id *dtis, struct dtx_cos_key *dcks,
+		 int count, int rc, int *committed)
+{
+	bool	*rm_cos = NULL;
+	bool	 cos = false;
+	int	 rc1 = 0;
+	int	 i;
+
+	if (rc != 0) {
+		/*
+		 * Some DTX entries may have been committed on some participants. Then mark all
+		 * the DTX entries (in the dtis) as "PARTIAL_COMMITTED" and re-commit them later.
+		 * It is harmless to re-commit the DTX that has ever been committed.
+		 */
+		if (*committed > 0)
+			rc1 = vos_dtx_set_flags(cont->sc_hdl, dtis, count, DTE_PARTIAL_COMMITTED);
+		return rc1;
+	}
+
+	if (dcks != NULL) {
+		if (count > 1) {
+			D_ALLOC_ARRAY(rm_cos, count);
+			if (rm_cos == NULL)
+				return -DER_NOMEM;
+		} else {
+			rm_cos = &cos;
+		}
+	}
+
+	rc1 = vos_dtx_commit(cont->sc_hdl, dtis, count, rm_cos);
+	if (rc1 > 0) {
+		*committed += rc1;
+		rc1 = 0;
+	} else if (rc1 == -DER_NONEXIST) {
+		/* -DER_NONEXIST may be caused by race or repeated commit, ignore it. */
+		rc1 = 0;
+	}
+
+	if (rc1 == 0 && rm_cos != NULL) {
+		for (i = 0; i < count; i++) {
+			if (rm_cos[i]) {
+				D_ASSERT(!daos_oid_is_null(dcks[i].oid.id_pub));
+				dtx_del_cos(cont, &dtis[i], &dcks[i].oid, dcks[i].dkey_hash);
+			}
+		}
+	}
+
+	if (rm_cos != &cos)
+		D_FREE(rm_cos);
+
+	return rc1;
+}
+
 /**
  * Commit the given DTX array globally.
  *
@@ -790,11 +859,8 @@ dtx_commit(struct ds_cont_child *cont, struct dtx_entry **dtes,
 {
 	struct dtx_common_args	 dca;
 	struct dtx_req_args	*dra = &dca.dca_dra;
-	bool			*rm_cos = NULL;
-	bool			 cos = false;
 	int			 rc;
-	int			 rc1 = 0;
-	int			 i;
+	int			 rc1;
 
 	rc = dtx_rpc_prep(cont, NULL, dtes, count, DTX_COMMIT, 0, NULL, NULL, NULL, &dca);
 
@@ -813,50 +879,8 @@ dtx_commit(struct ds_cont_child *cont, struct dtx_entry **dtes,
 	if (rc > 0 || rc == -DER_NONEXIST || rc == -DER_EXCLUDED || rc == -DER_OOG)
 		rc = 0;
 
-	if (rc != 0) {
-		/*
-		 * Some DTX entries may have been committed on some participants. Then mark all
-		 * the DTX entries (in the dtis) as "PARTIAL_COMMITTED" and re-commit them later.
-		 * It is harmless to re-commit the DTX that has ever been committed.
-		 */
-		if (dra->dra_committed > 0)
-			rc1 = vos_dtx_set_flags(cont->sc_hdl, dca.dca_dtis, count,
-						DTE_PARTIAL_COMMITTED);
-	} else {
-		if (dcks != NULL) {
-			if (count > 1) {
-				D_ALLOC_ARRAY(rm_cos, count);
-				if (rm_cos == NULL)
-					D_GOTO(out, rc1 = -DER_NOMEM);
-			} else {
-				rm_cos = &cos;
-			}
-		}
+	rc1 = dtx_commit_local(cont, dca.dca_dtis, dcks, count, rc, &dra->dra_committed);
 
-		rc1 = vos_dtx_commit(cont->sc_hdl, dca.dca_dtis, count, rm_cos);
-		if (rc1 > 0) {
-			dra->dra_committed += rc1;
-			rc1 = 0;
-		} else if (rc1 == -DER_NONEXIST) {
-			/* -DER_NONEXIST may be caused by race or repeated commit, ignore it. */
-			rc1 = 0;
-		}
-
-		if (rc1 == 0 && rm_cos != NULL) {
-			for (i = 0; i < count; i++) {
-				if (rm_cos[i]) {
-					D_ASSERT(!daos_oid_is_null(dcks[i].oid.id_pub));
-					dtx_del_cos(cont, &dca.dca_dtis[i], &dcks[i].oid,
-						    dcks[i].dkey_hash);
-				}
-			}
-		}
-
-		if (rm_cos != &cos)
-			D_FREE(rm_cos);
-	}
-
-out:
 	if (dca.dca_dtis != &dca.dca_dti_inline)
 		D_FREE(dca.dca_dtis);
 
@@ -871,6 +895,401 @@ out:
 	return rc != 0 ? rc : rc1;
 }
 
+static int
+dtx_batch_shard_cmp(const void *a, const void *b)
+{
+	const struct dtx_batch_shard	*sa = a;
+	const struct dtx_batch_shard	*sb = b;
+
+	if (sa->dbs_key != sb->dbs_key)
+		return sa->dbs_key < sb->dbs_key ? -1 : 1;
+
+	if (sa->dbs_cont != sb->dbs_cont)
+		return sa->dbs_cont < sb->dbs_cont ? -1 : 1;
+
+	if (sa->dbs_dte != sb->dbs_dte)
+		return sa->dbs_dte < sb->dbs_dte ? -1 : 1;
+
+	return 0;
+}
+
+/**
+ * Pack the shards of the DTX entries from multiple containers into DTX_BATCH_COMMIT requests.
+ *
+ * The shards are sorted by target, then by container. Each target corresponds to one request
+ * that carries the DTX entries from all related containers, grouped per container, and the
+ * same DTX is only packed once for the target even if it has multiple shards on that target.
+ * \a dtis[i] are the IDs of the DTX entries in \a dbcs[i]. The requests and their buffers are
+ * released via dtx_batch_pack_free().
+ */
+int
+dtx_batch_pack_build(struct dtx_batch_cont *dbcs, struct dtx_id **dtis,
+		     struct dtx_batch_shard *shards, int shard_cnt, struct dtx_batch_pack *dbp)
+{
+	struct dtx_batch_req	*dbr = NULL;
+	struct dtx_batch_cont	*dbc;
+	int			 cont_cnt = 0;
+	int			 dti_cnt = 0;
+	int			 i;
+
+	memset(dbp, 0, sizeof(*dbp));
+	if (shard_cnt == 0)
+		return 0;
+
+	qsort(shards, shard_cnt, sizeof(*shards), dtx_batch_shard_cmp);
+
+	for (i = 0; i < shard_cnt; i++) {
+		if (i == 0 || shards[i].dbs_key != shards[i - 1].dbs_key)
+			dbp->dbp_req_cnt++;
+	}
+
+	D_ALLOC_ARRAY(dbp->dbp_reqs, dbp->dbp_req_cnt);
+	D_ALLOC_ARRAY(dbp->dbp_dtis, shard_cnt);
+	D_ALLOC_ARRAY(dbp->dbp_cont_idx, shard_cnt);
+	D_ALLOC_ARRAY(dbp->dbp_dtx_cnts, shard_cnt);
+	D_ALLOC_ARRAY(dbp->dbp_po_uuids, shard_cnt);
+	D_ALLOC_ARRAY(dbp->dbp_co_uuids, shard_cnt);
+	if (dbp->dbp_reqs == NULL || dbp->dbp_dtis == NULL || dbp->dbp_cont_idx == NULL ||
+	    dbp->dbp_dtx_cnts == NULL || dbp->dbp_po_uuids == NULL || dbp->dbp_co_uuids == NULL) {
+		dtx_batch_pack_free(dbp);
+		return -DER_NOMEM;
+	}
+
+	for (i = 0; i < shard_cnt; i++) {
+		struct dtx_batch_shard	*dbs = &shards[i];
+
+		if (i == 0 || dbs->dbs_key != shards[i - 1].dbs_key) {
+			dbr = dbr == NULL ? &dbp->dbp_reqs[0] : dbr + 1;
+			dbr->dbr_conts = dbcs;
+			dbr->dbr_rank = dbs->dbs_key >> 32;
+			dbr->dbr_tag = (uint32_t)dbs->dbs_key;
+			dbr->dbr_cont_idx = &dbp->dbp_cont_idx[cont_cnt];
+			dbr->dbr_po_uuids = &dbp->dbp_po_uuids[cont_cnt];
+			dbr->dbr_co_uuids = &dbp->dbp_co_uuids[cont_cnt];
+			dbr->dbr_dtx_cnts = &dbp->dbp_dtx_cnts[cont_cnt];
+			dbr->dbr_dtis = &dbp->dbp_dtis[dti_cnt];
+		} else if (dbs->dbs_cont == shards[i - 1].dbs_cont &&
+			   dbs->dbs_dte == shards[i - 1].dbs_dte) {
+			continue;
+		}
+
+		if (dbr->dbr_cont_cnt == 0 ||
+		    dbr->dbr_cont_idx[dbr->dbr_cont_cnt - 1] != dbs->dbs_cont) {
+			dbc = &dbcs[dbs->dbs_cont];
+			dbr->dbr_cont_idx[dbr->dbr_cont_cnt] = dbs->dbs_cont;
+			uuid_copy(dbr->dbr_po_uuids[dbr->dbr_cont_cnt],
+				  dbc->dbc_cont->sc_pool->spc_pool->sp_uuid);
+			uuid_copy(dbr->dbr_co_uuids[dbr->dbr_cont_cnt], dbc->dbc_cont->sc_uuid);
+			dbr->dbr_dtx_cnts[dbr->dbr_cont_cnt] = 0;
+			dbr->dbr_cont_cnt++;
+			dbp->dbp_pair_cnt++;
+			cont_cnt++;
+		}
+
+		dbr->dbr_dtis[dbr->dbr_dti_cnt++] = dtis[dbs->dbs_cont][dbs->dbs_dte];
+		dbr->dbr_dtx_cnts[dbr->dbr_cont_cnt - 1]++;
+		dti_cnt++;
+	}
+
+	return 0;
+}
+
+void
+dtx_batch_pack_free(struct dtx_batch_pack *dbp)
+{
+	D_FREE(dbp->dbp_reqs);
+	D_FREE(dbp->dbp_dtis);
+	D_FREE(dbp->dbp_cont_idx);
+	D_FREE(dbp->dbp_dtx_cnts);
+	D_FREE(dbp->dbp_po_uuids);
+	D_FREE(dbp->dbp_co_uuids);
+	dbp->dbp_req_cnt = 0;
+	dbp->dbp_pair_cnt = 0;
+}
+
+static void
+dtx_batch_req_done(struct dtx_batch_req *dbr, int rc, int32_t *sub_rets)
+{
+	struct dtx_batch_cont	*dbc;
+	int			 ret;
+	int			 i;
+
+	D_ASSERT(dbr->dbr_comp == 0);
+
+	for (i = 0; i < dbr->dbr_cont_cnt; i++) {
+		dbc = &dbr->dbr_conts[dbr->dbr_cont_idx[i]];
+		ret = rc != 0 ? rc : sub_rets[i];
+		if (ret > 0)
+			dbc->dbc_committed += ret;
+		else if (ret < 0 && (dbc->dbc_result == 0 || dbc->dbc_result == -DER_NONEXIST))
+			dbc->dbc_result = ret;
+	}
+
+	D_CDEBUG(rc < 0, DLOG_ERR, DB_TRACE,
+		 "DTX batched commit for %d containers, %d entries to %d/%d done: "DF_RC"\n",
+		 dbr->dbr_cont_cnt, dbr->dbr_dti_cnt, dbr->dbr_rank, dbr->dbr_tag, DP_RC(rc));
+
+	dbr->dbr_comp = 1;
+	rc = ABT_future_set(dbr->dbr_future, dbr);
+	D_ASSERTF(rc == ABT_SUCCESS, "ABT_future_set failed for DTX batched commit to %d/%d: "
+		  "rc = %d.\n", dbr->dbr_rank, dbr->dbr_tag, rc);
+}
+
+static void
+dtx_batch_req_cb(const struct crt_cb_info *cb_info)
+{
+	struct dtx_batch_req	*dbr = cb_info->cci_arg;
+	struct dtx_batch_out	*dbo;
+	int			 rc = cb_info->cci_rc;
+
+	if (rc != 0)
+		goto out;
+
+	dbo = crt_reply_get(cb_info->cci_rpc);
+	rc = dbo->dbo_status;
+	if (rc == 0 && dbo->dbo_sub_rets.ca_count != dbr->dbr_cont_cnt)
+		rc = -DER_PROTO;
+	if (rc == 0) {
+		dtx_batch_req_done(dbr, 0, dbo->dbo_sub_rets.ca_arrays);
+		return;
+	}
+
+out:
+	dtx_batch_req_done(dbr, rc, NULL);
+}
+
+static int
+dtx_batch_req_send(struct dtx_batch_req *dbr)
+{
+	struct dtx_batch_in	*dbi;
+	crt_rpc_t		*req = NULL;
+	crt_endpoint_t		 tgt_ep;
+	crt_opcode_t		 opc;
+	int			 rc;
+
+	tgt_ep.ep_grp = NULL;
+	tgt_ep.ep_rank = dbr->dbr_rank;
+	tgt_ep.ep_tag = daos_rpc_tag(DAOS_REQ_TGT, dbr->dbr_tag);
+	opc = DAOS_RPC_OPCODE(DTX_BATCH_COMMIT, DAOS_DTX_MODULE, DAOS_DTX_VERSION);
+
+	rc = crt_req_create(dss_get_module_info()->dmi_ctx, &tgt_ep, opc, &req);
+	if (rc == 0) {
+		dbi = crt_req_get(req);
+		dbi->dbi_po_uuids.ca_count = dbr->dbr_cont_cnt;
+		dbi->dbi_po_uuids.ca_arrays = dbr->dbr_po_uuids;
+		dbi->dbi_co_uuids.ca_count = dbr->dbr_cont_cnt;
+		dbi->dbi_co_uuids.ca_arrays = dbr->dbr_co_uuids;
+		dbi->dbi_dtx_cnts.ca_count = dbr->dbr_cont_cnt;
+		dbi->dbi_dtx_cnts.ca_arrays = dbr->dbr_dtx_cnts;
+		dbi->dbi_dtx_array.ca_count = dbr->dbr_dti_cnt;
+		dbi->dbi_dtx_array.ca_arrays = dbr->dbr_dtis;
+
+		rc = crt_req_send(req, dtx_batch_req_cb, dbr);
+	}
+
+	D_DEBUG(DB_TRACE, "DTX batched commit for %d containers, %d entries to %d/%d (req %p) "
+		"sent: rc %d.\n", dbr->dbr_cont_cnt, dbr->dbr_dti_cnt, dbr->dbr_rank,
+		dbr->dbr_tag, req, rc);
+
+	if (rc != 0 && dbr->dbr_comp == 0)
+		dtx_batch_req_done(dbr, rc, NULL);
+
+	return rc;
+}
+
+/**
+ * Commit the DTX entries from multiple containers (maybe belong to different pools) globally.
+ *
+ * Similar as dtx_commit(), but the shards of the DTX entries from all the given containers
+ * that reside on the same remote target are packed into single DTX_BATCH_COMMIT RPC, then
+ * the remote target commits them per container. After that, commit them locally for each
+ * container. The result for each container is stored in dtx_batch_cont::dbc_result.
+ *
+ * \a rpc_cnt and \a pair_cnt return the count of sent RPCs and the count of the packed
+ * (container, target) pairs in them, the ratio indicates how well the packing works.
+ */
+int
+dtx_commit_batch(struct dtx_batch_cont *dbcs, int cont_cnt, int *rpc_cnt, int *pair_cnt)
+{
+	struct dtx_batch_shard	 *shards = NULL;
+	struct dtx_batch_pack	  dbp = { 0 };
+	struct dtx_batch_req	 *dbrs = NULL;
+	struct dtx_batch_cont	 *dbc;
+	struct dtx_memberships	 *mbs;
+	struct pool_target	 *target;
+	struct ds_pool		 *pool;
+	struct dtx_id		**dtis = NULL;
+	ABT_future		  future = ABT_FUTURE_NULL;
+	d_rank_t		  my_rank;
+	uint32_t		  my_tgtid = dss_get_module_info()->dmi_tgt_id;
+	int			  shard_cnt = 0;
+	int			  req_cnt = 0;
+	int			  pairs = 0;
+	int			  total = 0;
+	int			  rc = 0;
+	int			  rc1;
+	int			  i;
+	int			  j;
+	int			  k;
+
+	crt_group_rank(NULL, &my_rank);
+
+	for (i = 0; i < cont_cnt; i++) {
+		dbcs[i].dbc_committed = 0;
+		dbcs[i].dbc_result = 0;
+		for (j = 0; j < dbcs[i].dbc_count; j++)
+			total += dbcs[i].dbc_dtes[j]->dte_mbs->dm_tgt_cnt;
+	}
+
+	D_ALLOC_ARRAY(dtis, cont_cnt);
+	if (dtis == NULL)
+		D_GOTO(fail, rc = -DER_NOMEM);
+
+	for (i = 0; i < cont_cnt; i++) {
+		D_ALLOC_ARRAY(dtis[i], dbcs[i].dbc_count);
+		if (dtis[i] == NULL)
+			D_GOTO(fail, rc = -DER_NOMEM);
+
+		for (j = 0; j < dbcs[i].dbc_count; j++)
+			daos_dti_copy(&dtis[i][j], &dbcs[i].dbc_dtes[j]->dte_xid);
+	}
+
+	if (total > 0) {
+		D_ALLOC_ARRAY(shards, total);
+		if (shards == NULL)
+			D_GOTO(fail, rc = -DER_NOMEM);
+	}
+
+	for (i = 0; i < cont_cnt; i++) {
+		int	start = shard_cnt;
+
+		dbc = &dbcs[i];
+		pool = dbc->dbc_cont->sc_pool->spc_pool;
+
+		ABT_rwlock_rdlock(pool->sp_lock);
+		for (j = 0; j < dbc->dbc_count && rc == 0; j++) {
+			mbs = dbc->dbc_dtes[j]->dte_mbs;
+			if (mbs->dm_tgt_cnt == 0) {
+				rc = -DER_INVAL;
+				break;
+			}
+
+			/* mbs->dm_tgts[0] is the (current/old) leader, skip it. */
+			k = (mbs->dm_flags & DMF_CONTAIN_LEADER) ? 1 : 0;
+			for (; k < mbs->dm_tgt_cnt; k++) {
+				rc = pool_map_find_target(pool->sp_map, mbs->dm_tgts[k].ddt_id,
+							  &target);
+				if (rc != 1) {
+					D_WARN("Cannot find target %u at %d/%d, flags %x\n",
+					       mbs->dm_tgts[k].ddt_id, k, mbs->dm_tgt_cnt,
+					       mbs->dm_flags);
+					rc = -DER_UNINIT;
+					break;
+				}
+
+				rc = 0;
+				if (dtx_classify_skip(target, dbc->dbc_dtes[j], my_rank, my_tgtid))
+					continue;
+
+				shards[shard_cnt].dbs_key = (uint64_t)target->ta_comp.co_rank << 32 |
+							    target->ta_comp.co_index;
+				shards[shard_cnt].dbs_cont = i;
+				shards[shard_cnt].dbs_dte = j;
+				shard_cnt++;
+			}
+		}
+		ABT_rwlock_unlock(pool->sp_lock);
+
+		/* Nothing has been sent yet, the failed container will be committed next time. */
+		if (rc != 0) {
+			dbc->dbc_result = rc;
+			shard_cnt = start;
+			rc = 0;
+		}
+	}
+
+	if (shard_cnt == 0)
+		goto local;
+
+	rc = dtx_batch_pack_build(dbcs, dtis, shards, shard_cnt, &dbp);
+	if (rc != 0)
+		D_GOTO(fail, rc);
+
+	dbrs = dbp.dbp_reqs;
+	req_cnt = dbp.dbp_req_cnt;
+	pairs = dbp.dbp_pair_cnt;
+
+	rc = ABT_future_create(req_cnt, NULL, &future);
+	if (rc != ABT_SUCCESS) {
+		D_ERROR("ABT_future_create failed for DTX batched commit, len = %d: rc = %d.\n",
+			req_cnt, rc);
+		D_GOTO(fail, rc = dss_abterr2der(rc));
+	}
+
+	for (i = 0; i < req_cnt; i++) {
+		dbrs[i].dbr_future = future;
+		dtx_batch_req_send(&dbrs[i]);
+
+		/* Yield to avoid holding CPU for too long time. */
+		if ((i + 1) % DTX_RPC_YIELD_THD == 0)
+			ABT_thread_yield();
+	}
+
+	rc = ABT_future_wait(future);
+	D_ASSERTF(rc == ABT_SUCCESS, "ABT_future_wait failed for DTX batched commit: %d\n", rc);
+	ABT_future_free(&future);
+
+local:
+	for (i = 0; i < cont_cnt; i++) {
+		dbc = &dbcs[i];
+		rc1 = dbc->dbc_result;
+		if (rc1 > 0 || rc1 == -DER_NONEXIST || rc1 == -DER_EXCLUDED || rc1 == -DER_OOG)
+			rc1 = 0;
+
+		dbc->dbc_result = dtx_commit_local(dbc->dbc_cont, dtis[i], dbc->dbc_dcks,
+						   dbc->dbc_count, rc1, &dbc->dbc_committed);
+		if (rc1 != 0 || dbc->dbc_result != 0)
+			D_ERROR("Failed to batched commit DTX entries "DF_DTI" for "DF_UUID
+				", count %d, %s committed: %d %d\n", DP_DTI(&dtis[i][0]),
+				DP_UUID(dbc->dbc_cont->sc_uuid), dbc->dbc_count,
+				dbc->dbc_committed > 0 ? "partial" : "nothing", rc1,
+				dbc->dbc_result);
+		else
+			D_DEBUG(DB_TRACE, "Batched commit DTXs "DF_DTI" for "DF_UUID", count %d\n",
+				DP_DTI(&dtis[i][0]), DP_UUID(dbc->dbc_cont->sc_uuid),
+				dbc->dbc_count);
+
+		if (rc1 != 0)
+			dbc->dbc_result = rc1;
+		if (rc == 0)
+			rc = dbc->dbc_result;
+	}
+
+	goto out;
+
+fail:
+	/* Nothing has been sent, related containers will be committed next time. */
+	for (i = 0; i < cont_cnt; i++) {
+		if (dbcs[i].dbc_result == 0)
+			dbcs[i].dbc_result = rc;
+	}
+	req_cnt = 0;
+	pairs = 0;
+
+out:
+	if (dtis != NULL) {
+		for (i = 0; i < cont_cnt; i++)
+			D_FREE(dtis[i]);
+		D_FREE(dtis);
+	}
+	D_FREE(shards);
+	dtx_batch_pack_free(&dbp);
+
+	*rpc_cnt = req_cnt;
+	*pair_cnt = pairs;
+
+	return rc;
+}
 
 int
 dtx_abort(struct ds_cont_child *cont, struct dtx_entry *dte, daos_epoch_t epoch)
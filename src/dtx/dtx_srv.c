@@ -522,6 +522,123 @@ out:
 	D_FREE(results);
 }
 
+/* Check that the per container arrays of a DTX_BATCH_COMMIT request match the DTX array. */
+int
+dtx_batch_in_check(struct dtx_batch_in *dbi)
+{
+	uint32_t	*cnts = dbi->dbi_dtx_cnts.ca_arrays;
+	uint32_t	 cont_cnt = dbi->dbi_dtx_cnts.ca_count;
+	uint64_t	 total = 0;
+	int		 i;
+
+	if (dbi->dbi_po_uuids.ca_count != cont_cnt || dbi->dbi_co_uuids.ca_count != cont_cnt)
+		return -DER_PROTO;
+
+	for (i = 0; i < cont_cnt; i++)
+		total += cnts[i];
+
+	if (total != dbi->dbi_dtx_array.ca_count)
+		return -DER_PROTO;
+
+	return 0;
+}
+
+/*
+ * Commit the DTX entries of a DTX_BATCH_COMMIT request locally, per container. The result for
+ * the i-th container is stored in \a sub_rets[i], that is the count of committed DTX entries
+ * or the error. Return the count of committed DTX entries for all the containers.
+ */
+int
+dtx_batch_commit_conts(struct dtx_batch_in *dbi, int32_t *sub_rets)
+{
+	struct dtx_pool_metrics	*dpm;
+	struct ds_cont_child	*cont;
+	struct dtx_id		*dtis = dbi->dbi_dtx_array.ca_arrays;
+	uuid_t			*po_uuids = dbi->dbi_po_uuids.ca_arrays;
+	uuid_t			*co_uuids = dbi->dbi_co_uuids.ca_arrays;
+	uint32_t		*cnts = dbi->dbi_dtx_cnts.ca_arrays;
+	uint32_t		 cont_cnt = dbi->dbi_dtx_cnts.ca_count;
+	int			 committed = 0;
+	int			 count;
+	int			 rc;
+	int			 i;
+	int			 j;
+
+	for (i = 0; i < cont_cnt; dtis += cnts[i], i++) {
+		sub_rets[i] = 0;
+		rc = ds_cont_child_lookup(po_uuids[i], co_uuids[i], &cont);
+		if (rc != 0) {
+			D_ERROR("Failed to locate pool="DF_UUID" cont="DF_UUID
+				" for DTX batched commit: rc = "DF_RC"\n",
+				DP_UUID(po_uuids[i]), DP_UUID(co_uuids[i]), DP_RC(rc));
+			sub_rets[i] = rc;
+			continue;
+		}
+
+		for (j = 0, count = DTX_YIELD_CYCLE; j < cnts[i]; j += count) {
+			if (j + count > cnts[i])
+				count = cnts[i] - j;
+
+			rc = vos_dtx_commit(cont->sc_hdl, dtis + j, count, NULL);
+			if (rc > 0)
+				sub_rets[i] += rc;
+			else if (rc < 0 && sub_rets[i] >= 0)
+				sub_rets[i] = rc;
+		}
+
+		if (sub_rets[i] > 0)
+			committed += sub_rets[i];
+
+		dpm = cont->sc_pool->spc_metrics[DAOS_DTX_MODULE];
+		if (likely(dpm != NULL)) {
+			d_tm_inc_counter(dpm->dpm_batched_total, cnts[i]);
+			d_tm_inc_counter(dpm->dpm_total[DTX_BATCH_COMMIT], 1);
+		}
+
+		ds_cont_child_put(cont);
+	}
+
+	return committed;
+}
+
+static void
+dtx_batch_handler(crt_rpc_t *rpc)
+{
+	struct dtx_batch_in	*dbi = crt_req_get(rpc);
+	struct dtx_batch_out	*dbo = crt_reply_get(rpc);
+	uint32_t		 cont_cnt = dbi->dbi_dtx_cnts.ca_count;
+	int32_t			*sub_rets = NULL;
+	int			 committed = 0;
+	int			 rc;
+
+	rc = dtx_batch_in_check(dbi);
+	if (rc != 0)
+		goto out;
+
+	D_ALLOC_ARRAY(sub_rets, cont_cnt);
+	if (sub_rets == NULL)
+		D_GOTO(out, rc = -DER_NOMEM);
+
+	if (!DAOS_FAIL_CHECK(DAOS_DTX_MISS_COMMIT))
+		committed = dtx_batch_commit_conts(dbi, sub_rets);
+
+	dbo->dbo_sub_rets.ca_count = cont_cnt;
+	dbo->dbo_sub_rets.ca_arrays = sub_rets;
+
+out:
+	D_DEBUG(DB_TRACE, "Handle DTX batched commit for %u containers, count %u: rc = "DF_RC"\n",
+		cont_cnt, (uint32_t)dbi->dbi_dtx_array.ca_count, DP_RC(rc));
+
+	dbo->dbo_status = rc;
+	dbo->dbo_misc = committed;
+	rc = crt_reply_send(rpc);
+	if (rc != 0)
+		D_ERROR("send reply failed for DTX batched commit: rc = "DF_RC"\n", DP_RC(rc));
+
+	D_FREE(sub_rets);
+	dbo->dbo_sub_rets.ca_count = 0;
+}
+
 static int
 dtx_init(void)
 {
@@ -555,6 +672,11 @@ dtx_init(void)
 	d_getenv_uint32_t("DAOS_DTX_BATCHED_ULT_MAX", &dtx_batched_ult_max);
 	D_INFO("Set the max count of DTX batched commit ULTs as %d\n", dtx_batched_ult_max);
 
+	dtx_batch_cont_max = DTX_BATCH_CONT_DEF;
+	d_getenv_uint32_t("DAOS_DTX_BATCH_CONT_MAX", &dtx_batch_cont_max);
+	D_INFO("Set the max count of containers for DTX batched commit as %u\n",
+	       dtx_batch_cont_max);
+
 	rc = dbtree_class_register(DBTREE_CLASS_DTX_CF,
 				   BTR_FEAT_UINT_KEY | BTR_FEAT_DYNAMIC_ROOT,
 				   &dbtree_dtx_cf_ops);
@@ -0,0 +1,244 @@
+/**
+ * (C) Copyright 2024 Intel Corporation.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause-Patent
+ */
+/**
+ * DTX batched commit across containers tests
+ */
+#define D_LOGFAC DD_FAC(tests)
+
+#include <stddef.h>
+#include <stdbool.h>
+#include <uuid/uuid.h>
+#include <daos_types.h>
+#include <daos/object.h>
+#include <daos_srv/container.h>
+#include <daos_srv/pool.h>
+
+#include "vts_io.h"
+#include "dts_utils.h"
+#include "dtx_internal.h"
+
+#define DTS_BATCH_CONTS 2
+#define DTS_BATCH_DTES  2
+
+/* Two containers in different pools, each with two DTX entries. */
+struct dts_batch_conts {
+	struct ds_pool        dbc_pools[DTS_BATCH_CONTS];
+	struct ds_pool_child  dbc_pool_children[DTS_BATCH_CONTS];
+	struct ds_cont_child  dbc_conts[DTS_BATCH_CONTS];
+	struct dtx_batch_cont dbc_dbcs[DTS_BATCH_CONTS];
+	struct dtx_id         dbc_dti_buf[DTS_BATCH_CONTS][DTS_BATCH_DTES];
+	struct dtx_id        *dbc_dtis[DTS_BATCH_CONTS];
+};
+
+static void
+dts_batch_conts_init(struct dts_batch_conts *dbc)
+{
+	int i;
+	int j;
+
+	memset(dbc, 0, sizeof(*dbc));
+	for (i = 0; i < DTS_BATCH_CONTS; i++) {
+		uuid_generate(dbc->dbc_pools[i].sp_uuid);
+		uuid_generate(dbc->dbc_conts[i].sc_uuid);
+		dbc->dbc_pool_children[i].spc_pool = &dbc->dbc_pools[i];
+		dbc->dbc_conts[i].sc_pool          = &dbc->dbc_pool_children[i];
+		dbc->dbc_dbcs[i].dbc_cont          = &dbc->dbc_conts[i];
+		dbc->dbc_dbcs[i].dbc_count         = DTS_BATCH_DTES;
+		for (j = 0; j < DTS_BATCH_DTES; j++)
+			daos_dti_gen_unique(&dbc->dbc_dti_buf[i][j]);
+		dbc->dbc_dtis[i] = dbc->dbc_dti_buf[i];
+	}
+}
+
+#define DTS_TGT(rank, tag) ((uint64_t)(rank) << 32 | (tag))
+
+static void
+dts_check_req_cont(struct dts_batch_conts *dbc, struct dtx_batch_req *dbr, int idx, int cont,
+		   uint32_t dtx_cnt)
+{
+	assert_int_equal(dbr->dbr_cont_idx[idx], cont);
+	assert_int_equal(uuid_compare(dbr->dbr_po_uuids[idx], dbc->dbc_pools[cont].sp_uuid), 0);
+	assert_int_equal(uuid_compare(dbr->dbr_co_uuids[idx], dbc->dbc_conts[cont].sc_uuid), 0);
+	assert_int_equal(dbr->dbr_dtx_cnts[idx], dtx_cnt);
+}
+
+/* Shards are packed per target, grouped per container, without duplicated DTX. */
+static void
+ut_batch_pack(void **state)
+{
+	struct dts_batch_conts  dbc;
+	struct dtx_batch_pack   dbp;
+	struct dtx_batch_req   *dbr;
+	struct dtx_batch_shard  shards[] = {
+            {DTS_TGT(2, 1), 1, 0}, {DTS_TGT(1, 0), 0, 1}, {DTS_TGT(1, 0), 0, 0},
+            {DTS_TGT(1, 0), 0, 0}, {DTS_TGT(1, 0), 1, 0}, {DTS_TGT(2, 1), 0, 1},
+        };
+	int rc;
+
+	dts_print_start_message();
+	dts_batch_conts_init(&dbc);
+
+	rc = dtx_batch_pack_build(dbc.dbc_dbcs, dbc.dbc_dtis, shards, ARRAY_SIZE(shards), &dbp);
+	assert_rc_equal(rc, 0);
+	assert_int_equal(dbp.dbp_req_cnt, 2);
+	assert_int_equal(dbp.dbp_pair_cnt, 4);
+
+	/* Rank 1 tag 0: the two DTX of the first container once each, then the second one. */
+	dbr = &dbp.dbp_reqs[0];
+	assert_int_equal(dbr->dbr_rank, 1);
+	assert_int_equal(dbr->dbr_tag, 0);
+	assert_ptr_equal(dbr->dbr_conts, dbc.dbc_dbcs);
+	assert_int_equal(dbr->dbr_cont_cnt, 2);
+	assert_int_equal(dbr->dbr_dti_cnt, 3);
+	dts_check_req_cont(&dbc, dbr, 0, 0, 2);
+	dts_check_req_cont(&dbc, dbr, 1, 1, 1);
+	assert_true(daos_dti_equal(&dbr->dbr_dtis[0], &dbc.dbc_dti_buf[0][0]));
+	assert_true(daos_dti_equal(&dbr->dbr_dtis[1], &dbc.dbc_dti_buf[0][1]));
+	assert_true(daos_dti_equal(&dbr->dbr_dtis[2], &dbc.dbc_dti_buf[1][0]));
+
+	/* Rank 2 tag 1: one DTX from each container. */
+	dbr = &dbp.dbp_reqs[1];
+	assert_int_equal(dbr->dbr_rank, 2);
+	assert_int_equal(dbr->dbr_tag, 1);
+	assert_int_equal(dbr->dbr_cont_cnt, 2);
+	assert_int_equal(dbr->dbr_dti_cnt, 2);
+	dts_check_req_cont(&dbc, dbr, 0, 0, 1);
+	dts_check_req_cont(&dbc, dbr, 1, 1, 1);
+	assert_true(daos_dti_equal(&dbr->dbr_dtis[0], &dbc.dbc_dti_buf[0][1]));
+	assert_true(daos_dti_equal(&dbr->dbr_dtis[1], &dbc.dbc_dti_buf[1][0]));
+
+	dtx_batch_pack_free(&dbp);
+	assert_null(dbp.dbp_reqs);
+
+	/* Nothing to be sent. */
+	rc = dtx_batch_pack_build(dbc.dbc_dbcs, dbc.dbc_dtis, shards, 0, &dbp);
+	assert_rc_equal(rc, 0);
+	assert_int_equal(dbp.dbp_req_cnt, 0);
+	assert_int_equal(dbp.dbp_pair_cnt, 0);
+	dtx_batch_pack_free(&dbp);
+}
+
+static void
+dts_batch_in_set(struct dtx_batch_in *dbi, uuid_t *po_uuids, uuid_t *co_uuids, uint32_t *cnts,
+		 int cont_cnt, struct dtx_id *dtis, int dti_cnt)
+{
+	memset(dbi, 0, sizeof(*dbi));
+	dbi->dbi_po_uuids.ca_arrays  = po_uuids;
+	dbi->dbi_po_uuids.ca_count   = cont_cnt;
+	dbi->dbi_co_uuids.ca_arrays  = co_uuids;
+	dbi->dbi_co_uuids.ca_count   = cont_cnt;
+	dbi->dbi_dtx_cnts.ca_arrays  = cnts;
+	dbi->dbi_dtx_cnts.ca_count   = cont_cnt;
+	dbi->dbi_dtx_array.ca_arrays = dtis;
+	dbi->dbi_dtx_array.ca_count  = dti_cnt;
+}
+
+/* Malformed DTX_BATCH_COMMIT requests are rejected. */
+static void
+ut_batch_in_check(void **state)
+{
+	struct dtx_batch_in dbi;
+	struct dtx_id       dtis[3];
+	uuid_t              po_uuids[2];
+	uuid_t              co_uuids[2];
+	uint32_t            cnts[2] = {2, 1};
+
+	dts_print_start_message();
+
+	dts_batch_in_set(&dbi, po_uuids, co_uuids, cnts, 2, dtis, 3);
+	assert_rc_equal(dtx_batch_in_check(&dbi), 0);
+
+	/* The DTX count does not match the per container counts. */
+	dbi.dbi_dtx_array.ca_count = 2;
+	assert_rc_equal(dtx_batch_in_check(&dbi), -DER_PROTO);
+
+	/* The per container arrays have different sizes. */
+	dts_batch_in_set(&dbi, po_uuids, co_uuids, cnts, 2, dtis, 3);
+	dbi.dbi_co_uuids.ca_count = 1;
+	assert_rc_equal(dtx_batch_in_check(&dbi), -DER_PROTO);
+
+	dts_batch_in_set(&dbi, po_uuids, co_uuids, cnts, 2, dtis, 3);
+	dbi.dbi_po_uuids.ca_count = 3;
+	assert_rc_equal(dtx_batch_in_check(&dbi), -DER_PROTO);
+}
+
+/* The DTX entries of a DTX_BATCH_COMMIT request are committed per container. */
+static void
+ut_batch_commit_conts(void **state)
+{
+	struct io_test_args   *arg = *state;
+	daos_handle_t          coh = arg->ctx.tc_co_hdl;
+	struct dts_local_args *la  = arg->custom;
+	struct ds_pool_child   pool_child = {0};
+	struct ds_cont_child   cont       = {0};
+	struct dtx_handle     *dth;
+	struct dtx_batch_in    dbi;
+	struct dtx_id          dtis[3];
+	uuid_t                 po_uuids[2];
+	uuid_t                 co_uuids[2];
+	uint32_t               cnts[2] = {2, 1};
+	int32_t                sub_rets[2];
+	int                    rc;
+	int                    i;
+
+	dts_print_start_message();
+
+	cont.sc_hdl  = coh;
+	cont.sc_pool = &pool_child;
+	for (i = 0; i < 2; i++) {
+		uuid_generate(po_uuids[i]);
+		uuid_generate(co_uuids[i]);
+	}
+
+	for (i = 0; i < ARRAY_SIZE(dtis); i++) {
+		vts_dtx_begin(&la->oid, coh, la->epoch, 0, &dth);
+		dts_update(coh, la, i, "batch", dth);
+		dtis[i] = dth->dth_xid;
+		vts_dtx_end(dth);
+		la->epoch++;
+	}
+
+	/* The second container does not exist here. */
+	dts_batch_in_set(&dbi, po_uuids, co_uuids, cnts, 2, dtis, 3);
+	will_return(ds_cont_child_lookup, &cont);
+	will_return(ds_cont_child_lookup, 0);
+	expect_value(ds_cont_child_put, cont, &cont);
+	will_return(ds_cont_child_lookup, NULL);
+	will_return(ds_cont_child_lookup, -DER_NONEXIST);
+
+	rc = dtx_batch_commit_conts(&dbi, sub_rets);
+	assert_int_equal(rc, 2);
+	assert_int_equal(sub_rets[0], 2);
+	assert_rc_equal(sub_rets[1], -DER_NONEXIST);
+
+	/* Both containers are found, the first one has been committed already. */
+	will_return(ds_cont_child_lookup, &cont);
+	will_return(ds_cont_child_lookup, 0);
+	will_return(ds_cont_child_lookup, &cont);
+	will_return(ds_cont_child_lookup, 0);
+	expect_value_count(ds_cont_child_put, cont, &cont, 2);
+
+	rc = dtx_batch_commit_conts(&dbi, sub_rets);
+	assert_int_equal(rc, 1);
+	assert_true(sub_rets[0] == 0 || sub_rets[0] == -DER_NONEXIST);
+	assert_int_equal(sub_rets[1], 1);
+}
+
+static const struct CMUnitTest batch_tests_all[] = {
+    {"DTX200: Pack DTX across containers", ut_batch_pack, NULL, NULL},
+    {"DTX201: Check batched commit request", ut_batch_in_check, NULL, NULL},
+    BASIC_UT(202, "Batched commit per container", ut_batch_commit_conts),
+};
+
+int
+run_batch_tests(const char *cfg)
+{
+	const char *test_name = "DTX batched commit";
+
+	dts_global_init();
+
+	return cmocka_run_group_tests_name(test_name, batch_tests_all, setup_io, teardown_io);
+}
@@ -20,6 +20,7 @@
 #include <unistd.h>
 
 #include <pthread.h>
+#include <sched.h>
 
 #include <sys/socket.h>
 #include <sys/time.h>
@@ -35,6 +36,7 @@
 #include <gurt/dlog.h>
 #include <gurt/common.h>
 #include <gurt/list.h>
+#include <gurt/atomic.h>
 
 /* extra tag bytes to alloc for a pid */
 #define DLOG_TAGPAD 16
@@ -81,6 +83,7 @@ struct d_log_state {
 	int flush_pri;		/* flush priority */
 	bool append_rank;	/* append rank to the log filename */
 	bool rank_appended;	/* flag to indicate if rank is already appended */
+	ATOMIC bool log_async;	/* messages go through per-thread rings */
 };
 
 static pthread_mutex_t clogmux = PTHREAD_MUTEX_INITIALIZER; /* protect clog in threaded env */
@@ -106,10 +109,56 @@ static const char        *default_fac0name = "CLOG";
 /* whether we should merge log and stderr */
 static bool               merge_stderr;
 
+/*
+ * Asynchronous mode: every thread formats its messages into its own ring, and
+ * a writer thread drains the rings into the log buffer and log file, so the
+ * logging threads neither take clogmux nor wait for write(2). A ring has a
+ * single producer (the owner thread) and a single consumer (the holder of
+ * clogmux, normally the writer thread).
+ *
+ * A thread caches its ring and may still be copying a message into it while the
+ * asynchronous mode is stopped, so a ring is only freed once its thread exits,
+ * it is reused if the asynchronous mode is started again.
+ *
+ * Only the forking thread survives in the child of fork(), so the child drops
+ * the rings, whose contents are written by the parent, and starts its own
+ * writer thread.
+ */
+#define DLOG_RING_SIZE		(256 << 10)
+#define DLOG_WRITER_IDLE_US	1000
+
+struct dlog_ring {
+	/** link on dlog_rings, protected by clogmux */
+	d_list_t		 dr_link;
+	/** bytes produced, only updated by the owner thread */
+	ATOMIC uint64_t		 dr_head;
+	/** bytes consumed, only updated by the holder of clogmux */
+	ATOMIC uint64_t		 dr_tail;
+	/** messages dropped because the ring was full */
+	ATOMIC uint64_t		 dr_dropped;
+	/** dropped messages which have been reported in the log */
+	uint64_t		 dr_dropped_seen;
+	/** the owner thread has exited, free the ring once drained */
+	ATOMIC bool		 dr_orphan;
+	uint32_t		 dr_tid;
+	char			 dr_buf[DLOG_RING_SIZE];
+};
+
+static D_LIST_HEAD(dlog_rings);
+static pthread_once_t		 dlog_ring_once = PTHREAD_ONCE_INIT;
+static pthread_key_t		 dlog_ring_key;
+static int			 dlog_ring_key_rc;
+static pthread_t		 dlog_writer;
+static ATOMIC bool		 dlog_writer_stop;
+static __thread struct dlog_ring *dlog_tls_ring;
+static __thread bool		 dlog_tls_exited;
+
 #define clog_lock()   (void)pthread_mutex_lock(&clogmux)
 #define clog_unlock() (void)pthread_mutex_unlock(&clogmux)
 
 static int d_log_write(char *buf, int len, bool flush);
+static void dlog_async_start(void);
+static void dlog_async_stop(void);
 static const char *clog_pristr(int);
 static int clog_setnfac(int);
 
@@ -271,6 +320,7 @@ static void dlog_cleanout(void)
 	struct cache_entry	*ce;
 	int			 lcv;
 
+	dlog_async_stop();
 	clog_lock();
 	if (mst.log_file) {
 		if (mst.log_fd >= 0) {
@@ -504,12 +554,253 @@ d_log_write(char *msg, int len, bool flush)
 	return 0;
 }
 
+/* called with clogmux held */
+static int
+dlog_rings_drain(void)
+{
+	struct dlog_ring	*ring;
+	struct dlog_ring	*tmp;
+	char			 note[96];
+	uint64_t		 head;
+	uint64_t		 tail;
+	uint64_t		 dropped;
+	bool			 orphan;
+	int			 len;
+	int			 nob = 0;
+
+	d_list_for_each_entry_safe(ring, tmp, &dlog_rings, dr_link) {
+		/* check orphan first, so nothing logged before the thread exit is missed */
+		orphan = atomic_load_explicit(&ring->dr_orphan, memory_order_acquire);
+		head = atomic_load_explicit(&ring->dr_head, memory_order_acquire);
+		tail = atomic_load_relaxed(&ring->dr_tail);
+		while (tail < head) {
+			len = DLOG_RING_SIZE - tail % DLOG_RING_SIZE;
+			if (len > head - tail)
+				len = head - tail;
+			if (len > LOG_BUF_SIZE / 2)
+				len = LOG_BUF_SIZE / 2;
+
+			d_log_write(&ring->dr_buf[tail % DLOG_RING_SIZE], len, false);
+			tail += len;
+			nob += len;
+		}
+		atomic_store_release(&ring->dr_tail, tail);
+
+		dropped = atomic_load_relaxed(&ring->dr_dropped);
+		if (dropped != ring->dr_dropped_seen) {
+			len = snprintf(note, sizeof(note), "%s dlog: thread %u dropped "DF_U64
+				       " messages, ring is full\n", mst.uts.nodename, ring->dr_tid,
+				       dropped - ring->dr_dropped_seen);
+			d_log_write(note, len, false);
+			ring->dr_dropped_seen = dropped;
+		}
+
+		if (orphan) {
+			d_list_del(&ring->dr_link);
+			free(ring);
+		}
+	}
+
+	return nob;
+}
+
+/* the owner thread is exiting, hand the ring over to the drainer */
+static void
+dlog_ring_orphan(void *arg)
+{
+	struct dlog_ring *ring = arg;
+
+	/* anything logged by the remaining destructors of the thread is written directly */
+	dlog_tls_ring   = NULL;
+	dlog_tls_exited = true;
+	atomic_store_release(&ring->dr_orphan, true);
+}
+
+static struct dlog_ring *
+dlog_ring_get(void)
+{
+	struct dlog_ring *ring;
+
+	if (dlog_tls_ring != NULL)
+		return dlog_tls_ring;
+	if (dlog_tls_exited)
+		return NULL;
+
+	ring = calloc(1, sizeof(*ring));
+	if (ring == NULL)
+		return NULL;
+	ring->dr_tid = (uint32_t)syscall(SYS_gettid);
+
+	clog_lock();
+	d_list_add_tail(&ring->dr_link, &dlog_rings);
+	clog_unlock();
+
+	(void)pthread_setspecific(dlog_ring_key, ring);
+	dlog_tls_ring = ring;
+	return ring;
+}
+
+/**
+ * Copy one formatted message into the ring of the calling thread. If the ring
+ * is full the message is dropped and accounted, unless @important is true, in
+ * which case the caller drains all the rings and writes the message itself,
+ * under clogmux, so that it is neither lost nor reordered.
+ */
+static void
+dlog_ring_put(struct dlog_ring *ring, char *msg, int len, bool important)
+{
+	uint64_t	head = atomic_load_relaxed(&ring->dr_head);
+	uint64_t	off;
+	int		part;
+
+	if (head + len - atomic_load_explicit(&ring->dr_tail, memory_order_acquire) >
+	    DLOG_RING_SIZE) {
+		if (!important) {
+			atomic_fetch_add_relaxed(&ring->dr_dropped, 1);
+			return;
+		}
+		clog_lock();
+		dlog_rings_drain();
+		d_log_write(msg, len, true);
+		clog_unlock();
+		return;
+	}
+
+	off  = head % DLOG_RING_SIZE;
+	part = DLOG_RING_SIZE - off;
+	if (part > len)
+		part = len;
+	memcpy(&ring->dr_buf[off], msg, part);
+	if (part < len)
+		memcpy(ring->dr_buf, msg + part, len - part);
+	atomic_store_release(&ring->dr_head, head + len);
+}
+
+static void *
+dlog_writer_main(void *arg)
+{
+	int nob;
+
+	while (!atomic_load_relaxed(&dlog_writer_stop)) {
+		clog_lock();
+		nob = dlog_rings_drain();
+		if (nob > 0)
+			d_log_write(NULL, 0, true);
+		clog_unlock();
+
+		if (nob == 0)
+			usleep(DLOG_WRITER_IDLE_US);
+	}
+
+	return NULL;
+}
+
+/* hold clogmux across fork(), so the child does not inherit it locked by a thread it lacks */
+static void
+dlog_atfork_prepare(void)
+{
+	clog_lock();
+}
+
+static void
+dlog_atfork_parent(void)
+{
+	clog_unlock();
+}
+
+static void
+dlog_atfork_child(void)
+{
+	struct dlog_ring *ring;
+	struct dlog_ring *tmp;
+
+	/* the parent writes whatever is in the rings, free those of the threads left behind */
+	d_list_for_each_entry_safe(ring, tmp, &dlog_rings, dr_link) {
+		if (ring == dlog_tls_ring) {
+			atomic_store_relaxed(&ring->dr_tail, atomic_load_relaxed(&ring->dr_head));
+			ring->dr_dropped_seen = atomic_load_relaxed(&ring->dr_dropped);
+			ring->dr_tid = (uint32_t)syscall(SYS_gettid);
+			continue;
+		}
+		d_list_del(&ring->dr_link);
+		free(ring);
+	}
+
+	/* the writer thread is not copied by fork() */
+	if (atomic_load_relaxed(&mst.log_async)) {
+		atomic_store_relaxed(&mst.log_async, false);
+		dlog_async_start();
+	}
+	clog_unlock();
+}
+
+static void
+dlog_ring_key_init(void)
+{
+	dlog_ring_key_rc = pthread_key_create(&dlog_ring_key, dlog_ring_orphan);
+	if (dlog_ring_key_rc != 0)
+		return;
+
+	dlog_ring_key_rc = pthread_atfork(dlog_atfork_prepare, dlog_atfork_parent,
+					  dlog_atfork_child);
+	if (dlog_ring_key_rc != 0)
+		(void)pthread_key_delete(dlog_ring_key);
+}
+
+/*
+ * called with clogmux held, fall back to synchronous mode on failure, which is
+ * also how the child of fork() carries on if it cannot start a writer thread
+ */
+static void
+dlog_async_start(void)
+{
+	int rc;
+
+	/* the key is never deleted, the rings cached by live threads outlive a stop */
+	(void)pthread_once(&dlog_ring_once, dlog_ring_key_init);
+	if (dlog_ring_key_rc != 0) {
+		dlog_print_err(dlog_ring_key_rc,
+			       "failed to set up log rings, use synchronous log\n");
+		return;
+	}
+
+	atomic_store_relaxed(&dlog_writer_stop, false);
+	rc = pthread_create(&dlog_writer, NULL, dlog_writer_main, NULL);
+	if (rc != 0) {
+		dlog_print_err(rc, "failed to create log writer, use synchronous log\n");
+		return;
+	}
+
+	atomic_store_release(&mst.log_async, true);
+}
+
+/*
+ * Switch back to synchronous mode, stop the writer thread and drain the rings.
+ * The rings are kept, see dlog_ring_get(), anything a racing thread still puts
+ * into its ring is written by the next drain.
+ */
+static void
+dlog_async_stop(void)
+{
+	if (!atomic_load_relaxed(&mst.log_async))
+		return;
+
+	atomic_store_release(&mst.log_async, false);
+	atomic_store_relaxed(&dlog_writer_stop, true);
+	pthread_join(dlog_writer, NULL);
+
+	clog_lock();
+	dlog_rings_drain();
+	clog_unlock();
+}
+
 void
 d_log_sync(void)
 {
 	int rc = 0;
 
 	clog_lock();
+	dlog_rings_drain();
 	if (mst.log_buf_nob > 0) /* write back the in-flight buffer */
 		rc = d_log_write(NULL, 0, true);
 
@@ -565,10 +856,12 @@ void d_vlog(int flags, const char *fmt, va_list ap)
 	uint64_t uid = 0;
 	int fac, lvl, pri;
 	bool flush;
+	bool async;
+	struct dlog_ring *ring;
 	char *b_nopt1hdr;
 	char facstore[16], *facstr;
 	struct timeval tv;
-	struct tm *tm;
+	struct tm tm_buf, *tm;
 	unsigned int hlen_pt1, hlen, mlen, tlen;
 	/*
 	 * since we ignore any potential errors in CLOG let's always re-set
@@ -613,8 +906,12 @@ void d_vlog(int flags, const char *fmt, va_list ap)
 
 	/*
 	 * we must log it, start computing the parts of the log we'll need.
+	 * In asynchronous mode the message is formatted in the thread-local
+	 * buffer without the lock, and only queued to the ring of this thread.
 	 */
-	clog_lock();		/* lock out other threads */
+	async = atomic_load_explicit(&mst.log_async, memory_order_acquire);
+	if (!async)
+		clog_lock();	/* lock out other threads */
 	if (d_log_xst.dlog_facs[fac].fac_aname) {
 		facstr = d_log_xst.dlog_facs[fac].fac_aname;
 	} else {
@@ -622,10 +919,11 @@ void d_vlog(int flags, const char *fmt, va_list ap)
 		facstr = facstore;
 	}
 	(void)gettimeofday(&tv, 0);
-	tm = localtime(&tv.tv_sec);
+	tm = localtime_r(&tv.tv_sec, &tm_buf);
 	if (tm == NULL) {
 		dlog_print_err(errno, "localtime returned NULL\n");
-		clog_unlock();
+		if (!async)
+			clog_unlock();
 		return;
 	}
 
@@ -668,7 +966,8 @@ void d_vlog(int flags, const char *fmt, va_list ap)
 	 * check for it anyway.
 	 */
 	if (hlen + 1 >= sizeof(b)) {
-		clog_unlock();	/* drop lock, this is the only early exit */
+		if (!async)
+			clog_unlock();	/* drop lock, this is the only early exit */
 		dlog_print_err(E2BIG,
 			       "header overflowed %zd byte buffer (%d)\n",
 			       sizeof(b), hlen + 1);
@@ -707,18 +1006,26 @@ void d_vlog(int flags, const char *fmt, va_list ap)
 	 * NB: flush to logfile if the message is important (warning/error...)
 	 * or the last flush was 1+ second ago.
 	 */
-	if (mst.flush_pri == DLOG_DBG)
-		flush = true;
-	else
-		flush = (lvl >= mst.flush_pri) || (tv.tv_sec > last_flush);
-	if (flush)
-		last_flush = tv.tv_sec;
+	ring = async ? dlog_ring_get() : NULL;
+	if (ring != NULL) {
+		/* debug messages are dropped if the ring is full, not the important ones */
+		dlog_ring_put(ring, b, tlen, lvl >= mst.flush_pri);
+	} else {
+		if (async)
+			clog_lock();	/* no ring, fall back to synchronous write */
+		if (mst.flush_pri == DLOG_DBG)
+			flush = true;
+		else
+			flush = (lvl >= mst.flush_pri) || (tv.tv_sec > last_flush);
+		if (flush)
+			last_flush = tv.tv_sec;
 
-	rc = d_log_write(b, tlen, flush);
-	if (rc < 0)
-		errno = save_errno;
+		rc = d_log_write(b, tlen, flush);
+		if (rc < 0)
+			errno = save_errno;
 
-	clog_unlock();		/* drop lock here */
+		clog_unlock();	/* drop lock here */
+	}
 	/*
 	 * log it to stderr and/or stdout.  skip part one of the header
 	 * if the output channel is a tty
@@ -839,6 +1146,7 @@ d_log_open(char *tag, int maxfac_hint, int default_mask, int stderr_mask,
 	int		tagblen;
 	char		*newtag = NULL, *cp;
 	int		truncate = 0, rc;
+	bool		async = false;
 	char		*env;
 	char		*buffer = NULL;
 	uint64_t	log_size = LOG_SIZE_DEF;
@@ -889,6 +1197,11 @@ d_log_open(char *tag, int maxfac_hint, int default_mask, int stderr_mask,
 		mst.append_rank = true;
 	d_freeenv_str(&env);
 
+	d_agetenv_str(&env, D_LOG_ASYNC_ENV);
+	if (env != NULL && atoi(env) > 0)
+		async = true;
+	d_freeenv_str(&env);
+
 	/* quick sanity check (mst.tag is non-null if already open) */
 	if (d_log_xst.tag || !tag ||
 	    (maxfac_hint < 0) || (default_mask & ~DLOG_PRIMASK) ||
@@ -998,6 +1311,8 @@ d_log_open(char *tag, int maxfac_hint, int default_mask, int stderr_mask,
 	mst.stdout_isatty = isatty(fileno(stdout));
 	mst.stderr_isatty = isatty(fileno(stderr));
 	d_log_xst.tag = newtag;
+	if (async && mst.log_fd >= 0)
+		dlog_async_start();
 	clog_unlock();
 
 	/* ensure buffer+log flush upon exit in case fini routine not
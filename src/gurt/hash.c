@@ -13,6 +13,17 @@
 #include <gurt/list.h>
 #include <gurt/hash.h>
 
+/** maximum bits of resizable hash table */
+#define D_HASH_RESIZE_BITS_MAX	28
+/** grow resizable hash table if the average chain is longer than this */
+#define D_HASH_RESIZE_GROW	2
+/** shrink resizable hash table if it has less records than 1/this buckets */
+#define D_HASH_RESIZE_SHRINK	8
+/** number of buckets migrated by each hash operation while rehashing */
+#define D_HASH_REHASH_STEP	4
+
+#define CH_MASK(bits)		((1U << (bits)) - 1)
+
 enum d_hash_lru {
 	D_HASH_LRU_TAIL = -1,
 	D_HASH_LRU_NONE =  0,
@@ -219,14 +230,14 @@ d_hash_jump(uint64_t key, uint32_t num_buckets)
  ******************************************************************************/
 
 /**
- * Lock the hash table
+ * Lock the bucket(s) of \a hash.
  *
  * Note: if hash table is using rwlock, it only takes read lock for
  * reference-only operations and caller should protect refcount.
  * see D_HASH_FT_RWLOCK for the details.
  */
 static inline void
-ch_bucket_lock(struct d_hash_table *htable, uint32_t idx, bool read_only)
+ch_bucket_lock(struct d_hash_table *htable, uint32_t hash, bool read_only)
 {
 	union d_hash_lock *lock;
 
@@ -234,7 +245,8 @@ ch_bucket_lock(struct d_hash_table *htable, uint32_t idx, bool read_only)
 		return;
 
 	lock = (htable->ht_feats & D_HASH_FT_GLOCK)
-		? &htable->ht_lock : &htable->ht_locks[idx];
+		? &htable->ht_lock
+		: &htable->ht_locks[hash & CH_MASK(htable->ht_lock_bits)];
 	if (htable->ht_feats & D_HASH_FT_MUTEX) {
 		D_MUTEX_LOCK(&lock->mutex);
 	} else if (htable->ht_feats & D_HASH_FT_RWLOCK) {
@@ -247,9 +259,9 @@ ch_bucket_lock(struct d_hash_table *htable, uint32_t idx, bool read_only)
 	}
 }
 
-/** unlock the hash table */
+/** unlock the bucket(s) of \a hash */
 static inline void
-ch_bucket_unlock(struct d_hash_table *htable, uint32_t idx, bool read_only)
+ch_bucket_unlock(struct d_hash_table *htable, uint32_t hash, bool read_only)
 {
 	union d_hash_lock *lock;
 
@@ -257,7 +269,8 @@ ch_bucket_unlock(struct d_hash_table *htable, uint32_t idx, bool read_only)
 		return;
 
 	lock = (htable->ht_feats & D_HASH_FT_GLOCK)
-		? &htable->ht_lock : &htable->ht_locks[idx];
+		? &htable->ht_lock
+		: &htable->ht_locks[hash & CH_MASK(htable->ht_lock_bits)];
 	if (htable->ht_feats & D_HASH_FT_MUTEX)
 		D_MUTEX_UNLOCK(&lock->mutex);
 	else if (htable->ht_feats & D_HASH_FT_RWLOCK)
@@ -266,6 +279,61 @@ ch_bucket_unlock(struct d_hash_table *htable, uint32_t idx, bool read_only)
 		D_SPIN_UNLOCK(&lock->spin);
 }
 
+/** number of bucket locks, it is also the number of lock stripes */
+static inline uint32_t
+ch_lock_nr(struct d_hash_table *htable)
+{
+	if (htable->ht_feats & D_HASH_FT_NOLOCK)
+		return 0;
+
+	if (htable->ht_feats & D_HASH_FT_GLOCK)
+		return 1;
+
+	return 1U << htable->ht_lock_bits;
+}
+
+/** lock all buckets of the hash table */
+static void
+ch_bucket_lock_all(struct d_hash_table *htable)
+{
+	uint32_t nr = ch_lock_nr(htable);
+	uint32_t i;
+
+	for (i = 0; i < nr; i++)
+		ch_bucket_lock(htable, i, false);
+}
+
+static void
+ch_bucket_unlock_all(struct d_hash_table *htable)
+{
+	uint32_t nr = ch_lock_nr(htable);
+	uint32_t i;
+
+	for (i = 0; i < nr; i++)
+		ch_bucket_unlock(htable, i, false);
+}
+
+/**
+ * Return the bucket of \a hash, the caller should hold the bucket lock.
+ *
+ * While a resizable table is being rehashed, buckets of ht_buckets below
+ * ht_rehash_idx have been migrated to ht_buckets_new. The migration of a
+ * bucket holds the same lock as all records of the bucket, so the result
+ * is stable for the lock holder.
+ */
+static inline struct d_hash_bucket *
+ch_bucket(struct d_hash_table *htable, uint32_t hash)
+{
+	uint32_t idx = hash & CH_MASK(htable->ht_bits);
+
+	if (htable->ht_buckets_new != NULL &&
+	    idx < atomic_load_relaxed(&htable->ht_rehash_idx))
+		return &htable->ht_buckets_new[hash &
+					       CH_MASK(htable->ht_rehash_bits)];
+
+	return &htable->ht_buckets[idx];
+}
+
 /**
  * wrappers for member functions.
  */
@@ -284,35 +352,27 @@ ch_key_init(struct d_hash_table *htable, d_list_t *link, void *arg)
 }
 
 /**
- * Convert key to hash bucket id.
+ * Hash the key, see ch_bucket() for converting the hash to bucket.
  *
  * It calls DJB2 hash if no customized hash function is provided.
  */
 static inline uint32_t
 ch_key_hash(struct d_hash_table *htable, const void *key, unsigned int ksize)
 {
-	uint32_t idx;
-
 	if (htable->ht_ops->hop_key_hash)
-		idx = htable->ht_ops->hop_key_hash(htable, key, ksize);
-	else
-		idx = d_hash_string_u32((const char *)key, ksize);
+		return htable->ht_ops->hop_key_hash(htable, key, ksize);
 
-	return idx & ((1U << htable->ht_bits) - 1);
+	return d_hash_string_u32((const char *)key, ksize);
 }
 
 static inline uint32_t
 ch_rec_hash(struct d_hash_table *htable, d_list_t *link)
 {
-	uint32_t idx = 0;
-
 	if (htable->ht_ops->hop_rec_hash)
-		idx = htable->ht_ops->hop_rec_hash(htable, link);
-	else
-		D_ASSERT(htable->ht_feats &
-			 (D_HASH_FT_NOLOCK | D_HASH_FT_GLOCK));
+		return htable->ht_ops->hop_rec_hash(htable, link);
 
-	return idx & ((1U << htable->ht_bits) - 1);
+	D_ASSERT(htable->ht_feats & (D_HASH_FT_NOLOCK | D_HASH_FT_GLOCK));
+	return 0;
 }
 
 static inline void
@@ -341,6 +401,8 @@ ch_rec_insert(struct d_hash_table *htable, struct d_hash_bucket *bucket,
 	      d_list_t *link)
 {
 	d_list_add(link, &bucket->hb_head);
+	if (htable->ht_feats & D_HASH_FT_RESIZE)
+		atomic_fetch_add_relaxed(&htable->ht_rec_nr, 1);
 #if D_HASH_DEBUG
 	htable->ht_nr++;
 	if (htable->ht_nr > htable->ht_nr_max)
@@ -376,12 +438,14 @@ static inline void
 ch_rec_delete(struct d_hash_table *htable, d_list_t *link)
 {
 	d_list_del_init(link);
+	if (htable->ht_feats & D_HASH_FT_RESIZE)
+		atomic_fetch_sub_relaxed(&htable->ht_rec_nr, 1);
 #if D_HASH_DEBUG
 	htable->ht_nr--;
 	if (htable->ht_ops->hop_rec_hash) {
 		struct d_hash_bucket *bucket;
 
-		bucket = &htable->ht_buckets[ch_rec_hash(htable, link)];
+		bucket = ch_bucket(htable, ch_rec_hash(htable, link));
 		bucket->hb_dep--;
 	}
 #endif
@@ -429,6 +493,180 @@ ch_rec_find(struct d_hash_table *htable, struct d_hash_bucket *bucket,
 	return NULL;
 }
 
+/**
+ * Decide the new size of resizable table, return the current bits if it
+ * should not be resized.
+ */
+static uint32_t
+ch_resize_bits(struct d_hash_table *htable)
+{
+	uint32_t bits = htable->ht_bits;
+	uint32_t nr   = atomic_load_relaxed(&htable->ht_rec_nr);
+
+	if (nr > (D_HASH_RESIZE_GROW << bits) && bits < D_HASH_RESIZE_BITS_MAX)
+		return bits + 1;
+
+	if (nr < ((1U << bits) / D_HASH_RESIZE_SHRINK) &&
+	    bits > htable->ht_lock_bits)
+		return bits - 1;
+
+	return bits;
+}
+
+/** allocate the new buckets, and start to migrate records to them */
+static void
+ch_rehash_start(struct d_hash_table *htable, uint32_t bits)
+{
+	struct d_hash_bucket	*buckets;
+	uint32_t		 nr = 1U << bits;
+	uint32_t		 i;
+
+	D_ALLOC_ARRAY(buckets, nr);
+	if (buckets == NULL) {
+		/* not fatal, the table just keeps the current size */
+		D_DEBUG(DB_TRACE, "Failed to resize hash table %p to %u bits\n",
+			htable, bits);
+		return;
+	}
+
+	for (i = 0; i < nr; i++)
+		D_INIT_LIST_HEAD(&buckets[i].hb_head);
+
+	ch_bucket_lock_all(htable);
+	htable->ht_buckets_new = buckets;
+	htable->ht_rehash_bits = bits;
+	atomic_store_relaxed(&htable->ht_rehash_idx, 0);
+	ch_bucket_unlock_all(htable);
+
+	D_DEBUG(DB_TRACE, "Resize hash table %p from %u to %u bits, records %u\n",
+		htable, htable->ht_bits, bits,
+		atomic_load_relaxed(&htable->ht_rec_nr));
+}
+
+/** all buckets have been migrated, switch to the new buckets */
+static void
+ch_rehash_finish(struct d_hash_table *htable)
+{
+	struct d_hash_bucket *buckets;
+
+	ch_bucket_lock_all(htable);
+	buckets		       = htable->ht_buckets;
+	htable->ht_buckets     = htable->ht_buckets_new;
+	htable->ht_bits	       = htable->ht_rehash_bits;
+	htable->ht_buckets_new = NULL;
+	atomic_store_relaxed(&htable->ht_rehash_idx, 0);
+	ch_bucket_unlock_all(htable);
+
+	D_FREE(buckets);
+}
+
+/**
+ * Move records of bucket \a idx to the new buckets.
+ *
+ * The lock of \a idx also protects the new buckets of these records,
+ * because both sizes are multiple of the number of locks.
+ */
+static void
+ch_rehash_bucket(struct d_hash_table *htable, uint32_t idx)
+{
+	struct d_hash_bucket	*bucket;
+	d_list_t		*link;
+	d_list_t		*next;
+	uint32_t		 mask = CH_MASK(htable->ht_rehash_bits);
+
+	ch_bucket_lock(htable, idx, false);
+
+	bucket = &htable->ht_buckets[idx];
+	d_list_for_each_safe(link, next, &bucket->hb_head) {
+		d_list_move_tail(link, &htable->ht_buckets_new[
+				 ch_rec_hash(htable, link) & mask].hb_head);
+	}
+	atomic_store_relaxed(&htable->ht_rehash_idx, idx + 1);
+
+	ch_bucket_unlock(htable, idx, false);
+}
+
+/**
+ * Drive the resizing of the hash table: start a resize if the load factor
+ * is out of range, or migrate a few buckets if a resize is in progress.
+ *
+ * The caller should not hold any bucket lock. Only one thread can migrate
+ * buckets at a time, other threads just skip the migration.
+ */
+static void
+ch_rehash_step(struct d_hash_table *htable)
+{
+	uint32_t bits;
+	uint32_t idx;
+	uint32_t nr;
+	int	 i;
+
+	if (!(htable->ht_feats & D_HASH_FT_RESIZE))
+		return;
+
+	if (!(htable->ht_feats & D_HASH_FT_NOLOCK) &&
+	    pthread_spin_trylock(&htable->ht_rehash_lock) != 0)
+		return;
+
+	if (htable->ht_buckets_new == NULL) {
+		bits = ch_resize_bits(htable);
+		if (bits != htable->ht_bits)
+			ch_rehash_start(htable, bits);
+		goto out;
+	}
+
+	nr  = 1U << htable->ht_bits;
+	idx = atomic_load_relaxed(&htable->ht_rehash_idx);
+	for (i = 0; i < D_HASH_REHASH_STEP && idx < nr; i++, idx++)
+		ch_rehash_bucket(htable, idx);
+
+	if (idx == nr)
+		ch_rehash_finish(htable);
+out:
+	if (!(htable->ht_feats & D_HASH_FT_NOLOCK))
+		pthread_spin_unlock(&htable->ht_rehash_lock);
+}
+
+/**
+ * Call \a cb for records of all buckets protected by the same lock as
+ * \a idx, or all records if the table has no bucket lock. While the table
+ * is being rehashed, it walks both the old and the new buckets.
+ */
+static int
+ch_lock_traverse(struct d_hash_table *htable, uint32_t idx,
+		 d_hash_traverse_cb_t cb, void *arg)
+{
+	struct d_hash_bucket	*buckets[2];
+	uint32_t		 nrs[2];
+	uint32_t		 step = ch_lock_nr(htable);
+	d_list_t		*link;
+	d_list_t		*next;
+	uint32_t		 i;
+	int			 j;
+	int			 rc;
+
+	if (step <= 1) {
+		step = 1;
+		idx  = 0;
+	}
+
+	buckets[0] = htable->ht_buckets;
+	nrs[0]	   = 1U << htable->ht_bits;
+	buckets[1] = htable->ht_buckets_new;
+	nrs[1]	   = 1U << htable->ht_rehash_bits;
+
+	for (j = 0; j < 2 && buckets[j] != NULL; j++) {
+		for (i = idx; i < nrs[j]; i += step) {
+			d_list_for_each_safe(link, next, &buckets[j][i].hb_head) {
+				rc = cb(link, arg);
+				if (rc)
+					return rc;
+			}
+		}
+	}
+	return 0;
+}
+
 bool
 d_hash_rec_unlinked(d_list_t *link)
 {
@@ -441,20 +679,19 @@ d_hash_rec_find(struct d_hash_table *htable, const void *key,
 {
 	struct d_hash_bucket	*bucket;
 	d_list_t		*link;
-	uint32_t		 idx;
+	uint32_t		 hash;
 	bool			 is_lru = (htable->ht_feats & D_HASH_FT_LRU);
 
 	D_ASSERT(key != NULL && ksize != 0);
-	idx = ch_key_hash(htable, key, ksize);
-	bucket = &htable->ht_buckets[idx];
-
-	ch_bucket_lock(htable, idx, !is_lru);
+	hash = ch_key_hash(htable, key, ksize);
+	ch_bucket_lock(htable, hash, !is_lru);
+	bucket = ch_bucket(htable, hash);
 
 	link = ch_rec_find(htable, bucket, key, ksize, D_HASH_LRU_HEAD);
 	if (link != NULL)
 		ch_rec_addref(htable, link);
 
-	ch_bucket_unlock(htable, idx, !is_lru);
+	ch_bucket_unlock(htable, hash, !is_lru);
 	return link;
 }
 
@@ -464,14 +701,13 @@ d_hash_rec_insert(struct d_hash_table *htable, const void *key,
 {
 	struct d_hash_bucket	*bucket;
 	d_list_t		*tmp;
-	uint32_t		 idx;
+	uint32_t		 hash;
 	int			 rc = 0;
 
 	D_ASSERT(key != NULL && ksize != 0);
-	idx = ch_key_hash(htable, key, ksize);
-	bucket = &htable->ht_buckets[idx];
-
-	ch_bucket_lock(htable, idx, false);
+	hash = ch_key_hash(htable, key, ksize);
+	ch_bucket_lock(htable, hash, false);
+	bucket = ch_bucket(htable, hash);
 
 	if (exclusive) {
 		tmp = ch_rec_find(htable, bucket, key, ksize, D_HASH_LRU_NONE);
@@ -483,7 +719,9 @@ d_hash_rec_insert(struct d_hash_table *htable, const void *key,
 	ch_rec_insert_addref(htable, bucket, link);
 
 out_unlock:
-	ch_bucket_unlock(htable, idx, false);
+	ch_bucket_unlock(htable, hash, false);
+	if (rc == 0)
+		ch_rehash_step(htable);
 	return rc;
 }
 
@@ -493,13 +731,12 @@ d_hash_rec_find_insert(struct d_hash_table *htable, const void *key,
 {
 	struct d_hash_bucket	*bucket;
 	d_list_t		*tmp;
-	uint32_t		 idx;
+	uint32_t		 hash;
 
 	D_ASSERT(key != NULL && ksize != 0);
-	idx = ch_key_hash(htable, key, ksize);
-	bucket = &htable->ht_buckets[idx];
-
-	ch_bucket_lock(htable, idx, false);
+	hash = ch_key_hash(htable, key, ksize);
+	ch_bucket_lock(htable, hash, false);
+	bucket = ch_bucket(htable, hash);
 
 	tmp = ch_rec_find(htable, bucket, key, ksize, D_HASH_LRU_HEAD);
 	if (tmp) {
@@ -508,9 +745,13 @@ d_hash_rec_find_insert(struct d_hash_table *htable, const void *key,
 		D_GOTO(out_unlock, 0);
 	}
 	ch_rec_insert_addref(htable, bucket, link);
+	ch_bucket_unlock(htable, hash, false);
+
+	ch_rehash_step(htable);
+	return link;
 
 out_unlock:
-	ch_bucket_unlock(htable, idx, false);
+	ch_bucket_unlock(htable, hash, false);
 	return link;
 }
 
@@ -518,9 +759,7 @@ int
 d_hash_rec_insert_anonym(struct d_hash_table *htable, d_list_t *link,
 			 void *arg)
 {
-	struct d_hash_bucket	*bucket;
-	uint32_t		 idx;
-	uint32_t		 nr = 1U << htable->ht_bits;
+	uint32_t		 hash;
 	bool			 need_lock = !(htable->ht_feats & D_HASH_FT_NOLOCK);
 	bool			 need_keyinit_lock;
 
@@ -530,34 +769,26 @@ d_hash_rec_insert_anonym(struct d_hash_table *htable, d_list_t *link,
 	need_keyinit_lock = !(htable->ht_feats & D_HASH_FT_NO_KEYINIT_LOCK);
 	if (need_lock && need_keyinit_lock) {
 		/* Lock all buckets because of unknown key yet */
-		for (idx = 0; idx < nr; idx++) {
-			ch_bucket_lock(htable, idx, false);
-			if (htable->ht_feats & D_HASH_FT_GLOCK)
-				break;
-		}
+		ch_bucket_lock_all(htable);
 	}
 
 	/* has no key, hash table should have provided key generator */
 	ch_key_init(htable, link, arg);
-	idx = ch_rec_hash(htable, link);
-	bucket = &htable->ht_buckets[idx];
+	hash = ch_rec_hash(htable, link);
 
 	if (need_lock && !need_keyinit_lock)
-		ch_bucket_lock(htable, idx, false);
+		ch_bucket_lock(htable, hash, false);
 
-	ch_rec_insert_addref(htable, bucket, link);
+	ch_rec_insert_addref(htable, ch_bucket(htable, hash), link);
 
 	if (need_lock) {
-		if (!need_keyinit_lock) {
-			ch_bucket_unlock(htable, idx, false);
-		} else {
-			for (idx = 0; idx < nr; idx++) {
-				ch_bucket_unlock(htable, idx, false);
-				if (htable->ht_feats & D_HASH_FT_GLOCK)
-					break;
-			}
-		}
+		if (!need_keyinit_lock)
+			ch_bucket_unlock(htable, hash, false);
+		else
+			ch_bucket_unlock_all(htable);
 	}
+
+	ch_rehash_step(htable);
 	return 0;
 }
 
@@ -567,15 +798,14 @@ d_hash_rec_delete(struct d_hash_table *htable, const void *key,
 {
 	struct d_hash_bucket	*bucket;
 	d_list_t		*link;
-	uint32_t		 idx;
+	uint32_t		 hash;
 	bool			 deleted = false;
 	bool			 zombie  = false;
 
 	D_ASSERT(key != NULL && ksize != 0);
-	idx = ch_key_hash(htable, key, ksize);
-	bucket = &htable->ht_buckets[idx];
-
-	ch_bucket_lock(htable, idx, false);
+	hash = ch_key_hash(htable, key, ksize);
+	ch_bucket_lock(htable, hash, false);
+	bucket = ch_bucket(htable, hash);
 
 	link = ch_rec_find(htable, bucket, key, ksize, D_HASH_LRU_NONE);
 	if (link != NULL) {
@@ -583,24 +813,26 @@ d_hash_rec_delete(struct d_hash_table *htable, const void *key,
 		deleted = true;
 	}
 
-	ch_bucket_unlock(htable, idx, false);
+	ch_bucket_unlock(htable, hash, false);
 
 	if (zombie)
 		ch_rec_free(htable, link);
+	if (deleted)
+		ch_rehash_step(htable);
 	return deleted;
 }
 
 bool
 d_hash_rec_delete_at(struct d_hash_table *htable, d_list_t *link)
 {
-	uint32_t idx = 0;
+	uint32_t hash = 0;
 	bool	 deleted = false;
 	bool	 zombie  = false;
 	bool	 need_lock = !(htable->ht_feats & D_HASH_FT_NOLOCK);
 
 	if (need_lock) {
-		idx = ch_rec_hash(htable, link);
-		ch_bucket_lock(htable, idx, false);
+		hash = ch_rec_hash(htable, link);
+		ch_bucket_lock(htable, hash, false);
 	}
 
 	if (!d_list_empty(link)) {
@@ -609,10 +841,12 @@ d_hash_rec_delete_at(struct d_hash_table *htable, d_list_t *link)
 	}
 
 	if (need_lock)
-		ch_bucket_unlock(htable, idx, false);
+		ch_bucket_unlock(htable, hash, false);
 
 	if (zombie)
 		ch_rec_free(htable, link);
+	if (deleted)
+		ch_rehash_step(htable);
 	return deleted;
 }
 
@@ -622,20 +856,19 @@ d_hash_rec_evict(struct d_hash_table *htable, const void *key,
 {
 	struct d_hash_bucket	*bucket;
 	d_list_t		*link;
-	uint32_t		 idx;
+	uint32_t		 hash;
 
 	if (!(htable->ht_feats & D_HASH_FT_LRU))
 		return false;
 
 	D_ASSERT(key != NULL && ksize != 0);
-	idx = ch_key_hash(htable, key, ksize);
-	bucket = &htable->ht_buckets[idx];
-
-	ch_bucket_lock(htable, idx, false);
+	hash = ch_key_hash(htable, key, ksize);
+	ch_bucket_lock(htable, hash, false);
+	bucket = ch_bucket(htable, hash);
 
 	link = ch_rec_find(htable, bucket, key, ksize, D_HASH_LRU_TAIL);
 
-	ch_bucket_unlock(htable, idx, false);
+	ch_bucket_unlock(htable, hash, false);
 	return link != NULL;
 }
 
@@ -643,54 +876,53 @@ bool
 d_hash_rec_evict_at(struct d_hash_table *htable, d_list_t *link)
 {
 	struct d_hash_bucket	*bucket;
-	uint32_t		 idx;
+	uint32_t		 hash;
 	bool			 evicted = false;
 
 	if (!(htable->ht_feats & D_HASH_FT_LRU))
 		return false;
 
-	idx = ch_rec_hash(htable, link);
-	bucket = &htable->ht_buckets[idx];
-
-	ch_bucket_lock(htable, idx, false);
+	hash = ch_rec_hash(htable, link);
+	ch_bucket_lock(htable, hash, false);
+	bucket = ch_bucket(htable, hash);
 
 	if (link != bucket->hb_head.prev) {
 		d_list_move_tail(link, &bucket->hb_head);
 		evicted = true;
 	}
 
-	ch_bucket_unlock(htable, idx, false);
+	ch_bucket_unlock(htable, hash, false);
 	return evicted;
 }
 
 void
 d_hash_rec_addref(struct d_hash_table *htable, d_list_t *link)
 {
-	uint32_t idx = 0;
+	uint32_t hash = 0;
 	bool	 need_lock = !(htable->ht_feats & D_HASH_FT_NOLOCK);
 
 	if (need_lock) {
-		idx = ch_rec_hash(htable, link);
-		ch_bucket_lock(htable, idx, true);
+		hash = ch_rec_hash(htable, link);
+		ch_bucket_lock(htable, hash, true);
 	}
 
 	ch_rec_addref(htable, link);
 
 	if (need_lock)
-		ch_bucket_unlock(htable, idx, true);
+		ch_bucket_unlock(htable, hash, true);
 }
 
 void
 d_hash_rec_decref(struct d_hash_table *htable, d_list_t *link)
 {
-	uint32_t idx = 0;
+	uint32_t hash = 0;
 	bool	 need_lock = !(htable->ht_feats & D_HASH_FT_NOLOCK);
 	bool	 ephemeral = (htable->ht_feats & D_HASH_FT_EPHEMERAL);
 	bool	 zombie;
 
 	if (need_lock) {
-		idx = ch_rec_hash(htable, link);
-		ch_bucket_lock(htable, idx, !ephemeral);
+		hash = ch_rec_hash(htable, link);
+		ch_bucket_lock(htable, hash, !ephemeral);
 	}
 
 	zombie = ch_rec_decref(htable, link);
@@ -700,24 +932,27 @@ d_hash_rec_decref(struct d_hash_table *htable, d_list_t *link)
 	D_ASSERT(!zombie || d_list_empty(link));
 
 	if (need_lock)
-		ch_bucket_unlock(htable, idx, !ephemeral);
+		ch_bucket_unlock(htable, hash, !ephemeral);
 
-	if (zombie)
+	if (zombie) {
 		ch_rec_free(htable, link);
+		if (ephemeral)
+			ch_rehash_step(htable);
+	}
 }
 
 int
 d_hash_rec_ndecref(struct d_hash_table *htable, int count, d_list_t *link)
 {
-	uint32_t idx = 0;
+	uint32_t hash = 0;
 	bool	 need_lock = !(htable->ht_feats & D_HASH_FT_NOLOCK);
 	bool	 ephemeral = (htable->ht_feats & D_HASH_FT_EPHEMERAL);
 	bool	 zombie = false;
 	int	 rc = 0;
 
 	if (need_lock) {
-		idx = ch_rec_hash(htable, link);
-		ch_bucket_lock(htable, idx, !ephemeral);
+		hash = ch_rec_hash(htable, link);
+		ch_bucket_lock(htable, hash, !ephemeral);
 	}
 
 	if (htable->ht_ops->hop_rec_ndecref) {
@@ -743,10 +978,13 @@ d_hash_rec_ndecref(struct d_hash_table *htable, int count, d_list_t *link)
 	}
 
 	if (need_lock)
-		ch_bucket_unlock(htable, idx, !ephemeral);
+		ch_bucket_unlock(htable, hash, !ephemeral);
 
-	if (zombie)
+	if (zombie) {
 		ch_rec_free(htable, link);
+		if (ephemeral)
+			ch_rehash_step(htable);
+	}
 	return rc;
 }
 
@@ -791,10 +1029,21 @@ d_hash_table_create_inplace(uint32_t feats, uint32_t bits, void *priv,
 	D_ASSERT(hops != NULL);
 	D_ASSERT(hops->hop_key_cmp != NULL);
 
-	htable->ht_feats = feats;
-	htable->ht_bits	 = bits;
-	htable->ht_ops	 = hops;
-	htable->ht_priv	 = priv;
+	if ((feats & D_HASH_FT_RESIZE) &&
+	    (hops->hop_rec_hash == NULL || bits > D_HASH_RESIZE_BITS_MAX)) {
+		D_ERROR("Resizable hash table requires hop_rec_hash() and "
+			"no more than %d bits\n", D_HASH_RESIZE_BITS_MAX);
+		return -DER_INVAL;
+	}
+
+	htable->ht_feats     = feats;
+	htable->ht_bits	     = bits;
+	htable->ht_lock_bits = bits;
+	htable->ht_ops	     = hops;
+	htable->ht_priv	     = priv;
+	htable->ht_buckets_new = NULL;
+	atomic_store_relaxed(&htable->ht_rec_nr, 0);
+	atomic_store_relaxed(&htable->ht_rehash_idx, 0);
 
 	if (hops->hop_rec_hash == NULL && !(feats & D_HASH_FT_NOLOCK)) {
 		htable->ht_feats |= D_HASH_FT_GLOCK;
@@ -813,6 +1062,13 @@ d_hash_table_create_inplace(uint32_t feats, uint32_t bits, void *priv,
 	if (htable->ht_feats & D_HASH_FT_NOLOCK)
 		D_GOTO(out, rc = 0);
 
+	if (htable->ht_feats & D_HASH_FT_RESIZE) {
+		rc = D_SPIN_INIT(&htable->ht_rehash_lock,
+				 PTHREAD_PROCESS_PRIVATE);
+		if (rc)
+			D_GOTO(free_buckets, rc);
+	}
+
 	if (htable->ht_feats & D_HASH_FT_GLOCK) {
 		if (htable->ht_feats & D_HASH_FT_MUTEX)
 			rc = D_MUTEX_INIT(&htable->ht_lock.mutex, NULL);
@@ -822,11 +1078,11 @@ d_hash_table_create_inplace(uint32_t feats, uint32_t bits, void *priv,
 			rc = D_SPIN_INIT(&htable->ht_lock.spin,
 					 PTHREAD_PROCESS_PRIVATE);
 		if (rc)
-			D_GOTO(free_buckets, rc);
+			D_GOTO(free_rehash_lock, rc);
 	} else {
 		D_ALLOC_ARRAY(htable->ht_locks, nr);
 		if (htable->ht_locks == NULL)
-			D_GOTO(free_buckets, rc = -DER_NOMEM);
+			D_GOTO(free_rehash_lock, rc = -DER_NOMEM);
 
 		for (i = 0; i < nr; i++) {
 			if (htable->ht_feats & D_HASH_FT_MUTEX)
@@ -856,6 +1112,9 @@ free_locks:
 			D_SPIN_DESTROY(&htable->ht_locks[i].spin);
 	}
 	D_FREE(htable->ht_locks);
+free_rehash_lock:
+	if (htable->ht_feats & D_HASH_FT_RESIZE)
+		D_SPIN_DESTROY(&htable->ht_rehash_lock);
 free_buckets:
 	D_FREE(htable->ht_buckets);
 out:
@@ -886,9 +1145,7 @@ int
 d_hash_table_traverse(struct d_hash_table *htable, d_hash_traverse_cb_t cb,
 		      void *arg)
 {
-	struct d_hash_bucket	*bucket;
-	d_list_t		*link;
-	uint32_t		 nr = 1U << htable->ht_bits;
+	uint32_t		 nr = max(ch_lock_nr(htable), 1U);
 	uint32_t		 idx;
 	int			 rc = 0;
 
@@ -903,25 +1160,24 @@ d_hash_table_traverse(struct d_hash_table *htable, d_hash_traverse_cb_t cb,
 	}
 
 	for (idx = 0; idx < nr && !rc; idx++) {
-		d_list_t *linkn;
-
-		bucket = &htable->ht_buckets[idx];
 		ch_bucket_lock(htable, idx, true);
-		d_list_for_each_safe(link, linkn, &bucket->hb_head) {
-			rc = cb(link, arg);
-			if (rc)
-				break;
-		}
+		rc = ch_lock_traverse(htable, idx, cb, arg);
 		ch_bucket_unlock(htable, idx, true);
 	}
 out:
 	return rc;
 }
 
+static int
+d_hash_is_empty_cb(d_list_t *link, void *arg)
+{
+	return 1;
+}
+
 static bool
 d_hash_table_is_empty(struct d_hash_table *htable)
 {
-	uint32_t	 nr = 1U << htable->ht_bits;
+	uint32_t	 nr = max(ch_lock_nr(htable), 1U);
 	uint32_t	 idx;
 	bool		 is_empty = true;
 
@@ -933,7 +1189,8 @@ d_hash_table_is_empty(struct d_hash_table *htable)
 
 	for (idx = 0; idx < nr && is_empty; idx++) {
 		ch_bucket_lock(htable, idx, true);
-		is_empty = d_list_empty(&htable->ht_buckets[idx].hb_head);
+		is_empty = ch_lock_traverse(htable, idx, d_hash_is_empty_cb,
+					    NULL) == 0;
 		ch_bucket_unlock(htable, idx, true);
 	}
 
@@ -955,6 +1212,26 @@ d_hash_table_destroy_inplace(struct d_hash_table *htable, bool force)
 		D_GOTO(out, 0);
 	}
 
+	if (htable->ht_feats & D_HASH_FT_RESIZE) {
+		if (!force && !d_hash_table_is_empty(htable)) {
+			D_DEBUG(DB_TRACE, "Warning, non-empty hash\n");
+			D_GOTO(out, rc = -DER_BUSY);
+		}
+		/* stop resizing, then drain both old and new buckets */
+		htable->ht_feats &= ~D_HASH_FT_RESIZE;
+		if (!(htable->ht_feats & D_HASH_FT_NOLOCK))
+			D_SPIN_DESTROY(&htable->ht_rehash_lock);
+
+		if (htable->ht_buckets_new != NULL) {
+			for (i = 0; i < (1U << htable->ht_rehash_bits); i++) {
+				bucket = &htable->ht_buckets_new[i];
+				while (!d_list_empty(&bucket->hb_head))
+					d_hash_rec_delete_at(htable, bucket->hb_head.next);
+			}
+			D_FREE(htable->ht_buckets_new);
+		}
+	}
+
 	for (i = 0; i < nr; i++) {
 		bucket = &htable->ht_buckets[i];
 		while (!d_list_empty(&bucket->hb_head)) {
@@ -969,6 +1246,8 @@ d_hash_table_destroy_inplace(struct d_hash_table *htable, bool force)
 	if (htable->ht_feats & D_HASH_FT_NOLOCK)
 		D_GOTO(free_buckets, rc = 0);
 
+	nr = 1U << htable->ht_lock_bits;
+
 	if (htable->ht_feats & D_HASH_FT_GLOCK) {
 		if (htable->ht_feats & D_HASH_FT_MUTEX)
 			D_MUTEX_DESTROY(&htable->ht_lock.mutex);
@@ -15,6 +15,7 @@
 #include <malloc.h>
 #include <gurt/common.h>
 #include <gurt/list.h>
+#include <gurt/atomic.h>
 #include <sys/shm.h>
 #include <sys/types.h>
 #include <daos/common.h>
@@ -1520,6 +1521,125 @@ d_tm_node_unlock(struct d_tm_node_t *node) {
 		D_MUTEX_UNLOCK(&node->dtn_lock);
 }
 
+/**
+ * Per-thread shard of a sharded metric, one cache line so that the writers
+ * on different threads do not bounce it. Threads are assigned to the shards
+ * round-robin, so a shard can still be shared when there are more than
+ * D_TM_SHARD_NR writer threads, hence the atomics.
+ */
+struct d_tm_shard {
+	ATOMIC uint64_t		dts_value;
+	ATOMIC uint64_t		dts_min;
+	ATOMIC uint64_t		dts_max;
+	ATOMIC uint64_t		dts_sum;
+	ATOMIC double		dts_sum_of_squares;
+	ATOMIC uint64_t		dts_sample_size;
+	/** start of the interval being measured by a duration */
+	struct timespec		dts_start;
+};
+
+D_CASSERT(sizeof(struct d_tm_shard) == D_TM_SHARD_SIZE);
+
+static ATOMIC uint32_t	tm_shard_next;
+static __thread int	tm_shard_idx = -1;
+
+static inline struct d_tm_shard *
+d_tm_shard_get(struct d_tm_node_t *metric)
+{
+	if (unlikely(tm_shard_idx < 0))
+		tm_shard_idx = atomic_fetch_add_relaxed(&tm_shard_next, 1) % D_TM_SHARD_NR;
+
+	return &metric->dtn_metric->dtm_shards[tm_shard_idx];
+}
+
+static void
+d_tm_shards_reset(struct d_tm_shard *shards)
+{
+	int	i;
+
+	memset(shards, 0, D_TM_SHARD_NR * sizeof(*shards));
+	for (i = 0; i < D_TM_SHARD_NR; i++)
+		atomic_store_relaxed(&shards[i].dts_min, UINT64_MAX);
+}
+
+/** Same as d_tm_compute_stats() but for the shard of a sharded metric */
+static void
+d_tm_shard_compute_stats(struct d_tm_shard *shard, uint64_t value)
+{
+	uint64_t	cur;
+	double		sos;
+
+	atomic_fetch_add_relaxed(&shard->dts_sample_size, 1);
+	atomic_fetch_add_relaxed(&shard->dts_sum, value);
+
+	sos = atomic_load_relaxed(&shard->dts_sum_of_squares);
+	while (!atomic_compare_exchange(&shard->dts_sum_of_squares, sos,
+					sos + (double)(value * value)))
+		;
+
+	cur = atomic_load_relaxed(&shard->dts_max);
+	while (value > cur && !atomic_compare_exchange(&shard->dts_max, cur, value))
+		;
+
+	cur = atomic_load_relaxed(&shard->dts_min);
+	while (value < cur && !atomic_compare_exchange(&shard->dts_min, cur, value))
+		;
+}
+
+/**
+ * Sum up the shards of a sharded metric. The min, max, sum, sum of squares
+ * and sample size are merged into \a stats if it is not NULL, mean and
+ * standard deviation are left to the caller.
+ */
+static void
+d_tm_shards_read(struct d_tm_shard *shards, uint64_t *val, struct d_tm_stats_t *stats)
+{
+	struct d_tm_stats_t	merged = {.dtm_min = UINT64_MAX};
+	uint64_t		value = 0;
+	uint64_t		samples;
+	int			i;
+
+	for (i = 0; i < D_TM_SHARD_NR; i++) {
+		value += atomic_load_relaxed(&shards[i].dts_value);
+		if (stats == NULL)
+			continue;
+
+		samples = atomic_load_relaxed(&shards[i].dts_sample_size);
+		if (samples == 0)
+			continue;
+
+		merged.sample_size += samples;
+		merged.dtm_sum += atomic_load_relaxed(&shards[i].dts_sum);
+		merged.sum_of_squares += atomic_load_relaxed(&shards[i].dts_sum_of_squares);
+		merged.dtm_min = min(merged.dtm_min, atomic_load_relaxed(&shards[i].dts_min));
+		merged.dtm_max = max(merged.dtm_max, atomic_load_relaxed(&shards[i].dts_max));
+	}
+
+	if (val != NULL)
+		*val = value;
+
+	if (stats != NULL) {
+		if (merged.sample_size == 0)
+			merged.dtm_min = 0;
+		stats->dtm_min = merged.dtm_min;
+		stats->dtm_max = merged.dtm_max;
+		stats->dtm_sum = merged.dtm_sum;
+		stats->sum_of_squares = merged.sum_of_squares;
+		stats->sample_size = merged.sample_size;
+	}
+}
+
+/** Compute mean and standard deviation from the merged shard stats */
+static void
+d_tm_stats_finish(struct d_tm_stats_t *stats)
+{
+	stats->mean = 0;
+	if (stats->sample_size > 0)
+		stats->mean = (double)stats->dtm_sum / stats->sample_size;
+	stats->std_dev = d_tm_compute_standard_dev(stats->sum_of_squares, stats->sample_size,
+						   stats->mean);
+}
+
 /**
  * Prints the \a stats to the \a stream
  *
@@ -1555,6 +1675,7 @@ _reset_node(struct d_tm_context *ctx, struct d_tm_node_t *node)
 	struct d_tm_metric_t	*metric_data = NULL;
 	struct d_tm_stats_t	*dtm_stats = NULL;
 	struct d_tm_histogram_t *dtm_histogram = NULL;
+	struct d_tm_shard	*dtm_shards = NULL;
 	struct d_tm_shmem_hdr	*shmem = NULL;
 	int			 rc;
 
@@ -1571,10 +1692,13 @@ _reset_node(struct d_tm_context *ctx, struct d_tm_node_t *node)
 
 	dtm_stats = conv_ptr(shmem, metric_data->dtm_stats);
 	dtm_histogram = conv_ptr(shmem, metric_data->dtm_histogram);
+	dtm_shards = conv_ptr(shmem, metric_data->dtm_shards);
 	d_tm_node_lock(node);
 	memset(&metric_data->dtm_data, 0, sizeof(metric_data->dtm_data));
 	if (dtm_stats != NULL)
 		memset(dtm_stats, 0, sizeof(*dtm_stats));
+	if (dtm_shards != NULL)
+		d_tm_shards_reset(dtm_shards);
 
 	if (dtm_histogram != NULL) {
 		int i;
@@ -1842,7 +1966,8 @@ d_tm_compute_histogram(struct d_tm_node_t *node, uint64_t value)
 }
 
 /**
- * Set the given counter to the specified \a value
+ * Set the given counter to the specified \a value. For a sharded counter, it
+ * only sets the share of the calling thread.
  *
  * \param[in]	metric	Pointer to the metric
  * \param[in]	value	Sets the counter to this \a value
@@ -1859,6 +1984,11 @@ d_tm_set_counter(struct d_tm_node_t *metric, uint64_t value)
 		return;
 	}
 
+	if (metric->dtn_metric->dtm_shards != NULL) {
+		atomic_store_relaxed(&d_tm_shard_get(metric)->dts_value, value);
+		return;
+	}
+
 	d_tm_node_lock(metric);
 	metric->dtn_metric->dtm_data.value = value;
 	d_tm_node_unlock(metric);
@@ -1882,6 +2012,11 @@ d_tm_inc_counter(struct d_tm_node_t *metric, uint64_t value)
 		return;
 	}
 
+	if (metric->dtn_metric->dtm_shards != NULL) {
+		atomic_fetch_add_relaxed(&d_tm_shard_get(metric)->dts_value, value);
+		return;
+	}
+
 	d_tm_node_lock(metric);
 	metric->dtn_metric->dtm_data.value += value;
 	d_tm_node_unlock(metric);
@@ -1992,6 +2127,11 @@ d_tm_mark_duration_start(struct d_tm_node_t *metric, int clk_id)
 
 	metric->dtn_type = D_TM_DURATION | clk_id;
 
+	if (metric->dtn_metric->dtm_shards != NULL) {
+		clock_gettime(d_tm_clock_id(clk_id), &d_tm_shard_get(metric)->dts_start);
+		return;
+	}
+
 	d_tm_node_lock(metric);
 	clock_gettime(d_tm_clock_id(metric->dtn_type & ~D_TM_DURATION),
 		      &metric->dtn_metric->dtm_data.tms[1]);
@@ -2008,9 +2148,11 @@ d_tm_mark_duration_start(struct d_tm_node_t *metric, int clk_id)
 void
 d_tm_mark_duration_end(struct d_tm_node_t *metric)
 {
-	struct timespec	end;
-	struct timespec	*tms;
-	uint64_t	us;
+	struct d_tm_shard	*shard;
+	struct timespec		 end;
+	struct timespec		*tms;
+	struct timespec		 interval;
+	uint64_t		 us;
 
 	if (metric == NULL)
 		return;
@@ -2022,6 +2164,18 @@ d_tm_mark_duration_end(struct d_tm_node_t *metric)
 		return;
 	}
 
+	if (metric->dtn_metric->dtm_shards != NULL) {
+		shard = d_tm_shard_get(metric);
+		clock_gettime(d_tm_clock_id(metric->dtn_type & ~D_TM_DURATION), &end);
+		interval = d_timediff(shard->dts_start, end);
+		/* the last interval is shared, whoever stores it last wins */
+		metric->dtn_metric->dtm_data.tms[0] = interval;
+		us = (interval.tv_sec * 1000000) + (interval.tv_nsec / 1000);
+		d_tm_shard_compute_stats(shard, us);
+		d_tm_compute_histogram(metric, us);
+		return;
+	}
+
 	d_tm_node_lock(metric);
 	clock_gettime(d_tm_clock_id(metric->dtn_type & ~D_TM_DURATION), &end);
 	metric->dtn_metric->dtm_data.tms[0] =
@@ -2054,7 +2208,7 @@ has_stats(struct d_tm_node_t *metric)
 }
 
 /**
- * Set an arbitrary \a value for the gauge.
+ * Set an arbitrary \a value for the gauge
  *
  * \param[in,out]	metric	Pointer to the metric
  * \param[in]		value	Set the gauge to this value
@@ -2272,9 +2426,22 @@ add_metric(struct d_tm_context *ctx, struct d_tm_node_t **node, int metric_type,
 	char			*token;
 	char			*rest;
 	char			*unit_string;
+	bool			 sharded;
 	int			buff_len;
 	int			rc = 0;
 
+	sharded = metric_type & D_TM_SHARDED;
+	metric_type &= ~D_TM_SHARDED;
+	/*
+	 * A gauge can't be sharded: its value and stats depend on the total,
+	 * which no single shard knows when it is updated.
+	 */
+	if (sharded && metric_type != D_TM_COUNTER && !(metric_type & D_TM_DURATION)) {
+		D_ERROR("Metric type 0x%x cannot be sharded\n", metric_type);
+		rc = -DER_INVAL;
+		goto out;
+	}
+
 	rest = path;
 	parent_node = d_tm_get_root(ctx);
 	token = strtok_r(rest, "/", &rest);
@@ -2320,6 +2487,21 @@ add_metric(struct d_tm_context *ctx, struct d_tm_node_t **node, int metric_type,
 		}
 	}
 
+	metric->dtm_shards = NULL;
+	if (sharded) {
+		void	*mem;
+
+		/* align the shards to the cache line */
+		mem = shmalloc(shmem, D_TM_SHARDS_BYTES);
+		if (mem == NULL) {
+			rc = -DER_NO_SHMEM;
+			goto out;
+		}
+		metric->dtm_shards = (struct d_tm_shard *)D_ALIGNUP((uint64_t)mem,
+								    D_TM_SHARD_SIZE);
+		d_tm_shards_reset(conv_ptr(shmem, metric->dtm_shards));
+	}
+
 	buff_len = 0;
 	if (desc != NULL)
 		buff_len = strnlen(desc, D_TM_MAX_DESC_LEN);
@@ -3216,7 +3398,9 @@ d_tm_init_histogram(struct d_tm_node_t *node, char *path, int num_buckets,
 		dth_buckets[i].dtb_min = min;
 		dth_buckets[i].dtb_max = max;
 
-		rc = d_tm_add_metric(&dth_buckets[i].dtb_bucket, D_TM_COUNTER,
+		rc = d_tm_add_metric(&dth_buckets[i].dtb_bucket,
+				     metric->dtm_shards != NULL ? D_TM_COUNTER | D_TM_SHARDED :
+								  D_TM_COUNTER,
 				     meta_data, "elements", fullpath);
 		D_FREE(fullpath);
 		D_FREE(meta_data);
@@ -3405,6 +3589,12 @@ d_tm_get_counter(struct d_tm_context *ctx, uint64_t *val,
 			return -DER_METRIC_NOT_FOUND;
 	}
 
+	if (metric_data->dtm_shards != NULL) {
+		d_tm_shards_read(ctx == NULL ? metric_data->dtm_shards :
+				 conv_ptr(shmem, metric_data->dtm_shards), val, NULL);
+		return DER_SUCCESS;
+	}
+
 	d_tm_node_lock(node);
 	*val = metric_data->dtm_data.value;
 	d_tm_node_unlock(node);
@@ -3568,6 +3758,16 @@ d_tm_get_duration(struct d_tm_context *ctx, struct timespec *tms,
 		return -DER_METRIC_NOT_FOUND;
 
 	dtm_stats = conv_ptr(shmem, metric_data->dtm_stats);
+	if (metric_data->dtm_shards != NULL) {
+		tms->tv_sec = metric_data->dtm_data.tms[0].tv_sec;
+		tms->tv_nsec = metric_data->dtm_data.tms[0].tv_nsec;
+		if (stats != NULL) {
+			d_tm_shards_read(conv_ptr(shmem, metric_data->dtm_shards), NULL, stats);
+			d_tm_stats_finish(stats);
+		}
+		return DER_SUCCESS;
+	}
+
 	d_tm_node_lock(node);
 	tms->tv_sec = metric_data->dtm_data.tms[0].tv_sec;
 	tms->tv_nsec = metric_data->dtm_data.tms[0].tv_nsec;
@@ -13,7 +13,9 @@
 #include <stdio.h>
 #include <unistd.h>
 #include <fcntl.h>
+#include <sys/wait.h>
 #include <pthread.h>
+#include <inttypes.h>
 #include "wrap_cmocka.h"
 #include <gurt/common.h>
 #include <gurt/list.h>
@@ -744,6 +746,211 @@ test_log(void **state)
 	d_log_fini();
 }
 
+#define TEST_LOG_ASYNC_THREADS	8
+#define TEST_LOG_ASYNC_INFO	(D_ON_VALGRIND ? 1000 : 20000)
+#define TEST_LOG_ASYNC_ERR	50
+
+static void *
+log_async_thread(void *arg)
+{
+	int	id = (int)(intptr_t)arg;
+	int	i;
+
+	/* flood the ring with INFO messages, which may be dropped, but not the ERR ones */
+	for (i = 0; i < TEST_LOG_ASYNC_INFO; i++) {
+		d_log(DLOG_INFO, "async-info %d %d\n", id, i);
+		if (i % (TEST_LOG_ASYNC_INFO / TEST_LOG_ASYNC_ERR) == 0)
+			d_log(DLOG_ERR, "async-err %d %d\n", id, i);
+	}
+
+	return NULL;
+}
+
+static void
+log_async_count(const char *path, int *info_nr, int *err_nr, uint64_t *dropped_nr,
+		int *reopen_nr)
+{
+	FILE		*fp;
+	char		*line = NULL;
+	size_t		 len = 0;
+	uint64_t	 dropped;
+	char		*p;
+
+	*info_nr = *err_nr = *reopen_nr = 0;
+	*dropped_nr = 0;
+
+	fp = fopen(path, "r");
+	assert_non_null(fp);
+	while (getline(&line, &len, fp) != -1) {
+		if (strstr(line, "async-info ") != NULL) {
+			(*info_nr)++;
+		} else if (strstr(line, "async-err ") != NULL) {
+			(*err_nr)++;
+		} else if (strstr(line, "async-reopen") != NULL) {
+			(*reopen_nr)++;
+		} else {
+			p = strstr(line, " dlog: thread ");
+			if (p != NULL && sscanf(p, " dlog: thread %*u dropped %" SCNu64, &dropped) == 1)
+				*dropped_nr += dropped;
+		}
+	}
+	free(line);
+	fclose(fp);
+}
+
+static void
+test_log_async(void **state)
+{
+	char		path[] = "/tmp/test_gurt_log_async.XXXXXX";
+	pthread_t	thread[TEST_LOG_ASYNC_THREADS];
+	int		flags = DLOG_FLV_LOGPID | DLOG_FLV_FAC | DLOG_FLV_TAG;
+	int		info_nr, err_nr, reopen_nr;
+	uint64_t	dropped_nr;
+	int		fd;
+	int		i, rc;
+
+	fd = mkstemp(path);
+	assert_true(fd >= 0);
+	close(fd);
+
+	/* the log is opened by init_tests(), reopen it in asynchronous mode */
+	d_log_fini();
+	setenv(D_LOG_ASYNC_ENV, "1", 1);
+
+	rc = d_log_init_adv("async", path, flags, DLOG_DBG, DLOG_EMERG, NULL);
+	assert_int_equal(rc, 0);
+
+	/* the ring of this thread is cached across the reopen below */
+	d_log(DLOG_INFO, "async-info main 0\n");
+	for (i = 0; i < TEST_LOG_ASYNC_THREADS; i++) {
+		rc = pthread_create(&thread[i], NULL, log_async_thread, (void *)(intptr_t)i);
+		assert_int_equal(rc, 0);
+	}
+	for (i = 0; i < TEST_LOG_ASYNC_THREADS; i++) {
+		rc = pthread_join(thread[i], NULL);
+		assert_int_equal(rc, 0);
+	}
+	d_log_fini();
+
+	rc = d_log_init_adv("async", path, flags, DLOG_DBG, DLOG_EMERG, NULL);
+	assert_int_equal(rc, 0);
+	d_log(DLOG_ERR, "async-reopen\n");
+	d_log_fini();
+
+	log_async_count(path, &info_nr, &err_nr, &dropped_nr, &reopen_nr);
+	print_message("async log: %d info messages, " DF_U64 " dropped\n", info_nr, dropped_nr);
+	/* every message is either in the log or accounted as dropped */
+	assert_int_equal(info_nr + dropped_nr, TEST_LOG_ASYNC_THREADS * TEST_LOG_ASYNC_INFO + 1);
+	/* important messages are never dropped */
+	assert_int_equal(err_nr, TEST_LOG_ASYNC_THREADS * TEST_LOG_ASYNC_ERR);
+	assert_int_equal(reopen_nr, 1);
+
+	unsetenv(D_LOG_ASYNC_ENV);
+	unlink(path);
+	rc = d_log_init();
+	assert_int_equal(rc, 0);
+}
+
+#define TEST_LOG_FORK_MSGS	100
+
+static pthread_key_t	log_late_key;
+
+/* log from a destructor which runs after the one of the log ring */
+static void
+log_late_destructor(void *arg)
+{
+	d_log(DLOG_ERR, "async-late %d\n", (int)(intptr_t)arg);
+	if ((intptr_t)arg == 1)
+		(void)pthread_setspecific(log_late_key, (void *)2);
+}
+
+static void *
+log_late_thread(void *arg)
+{
+	d_log(DLOG_INFO, "async-fork thread\n");
+	(void)pthread_setspecific(log_late_key, (void *)1);
+	return NULL;
+}
+
+static int
+log_count(const char *path, const char *msg)
+{
+	FILE	*fp;
+	char	*line = NULL;
+	size_t	 len = 0;
+	int	 nr = 0;
+
+	fp = fopen(path, "r");
+	assert_non_null(fp);
+	while (getline(&line, &len, fp) != -1) {
+		if (strstr(line, msg) != NULL)
+			nr++;
+	}
+	free(line);
+	fclose(fp);
+	return nr;
+}
+
+static void
+test_log_async_fork(void **state)
+{
+	char		path[] = "/tmp/test_gurt_log_fork.XXXXXX";
+	pthread_t	thread;
+	pid_t		pid;
+	int		status;
+	int		fd;
+	int		i, rc;
+
+	fd = mkstemp(path);
+	assert_true(fd >= 0);
+	close(fd);
+
+	d_log_fini();
+	setenv(D_LOG_ASYNC_ENV, "1", 1);
+
+	rc = d_log_init_adv("async", path, DLOG_FLV_LOGPID, DLOG_DBG, DLOG_EMERG, NULL);
+	assert_int_equal(rc, 0);
+
+	/* messages logged after the ring of an exiting thread is released */
+	rc = pthread_key_create(&log_late_key, log_late_destructor);
+	assert_int_equal(rc, 0);
+	rc = pthread_create(&thread, NULL, log_late_thread, NULL);
+	assert_int_equal(rc, 0);
+	rc = pthread_join(thread, NULL);
+	assert_int_equal(rc, 0);
+
+	/* the message in the ring of this thread is written once, by the parent */
+	d_log(DLOG_INFO, "async-fork before\n");
+	pid = fork();
+	assert_true(pid >= 0);
+	if (pid == 0) {
+		/* the child needs a writer thread of its own */
+		for (i = 0; i < TEST_LOG_FORK_MSGS; i++)
+			d_log(DLOG_INFO, "async-fork child %d\n", i);
+		d_log_fini();
+		_exit(0);
+	}
+	for (i = 0; i < TEST_LOG_FORK_MSGS; i++)
+		d_log(DLOG_INFO, "async-fork parent %d\n", i);
+	rc = waitpid(pid, &status, 0);
+	assert_int_equal(rc, pid);
+	assert_true(WIFEXITED(status));
+	assert_int_equal(WEXITSTATUS(status), 0);
+	d_log_fini();
+	pthread_key_delete(log_late_key);
+
+	assert_int_equal(log_count(path, "async-fork thread"), 1);
+	assert_int_equal(log_count(path, "async-late "), 2);
+	assert_int_equal(log_count(path, "async-fork before"), 1);
+	assert_int_equal(log_count(path, "async-fork parent "), TEST_LOG_FORK_MSGS);
+	assert_int_equal(log_count(path, "async-fork child "), TEST_LOG_FORK_MSGS);
+
+	unsetenv(D_LOG_ASYNC_ENV);
+	unlink(path);
+	rc = d_log_init();
+	assert_int_equal(rc, 0);
+}
+
 #define TEST_GURT_HASH_NUM_BITS (D_ON_VALGRIND ? 4 : 12)
 #define TEST_GURT_HASH_NUM_ENTRIES (1 << TEST_GURT_HASH_NUM_BITS)
 #define TEST_GURT_HASH_NUM_THREADS (D_ON_VALGRIND ? 4 : 16)
@@ -1770,6 +1977,80 @@ test_gurt_hash_parallel_refcounting(void **state)
 	_test_gurt_hash_parallel_refcounting(D_HASH_FT_LRU);
 }
 
+static void
+_test_gurt_hash_resize(uint32_t ht_feats)
+{
+	/* Start from a tiny table so it has to grow several times */
+	const int		  num_bits = 2;
+	struct d_hash_table	 *thtab;
+	struct test_hash_entry	**entries;
+	d_list_t		 *test;
+	uint32_t		  grown_bits;
+	int			  expected_count;
+	int			  i;
+	int			  rc;
+
+	entries = test_gurt_hash_alloc_items(TEST_GURT_HASH_NUM_ENTRIES);
+	assert_non_null(entries);
+
+	rc = d_hash_table_create(ht_feats | D_HASH_FT_RESIZE, num_bits, NULL,
+				 &th_ops, &thtab);
+	assert_int_equal(rc, 0);
+
+	/* Insert and look up the records in parallel while the table grows */
+	_test_gurt_hash_threaded_same_operations(hash_parallel_insert,
+						 thtab, entries);
+	grown_bits = thtab->ht_bits;
+	assert_true(grown_bits > num_bits);
+	_test_gurt_hash_threaded_same_operations(hash_parallel_lookup,
+						 thtab, entries);
+
+	/* Records being migrated are still reachable by traverse */
+	expected_count = TEST_GURT_HASH_NUM_ENTRIES;
+	rc = d_hash_table_traverse(thtab, test_gurt_hash_traverse_count_cb,
+				   &expected_count);
+	assert_int_equal(rc, 0);
+	assert_int_equal(expected_count, 0);
+
+	/* Remove most of the records */
+	for (i = 0; i < TEST_GURT_HASH_NUM_ENTRIES - 1; i++)
+		assert_true(d_hash_rec_delete(thtab, entries[i]->tl_key,
+					      TEST_GURT_HASH_KEY_LEN));
+
+	/* Drive the incremental rehash, the table should shrink */
+	for (i = 0; i < (1 << grown_bits); i++) {
+		rc = d_hash_rec_insert(thtab, entries[0]->tl_key,
+				       TEST_GURT_HASH_KEY_LEN,
+				       &entries[0]->tl_link, true);
+		assert_int_equal(rc, 0);
+		assert_true(d_hash_rec_delete(thtab, entries[0]->tl_key,
+					      TEST_GURT_HASH_KEY_LEN));
+	}
+	assert_true(thtab->ht_bits < grown_bits);
+	i = TEST_GURT_HASH_NUM_ENTRIES - 1;
+
+	test = d_hash_rec_find(thtab, entries[i]->tl_key,
+			       TEST_GURT_HASH_KEY_LEN);
+	assert_ptr_equal(test, &entries[i]->tl_link);
+
+	/* Not empty, cannot be destroyed without force */
+	rc = d_hash_table_destroy(thtab, false);
+	assert_int_equal(rc, -DER_BUSY);
+	rc = d_hash_table_destroy(thtab, true);
+	assert_int_equal(rc, 0);
+
+	test_gurt_hash_free_items(entries, TEST_GURT_HASH_NUM_ENTRIES);
+}
+
+static void
+test_gurt_hash_resize(void **state)
+{
+	_test_gurt_hash_resize(0);
+	_test_gurt_hash_resize(D_HASH_FT_EPHEMERAL);
+	_test_gurt_hash_resize(D_HASH_FT_RWLOCK);
+	_test_gurt_hash_resize(D_HASH_FT_MUTEX | D_HASH_FT_LRU);
+}
+
 
 #define NUM_THREADS 16
 
@@ -2705,6 +2986,8 @@ main(int argc, char **argv)
 	    cmocka_unit_test(test_gurt_hlist),
 	    cmocka_unit_test(test_binheap),
 	    cmocka_unit_test(test_log),
+	    cmocka_unit_test(test_log_async),
+	    cmocka_unit_test(test_log_async_fork),
 	    cmocka_unit_test(test_gurt_hash_empty),
 	    cmocka_unit_test(test_gurt_hash_insert_lookup_delete),
 	    cmocka_unit_test(test_gurt_hash_decref),
@@ -2712,6 +2995,7 @@ main(int argc, char **argv)
 	    cmocka_unit_test(test_gurt_hash_parallel_same_operations),
 	    cmocka_unit_test(test_gurt_hash_parallel_different_operations),
 	    cmocka_unit_test(test_gurt_hash_parallel_refcounting),
+	    cmocka_unit_test(test_gurt_hash_resize),
 	    cmocka_unit_test(test_gurt_atomic),
 	    cmocka_unit_test(test_gurt_string_buffer),
 	    cmocka_unit_test(test_d_rank_list_dup_sort_uniq),
@@ -337,8 +337,8 @@ test_duration_stats(void **state)
 	assert_true(stats.std_dev - 1743290.71012 < STATS_EPSILON);
 }
 
-static void
-check_bucket_counter(char *path, int bucket_id, uint64_t exp_val)
+static uint64_t
+get_bucket_counter(char *path, int bucket_id)
 {
 	struct d_tm_node_t	*node;
 	uint64_t		val;
@@ -352,7 +352,13 @@ check_bucket_counter(char *path, int bucket_id, uint64_t exp_val)
 	assert_non_null(node);
 	rc = d_tm_get_counter(cli_ctx, &val, node);
 	assert_rc_equal(rc, DER_SUCCESS);
-	assert_int_equal(val, exp_val);
+	return val;
+}
+
+static void
+check_bucket_counter(char *path, int bucket_id, uint64_t exp_val)
+{
+	assert_int_equal(get_bucket_counter(path, bucket_id), exp_val);
 }
 
 static void
@@ -622,6 +628,118 @@ test_gauge_with_histogram_multiplier_2(void **state)
 	check_histogram_metadata(path);
 }
 
+#define SHARDED_THREADS	8
+#define SHARDED_LOOPS	10000
+/* Start value of the gauge, it can't go below zero when every writer decrements first */
+#define SHARDED_GAUGE	(SHARDED_THREADS * SHARDED_LOOPS)
+
+struct sharded_arg {
+	struct d_tm_node_t	**sa_nodes;
+	int			  sa_idx;
+};
+
+static void *
+sharded_writer(void *arg)
+{
+	struct sharded_arg	 *sa = arg;
+	struct d_tm_node_t	**nodes = sa->sa_nodes;
+	int			  i;
+
+	for (i = 0; i < SHARDED_LOOPS; i++) {
+		d_tm_inc_counter(nodes[0], 1);
+
+		d_tm_mark_duration_start(nodes[1], D_TM_CLOCK_REALTIME);
+		d_tm_mark_duration_end(nodes[1]);
+
+		/* half of the threads increment the gauge, the other half decrement it */
+		if (sa->sa_idx % 2)
+			d_tm_dec_gauge(nodes[2], 1);
+		else
+			d_tm_inc_gauge(nodes[2], 1);
+	}
+
+	return NULL;
+}
+
+static void
+test_sharded_metrics(void **state)
+{
+	struct d_tm_node_t	*nodes[3];
+	struct sharded_arg	 args[SHARDED_THREADS];
+	struct d_tm_stats_t	 stats;
+	struct timespec		 tms;
+	pthread_t		 threads[SHARDED_THREADS];
+	uint64_t		 val;
+	char			*path = "gurt/sharded/duration";
+	int			 rc;
+	int			 i;
+
+	/* Kept out of gurt/tests so that test_verify_object_count is not affected */
+	rc = d_tm_add_metric(&nodes[0], D_TM_COUNTER | D_TM_SHARDED, NULL, NULL,
+			     "gurt/sharded/counter");
+	assert_rc_equal(rc, DER_SUCCESS);
+
+	rc = d_tm_add_metric(&nodes[1], D_TM_DURATION | D_TM_SHARDED, NULL, NULL, path);
+	assert_rc_equal(rc, DER_SUCCESS);
+
+	/* bucket 0 is [0 .. 4], bucket 1 is [5 .. UINT64_MAX] */
+	rc = d_tm_init_histogram(nodes[1], path, 2, 5, 1);
+	assert_rc_equal(rc, DER_SUCCESS);
+
+	/* Gauges can't be sharded, their stats need the total value */
+	rc = d_tm_add_metric(NULL, D_TM_GAUGE | D_TM_SHARDED, NULL, NULL,
+			     "gurt/sharded/gauge");
+	assert_rc_equal(rc, -DER_INVAL);
+	rc = d_tm_add_metric(NULL, D_TM_STATS_GAUGE | D_TM_SHARDED, NULL, NULL,
+			     "gurt/sharded/stats_gauge");
+	assert_rc_equal(rc, -DER_INVAL);
+	rc = d_tm_add_metric(NULL, D_TM_TIMESTAMP | D_TM_SHARDED, NULL, NULL,
+			     "gurt/sharded/timestamp");
+	assert_rc_equal(rc, -DER_INVAL);
+
+	/* Updated along with the sharded metrics, under the node lock */
+	rc = d_tm_add_metric(&nodes[2], D_TM_STATS_GAUGE, NULL, NULL, "gurt/sharded/gauge");
+	assert_rc_equal(rc, DER_SUCCESS);
+	d_tm_set_gauge(nodes[2], SHARDED_GAUGE);
+
+	for (i = 0; i < SHARDED_THREADS; i++) {
+		args[i].sa_nodes = nodes;
+		args[i].sa_idx = i;
+		rc = pthread_create(&threads[i], NULL, sharded_writer, &args[i]);
+		assert_int_equal(rc, 0);
+	}
+	for (i = 0; i < SHARDED_THREADS; i++)
+		pthread_join(threads[i], NULL);
+
+	rc = d_tm_get_counter(cli_ctx, &val, srv_to_cli_node(nodes[0]));
+	assert_rc_equal(rc, DER_SUCCESS);
+	assert_int_equal(val, SHARDED_THREADS * SHARDED_LOOPS);
+
+	/* The stats of the duration are merged from all the shards */
+	rc = d_tm_get_duration(cli_ctx, &tms, &stats, srv_to_cli_node(nodes[1]));
+	assert_rc_equal(rc, DER_SUCCESS);
+	assert_int_equal(stats.sample_size, SHARDED_THREADS * SHARDED_LOOPS);
+	assert_true(stats.dtm_min <= stats.dtm_max);
+	assert_true(stats.dtm_sum >= stats.dtm_max);
+
+	/* So are the bucket counters */
+	assert_int_equal(get_bucket_counter(path, 0) + get_bucket_counter(path, 1),
+			 SHARDED_THREADS * SHARDED_LOOPS);
+
+	/* The increments and decrements of different threads cancel out */
+	rc = d_tm_get_gauge(cli_ctx, &val, &stats, srv_to_cli_node(nodes[2]));
+	assert_rc_equal(rc, DER_SUCCESS);
+	assert_int_equal(val, SHARDED_GAUGE);
+	assert_int_equal(stats.sample_size, SHARDED_THREADS * SHARDED_LOOPS + 1);
+	assert_true(stats.dtm_min >= SHARDED_GAUGE / 2);
+	assert_true(stats.dtm_max <= SHARDED_GAUGE + SHARDED_GAUGE / 2);
+
+	d_tm_reset_node(cli_ctx, srv_to_cli_node(nodes[0]), 0, NULL, D_TM_STANDARD, 0, stdout);
+	rc = d_tm_get_counter(cli_ctx, &val, srv_to_cli_node(nodes[0]));
+	assert_rc_equal(rc, DER_SUCCESS);
+	assert_int_equal(val, 0);
+}
+
 static void
 test_units(void **state)
 {
@@ -1362,6 +1480,7 @@ main(int argc, char **argv)
 		cmocka_unit_test(test_duration_stats),
 		cmocka_unit_test(test_gauge_with_histogram_multiplier_1),
 		cmocka_unit_test(test_gauge_with_histogram_multiplier_2),
+		cmocka_unit_test(test_sharded_metrics),
 		cmocka_unit_test(test_units),
 		cmocka_unit_test(test_ephemeral_simple),
 		cmocka_unit_test(test_ephemeral_nested),
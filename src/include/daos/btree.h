@@ -616,6 +616,14 @@ void hkey_common_gen(d_iov_t *key_iov, void *hkey);
 int hkey_common_cmp(struct ktr_hkey *k1, struct ktr_hkey *k2);
 void hkey_int_gen(d_iov_t *key,  void *hkey);
 
+/**
+ * Count the leading records of \a rec_nr sorted integer key records (struct
+ * btr_record followed by the uint64_t key) at \a recs which are less than
+ * \a key. Used to search the nodes of BTR_FEAT_UINT_KEY trees, exported for
+ * unit tests.
+ */
+int dbtree_uint_count_lt(const void *recs, int rec_nr, uint64_t key);
+
 /******* iterator API ******************************************************/
 
 enum {
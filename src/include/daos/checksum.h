@@ -109,6 +109,10 @@ struct daos_csummer {
 	bool		 dcs_skip_key_verify;
 	bool		 dcs_skip_data_verify;
 	pthread_mutex_t	 dcs_lock;
+	/** Chunk checksums calculated ahead of time, looked up before the
+	 * data of an array value is walked (see struct dcs_precalc)
+	 */
+	struct dcs_precalc *dcs_precalc;
 };
 
 /**
@@ -542,6 +546,40 @@ void dcs_csum_info_list_fini(struct dcs_ci_list *list);
 int dcs_csum_info_save(struct dcs_ci_list *list, struct dcs_csum_info *info);
 struct dcs_csum_info *dcs_csum_info_get(struct dcs_ci_list *list, uint32_t idx);
 
+/**
+ * A dcs_precalc records chunk checksums that the caller calculated ahead of time, i.e. while EC
+ * encoding a full stripe and the data and parity cells are still in cache. Each checksum is keyed
+ * by the address and length of the bytes it covers, so when daos_csummer_calc_iods() later needs
+ * the checksum of exactly the same bytes it is copied instead of calculated again.
+ */
+struct dcs_precalc_ent {
+	uint8_t			*pe_buf;
+	uint64_t		 pe_len;
+	uint32_t		 pe_csum_off;
+};
+
+struct dcs_precalc {
+	/** private copy of the csummer used by dcs_precalc_add */
+	struct daos_csummer	*dp_csummer;
+	struct dcs_precalc_ent	*dp_ents;
+	uint8_t			*dp_csums;
+	uint32_t		 dp_nr;
+	uint32_t		 dp_cap;
+	uint16_t		 dp_csum_len;
+	bool			 dp_sorted;
+};
+
+/**
+ * Initialize \a pc to hold up to \a nr checksums calculated with the same algorithm and chunk
+ * size as \a csummer. dcs_precalc_fini must be called when done.
+ */
+int dcs_precalc_init(struct dcs_precalc *pc, struct daos_csummer *csummer, uint32_t nr);
+void dcs_precalc_fini(struct dcs_precalc *pc);
+/** Calculate and record the checksum of \a len bytes at \a buf */
+int dcs_precalc_add(struct dcs_precalc *pc, uint8_t *buf, uint64_t len);
+/** Return the checksum recorded for \a len bytes at \a buf, or NULL */
+uint8_t *dcs_precalc_find(struct dcs_precalc *pc, uint8_t *buf, uint64_t len);
+
 /**
  * change the iov so that buf points to the next csum_info, assuming the
  * current csum info's csum buf is right after it in the buffer.
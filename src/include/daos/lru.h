@@ -33,7 +33,9 @@ struct daos_llink {
 	d_list_t		 ll_link;	/**< LRU hash link */
 	d_list_t		 ll_qlink;	/**< Temp link for traverse */
 	uint32_t		 ll_ref;	/**< refcount for this ref */
-	uint32_t		 ll_evicted:1;	/**< has been evicted */
+	uint32_t		 ll_evicted:1,	/**< has been evicted */
+				 ll_front:1;	/**< in front cache, holding a refcount */
+	uint32_t		 ll_front_idx;	/**< slot index in front cache */
 	struct daos_llink_ops	*ll_ops;	/**< ops to maintain refs */
 };
 
@@ -46,6 +48,13 @@ struct daos_lru_cache {
 	d_list_t		 dlc_lru;	/**< list head of LRU */
 	struct d_hash_table	 dlc_htable;	/**< Hash table for all refs */
 	struct daos_llink_ops	*dlc_ops;	/**< ops to maintain refs */
+	/**
+	 * Optional direct-mapped front cache, the slot is selected by a caller provided
+	 * hint. Items in front cache hold an extra refcount, so they are never on the LRU
+	 * list, and a hit only bumps the refcount: no hash lookup, no list manipulation.
+	 */
+	struct daos_llink	**dlc_front;
+	uint32_t		 dlc_front_mask; /**< Front cache size - 1 */
 };
 
 /**
@@ -123,6 +132,79 @@ daos_lru_ref_release(struct daos_lru_cache *lcache, struct daos_llink *llink);
 void
 daos_lru_ref_flush(struct daos_lru_cache *lcache);
 
+/**
+ * Create the front cache for an LRU cache.
+ *
+ * \param[in] lcache		DAOS LRU cache
+ * \param[in] bits		power2(bits) is the number of front cache slots
+ *
+ * \return			0 on success and negative on failure.
+ */
+int
+daos_lru_front_create(struct daos_lru_cache *lcache, int bits);
+
+/**
+ * Put a held item into the front cache slot selected by \a hint, the front
+ * cache takes its own refcount on the item. The item previously in the slot
+ * is dropped from front cache, it goes back to the LRU list if it's unused.
+ *
+ * \param[in] lcache		DAOS LRU cache
+ * \param[in] hint		Front cache slot hint, must be stable for a key
+ * \param[in] llink		DAOS LRU item held by caller
+ *
+ * \return			true if another item was replaced.
+ */
+bool
+daos_lru_front_insert(struct daos_lru_cache *lcache, uint32_t hint,
+		      struct daos_llink *llink);
+
+/**
+ * Drop an item from front cache, caller must hold a refcount on the item.
+ *
+ * \param[in] lcache		DAOS LRU cache
+ * \param[in] llink		DAOS LRU item
+ */
+static inline void
+daos_lru_front_drop(struct daos_lru_cache *lcache, struct daos_llink *llink)
+{
+	if (!llink->ll_front)
+		return;
+
+	D_ASSERT(lcache->dlc_front[llink->ll_front_idx] == llink);
+	D_ASSERT(llink->ll_ref > 2);
+	lcache->dlc_front[llink->ll_front_idx] = NULL;
+	llink->ll_front = 0;
+	llink->ll_ref--;
+}
+
+/**
+ * Find a ref in the front cache and take its reference.
+ *
+ * \param[in] lcache		DAOS LRU cache
+ * \param[in] hint		Front cache slot hint
+ * \param[in] key		Key to take reference of
+ * \param[in] ksize		Size of the key
+ *
+ * \return			DAOS LRU link, NULL if not in front cache.
+ */
+static inline struct daos_llink *
+daos_lru_front_hold(struct daos_lru_cache *lcache, uint32_t hint, void *key,
+		    unsigned int ksize)
+{
+	struct daos_llink	*llink;
+
+	if (lcache->dlc_front == NULL)
+		return NULL;
+
+	llink = lcache->dlc_front[hint & lcache->dlc_front_mask];
+	if (llink == NULL || !llink->ll_ops->lop_cmp_keys(key, ksize, llink))
+		return NULL;
+
+	D_ASSERT(llink->ll_front && !llink->ll_evicted);
+	llink->ll_ref++;
+	return llink;
+}
+
 /**
  * Evict the item from LRU after releasing the last refcount on it.
  *
@@ -132,6 +214,7 @@ daos_lru_ref_flush(struct daos_lru_cache *lcache);
 static inline void
 daos_lru_ref_evict(struct daos_lru_cache *lcache, struct daos_llink *llink)
 {
+	daos_lru_front_drop(lcache, llink);
 	llink->ll_evicted = 1;
 	d_hash_rec_evict_at(&lcache->dlc_htable, &llink->ll_link);
 }
@@ -164,7 +247,8 @@ daos_lru_ref_add(struct daos_llink *llink)
 static inline bool
 daos_lru_is_last_user(struct daos_llink *llink)
 {
-	return llink->ll_ref <= 2;
+	/* One refcount held by the cache, and one more by front cache */
+	return llink->ll_ref <= 2 + llink->ll_front;
 }
 
 #endif
@@ -139,6 +139,20 @@ int pl_obj_find_rebuild(struct pl_map *map, uint32_t gl_layout_ver,
 			uint32_t rebuild_ver, uint32_t *tgt_rank,
 			uint32_t *shard_id, unsigned int array_size);
 
+/** Rebuild targets of one object returned by pl_obj_find_rebuild_batch() */
+struct pl_rebuild_range {
+	/** Index of the first target/shard of the object in the output arrays */
+	uint32_t	prr_start;
+	/** Number of shards of the object need to be rebuilt */
+	uint32_t	prr_nr;
+};
+
+int pl_obj_find_rebuild_batch(struct pl_map *map, uint32_t gl_layout_ver,
+			      struct daos_obj_md *mds, unsigned int md_nr,
+			      uint32_t rebuild_ver, uint32_t *tgt_rank,
+			      uint32_t *shard_id, unsigned int array_size,
+			      struct pl_rebuild_range *ranges);
+
 typedef struct pl_obj_shard *(*pl_get_shard_t)(void *data, int idx);
 
 static inline struct pl_obj_shard *
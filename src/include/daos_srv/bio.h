@@ -665,6 +665,27 @@ int bio_iod_prep(struct bio_desc *biod, unsigned int type, void *bulk_ctxt,
 int bio_iod_try_prep(struct bio_desc *biod, unsigned int type, void *bulk_ctxt,
 		     unsigned int bulk_perm);
 
+/**
+ * Prefetch version for BIO_IOD_TYPE_FETCH, the media reads for all the SG lists are issued
+ * concurrently (adjacent extents are coalesced into single read), but it returns without
+ * waiting for their completion, so that the caller can overlap other preparations (or the
+ * bulk transfer of landed SG lists) with the in-flight reads. bio_iod_wait() must be called
+ * before accessing the data of any SG list.
+ */
+int bio_iod_prefetch(struct bio_desc *biod, unsigned int type, void *bulk_ctxt,
+		     unsigned int bulk_perm);
+
+/**
+ * Wait for the data of the first (idx + 1) SG lists to land in the DMA buffer, it's a noop
+ * if the io descriptor isn't prepared by bio_iod_prefetch().
+ *
+ * \param biod       [IN]	io descriptor
+ * \param idx        [IN]	SG list index, negative value means all SG lists
+ *
+ * \return			Zero on success, negative value on read error
+ */
+int bio_iod_wait(struct bio_desc *biod, int idx);
+
 /*
  * Post operation after the RDMA transfer or local copy done for the io
  * descriptor.
@@ -994,6 +1015,7 @@ struct bio_wal_stats {
 	uint32_t	ws_size;	/* WAL size for single tx in bytes */
 	uint32_t	ws_qd;		/* WAL tx QD */
 	uint32_t	ws_waiters;	/* Waiters for WAL reclaiming */
+	uint32_t	ws_batch;	/* Transactions in WAL commit group, 0 for non-leader */
 };
 
 /*
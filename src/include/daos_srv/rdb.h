@@ -62,7 +62,10 @@
  * A query sees all (conflicting) updates committed (successfully) before its
  * rdb_tx_begin(). It may or may not see updates committed after its
  * rdb_tx_begin(). And, it currently does not see uncommitted updates, even
- * those in the same TX.
+ * those in the same TX. Query-only TXs begun with rdb_tx_begin_stale() may
+ * also be served by followers; their queries are only guaranteed to see updates
+ * committed more than a caller-specified staleness bound before their
+ * rdb_tx_begin_stale().
  *
  * Updates in a TX are queued, not revealed to queries, until rdb_tx_commit().
  * They are applied sequentially. If one update fails to apply, then the TX is
@@ -262,6 +265,7 @@ struct rdb_tx {
 
 /** TX methods */
 int rdb_tx_begin(struct rdb *db, uint64_t term, struct rdb_tx *tx);
+int rdb_tx_begin_stale(struct rdb *db, uint64_t staleness, struct rdb_tx *tx);
 int rdb_tx_begin_local(struct rdb_storage *storage, struct rdb_tx *tx);
 void rdb_tx_discard(struct rdb_tx *tx);
 int rdb_tx_commit(struct rdb_tx *tx);
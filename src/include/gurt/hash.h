@@ -205,6 +205,22 @@ enum d_hash_feats {
 	 */
 	D_HASH_FT_NO_KEYINIT_LOCK	= (1 << 5),
 
+	/**
+	 * The hash table is resizable, it doubles or halves the number of
+	 * buckets based on the number of records. Records are migrated to the
+	 * new buckets incrementally by the following hash operations, so no
+	 * operation pays the cost of rehashing the whole table.
+	 *
+	 * The \a bits of d_hash_table_create() is the minimum size of the
+	 * table and also decides the number of bucket locks, a lock protects
+	 * all buckets whose index has the same lower \a bits bits.
+	 *
+	 * Note: hop_rec_hash() is mandatory for this feature, and both
+	 * hop_key_hash() and hop_rec_hash() should return the full 32-bit
+	 * hash rather than a value masked by ht_bits.
+	 */
+	D_HASH_FT_RESIZE		= (1 << 6),
+
 	/**
 	 * Use Global Table Lock instead of per bucket locking.
 	 * TODO: should be removed when all will use per bucket locking.
@@ -248,6 +264,24 @@ struct d_hash_table {
 	struct d_hash_bucket	*ht_buckets;
 	/** different type of locks based on ht_feats */
 	union d_hash_lock	*ht_locks;
+	/** bits to generate number of bucket locks */
+	uint32_t		 ht_lock_bits;
+	/**
+	 * Resizable table only, number of records, it is used to decide
+	 * whether the table should be resized.
+	 */
+	ATOMIC uint32_t		 ht_rec_nr;
+	/**
+	 * Resizable table only, buckets of ht_buckets below this index have
+	 * been migrated to ht_buckets_new.
+	 */
+	ATOMIC uint32_t		 ht_rehash_idx;
+	/** Resizable table only, bits of ht_buckets_new */
+	uint32_t		 ht_rehash_bits;
+	/** Resizable table only, new buckets while rehashing, or NULL */
+	struct d_hash_bucket	*ht_buckets_new;
+	/** Resizable table only, serialize the bucket migration */
+	pthread_spinlock_t	 ht_rehash_lock;
 };
 
 /**
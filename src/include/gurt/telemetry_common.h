@@ -140,6 +140,13 @@ enum {
 	D_TM_CLOCK_THREAD_CPUTIME	= 0x200,
 	D_TM_LINK			= 0x400,
 	D_TM_MEMINFO			= 0x800,
+	/**
+	 * Only for d_tm_add_metric(), can be combined with D_TM_COUNTER or
+	 * D_TM_DURATION, but not with a gauge. Writers of a sharded
+	 * metric update the shard of the calling thread with atomics and never
+	 * take the node lock, readers sum up all the shards.
+	 */
+	D_TM_SHARDED			= 0x1000,
 	D_TM_ALL_NODES			= (D_TM_DIRECTORY | \
 					   D_TM_COUNTER | \
 					   D_TM_TIMESTAMP | \
@@ -215,6 +222,15 @@ struct d_tm_meminfo_t {
 	uint64_t fordblks;
 };
 
+/** Number of the per-thread shards of a sharded metric */
+#define D_TM_SHARD_NR			32
+/** Size of one shard, a cache line */
+#define D_TM_SHARD_SIZE			64
+/** Shared memory used by the shards of one sharded metric, including alignment */
+#define D_TM_SHARDS_BYTES		((D_TM_SHARD_NR + 1) * D_TM_SHARD_SIZE)
+
+struct d_tm_shard;
+
 struct d_tm_metric_t {
 	union data {
 		uint64_t	value;
@@ -225,6 +241,8 @@ struct d_tm_metric_t {
 	struct d_tm_histogram_t	*dtm_histogram;
 	char			*dtm_desc;
 	char			*dtm_units;
+	/** D_TM_SHARD_NR shards for a sharded metric, otherwise NULL */
+	struct d_tm_shard	*dtm_shards;
 };
 
 struct d_tm_node_t {
@@ -0,0 +1,166 @@
+/**
+ * (C) Copyright 2024 Intel Corporation.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause-Patent
+ */
+/**
+ * object client: inline/bulk threshold auto-tuning
+ *
+ * Whether inline or bulk is cheaper for the mid-size I/O depends on the fabric
+ * and on the load of the peer engine, so the latency (per KiB) of both modes
+ * is sampled per rank and the inline limit is moved toward whichever is
+ * cheaper. A small share of the mid-size requests always probes the other
+ * mode to keep both estimates fresh.
+ *
+ * The inline payload has to fit in one RPC, hence the limit only moves within
+ * [OBJ_BULK_TUNE_MIN, DAOS_BULK_LIMIT], starting from DAOS_BULK_LIMIT, that is,
+ * the tuning can only make mid-size I/O switch to bulk earlier than it would
+ * with the static limit, or switch it back.
+ */
+#define D_LOGFAC	DD_FAC(object)
+
+#include <daos/common.h>
+#include <daos/rpc.h>
+#include "obj_internal.h"
+
+#define OBJ_BULK_TUNE_SLOTS	256
+
+bool	obj_bulk_tune = true;
+
+struct obj_bulk_tune_slot {
+	pthread_spinlock_t	obt_lock;
+	d_rank_t		obt_rank;
+	uint32_t		obt_limit;
+	uint32_t		obt_seq;
+	/* [0] for inline, [1] for bulk */
+	uint32_t		obt_samples[2];
+	/* EWMA of the latency per KiB in ns */
+	uint64_t		obt_cost[2];
+};
+
+static struct obj_bulk_tune_slot	obj_bulk_tune_slots[OBJ_BULK_TUNE_SLOTS];
+
+static void
+obj_bulk_tune_reset(struct obj_bulk_tune_slot *obt, d_rank_t rank)
+{
+	obt->obt_rank = rank;
+	obt->obt_limit = DAOS_BULK_LIMIT;
+	obt->obt_seq = 0;
+	obt->obt_samples[0] = 0;
+	obt->obt_samples[1] = 0;
+	obt->obt_cost[0] = 0;
+	obt->obt_cost[1] = 0;
+}
+
+int
+obj_bulk_tune_init(void)
+{
+	int	i;
+	int	rc;
+
+	for (i = 0; i < OBJ_BULK_TUNE_SLOTS; i++) {
+		rc = D_SPIN_INIT(&obj_bulk_tune_slots[i].obt_lock, PTHREAD_PROCESS_PRIVATE);
+		if (rc != 0) {
+			while (--i >= 0)
+				D_SPIN_DESTROY(&obj_bulk_tune_slots[i].obt_lock);
+			return rc;
+		}
+		obj_bulk_tune_reset(&obj_bulk_tune_slots[i], CRT_NO_RANK);
+	}
+
+	return 0;
+}
+
+void
+obj_bulk_tune_fini(void)
+{
+	int	i;
+
+	for (i = 0; i < OBJ_BULK_TUNE_SLOTS; i++)
+		D_SPIN_DESTROY(&obj_bulk_tune_slots[i].obt_lock);
+}
+
+/* Return the current inline limit for \a rank. */
+uint32_t
+obj_bulk_tune_limit(d_rank_t rank)
+{
+	struct obj_bulk_tune_slot	*obt;
+	uint32_t			 limit = DAOS_BULK_LIMIT;
+
+	obt = &obj_bulk_tune_slots[rank % OBJ_BULK_TUNE_SLOTS];
+	D_SPIN_LOCK(&obt->obt_lock);
+	if (obt->obt_rank == rank)
+		limit = obt->obt_limit;
+	D_SPIN_UNLOCK(&obt->obt_lock);
+
+	return limit;
+}
+
+/* Whether to use bulk for a mid-size request of \a size to \a rank. */
+bool
+obj_bulk_tune_use_bulk(d_rank_t rank, daos_size_t size)
+{
+	struct obj_bulk_tune_slot	*obt;
+	bool				 bulk;
+
+	obt = &obj_bulk_tune_slots[rank % OBJ_BULK_TUNE_SLOTS];
+	D_SPIN_LOCK(&obt->obt_lock);
+	/* The slot is taken over by another peer, restart from the static limit. */
+	if (obt->obt_rank != rank)
+		obj_bulk_tune_reset(obt, rank);
+
+	bulk = size >= obt->obt_limit;
+	if (++obt->obt_seq % OBJ_BULK_TUNE_PROBE == 0)
+		bulk = !bulk;
+	D_SPIN_UNLOCK(&obt->obt_lock);
+
+	return bulk;
+}
+
+/* Sample the latency \a lat in ns of a successful mid-size request to \a rank. */
+void
+obj_bulk_tune_update(d_rank_t rank, daos_size_t size, bool bulk, uint64_t lat)
+{
+	struct obj_bulk_tune_slot	*obt;
+	uint64_t			 cost;
+	uint32_t			 limit;
+	int				 mode = bulk ? 1 : 0;
+
+	D_ASSERT(size >= OBJ_BULK_TUNE_MIN);
+
+	cost = (lat << 10) / size;
+	obt = &obj_bulk_tune_slots[rank % OBJ_BULK_TUNE_SLOTS];
+	D_SPIN_LOCK(&obt->obt_lock);
+	if (obt->obt_rank != rank)
+		goto unlock;
+
+	if (obt->obt_samples[mode]++ == 0)
+		obt->obt_cost[mode] = cost;
+	else
+		obt->obt_cost[mode] = (obt->obt_cost[mode] * 7 + cost) >> 3;
+
+	if (obt->obt_samples[0] < OBJ_BULK_TUNE_SAMPLES ||
+	    obt->obt_samples[1] < OBJ_BULK_TUNE_SAMPLES)
+		goto unlock;
+
+	/* Only move the limit when one mode is at least 1/8 cheaper than the other. */
+	limit = obt->obt_limit;
+	if (obt->obt_cost[1] * 8 < obt->obt_cost[0] * 7)
+		limit = max(limit - OBJ_BULK_TUNE_STEP, OBJ_BULK_TUNE_MIN);
+	else if (obt->obt_cost[0] * 8 < obt->obt_cost[1] * 7)
+		limit = min(limit + OBJ_BULK_TUNE_STEP, DAOS_BULK_LIMIT);
+	else
+		goto unlock;
+
+	if (limit != obt->obt_limit) {
+		D_DEBUG(DB_IO, "rank %u inline limit %u -> %u, cost inline "DF_U64
+			", bulk "DF_U64"\n", rank, obt->obt_limit, limit,
+			obt->obt_cost[0], obt->obt_cost[1]);
+		obt->obt_limit = limit;
+	}
+	/* Collect fresh samples with the new limit before moving it again. */
+	obt->obt_samples[0] = 0;
+	obt->obt_samples[1] = 0;
+unlock:
+	D_SPIN_UNLOCK(&obt->obt_lock);
+}
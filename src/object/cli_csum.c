@@ -10,8 +10,8 @@
 int
 dc_obj_csum_update(struct daos_csummer *csummer, struct cont_props props, daos_obj_id_t oid,
 		   daos_key_t *dkey, daos_iod_t *iods, d_sg_list_t *sgls, const uint32_t iod_nr,
-		   struct dcs_layout *layout, struct dcs_csum_info **dkey_csum,
-		   struct dcs_iod_csums **iod_csums)
+		   struct dcs_layout *layout, struct dcs_precalc *precalc,
+		   struct dcs_csum_info **dkey_csum, struct dcs_iod_csums **iod_csums)
 {
 	struct daos_csummer	*csummer_copy = NULL;
 	int			 rc;
@@ -44,7 +44,10 @@ dc_obj_csum_update(struct daos_csummer *csummer, struct cont_props props, daos_o
 		return rc;
 	}
 
-	/** Calc 'a' key checksum and value checksum */
+	/** Calc 'a' key checksum and value checksum, reusing chunk checksums
+	 * already calculated during EC encoding if any
+	 */
+	csummer_copy->dcs_precalc = precalc;
 	rc = daos_csummer_calc_iods(csummer_copy, sgls, iods, NULL,
 				    iod_nr, false,
 				    layout,
@@ -471,18 +471,90 @@ out:
 	return rc;
 }
 
-/** Encode one full stripe, the result parity buffer will be filled. */
+/**
+ * Bytes of one stripe (data and parity cells together) encoded at a time by
+ * obj_ec_stripe_encode_csum, sized to stay in the L2 cache.
+ */
+#define OBJ_EC_TILE_BYTES	(256UL << 10)
+
+/**
+ * Encode one full stripe tile by tile, and calculate the chunk checksums of the
+ * data and parity cells right after each tile is encoded while it is still in
+ * cache, instead of walking the whole stripe again in daos_csummer_calc_iods().
+ * Data cells that were copied (\a is_copy) are not checksummed as the copy is
+ * not what the reassembled sgl points to.
+ *
+ * Return an error if a checksum cannot be recorded, i.e. \a precalc is full or
+ * the csummer fails, in which case the stripe may be partially encoded.
+ */
+static int
+obj_ec_stripe_encode_csum(struct obj_ec_codec *codec, unsigned int k,
+			  unsigned int p, uint64_t cell_bytes,
+			  uint64_t chunk_bytes, unsigned char *data[],
+			  bool is_copy[], unsigned char *parity_bufs[],
+			  struct dcs_precalc *precalc)
+{
+	unsigned char	*t_data[k];
+	unsigned char	*t_parity[p];
+	uint64_t	 tile_bytes;
+	uint64_t	 off, len, c;
+	unsigned int	 i;
+	int		 rc;
+
+	tile_bytes = max(OBJ_EC_TILE_BYTES / (k + p) / chunk_bytes, 1) *
+		     chunk_bytes;
+	for (off = 0; off < cell_bytes; off += tile_bytes) {
+		len = min(tile_bytes, cell_bytes - off);
+		for (i = 0; i < k; i++)
+			t_data[i] = data[i] + off;
+		for (i = 0; i < p; i++)
+			t_parity[i] = parity_bufs[i] + off;
+
+		ec_encode_data(len, k, p, codec->ec_gftbls, t_data, t_parity);
+
+		for (c = 0; c < len; c += chunk_bytes) {
+			for (i = 0; i < k; i++) {
+				if (is_copy[i])
+					continue;
+				rc = dcs_precalc_add(precalc, t_data[i] + c,
+						     chunk_bytes);
+				if (rc)
+					goto failed;
+			}
+			for (i = 0; i < p; i++) {
+				rc = dcs_precalc_add(precalc, t_parity[i] + c,
+						     chunk_bytes);
+				if (rc)
+					goto failed;
+			}
+		}
+	}
+
+	return 0;
+
+failed:
+	D_ERROR("can not record stripe chunk checksum: "DF_RC"\n", DP_RC(rc));
+	return rc;
+}
+
+/**
+ * Encode one full stripe, the result parity buffer will be filled. If
+ * \a precalc is provided, the chunk checksums (of \a chunk_bytes each) are
+ * calculated in the same pass.
+ */
 static int
 obj_ec_stripe_encode(daos_iod_t *iod, d_sg_list_t *sgl, uint32_t iov_idx,
 		     size_t iov_off, struct obj_ec_codec *codec,
 		     struct daos_oclass_attr *oca, uint64_t cell_bytes,
-		     unsigned char *parity_bufs[])
+		     unsigned char *parity_bufs[], struct dcs_precalc *precalc,
+		     uint64_t chunk_bytes)
 {
 	uint64_t			 len = cell_bytes;
 	unsigned int			 k = oca->u.ec.e_k;
 	unsigned int			 p = oca->u.ec.e_p;
 	unsigned char			*data[k];
 	unsigned char			*c_data[k]; /* copied data */
+	bool				 is_copy[k];
 	unsigned char			*from;
 	struct obj_ec_singv_local	 loc = {0};
 	bool				 with_padding = false;
@@ -494,6 +566,7 @@ obj_ec_stripe_encode(daos_iod_t *iod, d_sg_list_t *sgl, uint32_t iov_idx,
 
 	for (i = 0; i < k; i++) {
 		c_data[i] = NULL;
+		is_copy[i] = false;
 		/* for singv the last data target may need padding of zero */
 		if (i == k - 1) {
 			len = cell_bytes - loc.esl_bytes_pad;
@@ -533,10 +606,17 @@ obj_ec_stripe_encode(daos_iod_t *iod, d_sg_list_t *sgl, uint32_t iov_idx,
 					D_GOTO(out, rc = -DER_REC2BIG);
 			}
 			data[i] = c_data[c_idx++];
+			is_copy[i] = true;
 		}
 	}
 
-	ec_encode_data(cell_bytes, k, p, codec->ec_gftbls, data, parity_bufs);
+	if (precalc != NULL)
+		rc = obj_ec_stripe_encode_csum(codec, k, p, cell_bytes,
+					       chunk_bytes, data, is_copy,
+					       parity_bufs, precalc);
+	else
+		ec_encode_data(cell_bytes, k, p, codec->ec_gftbls, data,
+			       parity_bufs);
 
 out:
 	for (i = 0; i < c_idx; i++)
@@ -585,14 +665,38 @@ codec_get(struct obj_reasb_req *reasb_req, daos_obj_id_t oid)
 	return reasb_req->orr_codec;
 }
 
+/**
+ * Size of the checksum chunks that can be calculated while encoding the full
+ * stripes of \a iod, or 0 if they cannot be. Chunks are aligned in the index
+ * space, so they must evenly divide the cell to fall in one cell each.
+ */
+static uint64_t
+obj_ec_csum_chunk_bytes(struct daos_csummer *csummer, daos_iod_t *iod,
+			struct daos_oclass_attr *oca)
+{
+	uint64_t	chunk_bytes;
+
+	if (csummer == NULL || iod->iod_type != DAOS_IOD_ARRAY ||
+	    iod->iod_size == DAOS_REC_ANY || iod->iod_size == 0)
+		return 0;
+
+	chunk_bytes = daos_csummer_get_rec_chunksize(csummer, iod->iod_size);
+	if (chunk_bytes == 0 || obj_ec_cell_bytes(iod, oca) % chunk_bytes != 0)
+		return 0;
+
+	return chunk_bytes;
+}
+
 /**
  * Encode the data in full stripe recx_array, the result parity stored in
- * struct obj_ec_recx_array::oer_pbufs.
+ * struct obj_ec_recx_array::oer_pbufs. The chunk checksums of the full
+ * stripes are recorded in \a precalc if it is not NULL.
  */
 static int
 obj_ec_recx_encode(struct obj_ec_codec *codec, struct daos_oclass_attr *oca,
 		   daos_iod_t *iod, d_sg_list_t *sgl,
-		   struct obj_ec_recx_array *recx_array)
+		   struct obj_ec_recx_array *recx_array,
+		   struct dcs_precalc *precalc)
 {
 	struct obj_ec_recx	*ec_recx;
 	unsigned int		 p = oca->u.ec.e_p;
@@ -603,6 +707,7 @@ obj_ec_recx_encode(struct obj_ec_codec *codec, struct daos_oclass_attr *oca,
 	uint32_t		 encoded_nr = 0;
 	uint32_t		 recx_nr, stripe_nr;
 	uint32_t		 i, j, m;
+	uint64_t		 chunk_bytes;
 	bool			 singv;
 	int			 rc = 0;
 
@@ -621,6 +726,10 @@ obj_ec_recx_encode(struct obj_ec_codec *codec, struct daos_oclass_attr *oca,
 		recx_nr = recx_array->oer_nr;
 	}
 	stripe_bytes = cell_bytes * oca->u.ec.e_k;
+	chunk_bytes = obj_ec_csum_chunk_bytes(precalc ? precalc->dp_csummer : NULL,
+					      iod, oca);
+	if (chunk_bytes == 0)
+		precalc = NULL;
 
 	/* calculate EC parity for each full_stripe */
 	for (i = 0; i < recx_nr; i++) {
@@ -644,7 +753,8 @@ obj_ec_recx_encode(struct obj_ec_codec *codec, struct daos_oclass_attr *oca,
 #endif
 			rc = obj_ec_stripe_encode(iod, sgl, iov_idx, iov_off,
 						  codec, oca, cell_bytes,
-						  parity_buf);
+						  parity_buf, precalc,
+						  chunk_bytes);
 			if (rc) {
 				D_ERROR("stripe encoding failed rc %d.\n", rc);
 				goto out;
@@ -1432,7 +1542,7 @@ obj_ec_singv_encode(struct obj_ec_codec *codec, struct daos_oclass_attr *oca,
 	if (rc)
 		D_GOTO(out, rc);
 
-	rc = obj_ec_recx_encode(codec, oca, iod, sgl, recxs);
+	rc = obj_ec_recx_encode(codec, oca, iod, sgl, recxs, NULL);
 	if (rc) {
 		D_ERROR("obj_ec_recx_encode failed %d.\n", rc);
 		D_GOTO(out, rc);
@@ -1654,10 +1764,65 @@ out:
 	return rc;
 }
 
-int
-obj_ec_encode(struct obj_reasb_req *reasb_req)
+void
+obj_ec_precalc_free(struct obj_reasb_req *reasb_req)
+{
+	if (!reasb_req->orr_csum_fuse || reasb_req->orr_precalc == NULL)
+		return;
+
+	dcs_precalc_fini(reasb_req->orr_precalc);
+	D_FREE(reasb_req->orr_precalc);
+}
+
+/**
+ * Prepare reasb_req::orr_precalc to record the chunk checksums of all the full
+ * stripes of the request, returns NULL if none can be calculated while encoding.
+ */
+static struct dcs_precalc *
+obj_ec_precalc_init(struct obj_reasb_req *reasb_req, struct daos_csummer *csummer)
+{
+	struct daos_oclass_attr	*oca = reasb_req->orr_oca;
+	daos_iod_t		*iod;
+	uint64_t		 chunk_bytes;
+	uint64_t		 nr = 0;
+	uint32_t		 i;
+	int			 rc;
+
+	D_ASSERT(reasb_req->orr_csum_fuse);
+	obj_ec_precalc_free(reasb_req);
+	for (i = 0; i < reasb_req->orr_iod_nr; i++) {
+		iod = &reasb_req->orr_uiods[i];
+		chunk_bytes = obj_ec_csum_chunk_bytes(csummer, iod, oca);
+		if (chunk_bytes == 0)
+			continue;
+		nr += (uint64_t)reasb_req->orr_recxs[i].oer_stripe_total *
+		      obj_ec_tgt_nr(oca) * (obj_ec_cell_bytes(iod, oca) / chunk_bytes);
+	}
+	if (nr == 0 || nr > UINT32_MAX)
+		return NULL;
+
+	D_ALLOC_PTR(reasb_req->orr_precalc);
+	if (reasb_req->orr_precalc == NULL)
+		D_GOTO(failed, rc = -DER_NOMEM);
+
+	rc = dcs_precalc_init(reasb_req->orr_precalc, csummer, nr);
+	if (rc)
+		goto failed;
+	return reasb_req->orr_precalc;
+
+failed:
+	/* not fatal, checksums are calculated after encoding as usual */
+	D_DEBUG(DB_CSUM, DF_OID" can not prepare precalc checksums: "DF_RC"\n",
+		DP_OID(reasb_req->orr_oid), DP_RC(rc));
+	obj_ec_precalc_free(reasb_req);
+	return NULL;
+}
+
+static int
+obj_ec_encode(struct obj_reasb_req *reasb_req, struct daos_csummer *csummer)
 {
 	struct obj_ec_codec *codec;
+	struct dcs_precalc  *precalc = NULL;
 	uint32_t	i;
 	int		rc;
 
@@ -1671,12 +1836,15 @@ obj_ec_encode(struct obj_reasb_req *reasb_req)
 		return -DER_INVAL;
 	}
 
+	if (csummer != NULL)
+		precalc = obj_ec_precalc_init(reasb_req, csummer);
+
 	for (i = 0; i < reasb_req->orr_iod_nr; i++) {
 		rc = obj_ec_recx_encode(codec,
 					reasb_req->orr_oca,
 					&reasb_req->orr_uiods[i],
 					&reasb_req->orr_usgls[i],
-					&reasb_req->orr_recxs[i]);
+					&reasb_req->orr_recxs[i], precalc);
 		if (rc) {
 			D_ERROR(DF_OID" obj_ec_recx_encode failed %d.\n",
 				DP_OID(reasb_req->orr_oid), rc);
@@ -1780,7 +1948,7 @@ obj_ec_req_reasb(struct dc_object *obj, daos_iod_t *iods, uint64_t dkey_hash, d_
 	}
 	reasb_req->orr_single_tgt = data_tgt_nr == 1;
 	reasb_req->orr_singv_only = singv_only;
-	rc = obj_ec_encode(reasb_req);
+	rc = obj_ec_encode(reasb_req, reasb_req->orr_csum_fuse ? obj->cob_co->dc_csummer : NULL);
 	if (rc) {
 		D_ERROR(DF_OID" obj_ec_encode failed %d.\n", DP_OID(obj->cob_md.omd_id), rc);
 		goto out;
@@ -204,6 +204,22 @@ dc_obj_init(void)
 	d_getenv_bool("DAOS_TX_VERIFY_RDG", &tx_verify_rdg);
 	D_INFO("%s TX redundancy group verification\n", tx_verify_rdg ? "Enable" : "Disable");
 
+	obj_bulk_tune = true;
+	d_getenv_bool("DAOS_OBJ_BULK_TUNE", &obj_bulk_tune);
+	D_INFO("%s inline/bulk threshold auto-tuning\n", obj_bulk_tune ? "Enable" : "Disable");
+	if (obj_bulk_tune) {
+		rc = obj_bulk_tune_init();
+		if (rc != 0) {
+			D_ERROR("failed to init bulk auto-tuning: "DF_RC"\n", DP_RC(rc));
+			obj_ec_codec_fini();
+			if (dc_obj_proto_version == DAOS_OBJ_VERSION - 1)
+				daos_rpc_unregister(&obj_proto_fmt_v9);
+			else
+				daos_rpc_unregister(&obj_proto_fmt_v10);
+			D_GOTO(out_class, rc);
+		}
+	}
+
 out_class:
 	if (rc)
 		obj_class_fini();
@@ -224,6 +240,8 @@ dc_obj_fini(void)
 		daos_rpc_unregister(&obj_proto_fmt_v9);
 	else
 		daos_rpc_unregister(&obj_proto_fmt_v10);
+	if (obj_bulk_tune)
+		obj_bulk_tune_fini();
 	obj_ec_codec_fini();
 	obj_class_fini();
 	obj_utils_fini();
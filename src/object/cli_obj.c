@@ -991,6 +991,7 @@ obj_reasb_req_fini(struct obj_reasb_req *reasb_req, uint32_t iod_nr)
 		reasb_req->tgt_oiods = NULL;
 	}
 	D_MUTEX_DESTROY(&reasb_req->orr_mutex);
+	obj_ec_precalc_free(reasb_req);
 	obj_ec_fail_info_free(reasb_req);
 	D_FREE(reasb_req->orr_iods);
 	memset(reasb_req, 0, sizeof(*reasb_req));
@@ -1029,6 +1030,12 @@ obj_rw_req_reassemb(struct dc_object *obj, daos_obj_rw_t *args,
 			return rc;
 		}
 		reasb_req->orr_args = args;
+		/* Checksums are calculated on the reassembled sgls, let encoding calculate the
+		 * chunk checksums of full stripes while the data is still in cache.
+		 */
+		if (obj_auxi->opc == DAOS_OBJ_RPC_UPDATE && obj->cob_co->dc_props.dcp_csum_enabled &&
+		    daos_csummer_initialized(obj->cob_co->dc_csummer))
+			reasb_req->orr_csum_fuse = 1;
 	}
 
 	rc = obj_ec_req_reasb(obj, args->iods, obj_auxi->dkey_hash,
@@ -2084,10 +2091,13 @@ obj_rw_bulk_prep(struct dc_object *obj, daos_iod_t *iods, d_sg_list_t *sgls,
 		 unsigned int nr, bool update, bool bulk_bind,
 		 tse_task_t *task, struct obj_auxi_args *obj_auxi)
 {
+	struct obj_req_tgts	*req_tgts = &obj_auxi->req_tgts;
 	daos_size_t		sgls_size;
 	crt_bulk_perm_t		bulk_perm;
+	bool			bulk;
 	int			rc = 0;
 
+	obj_auxi->bulk_tune_size = 0;
 	if ((obj_auxi->io_retry && !obj_auxi->reasb_req.orr_size_fetched &&
 	     obj_auxi->bulks != NULL) || obj_auxi->reasb_req.orr_size_fetch || sgls == NULL)
 		return 0;
@@ -2096,8 +2106,21 @@ obj_rw_bulk_prep(struct dc_object *obj, daos_iod_t *iods, d_sg_list_t *sgls,
 	 * if need bulk transferring.
 	 */
 	sgls_size = daos_sgls_packed_size(sgls, nr, NULL);
-	if (sgls_size >= DAOS_BULK_LIMIT ||
-	    (obj_is_ec(obj) && !obj_auxi->reasb_req.orr_single_tgt)) {
+	if (obj_is_ec(obj) && !obj_auxi->reasb_req.orr_single_tgt) {
+		bulk = true;
+	} else if (sgls_size >= DAOS_BULK_LIMIT) {
+		bulk = true;
+	} else if (obj_bulk_tune && sgls_size >= OBJ_BULK_TUNE_MIN && !obj_auxi->io_retry &&
+		   req_tgts->ort_grp_nr == 1 &&
+		   (req_tgts->ort_srv_disp || req_tgts->ort_grp_size == 1)) {
+		/* Only sample the requests that are sent as single RPC. */
+		bulk = obj_bulk_tune_use_bulk(req_tgts->ort_shard_tgts[0].st_rank, sgls_size);
+		obj_auxi->bulk_tune_size = sgls_size;
+	} else {
+		bulk = false;
+	}
+
+	if (bulk) {
 		bulk_perm = update ? CRT_BULK_RO : CRT_BULK_RW;
 		rc = obj_bulk_prep(sgls, nr, bulk_bind, bulk_perm, task,
 				   &obj_auxi->bulks);
@@ -5111,8 +5134,10 @@ obj_csum_update(struct dc_object *obj, daos_obj_update_t *args, struct obj_auxi_
 
 	return dc_obj_csum_update(obj->cob_co->dc_csummer, obj->cob_co->dc_props,
 				  obj->cob_md.omd_id, args->dkey, args->iods, args->sgls, args->nr,
-				  obj_auxi->reasb_req.orr_singv_los, &obj_auxi->rw_args.dkey_csum,
-				  &obj_auxi->rw_args.iod_csums);
+				  obj_auxi->reasb_req.orr_singv_los,
+				  obj_auxi->reasb_req.orr_csum_fuse ?
+				  obj_auxi->reasb_req.orr_precalc : NULL,
+				  &obj_auxi->rw_args.dkey_csum, &obj_auxi->rw_args.iod_csums);
 }
 
 static int
@@ -1053,6 +1053,12 @@ out:
 	obj_shard_update_metrics_end(rw_args->rpc, rw_args->send_time, rw_args,
 				     ret == 0 ? rc : ret);
 
+	if (ret == 0 && rc == 0 && rw_args->shard_args->auxi.obj_auxi->bulk_tune_size != 0)
+		obj_bulk_tune_update(rw_args->tgt_ep.ep_rank,
+				     rw_args->shard_args->auxi.obj_auxi->bulk_tune_size,
+				     rw_args->shard_args->bulks != NULL,
+				     daos_get_ntime() - rw_args->send_time);
+
 	crt_req_decref(rw_args->rpc);
 
 	if (ret == 0 || obj_retry_error(rc))
@@ -1232,7 +1238,10 @@ dc_obj_shard_rw(struct dc_obj_shard *shard, enum obj_rpc_opc opc,
 	rw_args.shard_args = args;
 	/* remember the sgl to copyout the data inline for fetch */
 	rw_args.rwaa_sgls = sgls;
-	rw_args.send_time = daos_client_metric ? daos_get_ntime() : 0;
+	if (daos_client_metric || auxi->obj_auxi->bulk_tune_size != 0)
+		rw_args.send_time = daos_get_ntime();
+	else
+		rw_args.send_time = 0;
 	obj_shard_update_metrics_begin(req);
 	if (args->reasb_req && args->reasb_req->orr_recov) {
 		rw_args.maps = NULL;
@@ -840,6 +840,7 @@ int obj_ec_fail_info_parity_get(struct dc_object *obj, struct obj_reasb_req *rea
 int obj_ec_fail_info_insert(struct obj_reasb_req *reasb_req, uint16_t fail_tgt);
 void obj_ec_fail_info_reset(struct obj_reasb_req *reasb_req);
 void obj_ec_fail_info_free(struct obj_reasb_req *reasb_req);
+void obj_ec_precalc_free(struct obj_reasb_req *reasb_req);
 int obj_ec_recov_prep(struct dc_object *obj, struct obj_reasb_req *reasb_req,
 		      uint64_t dkey_hash, daos_iod_t *iods, uint32_t iod_nr);
 void obj_ec_recov_data(struct obj_reasb_req *reasb_req, uint32_t iod_nr);
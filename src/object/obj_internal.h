@@ -48,6 +48,9 @@ extern btr_ops_t	dbtree_coll_ops;
 /* Whether check redundancy group validation when DTX resync. */
 extern bool	tx_verify_rdg;
 
+/** Switch of per-peer inline/bulk threshold auto-tuning */
+extern bool	obj_bulk_tune;
+
 /** client object shard */
 struct dc_obj_shard {
 	/** refcount */
@@ -183,9 +186,19 @@ struct obj_reasb_req {
 	struct obj_tgt_oiod		*tgt_oiods;
 	/* IO failure information */
 	struct obj_ec_fail_info		*orr_fail;
-	/* parity recx list (to compare parity ext/epoch when data recovery) */
-	struct daos_recx_ep_list	*orr_parity_lists;
-	uint32_t			 orr_parity_list_nr;
+	union {
+		/* parity recx list (to compare parity ext/epoch when data recovery), only for
+		 * fetch with orr_fail.
+		 */
+		struct {
+			struct daos_recx_ep_list	*orr_parity_lists;
+			uint32_t			 orr_parity_list_nr;
+		};
+		/* chunk checksums calculated while EC encoding, only for update (the task args
+		 * have no room for another pointer).
+		 */
+		struct dcs_precalc			*orr_precalc;
+	};
 	/* for data recovery flag */
 	uint32_t			 orr_recov:1,
 	/* for snapshot data recovery flag */
@@ -203,7 +216,9 @@ struct obj_reasb_req {
 	/* orr_fail allocated flag, recovery task's orr_fail is inherited */
 					 orr_fail_alloc:1,
 	/* The fetch data/sgl is rebuilt by EC parity rebuild */
-					 orr_recov_data:1;
+					 orr_recov_data:1,
+	/* calculate data/parity chunk checksums while EC encoding */
+					 orr_csum_fuse:1;
 };
 
 static inline void
@@ -478,6 +493,8 @@ struct obj_auxi_args {
 	uint32_t			 specified_shard;
 	uint16_t			 retry_cnt;
 	uint16_t			 inprogress_cnt;
+	/* sgls size sampled by the inline/bulk auto-tuning, zero if not sampled */
+	uint32_t			 bulk_tune_size;
 	struct obj_req_tgts		 req_tgts;
 	d_sg_list_t			*sgls_dup;
 	crt_bulk_t			*bulks;
@@ -511,6 +528,30 @@ D_CASSERT(sizeof(struct obj_auxi_args) + sizeof(struct shard_auxi_args) <=
 D_CASSERT(sizeof(struct obj_auxi_args) + sizeof(struct daos_task_args) <=
 	  TSE_TASK_ARG_LEN);
 
+/*
+ * Inline/bulk threshold auto-tuning for the mid-size I/O, the size range is
+ * [OBJ_BULK_TUNE_MIN, DAOS_BULK_LIMIT). Below it always inline, above it
+ * always bulk. See cli_bulk_tune.c.
+ */
+#define OBJ_BULK_TUNE_MIN	(4 << 10)
+/* The inline limit moves by OBJ_BULK_TUNE_STEP at a time. */
+#define OBJ_BULK_TUNE_STEP	(1 << 10)
+/* One out of every OBJ_BULK_TUNE_PROBE mid-size requests uses the other mode */
+#define OBJ_BULK_TUNE_PROBE	32
+/* Minimum samples of each mode before moving the limit */
+#define OBJ_BULK_TUNE_SAMPLES	8
+
+int
+obj_bulk_tune_init(void);
+void
+obj_bulk_tune_fini(void);
+uint32_t
+obj_bulk_tune_limit(d_rank_t rank);
+bool
+obj_bulk_tune_use_bulk(d_rank_t rank, daos_size_t size);
+void
+obj_bulk_tune_update(d_rank_t rank, daos_size_t size, bool bulk, uint64_t lat);
+
 
 typedef int (*obj_enum_process_cb_t)(daos_key_desc_t *kds, void *ptr,
 				     unsigned int size, void *arg);
@@ -158,6 +158,7 @@ obj_metrics_alloc_internal(const char *path, int tgt_id, bool server)
 	struct obj_pool_metrics *metrics;
 	char                     tgt_path[32];
 	uint32_t                 opc;
+	int                      ctr_type;
 	int                      rc;
 
 	D_ASSERT(tgt_id >= 0);
@@ -166,6 +167,9 @@ obj_metrics_alloc_internal(const char *path, int tgt_id, bool server)
 	else
 		tgt_path[0] = '\0';
 
+	/* Client per-pool counters are updated by all the application threads. */
+	ctr_type = server ? D_TM_COUNTER : D_TM_COUNTER | D_TM_SHARDED;
+
 	D_ALLOC_PTR(metrics);
 	if (metrics == NULL) {
 		D_ERROR("failed to alloc object metrics");
@@ -175,7 +179,7 @@ obj_metrics_alloc_internal(const char *path, int tgt_id, bool server)
 	/** register different per-opcode counters */
 	for (opc = 0; opc < OBJ_PROTO_CLI_COUNT; opc++) {
 		/** Then the total number of requests, of type counter */
-		rc = d_tm_add_metric(&metrics->opm_total[opc], D_TM_COUNTER,
+		rc = d_tm_add_metric(&metrics->opm_total[opc], ctr_type,
 				     "total number of processed object RPCs", "ops", "%s/ops/%s%s",
 				     path, obj_opc_to_str(opc), tgt_path);
 		if (rc)
@@ -183,49 +187,49 @@ obj_metrics_alloc_internal(const char *path, int tgt_id, bool server)
 	}
 
 	/** Total number of silently restarted updates, of type counter */
-	rc = d_tm_add_metric(&metrics->opm_update_restart, D_TM_COUNTER,
+	rc = d_tm_add_metric(&metrics->opm_update_restart, ctr_type,
 			     "total number of restarted update ops", "updates", "%s/restarted%s",
 			     path, tgt_path);
 	if (rc)
 		D_WARN("Failed to create restarted counter: " DF_RC "\n", DP_RC(rc));
 
 	/** Total number of resent updates, of type counter */
-	rc = d_tm_add_metric(&metrics->opm_update_resent, D_TM_COUNTER,
+	rc = d_tm_add_metric(&metrics->opm_update_resent, ctr_type,
 			     "total number of resent update RPCs", "updates", "%s/resent%s", path,
 			     tgt_path);
 	if (rc)
 		D_WARN("Failed to create resent counter: " DF_RC "\n", DP_RC(rc));
 
 	/** Total number of retry updates locally, of type counter */
-	rc = d_tm_add_metric(&metrics->opm_update_retry, D_TM_COUNTER,
+	rc = d_tm_add_metric(&metrics->opm_update_retry, ctr_type,
 			     "total number of retried update RPCs", "updates", "%s/retry%s", path,
 			     tgt_path);
 	if (rc)
 		D_WARN("Failed to create retry cnt sensor: " DF_RC "\n", DP_RC(rc));
 
 	/** Total bytes read */
-	rc = d_tm_add_metric(&metrics->opm_fetch_bytes, D_TM_COUNTER,
+	rc = d_tm_add_metric(&metrics->opm_fetch_bytes, ctr_type,
 			     "total number of bytes fetched/read", "bytes", "%s/xferred/fetch%s",
 			     path, tgt_path);
 	if (rc)
 		D_WARN("Failed to create bytes fetch counter: " DF_RC "\n", DP_RC(rc));
 
 	/** Total bytes written */
-	rc = d_tm_add_metric(&metrics->opm_update_bytes, D_TM_COUNTER,
+	rc = d_tm_add_metric(&metrics->opm_update_bytes, ctr_type,
 			     "total number of bytes updated/written", "bytes",
 			     "%s/xferred/update%s", path, tgt_path);
 	if (rc)
 		D_WARN("Failed to create bytes update counter: " DF_RC "\n", DP_RC(rc));
 
 	/** Total number of EC full-stripe update operations, of type counter */
-	rc = d_tm_add_metric(&metrics->opm_update_ec_full, D_TM_COUNTER,
+	rc = d_tm_add_metric(&metrics->opm_update_ec_full, ctr_type,
 			     "total number of EC full-stripe updates", "updates",
 			     "%s/EC_update/full_stripe%s", path, tgt_path);
 	if (rc)
 		D_WARN("Failed to create EC full stripe update counter: " DF_RC "\n", DP_RC(rc));
 
 	/** Total number of EC partial update operations, of type counter */
-	rc = d_tm_add_metric(&metrics->opm_update_ec_partial, D_TM_COUNTER,
+	rc = d_tm_add_metric(&metrics->opm_update_ec_partial, ctr_type,
 			     "total number of EC partial updates", "updates",
 			     "%s/EC_update/partial%s", path, tgt_path);
 	if (rc)
@@ -234,7 +238,7 @@ obj_metrics_alloc_internal(const char *path, int tgt_id, bool server)
 	/** Total number of times EC aggregation conflicts with discard or VOS
 	 * aggregation
 	 */
-	rc = d_tm_add_metric(&metrics->opm_ec_agg_blocked, D_TM_COUNTER,
+	rc = d_tm_add_metric(&metrics->opm_ec_agg_blocked, ctr_type,
 			     "total number of EC agg pauses due to VOS discard or agg", NULL,
 			     "%s/EC_agg/blocked%s", path, tgt_path);
 	if (rc)
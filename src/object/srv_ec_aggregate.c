@@ -18,14 +18,16 @@
  *	- The parity for peer parity extents is transferred.
  *	- Replicas for the stripe are removed from parity targets.
  *
- * If replicas are partial, and prior parity exists:
- *	- If less than half cells are updated (have replicas, parity is updated:
- *		- Old data cells for cells with replica data are fetched from
- *		  data targets (old, since fetched at epoch of existing parity).
+ * If replicas are partial, and prior parity exists, the cheaper of the two
+ * ways below (by the bytes fetched from other targets) is chosen per stripe:
+ *	- Delta update of the parity:
+ *		- Old data for the replicated range of each cell with replica
+ *		  data is fetched from data targets (old, since fetched at epoch
+ *		  of existing parity).
  *		- Peer parity is fetched.
- *		- Parity is incrementally updated.
+ *		- Parity is incrementally updated with the delta of the range.
  *		- Updated parity is transferred to peer parity target(s).
- *	- If half or more of the cells are update by replicas:
+ *	- Recalculation of the parity (always, if older replicas exist):
  *		- All cells not filled by local replicas are fetched.
  *		- New parity is generated from entire stripe.
  *		- Updated parity is transferred to peer parity target(s).
@@ -495,6 +497,83 @@ agg_count_cells(uint8_t *fcbit_map, uint8_t *tbit_map, uint64_t estart,
 	return cell_cnt;
 }
 
+/* Returns the range (in records, relative to the cell start) of cell cell_idx
+ * that is covered by replicas newer than the parity. Only this range of the
+ * cell differs from the old data, so only it needs to be fetched and applied
+ * to the parity as a delta.
+ */
+static void
+agg_cell_span(struct ec_agg_entry *entry, unsigned int cell_idx,
+	      uint64_t *span_off, uint64_t *span_nr)
+{
+	struct ec_agg_extent	*extent;
+	unsigned int		 len = ec_age2cs(entry);
+	unsigned int		 k = ec_age2k(entry);
+	uint64_t		 ss, estart, eend;
+	uint64_t		 cell_start, cell_end;
+	uint64_t		 lo = len, hi = 0;
+
+	ss = k * len * entry->ae_cur_stripe.as_stripenum;
+	cell_start = (uint64_t)cell_idx * len;
+	cell_end = cell_start + len;
+	d_list_for_each_entry(extent, &entry->ae_cur_stripe.as_dextents,
+			      ae_link) {
+		if (extent->ae_epoch <= entry->ae_par_extent.ape_epoch)
+			continue;
+		estart = extent->ae_recx.rx_idx - ss;
+		eend = estart + extent->ae_recx.rx_nr;
+		if (estart >= cell_end)
+			break;
+		if (eend <= cell_start)
+			continue;
+		lo = min(lo, max(estart, cell_start) - cell_start);
+		hi = max(hi, min(eend, cell_end) - cell_start);
+	}
+
+	if (lo >= hi) {
+		/* not expected for a replicated cell, use the full cell */
+		lo = 0;
+		hi = len;
+	}
+	*span_off = lo;
+	*span_nr = hi - lo;
+}
+
+/* Chooses between updating the existing parity with the delta of the
+ * replicated cells, and recalculating it from the full stripe, by the bytes
+ * each would pull from the other targets:
+ *	- delta fetches the old data of the replicated range of each cell in
+ *	  tbit_map, plus the peer parity cells.
+ *	- recalc fetches every data cell that is not fully replicated.
+ * The parity pushed to the peer parity targets is the same either way.
+ */
+static bool
+agg_delta_is_cheaper(struct ec_agg_entry *entry, uint8_t *tbit_map,
+		     unsigned int full_cell_cnt)
+{
+	uint64_t	cell_b = ec_age2cs_b(entry);
+	unsigned int	k = ec_age2k(entry);
+	unsigned int	p = ec_age2p(entry);
+	uint64_t	delta_b, recalc_b;
+	uint64_t	off, nr;
+	unsigned int	i;
+
+	delta_b = (uint64_t)(p - 1) * cell_b;
+	for (i = 0; i < k; i++) {
+		if (!isset(tbit_map, i))
+			continue;
+		agg_cell_span(entry, i, &off, &nr);
+		delta_b += nr * entry->ae_rsize;
+	}
+	recalc_b = (uint64_t)(k - full_cell_cnt) * cell_b;
+
+	D_DEBUG(DB_EPC, DF_UOID" stripe "DF_U64": delta "DF_U64" bytes, "
+		"recalc "DF_U64" bytes\n", DP_UOID(entry->ae_oid),
+		entry->ae_cur_stripe.as_stripenum, delta_b, recalc_b);
+
+	return delta_b < recalc_b;
+}
+
 /* Initializes the object handle of for the object represented by the entry.
  * No way to do this until pool handle uuid and container handle uuid are
  * initialized and share to other servers at higher(pool/container) layer.
@@ -551,8 +630,10 @@ out:
 /* Fetches the old data for the cells in the stripe undergoing a partial parity
  * update, or a parity recalculation. For update, the bit_map indicates the
  * cells that are present as replicas. In this case the parity epoch is used
- * for the fetch. For recalc, the bit_map indicates the cells that are not fully
- * populated as replicas. In this case, the highest replica epoch is used.
+ * for the fetch, and only the replicated range of each cell is fetched (to the
+ * start of its slot in the buffer). For recalc, the bit_map indicates the cells
+ * that are not fully populated as replicas. In this case, the highest replica
+ * epoch is used.
  */
 static int
 agg_fetch_odata_cells(struct ec_agg_entry *entry, uint8_t *bit_map,
@@ -567,6 +648,7 @@ agg_fetch_odata_cells(struct ec_agg_entry *entry, uint8_t *bit_map,
 	uint64_t		 cell_b = ec_age2cs_b(entry);
 	unsigned int		 len = ec_age2cs(entry);
 	unsigned int		 k = ec_age2k(entry);
+	uint64_t		 off = 0, nr = len;
 	unsigned int		 i, j;
 	int			 rc = 0;
 
@@ -578,8 +660,10 @@ agg_fetch_odata_cells(struct ec_agg_entry *entry, uint8_t *bit_map,
 		if (!isset(bit_map, i))
 			continue;
 
-		recxs[j].rx_idx = stripe->as_stripenum * k * len + i * len;
-		recxs[j++].rx_nr = len;
+		if (!is_recalc)
+			agg_cell_span(entry, i, &off, &nr);
+		recxs[j].rx_idx = stripe->as_stripenum * k * len + i * len + off;
+		recxs[j++].rx_nr = nr;
 	}
 	D_ASSERT(j == cell_cnt);
 
@@ -597,7 +681,8 @@ agg_fetch_odata_cells(struct ec_agg_entry *entry, uint8_t *bit_map,
 	sgl.sg_nr = cell_cnt;
 	buf = entry->ae_sgl.sg_iovs[AGG_IOV_ODATA].iov_buf;
 	for (i = 0; i < cell_cnt; i++)
-		d_iov_set(&sgl.sg_iovs[i], &buf[i * cell_b], cell_b);
+		d_iov_set(&sgl.sg_iovs[i], &buf[i * cell_b],
+			  recxs[i].rx_nr * entry->ae_rsize);
 
 	rc = agg_get_obj_handle(entry);
 	if (rc) {
@@ -866,6 +951,7 @@ agg_fetch_local_extents(struct ec_agg_entry *entry, uint8_t *bit_map,
 	uint32_t		 len = ec_age2cs(entry);
 	uint32_t		 k = ec_age2k(entry);
 	uint32_t		 pidx = ec_age2pidx(entry);
+	uint64_t		 off = 0, nr = len;
 	uint32_t		 i, j;
 	int			 rc = 0;
 
@@ -877,9 +963,11 @@ agg_fetch_local_extents(struct ec_agg_entry *entry, uint8_t *bit_map,
 
 	for (i = 0, j = 0; i < k; i++)
 		if (isset(bit_map, i)) {
+			if (!is_recalc)
+				agg_cell_span(entry, i, &off, &nr);
 			recxs[j].rx_idx =
-			  entry->ae_cur_stripe.as_stripenum * k * len + i * len;
-			recxs[j++].rx_nr = len;
+			  entry->ae_cur_stripe.as_stripenum * k * len + i * len + off;
+			recxs[j++].rx_nr = nr;
 		}
 	D_ASSERT(j == cell_cnt);
 
@@ -903,7 +991,8 @@ agg_fetch_local_extents(struct ec_agg_entry *entry, uint8_t *bit_map,
 	sgl.sg_nr =  is_recalc ? cell_cnt : cell_cnt + 1;
 	buf = entry->ae_sgl.sg_iovs[AGG_IOV_DATA].iov_buf;
 	for (i = 0; i < cell_cnt; i++)
-		d_iov_set(&sgl.sg_iovs[i], &buf[i * cell_bytes], cell_bytes);
+		d_iov_set(&sgl.sg_iovs[i], &buf[i * cell_bytes],
+			  recxs[i].rx_nr * entry->ae_rsize);
 
 	/* fetch the local parity */
 	if (!is_recalc) {
@@ -1035,7 +1124,10 @@ agg_diff_preprocess(struct ec_agg_entry *entry, unsigned char *diff,
 	}
 }
 
-/* Performs an incremental update of the existing parity for the stripe.
+/* Performs an incremental update of the existing parity for the stripe. The
+ * old and new data only cover the replicated range of each cell (see
+ * agg_cell_span), and the parity is only updated for that range, as each
+ * parity byte only depends on the data bytes at the same offset.
  */
 static int
 agg_update_parity(struct ec_agg_entry *entry, uint8_t *bit_map,
@@ -1045,13 +1137,15 @@ agg_update_parity(struct ec_agg_entry *entry, uint8_t *bit_map,
 	unsigned int	 p = ec_age2p(entry);
 	unsigned int	 cell_bytes = ec_age2cs_b(entry);
 	unsigned char	*parity_bufs[OBJ_EC_MAX_P];
+	unsigned char	*span_parity[OBJ_EC_MAX_P];
 	unsigned char	*vects[3];
 	unsigned char	*buf;
 	unsigned char	*obuf;
 	unsigned char	*old;
 	unsigned char	*new;
 	unsigned char	*diff;
-	int		 i, j, rc = 0;
+	uint64_t	 off, nr, off_b, nr_b;
+	int		 i, j, m, rc = 0;
 
 	buf = entry->ae_sgl.sg_iovs[AGG_IOV_PARITY].iov_buf;
 	for (i = 0; i < p; i++)
@@ -1061,21 +1155,27 @@ agg_update_parity(struct ec_agg_entry *entry, uint8_t *bit_map,
 	buf  = entry->ae_sgl.sg_iovs[AGG_IOV_DATA].iov_buf;
 	diff = entry->ae_sgl.sg_iovs[AGG_IOV_DIFF].iov_buf;
 
-	for (i = 0, j = 0; i < cell_cnt; i++) {
+	for (i = 0, j = 0; i < cell_cnt; i++, j++) {
+		while (!isset(bit_map, j))
+			j++;
+		agg_cell_span(entry, j, &off, &nr);
+		off_b = off * entry->ae_rsize;
+		nr_b = nr * entry->ae_rsize;
+
 		old = &obuf[i * cell_bytes];
 		new = &buf[i * cell_bytes];
 		vects[0] = old;
 		vects[1] = new;
-		vects[2] = diff;
-		rc = xor_gen(3, cell_bytes, (void **)vects);
+		vects[2] = diff + off_b;
+		rc = xor_gen(3, nr_b, (void **)vects);
 		if (rc)
 			goto out;
-		while (!isset(bit_map, j))
-			j++;
 		agg_diff_preprocess(entry, diff, j);
-		ec_encode_data_update(cell_bytes, k, p, j,
-				      entry->ae_codec->ec_gftbls, diff,
-				      parity_bufs);
+		for (m = 0; m < p; m++)
+			span_parity[m] = parity_bufs[m] + off_b;
+		ec_encode_data_update(nr_b, k, p, j,
+				      entry->ae_codec->ec_gftbls, diff + off_b,
+				      span_parity);
 	}
 out:
 	return rc;
@@ -1204,7 +1304,10 @@ agg_process_partial_stripe(struct ec_agg_entry *entry)
 				    entry->ae_cur_stripe.as_stripenum,
 				    &full_cell_cnt);
 
-	if (full_cell_cnt >= k / 2 || cell_cnt == k || has_old_replicas) {
+	/* The delta only applies replicas newer than the parity, so older
+	 * replicas force a recalc.
+	 */
+	if (has_old_replicas || !agg_delta_is_cheaper(entry, tbit_map, full_cell_cnt)) {
 		stripe_ud.asu_recalc = true;
 		cell_cnt = full_cell_cnt;
 		bit_map = fcbit_map;
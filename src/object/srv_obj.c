@@ -560,6 +560,17 @@ obj_bulk_transfer(crt_rpc_t *rpc, crt_bulk_op_t bulk_op, bool bulk_bind, crt_bul
 				break;
 		}
 
+		/* Wait for the prefetched data of current SG list landed, see bio_iod_prefetch(). */
+		if (bulk_op == CRT_BULK_PUT && daos_handle_is_valid(ioh)) {
+			rc = bio_iod_wait(vos_ioh2desc(ioh), i);
+			if (rc) {
+				if (sgls == NULL)
+					d_sgl_fini(sgl, false);
+				D_ERROR("bio_iod_wait i %d failed, "DF_RC"\n", i, DP_RC(rc));
+				break;
+			}
+		}
+
 		rc = bulk_transfer_sgl(ioh, rpc, remote_bulks[i + skip_nr],
 				       remote_offs ? remote_offs[i] : 0,
 				       bulk_op, bulk_bind, sgl, i, p_arg);
@@ -1577,7 +1588,15 @@ obj_local_rw_internal(crt_rpc_t *rpc, struct obj_io_context *ioc, daos_iod_t *io
 
 	time = daos_get_ntime();
 	biod = vos_ioh2desc(ioh);
-	rc   = bio_iod_prep(biod, BIO_CHK_TYPE_IO, rma ? rpc->cr_ctx : NULL, CRT_BULK_RW);
+	/*
+	 * For fetch, don't wait for the media reads here, the bulk transfer of each SG list
+	 * starts as soon as its data is landed, see obj_bulk_transfer().
+	 */
+	if (obj_rpc_is_fetch(rpc))
+		rc = bio_iod_prefetch(biod, BIO_CHK_TYPE_IO, rma ? rpc->cr_ctx : NULL,
+				      CRT_BULK_RW);
+	else
+		rc = bio_iod_prep(biod, BIO_CHK_TYPE_IO, rma ? rpc->cr_ctx : NULL, CRT_BULK_RW);
 	if (rc) {
 		D_ERROR(DF_UOID " bio_iod_prep failed: " DF_RC "\n", DP_UOID(orw->orw_oid),
 			DP_RC(rc));
@@ -1608,6 +1627,13 @@ obj_local_rw_internal(crt_rpc_t *rpc, struct obj_io_context *ioc, daos_iod_t *io
 		}
 
 		if (ioc->ioc_coc->sc_props.dcp_csum_enabled) {
+			rc = bio_iod_wait(biod, -1);
+			if (rc) {
+				D_ERROR(DF_UOID" fetch read failed: %d.\n",
+					DP_UOID(orw->orw_oid), rc);
+				goto post;
+			}
+
 			rc = csum_add2iods(ioh, orw->orw_iod_array.oia_iods,
 					   orw->orw_iod_array.oia_iod_nr, skips,
 					   ioc->ioc_coc->sc_csummer, orwo->orw_iod_csums.ca_arrays,
@@ -0,0 +1,145 @@
+/*
+ * (C) Copyright 2024 Intel Corporation.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause-Patent
+ */
+
+/**
+ * Unit tests for the per-peer inline/bulk threshold auto-tuning.
+ */
+
+#include <stddef.h>
+#include <stdarg.h>
+#include <setjmp.h>
+#include <cmocka.h>
+#include <daos/tests_lib.h>
+#include "../obj_internal.h"
+
+#define T_RANK		3
+#define T_SIZE		(8 << 10)
+#define T_CHEAP		1000
+#define T_COSTLY	2000
+
+/* Feed one round of samples of both modes and return the resulting limit. */
+static uint32_t
+t_round(d_rank_t rank, uint64_t inline_lat, uint64_t bulk_lat)
+{
+	int i;
+
+	for (i = 0; i < OBJ_BULK_TUNE_SAMPLES; i++) {
+		obj_bulk_tune_update(rank, T_SIZE, false /* bulk */, inline_lat);
+		obj_bulk_tune_update(rank, T_SIZE, true /* bulk */, bulk_lat);
+	}
+	return obj_bulk_tune_limit(rank);
+}
+
+static int
+t_setup(void **state)
+{
+	return obj_bulk_tune_init();
+}
+
+static int
+t_teardown(void **state)
+{
+	obj_bulk_tune_fini();
+	return 0;
+}
+
+/* The limit starts from the static one and only mid-size requests use bulk below it. */
+static void
+bulk_tune_test_initial(void **state)
+{
+	int i;
+
+	assert_int_equal(obj_bulk_tune_limit(T_RANK), DAOS_BULK_LIMIT);
+	for (i = 1; i < OBJ_BULK_TUNE_PROBE; i++)
+		assert_false(obj_bulk_tune_use_bulk(T_RANK, DAOS_BULK_LIMIT - 1));
+	/* The probe */
+	assert_true(obj_bulk_tune_use_bulk(T_RANK, DAOS_BULK_LIMIT - 1));
+	assert_false(obj_bulk_tune_use_bulk(T_RANK, DAOS_BULK_LIMIT - 1));
+}
+
+/* Cheaper bulk lowers the limit down to OBJ_BULK_TUNE_MIN, cheaper inline raises it back. */
+static void
+bulk_tune_test_down_up(void **state)
+{
+	uint32_t	limit = DAOS_BULK_LIMIT;
+	uint32_t	next;
+
+	obj_bulk_tune_use_bulk(T_RANK, T_SIZE);
+	assert_int_equal(obj_bulk_tune_limit(T_RANK), DAOS_BULK_LIMIT);
+
+	do {
+		next = t_round(T_RANK, T_COSTLY, T_CHEAP);
+		assert_int_equal(next, max(limit - OBJ_BULK_TUNE_STEP, OBJ_BULK_TUNE_MIN));
+		limit = next;
+	} while (limit > OBJ_BULK_TUNE_MIN);
+
+	/* Stays at the bottom. */
+	assert_int_equal(t_round(T_RANK, T_COSTLY, T_CHEAP), OBJ_BULK_TUNE_MIN);
+	assert_true(obj_bulk_tune_use_bulk(T_RANK, OBJ_BULK_TUNE_MIN));
+
+	do {
+		next = t_round(T_RANK, T_CHEAP, T_COSTLY);
+		assert_int_equal(next, min(limit + OBJ_BULK_TUNE_STEP, DAOS_BULK_LIMIT));
+		limit = next;
+	} while (limit < DAOS_BULK_LIMIT);
+
+	/* Stays at the top. */
+	assert_int_equal(t_round(T_RANK, T_CHEAP, T_COSTLY), DAOS_BULK_LIMIT);
+}
+
+/* The limit only moves with enough samples of both modes differing by 1/8 at least. */
+static void
+bulk_tune_test_hysteresis(void **state)
+{
+	int i;
+
+	obj_bulk_tune_use_bulk(T_RANK, T_SIZE);
+
+	/* Not enough bulk samples */
+	for (i = 0; i < 4 * OBJ_BULK_TUNE_SAMPLES; i++)
+		obj_bulk_tune_update(T_RANK, T_SIZE, false /* bulk */, T_COSTLY);
+	for (i = 0; i < OBJ_BULK_TUNE_SAMPLES - 1; i++)
+		obj_bulk_tune_update(T_RANK, T_SIZE, true /* bulk */, T_CHEAP);
+	assert_int_equal(obj_bulk_tune_limit(T_RANK), DAOS_BULK_LIMIT);
+	obj_bulk_tune_update(T_RANK, T_SIZE, true /* bulk */, T_CHEAP);
+	assert_int_equal(obj_bulk_tune_limit(T_RANK), DAOS_BULK_LIMIT - OBJ_BULK_TUNE_STEP);
+
+	/* Less than 1/8 cheaper */
+	for (i = 0; i < 4; i++)
+		assert_int_equal(t_round(T_RANK, T_COSTLY, T_COSTLY * 15 / 16),
+				 DAOS_BULK_LIMIT - OBJ_BULK_TUNE_STEP);
+}
+
+/* A peer taking over the slot of another restarts from the static limit. */
+static void
+bulk_tune_test_slot(void **state)
+{
+	d_rank_t other = T_RANK + 256;
+
+	obj_bulk_tune_use_bulk(T_RANK, T_SIZE);
+	assert_int_equal(t_round(T_RANK, T_COSTLY, T_CHEAP), DAOS_BULK_LIMIT - OBJ_BULK_TUNE_STEP);
+
+	obj_bulk_tune_use_bulk(other, T_SIZE);
+	assert_int_equal(obj_bulk_tune_limit(T_RANK), DAOS_BULK_LIMIT);
+	assert_int_equal(obj_bulk_tune_limit(other), DAOS_BULK_LIMIT);
+
+	/* Samples from the previous peer are dropped. */
+	assert_int_equal(t_round(T_RANK, T_COSTLY, T_CHEAP), DAOS_BULK_LIMIT);
+	assert_int_equal(obj_bulk_tune_limit(other), DAOS_BULK_LIMIT);
+}
+
+int
+main(void)
+{
+	const struct CMUnitTest tests[] = {
+	    cmocka_unit_test_setup_teardown(bulk_tune_test_initial, t_setup, t_teardown),
+	    cmocka_unit_test_setup_teardown(bulk_tune_test_down_up, t_setup, t_teardown),
+	    cmocka_unit_test_setup_teardown(bulk_tune_test_hysteresis, t_setup, t_teardown),
+	    cmocka_unit_test_setup_teardown(bulk_tune_test_slot, t_setup, t_teardown),
+	};
+
+	return cmocka_run_group_tests_name("cli_bulk_tune", tests, NULL, NULL);
+}
@@ -28,13 +28,13 @@ timing_obj_csum_update(void **state)
 	struct cont_props		 props = {.dcp_csum_enabled = true};
 
 	MEASURE_TIME(dc_obj_csum_update(st->csummer, props, oid, &st->td.dkey, st->td.td_iods,
-					st->td.td_sgls, 1, NULL, &dkey_csum,
+					st->td.td_sgls, 1, NULL, NULL, &dkey_csum,
 					&iod_csums),
 		     noop(),
 		     daos_csummer_free_ci(st->csummer, &dkey_csum);
 		     daos_csummer_free_ic(st->csummer, &iod_csums););
 	MEASURE_TIME(dc_obj_csum_update(st->csummer, props, oid, &st->td.dkey, st->td.td_iods,
-					st->td.td_sgls, st->td.td_iods_nr, NULL, &dkey_csum,
+					st->td.td_sgls, st->td.td_iods_nr, NULL, NULL, &dkey_csum,
 					&iod_csums),
 		     noop(),
 		     daos_csummer_free_ci(st->csummer, &dkey_csum);
@@ -7,6 +7,7 @@
 
 #define D_LOGFAC DD_FAC(pipeline)
 
+#include <math.h>
 #include <daos/common.h>
 #include "pipeline_internal.h"
 
@@ -80,3 +81,87 @@ DEFINE_AGGR_FUNC_MAX(d)
 DEFINE_AGGR_FUNC_MIN(u)
 DEFINE_AGGR_FUNC_MIN(i)
 DEFINE_AGGR_FUNC_MIN(d)
+
+/**
+ * Batched SUM(), MAX(), and MIN(). The operand is gathered for all the selected records of the
+ * batch first. SUM() adds the values in record order so results are the same as the scalar version;
+ * MAX() and MIN() are branch-free reductions over the column.
+ */
+
+#define DEFINE_AGGR_BATCH_SUM(type)                                                                \
+	int aggr_batch_sum_##type(struct filter_batch_run_t *args, uint64_t *mask)                 \
+	{                                                                                          \
+		double  *aggr;                                                                     \
+		uint32_t r;                                                                        \
+		int      rc;                                                                       \
+		rc = filter_batch_getdata_##type(args, &args->left);                               \
+		if (unlikely(rc != 0))                                                             \
+			return rc;                                                                 \
+		aggr = (double *)args->iov_aggr->iov_buf;                                          \
+		for (r = 0; r < args->nr; r++) {                                                   \
+			if (args->left.valid & (1ULL << r))                                        \
+				*aggr += (double)args->left.type[r];                               \
+		}                                                                                  \
+		*mask = args->left.valid;                                                          \
+		return 0;                                                                          \
+	}
+
+DEFINE_AGGR_BATCH_SUM(u)
+DEFINE_AGGR_BATCH_SUM(i)
+DEFINE_AGGR_BATCH_SUM(d)
+
+#define DEFINE_AGGR_BATCH_MAX(type)                                                                \
+	int aggr_batch_max_##type(struct filter_batch_run_t *args, uint64_t *mask)                 \
+	{                                                                                          \
+		double   *aggr;                                                                    \
+		double    res = -INFINITY;                                                         \
+		double    val;                                                                     \
+		uint64_t  valid;                                                                   \
+		uint32_t  r;                                                                       \
+		int       rc;                                                                      \
+		rc = filter_batch_getdata_##type(args, &args->left);                               \
+		if (unlikely(rc != 0))                                                             \
+			return rc;                                                                 \
+		valid = args->left.valid;                                                          \
+		for (r = 0; r < args->nr; r++) {                                                   \
+			val = ((valid >> r) & 1) ? (double)args->left.type[r] : -INFINITY;         \
+			res = val > res ? val : res;                                               \
+		}                                                                                  \
+		aggr = (double *)args->iov_aggr->iov_buf;                                          \
+		if (res > *aggr)                                                                   \
+			*aggr = res;                                                               \
+		*mask = valid;                                                                     \
+		return 0;                                                                          \
+	}
+
+DEFINE_AGGR_BATCH_MAX(u)
+DEFINE_AGGR_BATCH_MAX(i)
+DEFINE_AGGR_BATCH_MAX(d)
+
+#define DEFINE_AGGR_BATCH_MIN(type)                                                                \
+	int aggr_batch_min_##type(struct filter_batch_run_t *args, uint64_t *mask)                 \
+	{                                                                                          \
+		double   *aggr;                                                                    \
+		double    res = INFINITY;                                                          \
+		double    val;                                                                     \
+		uint64_t  valid;                                                                   \
+		uint32_t  r;                                                                       \
+		int       rc;                                                                      \
+		rc = filter_batch_getdata_##type(args, &args->left);                               \
+		if (unlikely(rc != 0))                                                             \
+			return rc;                                                                 \
+		valid = args->left.valid;                                                          \
+		for (r = 0; r < args->nr; r++) {                                                   \
+			val = ((valid >> r) & 1) ? (double)args->left.type[r] : INFINITY;          \
+			res = val < res ? val : res;                                               \
+		}                                                                                  \
+		aggr = (double *)args->iov_aggr->iov_buf;                                          \
+		if (res < *aggr)                                                                   \
+			*aggr = res;                                                               \
+		*mask = valid;                                                                     \
+		return 0;                                                                          \
+	}
+
+DEFINE_AGGR_BATCH_MIN(u)
+DEFINE_AGGR_BATCH_MIN(i)
+DEFINE_AGGR_BATCH_MIN(d)
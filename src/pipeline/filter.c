@@ -77,6 +77,23 @@ static filter_func_t *filter_func_ptrs[N_FILTER_FUNC_PTRS] = {
     filter_func_isnull, filter_func_isnotnull, filter_func_not,      filter_func_and,
     filter_func_or};
 
+/** batch version of filter_func_ptrs[], NULL for the functions only evaluated record by record */
+static filter_batch_func_t *filter_batch_func_ptrs[N_FILTER_FUNC_PTRS] = {
+    filter_batch_eq_u,   filter_batch_eq_i,      filter_batch_eq_d,  NULL,
+    filter_batch_ne_u,   filter_batch_ne_i,      filter_batch_ne_d,  NULL,
+    filter_batch_lt_u,   filter_batch_lt_i,      filter_batch_lt_d,  NULL,
+    filter_batch_le_u,   filter_batch_le_i,      filter_batch_le_d,  NULL,
+    filter_batch_ge_u,   filter_batch_ge_i,      filter_batch_ge_d,  NULL,
+    filter_batch_gt_u,   filter_batch_gt_i,      filter_batch_gt_d,  NULL,
+    NULL,                NULL,                   NULL,               NULL,
+    NULL,                NULL,                   NULL,               NULL,
+    NULL,                NULL,                   NULL,               NULL,
+    aggr_batch_sum_u,    aggr_batch_sum_i,       aggr_batch_sum_d,   aggr_batch_max_u,
+    aggr_batch_max_i,    aggr_batch_max_d,       aggr_batch_min_u,   aggr_batch_min_i,
+    aggr_batch_min_d,    NULL,                   NULL,               NULL,
+    filter_batch_isnull, filter_batch_isnotnull, filter_batch_not,   filter_batch_and,
+    filter_batch_or};
+
 static filter_func_t *getd_func_ptrs[N_GETD_FUNC_PTRS] = {
     getdata_func_dkey_u1,   getdata_func_dkey_u2,  getdata_func_dkey_u4,  getdata_func_dkey_u8,
     getdata_func_dkey_i1,   getdata_func_dkey_i2,  getdata_func_dkey_i4,  getdata_func_dkey_i8,
@@ -301,6 +318,7 @@ compile_filter(daos_filter_t *filter, struct filter_compiled_t *comp_filter, uin
 			comp_part->data_offset = 0;
 			comp_part->iov         = &filter->parts[*part_idx]->constant[0];
 			comp_part->data_len    = comp_part->iov->iov_len;
+			comp_part->constant    = true;
 			comp_part->filter_func = getd_func_ptrs[func_idx];
 
 			for (j = 1; j < filter->parts[*part_idx]->num_constants; j++) {
@@ -311,6 +329,7 @@ compile_filter(daos_filter_t *filter, struct filter_compiled_t *comp_filter, uin
 				comp_part->data_offset = 0;
 				comp_part->iov         = &filter->parts[*part_idx]->constant[j];
 				comp_part->data_len    = comp_part->iov->iov_len;
+				comp_part->constant    = true;
 				comp_part->filter_func = getd_func_ptrs[func_idx];
 			}
 		} else if (!strncmp(part_type, "DAOS_FILTER_DKEY", part_type_s)) {
@@ -341,11 +360,38 @@ compile_filter(daos_filter_t *filter, struct filter_compiled_t *comp_filter, uin
 		func_idx += type_idx;
 
 	comp_part->filter_func     = filter_func_ptrs[func_idx];
+	comp_part->batch_func      = filter_batch_func_ptrs[func_idx];
 	comp_part->idx_end_subtree = *comp_part_idx;
 exit:
 	return rc;
 }
 
+/**
+ * A filter can be evaluated over a batch of records if all its functions have a batch version.
+ * Apart from the logical operators, batch functions only take getdata parts as operands.
+ */
+static bool
+compile_filter_batch(struct filter_compiled_t *comp_filter)
+{
+	struct filter_part_compiled_t *part;
+	uint32_t                       i;
+
+	for (i = 0; i < comp_filter->num_parts; i++) {
+		part = &comp_filter->parts[i];
+		if (part->num_operands == 0)
+			continue; /** getdata */
+		if (part->batch_func == NULL)
+			return false;
+		if (part->batch_func == filter_batch_not || part->batch_func == filter_batch_and ||
+		    part->batch_func == filter_batch_or)
+			continue;
+		/** operands are getdata parts only if the subtree has no other parts */
+		if (part->idx_end_subtree != i + part->num_operands)
+			return false;
+	}
+	return true;
+}
+
 static int
 compile_filters(daos_filter_t **ftrs, uint32_t nftrs, struct filter_compiled_t *c_ftrs)
 {
@@ -382,6 +428,7 @@ compile_filters(daos_filter_t **ftrs, uint32_t nftrs, struct filter_compiled_t *
 				    &type_len);
 		if (rc != 0)
 			D_GOTO(error, rc);
+		c_ftrs[i].batch = compile_filter_batch(&c_ftrs[i]);
 	}
 	return 0;
 error:
@@ -547,3 +547,223 @@ exit:
 	args->log_out = res;
 	return 0;
 }
+
+/**
+ * Batched evaluation. The operands of a function are gathered column by column for all the
+ * selected records of a batch using the getdata functions above, then the comparison and logical
+ * kernels run over whole columns producing one bit per record. Kernels are plain loops over
+ * arrays, without branches, so the compiler can vectorize them.
+ */
+
+static inline uint64_t
+filter_batch_rows(uint32_t nr)
+{
+	return nr == PIPELINE_BATCH_MAX ? ~0ULL : (1ULL << nr) - 1;
+}
+
+#define DEFINE_FILTER_BATCH_GETDATA(type, ctype)                                                   \
+	int filter_batch_getdata_##type(struct filter_batch_run_t *args,                           \
+					struct filter_batch_col_t *col)                            \
+	{                                                                                          \
+		struct filter_part_run_t      *run = &args->run;                                   \
+		struct filter_part_compiled_t *part;                                               \
+		uint32_t                       r;                                                  \
+		int                            rc;                                                 \
+		args->part_idx += 1;                                                               \
+		part          = &args->parts[args->part_idx];                                      \
+		run->parts    = args->parts;                                                       \
+		run->nr_iods  = args->nr_iods;                                                     \
+		col->valid    = 0;                                                                 \
+		if (part->constant) {                                                              \
+			/** same value for every record, read it only once */                     \
+			run->part_idx = args->part_idx;                                            \
+			rc            = part->filter_func(run);                                    \
+			if (unlikely(rc != 0))                                                     \
+				return rc > 0 ? 0 : rc;                                            \
+			for (r = 0; r < args->nr; r++)                                             \
+				col->type[r] = run->value_##type##_out;                            \
+			col->valid = filter_batch_rows(args->nr);                                  \
+			return 0;                                                                  \
+		}                                                                                  \
+		for (r = 0; r < args->nr; r++) {                                                   \
+			col->type[r] = (_##ctype)0;                                                \
+			if (!(args->sel & (1ULL << r)))                                            \
+				continue;                                                          \
+			run->dkey               = &args->recs[r].dkey;                             \
+			run->iods               = args->recs[r].iods;                              \
+			run->akeys              = args->recs[r].akeys;                             \
+			run->part_idx           = args->part_idx;                                  \
+			run->data_out           = NULL;                                            \
+			run->value_##type##_out = (_##ctype)0;                                     \
+			rc                      = part->filter_func(run);                          \
+			if (unlikely(rc < 0))                                                      \
+				return rc;                                                         \
+			if (rc > 0 || run->data_out == NULL)                                       \
+				continue;                                                          \
+			col->type[r] = run->value_##type##_out;                                    \
+			col->valid |= 1ULL << r;                                                   \
+		}                                                                                  \
+		return 0;                                                                          \
+	}
+
+DEFINE_FILTER_BATCH_GETDATA(u, uint64_t)
+DEFINE_FILTER_BATCH_GETDATA(i, int64_t)
+DEFINE_FILTER_BATCH_GETDATA(d, double)
+
+#define DEFINE_FILTER_BATCH_LOG(op, type, ctype)                                                   \
+	static uint64_t filter_batch_kernel_##op##_##type(const _##ctype *left,                    \
+							  const _##ctype *right, uint32_t nr)      \
+	{                                                                                          \
+		uint64_t mask = 0;                                                                 \
+		uint32_t r;                                                                        \
+		for (r = 0; r < nr; r++)                                                           \
+			mask |= (uint64_t)logfunc_##op##_##type(left[r], right[r]) << r;           \
+		return mask;                                                                       \
+	}                                                                                          \
+	int filter_batch_##op##_##type(struct filter_batch_run_t *args, uint64_t *mask)            \
+	{                                                                                          \
+		uint64_t res = 0;                                                                  \
+		uint64_t valid;                                                                    \
+		uint32_t idx_end_subtree;                                                          \
+		uint32_t comparisons;                                                              \
+		uint32_t i;                                                                        \
+		int      rc;                                                                       \
+		comparisons     = args->parts[args->part_idx].num_operands - 1;                    \
+		idx_end_subtree = args->parts[args->part_idx].idx_end_subtree;                     \
+		rc              = filter_batch_getdata_##type(args, &args->left);                  \
+		if (unlikely(rc != 0))                                                             \
+			return rc;                                                                 \
+		valid = args->left.valid;                                                          \
+		for (i = 0; i < comparisons && valid != 0; i++) {                                  \
+			rc = filter_batch_getdata_##type(args, &args->right);                      \
+			if (unlikely(rc != 0))                                                     \
+				return rc;                                                         \
+			/** a missing operand fails the rest of the comparisons, as above */      \
+			valid &= args->right.valid;                                                \
+			res |= valid & filter_batch_kernel_##op##_##type(args->left.type,          \
+									 args->right.type,         \
+									 args->nr);                \
+		}                                                                                  \
+		args->part_idx = idx_end_subtree;                                                  \
+		*mask          = res;                                                              \
+		return 0;                                                                          \
+	}
+
+DEFINE_FILTER_BATCH_LOG(eq, u, uint64_t)
+DEFINE_FILTER_BATCH_LOG(ne, u, uint64_t)
+DEFINE_FILTER_BATCH_LOG(lt, u, uint64_t)
+DEFINE_FILTER_BATCH_LOG(le, u, uint64_t)
+DEFINE_FILTER_BATCH_LOG(ge, u, uint64_t)
+DEFINE_FILTER_BATCH_LOG(gt, u, uint64_t)
+
+DEFINE_FILTER_BATCH_LOG(eq, i, int64_t)
+DEFINE_FILTER_BATCH_LOG(ne, i, int64_t)
+DEFINE_FILTER_BATCH_LOG(lt, i, int64_t)
+DEFINE_FILTER_BATCH_LOG(le, i, int64_t)
+DEFINE_FILTER_BATCH_LOG(ge, i, int64_t)
+DEFINE_FILTER_BATCH_LOG(gt, i, int64_t)
+
+DEFINE_FILTER_BATCH_LOG(eq, d, double)
+DEFINE_FILTER_BATCH_LOG(ne, d, double)
+DEFINE_FILTER_BATCH_LOG(lt, d, double)
+DEFINE_FILTER_BATCH_LOG(le, d, double)
+DEFINE_FILTER_BATCH_LOG(ge, d, double)
+DEFINE_FILTER_BATCH_LOG(gt, d, double)
+
+int
+filter_batch_isnull(struct filter_batch_run_t *args, uint64_t *mask)
+{
+	int rc;
+
+	rc = filter_batch_getdata_u(args, &args->left);
+	if (unlikely(rc != 0))
+		return rc;
+	*mask = ~args->left.valid;
+	return 0;
+}
+
+int
+filter_batch_isnotnull(struct filter_batch_run_t *args, uint64_t *mask)
+{
+	int rc;
+
+	rc = filter_batch_getdata_u(args, &args->left);
+	if (unlikely(rc != 0))
+		return rc;
+	*mask = args->left.valid;
+	return 0;
+}
+
+int
+filter_batch_not(struct filter_batch_run_t *args, uint64_t *mask)
+{
+	int rc;
+
+	args->part_idx += 1;
+	rc = args->parts[args->part_idx].batch_func(args, mask);
+	if (unlikely(rc != 0))
+		return rc;
+	*mask = ~*mask;
+	return 0;
+}
+
+/**
+ * AND and OR narrow the selection while going through their operands, so records already decided
+ * are not read again by the following operands (same as the short-circuit of the scalar version).
+ */
+
+int
+filter_batch_and(struct filter_batch_run_t *args, uint64_t *mask)
+{
+	uint64_t sel = args->sel;
+	uint64_t res = ~0ULL;
+	uint64_t child;
+	uint32_t idx_end_subtree;
+	uint32_t operands;
+	uint32_t i;
+	int      rc  = 0;
+
+	operands        = args->parts[args->part_idx].num_operands;
+	idx_end_subtree = args->parts[args->part_idx].idx_end_subtree;
+
+	for (i = 0; i < operands && args->sel != 0; i++) {
+		args->part_idx += 1;
+		rc = args->parts[args->part_idx].batch_func(args, &child);
+		if (unlikely(rc != 0))
+			break;
+		res &= child;
+		args->sel &= child;
+	}
+	args->sel      = sel;
+	args->part_idx = idx_end_subtree;
+	*mask          = res;
+	return rc;
+}
+
+int
+filter_batch_or(struct filter_batch_run_t *args, uint64_t *mask)
+{
+	uint64_t sel = args->sel;
+	uint64_t res = 0;
+	uint64_t child;
+	uint32_t idx_end_subtree;
+	uint32_t operands;
+	uint32_t i;
+	int      rc  = 0;
+
+	operands        = args->parts[args->part_idx].num_operands;
+	idx_end_subtree = args->parts[args->part_idx].idx_end_subtree;
+
+	for (i = 0; i < operands && args->sel != 0; i++) {
+		args->part_idx += 1;
+		rc = args->parts[args->part_idx].batch_func(args, &child);
+		if (unlikely(rc != 0))
+			break;
+		res |= child;
+		args->sel &= ~child;
+	}
+	args->sel      = sel;
+	args->part_idx = idx_end_subtree;
+	*mask          = res;
+	return rc;
+}
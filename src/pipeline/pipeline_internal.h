@@ -29,18 +29,60 @@ struct filter_part_run_t {
 
 typedef int filter_func_t(struct filter_part_run_t *args);
 
+/**
+ * Records are filtered in batches of up to PIPELINE_BATCH_MAX. The selection over a batch is a
+ * bitmap with one bit per record, so the batch size can't be larger than 64.
+ */
+#define PIPELINE_BATCH_MAX	64
+
+/** One record of a batch */
+struct filter_batch_rec_t {
+	d_iov_t				dkey;
+	daos_iod_t			*iods;
+	d_sg_list_t			*akeys;
+};
+
+/** Values of one operand gathered for all the records of a batch */
+struct filter_batch_col_t {
+	uint64_t			valid;
+	union {
+		uint64_t		u[PIPELINE_BATCH_MAX];
+		int64_t			i[PIPELINE_BATCH_MAX];
+		double			d[PIPELINE_BATCH_MAX];
+	};
+};
+
+struct filter_batch_run_t {
+	uint32_t			nr;
+	uint32_t			nr_iods;
+	struct filter_batch_rec_t	*recs;
+	struct filter_part_compiled_t	*parts;
+	uint32_t			part_idx;
+	uint64_t			sel;
+	d_iov_t				*iov_aggr;
+	struct filter_part_run_t	run;
+	struct filter_batch_col_t	left;
+	struct filter_batch_col_t	right;
+};
+
+typedef int filter_batch_func_t(struct filter_batch_run_t *args, uint64_t *mask);
+
 struct filter_part_compiled_t {
-	uint32_t	num_operands;
-	uint32_t	idx_end_subtree;
-	d_iov_t		*iov;
-	size_t		data_offset;
-	size_t		data_len;
-	filter_func_t	*filter_func;
+	uint32_t		num_operands;
+	uint32_t		idx_end_subtree;
+	d_iov_t			*iov;
+	size_t			data_offset;
+	size_t			data_len;
+	bool			constant;
+	filter_func_t		*filter_func;
+	filter_batch_func_t	*batch_func;
 };
 
 struct filter_compiled_t {
 	uint32_t			num_parts;
 	struct filter_part_compiled_t	*parts;
+	/** all the parts have a batch_func: the filter can be evaluated over a whole batch */
+	bool				batch;
 };
 
 struct pipeline_compiled_t {
@@ -152,6 +194,52 @@ filter_func_t filter_func_not;
 filter_func_t filter_func_and;
 filter_func_t filter_func_or;
 
+int filter_batch_getdata_u(struct filter_batch_run_t *args, struct filter_batch_col_t *col);
+int filter_batch_getdata_i(struct filter_batch_run_t *args, struct filter_batch_col_t *col);
+int filter_batch_getdata_d(struct filter_batch_run_t *args, struct filter_batch_col_t *col);
+
+filter_batch_func_t filter_batch_eq_u;
+filter_batch_func_t filter_batch_eq_i;
+filter_batch_func_t filter_batch_eq_d;
+
+filter_batch_func_t filter_batch_ne_u;
+filter_batch_func_t filter_batch_ne_i;
+filter_batch_func_t filter_batch_ne_d;
+
+filter_batch_func_t filter_batch_lt_u;
+filter_batch_func_t filter_batch_lt_i;
+filter_batch_func_t filter_batch_lt_d;
+
+filter_batch_func_t filter_batch_le_u;
+filter_batch_func_t filter_batch_le_i;
+filter_batch_func_t filter_batch_le_d;
+
+filter_batch_func_t filter_batch_ge_u;
+filter_batch_func_t filter_batch_ge_i;
+filter_batch_func_t filter_batch_ge_d;
+
+filter_batch_func_t filter_batch_gt_u;
+filter_batch_func_t filter_batch_gt_i;
+filter_batch_func_t filter_batch_gt_d;
+
+filter_batch_func_t aggr_batch_sum_u;
+filter_batch_func_t aggr_batch_sum_i;
+filter_batch_func_t aggr_batch_sum_d;
+
+filter_batch_func_t aggr_batch_max_u;
+filter_batch_func_t aggr_batch_max_i;
+filter_batch_func_t aggr_batch_max_d;
+
+filter_batch_func_t aggr_batch_min_u;
+filter_batch_func_t aggr_batch_min_i;
+filter_batch_func_t aggr_batch_min_d;
+
+filter_batch_func_t filter_batch_isnull;
+filter_batch_func_t filter_batch_isnotnull;
+filter_batch_func_t filter_batch_not;
+filter_batch_func_t filter_batch_and;
+filter_batch_func_t filter_batch_or;
+
 filter_func_t getdata_func_dkey_u1;
 filter_func_t getdata_func_dkey_u2;
 filter_func_t getdata_func_dkey_u4;
@@ -132,47 +132,93 @@ out:
 	return rc;
 }
 
+/**
+ * Aggregations over the records selected in the batch. Aggregations without a batch version are
+ * done record by record.
+ */
 static int
-pipeline_aggregations(struct pipeline_compiled_t *pipe, struct filter_part_run_t *args,
-		      d_iov_t *dkey, d_sg_list_t *akeys, d_sg_list_t *sgl_agg)
+pipeline_aggregations(struct pipeline_compiled_t *pipe, struct filter_batch_run_t *batch,
+		      d_sg_list_t *sgl_agg)
 {
-	uint32_t i;
-	int      rc = 0;
+	struct filter_part_run_t *args = &batch->run;
+	uint64_t                  mask;
+	uint32_t                  i;
+	uint32_t                  r;
+	int                       rc = 0;
 
-	args->dkey  = dkey;
-	args->akeys = akeys;
+	args->nr_iods = batch->nr_iods;
 	for (i = 0; i < pipe->num_aggr_filters; i++) {
-		args->part_idx = 0;
-		args->parts    = pipe->aggr_filters[i].parts;
-		args->iov_aggr = &sgl_agg->sg_iovs[i];
-
-		rc             = args->parts[0].filter_func(args);
-		if (rc != 0)
-			D_GOTO(exit, rc);
+		if (pipe->aggr_filters[i].batch) {
+			batch->part_idx = 0;
+			batch->parts    = pipe->aggr_filters[i].parts;
+			batch->iov_aggr = &sgl_agg->sg_iovs[i];
+
+			rc              = batch->parts[0].batch_func(batch, &mask);
+			if (rc != 0)
+				D_GOTO(exit, rc);
+			continue;
+		}
+		for (r = 0; r < batch->nr; r++) {
+			if (!(batch->sel & (1ULL << r)))
+				continue;
+			args->dkey     = &batch->recs[r].dkey;
+			args->iods     = batch->recs[r].iods;
+			args->akeys    = batch->recs[r].akeys;
+			args->part_idx = 0;
+			args->parts    = pipe->aggr_filters[i].parts;
+			args->iov_aggr = &sgl_agg->sg_iovs[i];
+
+			rc             = args->parts[0].filter_func(args);
+			if (rc != 0)
+				D_GOTO(exit, rc);
+		}
 	}
 exit:
 	return rc;
 }
 
+/**
+ * Filters the records of the batch, clearing from batch->sel the records that don't pass. Filters
+ * without a batch version are evaluated record by record for the records still selected.
+ */
 static int
-pipeline_filters(struct pipeline_compiled_t *pipe, struct filter_part_run_t *args, d_iov_t *dkey,
-		 d_sg_list_t *akeys)
+pipeline_filters(struct pipeline_compiled_t *pipe, struct filter_batch_run_t *batch)
 {
-	uint32_t i;
-	int      rc = 0;
-
-	args->dkey  = dkey;
-	args->akeys = akeys;
-	for (i = 0; i < pipe->num_filters; i++) {
-		args->part_idx = 0;
-		args->parts    = pipe->filters[i].parts;
-
-		rc             = args->parts[0].filter_func(args);
-		if (rc != 0)
-			D_GOTO(exit, rc);
-		if (!args->log_out)
-			D_GOTO(exit, rc = 1);
+	struct filter_part_run_t *args = &batch->run;
+	uint64_t                  mask;
+	uint32_t                  i;
+	uint32_t                  r;
+	int                       rc = 0;
+
+	args->nr_iods = batch->nr_iods;
+	for (i = 0; i < pipe->num_filters && batch->sel != 0; i++) {
+		if (pipe->filters[i].batch) {
+			batch->part_idx = 0;
+			batch->parts    = pipe->filters[i].parts;
+
+			rc              = batch->parts[0].batch_func(batch, &mask);
+			if (rc != 0)
+				D_GOTO(exit, rc);
+			batch->sel &= mask;
+			continue;
+		}
+		for (r = 0; r < batch->nr; r++) {
+			if (!(batch->sel & (1ULL << r)))
+				continue;
+			args->dkey     = &batch->recs[r].dkey;
+			args->iods     = batch->recs[r].iods;
+			args->akeys    = batch->recs[r].akeys;
+			args->part_idx = 0;
+			args->parts    = pipe->filters[i].parts;
+
+			rc             = args->parts[0].filter_func(args);
+			if (rc < 0)
+				D_GOTO(exit, rc);
+			if (rc > 0 || !args->log_out)
+				batch->sel &= ~(1ULL << r);
+		}
 	}
+	rc = 0;
 exit:
 	return rc;
 }
@@ -259,6 +305,89 @@ free_iter_bufs(uint32_t nr, daos_iod_t *iods_iter, d_sg_list_t *sgl_recx_iter)
 		D_FREE(iods_iter);
 }
 
+static void
+free_batch_recs(uint32_t nr, uint32_t nr_iods, struct filter_batch_rec_t *recs)
+{
+	uint32_t i;
+
+	if (recs == NULL)
+		return;
+	for (i = 0; i < nr; i++) {
+		free_iter_bufs(nr_iods, recs[i].iods, recs[i].akeys);
+		if (recs[i].dkey.iov_buf != NULL)
+			D_FREE(recs[i].dkey.iov_buf);
+	}
+	D_FREE(recs);
+}
+
+static int
+alloc_batch_recs(daos_iod_t *iods, uint32_t nr_iods, uint32_t nr,
+		 struct filter_batch_rec_t **recs)
+{
+	struct filter_batch_rec_t *recs_out;
+	uint32_t                   i;
+	int                        rc;
+
+	D_ALLOC_ARRAY(recs_out, nr);
+	if (recs_out == NULL)
+		return -DER_NOMEM;
+
+	for (i = 0; i < nr; i++) {
+		rc = alloc_iter_bufs(iods, nr_iods, &recs_out[i].iods, &recs_out[i].akeys);
+		if (rc != 0) {
+			free_batch_recs(i, nr_iods, recs_out);
+			return rc;
+		}
+	}
+	*recs = recs_out;
+	return 0;
+}
+
+/**
+ * The dkey returned by the iterator points to VOS memory, which is not guaranteed to stay valid
+ * once we yield. Copy it into the record, NUL terminated for the cstring getdata functions.
+ */
+static int
+batch_rec_set_dkey(struct filter_batch_rec_t *rec, d_iov_t *d_key)
+{
+	char *buf;
+
+	if (d_key->iov_len + 1 > rec->dkey.iov_buf_len) {
+		D_ALLOC(buf, d_key->iov_len + 1);
+		if (buf == NULL)
+			return -DER_NOMEM;
+		if (rec->dkey.iov_buf != NULL)
+			D_FREE(rec->dkey.iov_buf);
+		rec->dkey.iov_buf     = buf;
+		rec->dkey.iov_buf_len = d_key->iov_len + 1;
+	}
+	buf = rec->dkey.iov_buf;
+	memcpy(buf, d_key->iov_buf, d_key->iov_len);
+	buf[d_key->iov_len] = '\0';
+	rec->dkey.iov_len   = d_key->iov_len;
+	return 0;
+}
+
+/**
+ * Records are only batched when at least one filter or aggregation can be evaluated over the
+ * whole batch; otherwise there is nothing to gain from holding more than one record in memory.
+ */
+static uint32_t
+pipeline_batch_size(struct pipeline_compiled_t *pipe)
+{
+	uint32_t i;
+
+	for (i = 0; i < pipe->num_filters; i++) {
+		if (pipe->filters[i].batch)
+			return PIPELINE_BATCH_MAX;
+	}
+	for (i = 0; i < pipe->num_aggr_filters; i++) {
+		if (pipe->aggr_filters[i].batch)
+			return PIPELINE_BATCH_MAX;
+	}
+	return 1;
+}
+
 static int
 pack_value(d_sg_list_t *sgl, uint32_t *iov_idx, d_iov_t *iov)
 {
@@ -353,13 +482,16 @@ ds_pipeline_run(daos_handle_t vos_coh, daos_unit_oid_t oid, daos_pipeline_t pipe
 {
 	int                         rc;
 	uint32_t                    nr_kds_pass;
+	uint32_t                    batch_max          = 0;
+	uint32_t                    batch_nr;
+	uint32_t                    r;
 	d_iov_t                     d_key_iter;
-	d_sg_list_t                *sgl_recx_iter      = NULL;
-	daos_iod_t                 *iods_iter          = NULL;
+	struct filter_batch_rec_t  *batch_recs         = NULL;
+	struct filter_batch_rec_t  *rec;
+	struct filter_batch_run_t  *batch              = NULL;
 	struct enum_credits         credits            = {0};
 	struct vos_iter_anchors     anchors            = {0};
 	struct pipeline_compiled_t  pipeline_compiled  = {0};
-	struct filter_part_run_t    pipe_run_args      = {0};
 	struct pack_ret_data_args   pack_args          = {0};
 
 	*nr_kds_out  = 0;
@@ -386,16 +518,20 @@ ds_pipeline_run(daos_handle_t vos_coh, daos_unit_oid_t oid, daos_pipeline_t pipe
 	if (rc != 0)
 		D_GOTO(exit, rc); /** compilation failed. Bad pipeline? */
 
-	/** -- allocating space for temporary bufs */
+	/** -- allocating space for temporary bufs, one set per record of a batch */
 
-	rc = alloc_iter_bufs(iods, nr_iods, &iods_iter, &sgl_recx_iter);
+	batch_max = pipeline_batch_size(&pipeline_compiled);
+	rc        = alloc_batch_recs(iods, nr_iods, batch_max, &batch_recs);
 	if (rc != 0)
 		D_GOTO(exit, rc);
+	D_ALLOC_PTR(batch);
+	if (batch == NULL)
+		D_GOTO(exit, rc = -DER_NOMEM);
 
 	/** -- init pipe run data struct and pack result data struct */
 
-	pipe_run_args.nr_iods  = nr_iods;
-	pipe_run_args.iods     = iods_iter;
+	batch->nr_iods         = nr_iods;
+	batch->recs            = batch_recs;
 
 	pack_args.recx_size    = recx_size;
 	pack_args.nr_iods      = nr_iods;
@@ -418,60 +554,85 @@ ds_pipeline_run(daos_handle_t vos_coh, daos_unit_oid_t oid, daos_pipeline_t pipe
 		if (pipeline.num_aggr_filters == 0 && nr_kds_pass == nr_kds)
 			break; /** all records read */
 
-		/** -- fetching record */
-
-		rc = pipeline_fetch_record(vos_coh, oid, &anchors, epr, iods_iter, nr_iods,
-					   &d_key_iter, sgl_recx_iter);
-		if (rc < 0)
-			D_GOTO(exit, rc); /** error */
-		if (rc == 1)
-			continue; /** nothing returned; no more records? */
-
-		stats->nr_dkeys += 1; /** new record considered for filtering */
+		/**
+		 * -- fetching a batch of records. Without aggregations, we never fetch more records
+		 *    than can still be returned, so the anchor is left right after the last record
+		 *    considered.
+		 */
 
-		credits.used++;
-		if (credits.used > credits.max) {
-			/** we have used all the credit. Yielding... */
-			credits.used = 0;
-			dss_sleep(0); /** 0 msec will not sleep, just yield */
+		batch_nr = batch_max;
+		if (pipeline.num_aggr_filters == 0 && nr_kds - nr_kds_pass < batch_nr)
+			batch_nr = nr_kds - nr_kds_pass;
+
+		batch->nr = 0;
+		while (batch->nr < batch_nr && !daos_anchor_is_eof(&anchors.ia_dkey)) {
+			rec = &batch_recs[batch->nr];
+			rc  = pipeline_fetch_record(vos_coh, oid, &anchors, epr, rec->iods, nr_iods,
+						    &d_key_iter, rec->akeys);
+			if (rc < 0)
+				D_GOTO(exit, rc); /** error */
+			if (rc == 1)
+				continue; /** nothing returned; no more records? */
+
+			rc = batch_rec_set_dkey(rec, &d_key_iter);
+			if (rc != 0)
+				D_GOTO(exit, rc);
+			batch->nr++;
+
+			stats->nr_dkeys += 1; /** new record considered for filtering */
+
+			credits.used++;
+			if (credits.used > credits.max) {
+				/** we have used all the credit. Yielding... */
+				credits.used = 0;
+				dss_sleep(0); /** 0 msec will not sleep, just yield */
+			}
 		}
+		if (batch->nr == 0)
+			continue;
 
 		/** -- doing filtering... */
 
-		rc = pipeline_filters(&pipeline_compiled, &pipe_run_args, &d_key_iter,
-				      sgl_recx_iter);
+		batch->sel = batch->nr == PIPELINE_BATCH_MAX ? ~0ULL : (1ULL << batch->nr) - 1;
+		rc         = pipeline_filters(&pipeline_compiled, batch);
 		if (rc < 0)
 			D_GOTO(exit, rc); /** error */
-		if (rc == 1)
-			continue; /** record does not pass filters */
-
-		/** -- dkey+akey pass filters */
-
-		nr_kds_pass++;
+		if (batch->sel == 0)
+			continue; /** no record passes filters */
 
 		/** -- aggregations */
 
-		rc = pipeline_aggregations(&pipeline_compiled, &pipe_run_args, &d_key_iter,
-					   sgl_recx_iter, sgl_agg);
+		rc = pipeline_aggregations(&pipeline_compiled, batch, sgl_agg);
 		if (rc < 0)
 			D_GOTO(exit, rc);
 
-		/**
-		 * -- Returning matching records. We don't need to return all matching records if
-		 *    aggregation is being performed: at most one is returned.
-		 */
+		for (r = 0; r < batch->nr; r++) {
+			if (!(batch->sel & (1ULL << r)))
+				continue;
 
-		if (nr_kds == 0 || (nr_kds > 0 && pipeline.num_aggr_filters > 0 && nr_kds_pass > 1))
-			continue;
+			/** -- dkey+akey pass filters */
 
-		/**
-		 * -- Saving record info to be returned.
-		 */
+			nr_kds_pass++;
 
-		rc = pack_record(&d_key_iter, iods_iter, sgl_recx_iter, nr_kds_pass - 1,
-				 &pack_args);
-		if (rc != 0)
-			D_GOTO(exit, rc);
+			/**
+			 * -- Returning matching records. We don't need to return all matching
+			 *    records if aggregation is being performed: at most one is returned.
+			 */
+
+			if (nr_kds == 0 ||
+			    (nr_kds > 0 && pipeline.num_aggr_filters > 0 && nr_kds_pass > 1))
+				continue;
+
+			/**
+			 * -- Saving record info to be returned.
+			 */
+
+			rec = &batch_recs[r];
+			rc  = pack_record(&rec->dkey, rec->iods, rec->akeys, nr_kds_pass - 1,
+					  &pack_args);
+			if (rc != 0)
+				D_GOTO(exit, rc);
+		}
 	}
 
 	/**
@@ -502,7 +663,9 @@ ds_pipeline_run(daos_handle_t vos_coh, daos_unit_oid_t oid, daos_pipeline_t pipe
 	rc = 0;
 exit:
 	pipeline_compile_free(&pipeline_compiled);
-	free_iter_bufs(nr_iods, iods_iter, sgl_recx_iter);
+	free_batch_recs(batch_max, nr_iods, batch_recs);
+	if (batch != NULL)
+		D_FREE(batch);
 
 	return rc;
 }
@@ -0,0 +1,489 @@
+/**
+ * (C) Copyright 2024 Intel Corporation.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause-Patent
+ */
+
+/**
+ * Unit tests for the batch versions of the pipeline filter and aggregation functions, which are
+ * checked against the record by record evaluation of the same compiled filters.
+ */
+#define D_LOGFAC DD_FAC(tests)
+
+#include <stdarg.h>
+#include <stdlib.h>
+#include <setjmp.h>
+#include <math.h>
+#include <cmocka.h>
+
+#include <daos/common.h>
+#include "../pipeline_internal.h"
+
+#define TST_PARTS_MAX	8
+#define TST_CONSTS_MAX	2
+#define TST_LOOPS	200
+
+/** dkey layout of the test records */
+#define TST_DKEY_U	0
+#define TST_DKEY_I	8
+#define TST_DKEY_D	16
+#define TST_DKEY_LEN	24
+
+#define TST_AKEY	"a"
+
+union tst_val {
+	uint64_t	u;
+	int64_t		i;
+	double		d;
+};
+
+struct tst_rec {
+	char		tr_dkey[TST_DKEY_LEN];
+	uint64_t	tr_akey;
+	daos_iod_t	tr_iod;
+	d_iov_t		tr_akey_iov;
+	d_sg_list_t	tr_sgl;
+};
+
+struct tst_filter {
+	daos_filter_t		 tf_filter;
+	daos_filter_part_t	*tf_parts[TST_PARTS_MAX];
+	daos_filter_part_t	 tf_part_buf[TST_PARTS_MAX];
+	d_iov_t			 tf_consts[TST_PARTS_MAX][TST_CONSTS_MAX];
+	union tst_val		 tf_vals[TST_PARTS_MAX][TST_CONSTS_MAX];
+};
+
+static struct tst_rec			tst_recs[PIPELINE_BATCH_MAX];
+static struct filter_batch_rec_t	tst_batch_recs[PIPELINE_BATCH_MAX];
+
+static const char *tst_types[] = {
+	"DAOS_FILTER_TYPE_UINTEGER8", "DAOS_FILTER_TYPE_INTEGER8", "DAOS_FILTER_TYPE_REAL8",
+};
+static const size_t tst_offsets[] = {TST_DKEY_U, TST_DKEY_I, TST_DKEY_D};
+
+static void
+tst_str_iov(d_iov_t *iov, const char *str)
+{
+	d_iov_set(iov, (void *)str, strlen(str));
+}
+
+static void
+tst_filter_init(struct tst_filter *tf, const char *filter_type)
+{
+	memset(tf, 0, sizeof(*tf));
+	tst_str_iov(&tf->tf_filter.filter_type, filter_type);
+	tf->tf_filter.parts = tf->tf_parts;
+}
+
+static daos_filter_part_t *
+tst_part(struct tst_filter *tf, const char *part_type, const char *data_type, uint32_t nops)
+{
+	daos_filter_part_t *part;
+
+	assert_true(tf->tf_filter.num_parts < TST_PARTS_MAX);
+	part = &tf->tf_part_buf[tf->tf_filter.num_parts];
+	tf->tf_parts[tf->tf_filter.num_parts++] = part;
+
+	tst_str_iov(&part->part_type, part_type);
+	if (data_type != NULL)
+		tst_str_iov(&part->data_type, data_type);
+	part->num_operands = nops;
+	return part;
+}
+
+static void
+tst_func(struct tst_filter *tf, const char *func, uint32_t nops)
+{
+	tst_part(tf, func, NULL, nops);
+}
+
+/** Field of type t of the dkey */
+static void
+tst_dkey(struct tst_filter *tf, int t)
+{
+	daos_filter_part_t *part;
+
+	part              = tst_part(tf, "DAOS_FILTER_DKEY", tst_types[t], 0);
+	part->data_offset = tst_offsets[t];
+	part->data_len    = sizeof(uint64_t);
+}
+
+/** The uint64_t akey, which is missing from some records */
+static void
+tst_akey(struct tst_filter *tf)
+{
+	daos_filter_part_t *part;
+
+	part           = tst_part(tf, "DAOS_FILTER_AKEY", tst_types[0], 0);
+	part->data_len = sizeof(uint64_t);
+	tst_str_iov(&part->akey, TST_AKEY);
+}
+
+static void
+tst_const(struct tst_filter *tf, int t, int nr, union tst_val *vals)
+{
+	daos_filter_part_t *part;
+	int                 idx = tf->tf_filter.num_parts;
+	int                 i;
+
+	assert_true(nr <= TST_CONSTS_MAX);
+	part                = tst_part(tf, "DAOS_FILTER_CONST", tst_types[t], 0);
+	part->num_constants = nr;
+	part->constant      = tf->tf_consts[idx];
+	for (i = 0; i < nr; i++) {
+		tf->tf_vals[idx][i] = vals[i];
+		d_iov_set(&tf->tf_consts[idx][i], &tf->tf_vals[idx][i], sizeof(uint64_t));
+	}
+}
+
+/** Random records with few distinct values, so that comparisons go both ways */
+static void
+tst_recs_fill(uint32_t nr)
+{
+	struct tst_rec *rec;
+	union tst_val   val;
+	uint32_t        r;
+
+	for (r = 0; r < nr; r++) {
+		rec   = &tst_recs[r];
+		val.u = rand() % 8;
+		memcpy(&rec->tr_dkey[TST_DKEY_U], &val, sizeof(val));
+		val.i = rand() % 8 - 4;
+		memcpy(&rec->tr_dkey[TST_DKEY_I], &val, sizeof(val));
+		val.d = (rand() % 16 - 8) / 2.0;
+		memcpy(&rec->tr_dkey[TST_DKEY_D], &val, sizeof(val));
+
+		rec->tr_akey = rand() % 8;
+		tst_str_iov(&rec->tr_iod.iod_name, TST_AKEY);
+		rec->tr_iod.iod_type = DAOS_IOD_SINGLE;
+		rec->tr_iod.iod_size = sizeof(uint64_t);
+		rec->tr_iod.iod_nr   = 1;
+		d_iov_set(&rec->tr_akey_iov, &rec->tr_akey, sizeof(uint64_t));
+		/** missing akey */
+		if (rand() % 4 == 0)
+			rec->tr_akey_iov.iov_len = 0;
+		rec->tr_sgl.sg_nr   = 1;
+		rec->tr_sgl.sg_iovs = &rec->tr_akey_iov;
+
+		d_iov_set(&tst_batch_recs[r].dkey, rec->tr_dkey, TST_DKEY_LEN);
+		tst_batch_recs[r].iods  = &rec->tr_iod;
+		tst_batch_recs[r].akeys = &rec->tr_sgl;
+	}
+}
+
+static void
+tst_batch_init(struct filter_batch_run_t *batch, struct filter_compiled_t *comp, uint32_t nr,
+	       uint64_t sel)
+{
+	memset(batch, 0, sizeof(*batch));
+	batch->nr      = nr;
+	batch->nr_iods = 1;
+	batch->recs    = tst_batch_recs;
+	batch->parts   = comp->parts;
+	batch->sel     = sel;
+}
+
+static void
+tst_run_init(struct filter_part_run_t *run, struct filter_compiled_t *comp, uint32_t r)
+{
+	memset(run, 0, sizeof(*run));
+	run->nr_iods = 1;
+	run->dkey    = &tst_batch_recs[r].dkey;
+	run->iods    = tst_batch_recs[r].iods;
+	run->akeys   = tst_batch_recs[r].akeys;
+	run->parts   = comp->parts;
+}
+
+static void
+tst_compile(struct tst_filter *tf, bool aggr, daos_pipeline_t *pipe,
+	    struct pipeline_compiled_t *comp)
+{
+	daos_filter_t *filter = &tf->tf_filter;
+
+	memset(pipe, 0, sizeof(*pipe));
+	if (aggr) {
+		pipe->num_aggr_filters = 1;
+		pipe->aggr_filters     = &filter;
+	} else {
+		pipe->num_filters = 1;
+		pipe->filters     = &filter;
+	}
+	assert_rc_equal(d_pipeline_check(pipe), 0);
+	assert_rc_equal(pipeline_compile(pipe, comp), 0);
+}
+
+/** Run a condition filter over random batches, both batched and record by record */
+static void
+tst_check_filter(struct tst_filter *tf)
+{
+	struct pipeline_compiled_t comp;
+	daos_pipeline_t            pipe;
+	struct filter_batch_run_t  batch;
+	struct filter_part_run_t   run;
+	uint64_t                   mask;
+	uint64_t                   sel;
+	uint64_t                   exp;
+	uint32_t                   nr;
+	uint32_t                   r;
+	int                        loop;
+	int                        rc;
+
+	tst_compile(tf, false, &pipe, &comp);
+	/** otherwise there is nothing to compare */
+	assert_true(comp.filters[0].batch);
+
+	for (loop = 0; loop < TST_LOOPS; loop++) {
+		nr = 1 + rand() % PIPELINE_BATCH_MAX;
+		tst_recs_fill(nr);
+		/** as left by the previous filters of the pipeline */
+		sel = ((uint64_t)rand() << 32 | rand()) | (loop % 2 ? ~0ULL : 0);
+		if (nr < PIPELINE_BATCH_MAX)
+			sel &= (1ULL << nr) - 1;
+
+		exp = 0;
+		for (r = 0; r < nr; r++) {
+			if (!(sel & (1ULL << r)))
+				continue;
+			tst_run_init(&run, &comp.filters[0], r);
+			rc = run.parts[0].filter_func(&run);
+			assert_true(rc >= 0);
+			if (rc == 0 && run.log_out)
+				exp |= 1ULL << r;
+		}
+
+		tst_batch_init(&batch, &comp.filters[0], nr, sel);
+		rc = batch.parts[0].batch_func(&batch, &mask);
+		assert_rc_equal(rc, 0);
+		assert_int_equal(mask & sel, exp);
+	}
+	pipeline_compile_free(&comp);
+}
+
+/** Run an aggregation over random batches, both batched and record by record */
+static void
+tst_check_aggr(struct tst_filter *tf, double init)
+{
+	struct pipeline_compiled_t comp;
+	daos_pipeline_t            pipe;
+	struct filter_batch_run_t  batch;
+	struct filter_part_run_t   run;
+	d_iov_t                    iov_exp;
+	d_iov_t                    iov_res;
+	double                     exp = init;
+	double                     res = init;
+	uint64_t                   mask;
+	uint64_t                   sel;
+	uint32_t                   nr;
+	uint32_t                   r;
+	int                        loop;
+	int                        rc;
+
+	tst_compile(tf, true, &pipe, &comp);
+	assert_true(comp.aggr_filters[0].batch);
+	d_iov_set(&iov_exp, &exp, sizeof(exp));
+	d_iov_set(&iov_res, &res, sizeof(res));
+
+	for (loop = 0; loop < TST_LOOPS; loop++) {
+		nr = 1 + rand() % PIPELINE_BATCH_MAX;
+		tst_recs_fill(nr);
+		sel = ((uint64_t)rand() << 32 | rand()) | (loop % 2 ? ~0ULL : 0);
+		if (nr < PIPELINE_BATCH_MAX)
+			sel &= (1ULL << nr) - 1;
+
+		for (r = 0; r < nr; r++) {
+			if (!(sel & (1ULL << r)))
+				continue;
+			tst_run_init(&run, &comp.aggr_filters[0], r);
+			run.iov_aggr = &iov_exp;
+			rc           = run.parts[0].filter_func(&run);
+			assert_rc_equal(rc, 0);
+		}
+
+		tst_batch_init(&batch, &comp.aggr_filters[0], nr, sel);
+		batch.iov_aggr = &iov_res;
+		rc             = batch.parts[0].batch_func(&batch, &mask);
+		assert_rc_equal(rc, 0);
+		/** SUM() adds in record order too, so even doubles are equal */
+		assert_true(res == exp);
+	}
+	pipeline_compile_free(&comp);
+}
+
+static const char *tst_cmp_funcs[] = {
+	"DAOS_FILTER_FUNC_EQ", "DAOS_FILTER_FUNC_NE", "DAOS_FILTER_FUNC_LT",
+	"DAOS_FILTER_FUNC_LE", "DAOS_FILTER_FUNC_GE", "DAOS_FILTER_FUNC_GT",
+};
+
+static union tst_val
+tst_val(int t, int v)
+{
+	union tst_val val;
+
+	if (t == 0)
+		val.u = v;
+	else if (t == 1)
+		val.i = v - 4;
+	else
+		val.d = (v - 4) / 2.0;
+	return val;
+}
+
+/** dkey field <op> constant, for all the comparisons and types */
+static void
+test_batch_cmp(void **state)
+{
+	struct tst_filter tf;
+	union tst_val     val;
+	size_t            f;
+	int               t;
+
+	for (f = 0; f < ARRAY_SIZE(tst_cmp_funcs); f++) {
+		for (t = 0; t < ARRAY_SIZE(tst_types); t++) {
+			tst_filter_init(&tf, "DAOS_FILTER_CONDITION");
+			tst_func(&tf, tst_cmp_funcs[f], 2);
+			tst_dkey(&tf, t);
+			val = tst_val(t, 3);
+			tst_const(&tf, t, 1, &val);
+			tst_check_filter(&tf);
+		}
+	}
+}
+
+/** Comparisons with several constants (IN), and with an akey missing from some records */
+static void
+test_batch_cmp_multi(void **state)
+{
+	struct tst_filter tf;
+	union tst_val     vals[2];
+	size_t            f;
+	int               t;
+
+	for (t = 0; t < ARRAY_SIZE(tst_types); t++) {
+		tst_filter_init(&tf, "DAOS_FILTER_CONDITION");
+		tst_func(&tf, "DAOS_FILTER_FUNC_IN", 2);
+		tst_dkey(&tf, t);
+		vals[0] = tst_val(t, 1);
+		vals[1] = tst_val(t, 5);
+		tst_const(&tf, t, 2, vals);
+		tst_check_filter(&tf);
+	}
+
+	for (f = 0; f < ARRAY_SIZE(tst_cmp_funcs); f++) {
+		tst_filter_init(&tf, "DAOS_FILTER_CONDITION");
+		tst_func(&tf, tst_cmp_funcs[f], 2);
+		tst_akey(&tf);
+		vals[0].u = 4;
+		tst_const(&tf, 0, 1, vals);
+		tst_check_filter(&tf);
+	}
+}
+
+static void
+test_batch_null(void **state)
+{
+	struct tst_filter tf;
+
+	tst_filter_init(&tf, "DAOS_FILTER_CONDITION");
+	tst_func(&tf, "DAOS_FILTER_FUNC_ISNULL", 1);
+	tst_akey(&tf);
+	tst_check_filter(&tf);
+
+	tst_filter_init(&tf, "DAOS_FILTER_CONDITION");
+	tst_func(&tf, "DAOS_FILTER_FUNC_ISNOTNULL", 1);
+	tst_akey(&tf);
+	tst_check_filter(&tf);
+}
+
+/** NOT, AND, and OR over comparisons */
+static void
+test_batch_logical(void **state)
+{
+	struct tst_filter tf;
+	union tst_val     val;
+
+	tst_filter_init(&tf, "DAOS_FILTER_CONDITION");
+	tst_func(&tf, "DAOS_FILTER_FUNC_NOT", 1);
+	tst_func(&tf, "DAOS_FILTER_FUNC_LT", 2);
+	tst_akey(&tf);
+	val.u = 3;
+	tst_const(&tf, 0, 1, &val);
+	tst_check_filter(&tf);
+
+	tst_filter_init(&tf, "DAOS_FILTER_CONDITION");
+	tst_func(&tf, "DAOS_FILTER_FUNC_AND", 2);
+	tst_func(&tf, "DAOS_FILTER_FUNC_GE", 2);
+	tst_dkey(&tf, 1);
+	val = tst_val(1, 2);
+	tst_const(&tf, 1, 1, &val);
+	tst_func(&tf, "DAOS_FILTER_FUNC_LE", 2);
+	tst_dkey(&tf, 2);
+	val = tst_val(2, 6);
+	tst_const(&tf, 2, 1, &val);
+	tst_check_filter(&tf);
+
+	tst_filter_init(&tf, "DAOS_FILTER_CONDITION");
+	tst_func(&tf, "DAOS_FILTER_FUNC_OR", 2);
+	tst_func(&tf, "DAOS_FILTER_FUNC_EQ", 2);
+	tst_akey(&tf);
+	val.u = 2;
+	tst_const(&tf, 0, 1, &val);
+	tst_func(&tf, "DAOS_FILTER_FUNC_GT", 2);
+	tst_dkey(&tf, 0);
+	val.u = 5;
+	tst_const(&tf, 0, 1, &val);
+	tst_check_filter(&tf);
+}
+
+static void
+test_batch_aggr(void **state)
+{
+	static const char *funcs[] = {
+		"DAOS_FILTER_FUNC_SUM", "DAOS_FILTER_FUNC_MAX", "DAOS_FILTER_FUNC_MIN",
+	};
+	static const double inits[] = {0, -INFINITY, INFINITY};
+	struct tst_filter   tf;
+	size_t              f;
+	int                 t;
+
+	for (f = 0; f < ARRAY_SIZE(funcs); f++) {
+		for (t = 0; t < ARRAY_SIZE(tst_types); t++) {
+			tst_filter_init(&tf, "DAOS_FILTER_AGGREGATION");
+			tst_func(&tf, funcs[f], 1);
+			tst_dkey(&tf, t);
+			tst_check_aggr(&tf, inits[f]);
+		}
+		/** records without the akey are skipped */
+		tst_filter_init(&tf, "DAOS_FILTER_AGGREGATION");
+		tst_func(&tf, funcs[f], 1);
+		tst_akey(&tf);
+		tst_check_aggr(&tf, inits[f]);
+	}
+}
+
+static int
+tst_setup(void **state)
+{
+	return d_log_init();
+}
+
+static int
+tst_teardown(void **state)
+{
+	d_log_fini();
+	return 0;
+}
+
+int
+main(void)
+{
+	const struct CMUnitTest tests[] = {
+		cmocka_unit_test(test_batch_cmp),
+		cmocka_unit_test(test_batch_cmp_multi),
+		cmocka_unit_test(test_batch_null),
+		cmocka_unit_test(test_batch_logical),
+		cmocka_unit_test(test_batch_aggr),
+	};
+
+	srand(time(NULL));
+	return cmocka_run_group_tests_name("pipeline_batch", tests, tst_setup, tst_teardown);
+}
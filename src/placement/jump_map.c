@@ -783,6 +783,184 @@ out:
 	return rc;
 }
 
+/*
+ * Layout cache.
+ *
+ * Opening an object and scanning objects for rebuild/migration both compute the
+ * layout from scratch, walking the pool domain tree for every shard. The layout
+ * only depends on the object metadata, the placement arguments and the pool map,
+ * so it is cached per placement map in a bounded direct-mapped table. A new
+ * placement map is created by pl_map_update() whenever the pool map version
+ * changes, so the cache of the old map is simply dropped with it; the pool map
+ * version is part of the key as well to be safe against in-place map reuse.
+ *
+ * Jump consistent hashing is seeded by the full object ID, so objects of the same
+ * class do not share placement and entries are keyed per object. The shard
+ * buffer of a slot is sized to the largest layout it has held.
+ */
+#define JM_LAYOUT_CACHE_DEF	(4096)
+#define JM_LAYOUT_CACHE_MAX	(1U << 20)
+/* Do not cache large layouts, their computation dominates the memory copy anyway */
+#define JM_LAYOUT_CACHE_SHARDS	(128)
+
+static void
+jm_layout_cache_destroy(struct pl_jump_map *jmap)
+{
+	uint32_t	i;
+
+	if (jmap->jmp_cache == NULL)
+		return;
+
+	for (i = 0; i <= jmap->jmp_cache_mask; i++) {
+		D_SPIN_DESTROY(&jmap->jmp_cache[i].jls_lock);
+		D_FREE(jmap->jmp_cache[i].jls_shards);
+	}
+	D_FREE(jmap->jmp_cache);
+}
+
+static int
+jm_layout_cache_create(struct pl_jump_map *jmap)
+{
+	unsigned int	nr = JM_LAYOUT_CACHE_DEF;
+	uint32_t	i;
+	int		rc;
+
+	d_getenv_uint("DAOS_PL_LAYOUT_CACHE", &nr);
+	if (nr == 0) {
+		D_DEBUG(DB_PL, "layout cache is disabled\n");
+		return 0;
+	}
+
+	nr = min(nr, JM_LAYOUT_CACHE_MAX);
+	/* round down to power of 2 */
+	while ((nr & (nr - 1)) != 0)
+		nr &= nr - 1;
+
+	D_ALLOC_ARRAY(jmap->jmp_cache, nr);
+	if (jmap->jmp_cache == NULL)
+		return -DER_NOMEM;
+
+	for (i = 0; i < nr; i++) {
+		rc = D_SPIN_INIT(&jmap->jmp_cache[i].jls_lock, PTHREAD_PROCESS_PRIVATE);
+		if (rc != 0) {
+			while (i-- > 0)
+				D_SPIN_DESTROY(&jmap->jmp_cache[i].jls_lock);
+			D_FREE(jmap->jmp_cache);
+			return rc;
+		}
+	}
+	jmap->jmp_cache_mask = nr - 1;
+	return 0;
+}
+
+static inline struct jm_layout_slot *
+jm_layout_cache_slot(struct pl_jump_map *jmap, struct jm_layout_key *key)
+{
+	uint64_t	hash;
+
+	hash = d_hash_murmur64((unsigned char *)key, sizeof(*key), 0);
+	return &jmap->jmp_cache[hash & jmap->jmp_cache_mask];
+}
+
+static bool
+jm_layout_cache_lookup(struct pl_jump_map *jmap, struct jm_layout_key *key,
+		       struct pl_obj_layout *layout, bool *is_extending)
+{
+	struct jm_layout_slot	*slot = jm_layout_cache_slot(jmap, key);
+	bool			 found = false;
+
+	D_SPIN_LOCK(&slot->jls_lock);
+	if (slot->jls_valid && memcmp(&slot->jls_key, key, sizeof(*key)) == 0) {
+		D_ASSERT(slot->jls_shard_cap >= layout->ol_nr);
+		memcpy(layout->ol_shards, slot->jls_shards,
+		       sizeof(*layout->ol_shards) * layout->ol_nr);
+		layout->ol_ver = slot->jls_ver;
+		if (is_extending != NULL && slot->jls_extending)
+			*is_extending = true;
+		found = true;
+	}
+	D_SPIN_UNLOCK(&slot->jls_lock);
+
+	return found;
+}
+
+static void
+jm_layout_cache_insert(struct pl_jump_map *jmap, struct jm_layout_key *key,
+		       struct pl_obj_layout *layout, bool extending)
+{
+	struct jm_layout_slot	*slot = jm_layout_cache_slot(jmap, key);
+	struct pl_obj_shard	*shards = NULL;
+
+	D_SPIN_LOCK(&slot->jls_lock);
+	if (slot->jls_shard_cap < layout->ol_nr) {
+		/* Allocate outside of the spinlock, the slot buffer only ever grows */
+		D_SPIN_UNLOCK(&slot->jls_lock);
+		D_ALLOC_ARRAY(shards, layout->ol_nr);
+		if (shards == NULL)
+			return;
+		D_SPIN_LOCK(&slot->jls_lock);
+		if (slot->jls_shard_cap < layout->ol_nr) {
+			struct pl_obj_shard	*old = slot->jls_shards;
+
+			slot->jls_shards = shards;
+			slot->jls_shard_cap = layout->ol_nr;
+			shards = old;
+		}
+	}
+	slot->jls_key = *key;
+	slot->jls_ver = layout->ol_ver;
+	slot->jls_extending = extending;
+	memcpy(slot->jls_shards, layout->ol_shards,
+	       sizeof(*layout->ol_shards) * layout->ol_nr);
+	slot->jls_valid = 1;
+	D_SPIN_UNLOCK(&slot->jls_lock);
+
+	/* the replaced buffer, or the new one if another insert grew the slot first */
+	D_FREE(shards);
+}
+
+/* Fill the already allocated \a layout, look up the layout cache first */
+static int
+obj_layout_get(struct pl_jump_map *jmap, uint32_t layout_ver, struct jm_obj_placement *jmop,
+	       struct daos_obj_md *md, uint32_t allow_version, enum layout_gen_mode gen_mode,
+	       struct pl_obj_layout *layout, d_list_t *remap_list, bool *is_extending)
+{
+	struct jm_layout_key	 key;
+	bool			 cached = false;
+	bool			 extending = false;
+	int			 rc;
+
+	/* The remap list is an output of the calculation, it cannot be cached */
+	if (jmap->jmp_cache != NULL && remap_list == NULL &&
+	    layout->ol_nr <= JM_LAYOUT_CACHE_SHARDS) {
+		memset(&key, 0, sizeof(key));
+		key.jlk_md		= *md;
+		key.jlk_layout_ver	= layout_ver;
+		key.jlk_allow_ver	= allow_version;
+		key.jlk_gen_mode	= gen_mode;
+		key.jlk_map_ver		= pool_map_get_version(jmap->jmp_map.pl_poolmap);
+		key.jlk_grp_size	= jmop->jmop_grp_size;
+		key.jlk_grp_nr		= jmop->jmop_grp_nr;
+		if (jm_layout_cache_lookup(jmap, &key, layout, is_extending))
+			return 0;
+		cached = true;
+	}
+
+	rc = get_object_layout(jmap, layout_ver, layout, jmop, remap_list,
+			       allow_version, gen_mode, md, &extending);
+	if (rc) {
+		D_ERROR("get object layout failed, rc "DF_RC"\n",
+			DP_RC(rc));
+		return rc;
+	}
+
+	if (is_extending != NULL && extending)
+		*is_extending = true;
+	if (cached)
+		jm_layout_cache_insert(jmap, &key, layout, extending);
+	return 0;
+}
+
 static int
 obj_layout_alloc_and_get(struct pl_jump_map *jmap, uint32_t layout_ver,
 			 struct jm_obj_placement *jmop, struct daos_obj_md *md,
@@ -803,15 +981,8 @@ obj_layout_alloc_and_get(struct pl_jump_map *jmap, uint32_t layout_ver,
 		return rc;
 	}
 
-	rc = get_object_layout(jmap, layout_ver, *layout_p, jmop, remap_list,
-			       allow_version, gen_mode, md, is_extending);
-	if (rc) {
-		D_ERROR("get object layout failed, rc "DF_RC"\n",
-			DP_RC(rc));
-		D_GOTO(out, rc);
-	}
-
-out:
+	rc = obj_layout_get(jmap, layout_ver, jmop, md, allow_version, gen_mode, *layout_p,
+			    remap_list, is_extending);
 	if (rc != 0) {
 		if (*layout_p != NULL)
 			pl_obj_layout_free(*layout_p);
@@ -832,6 +1003,7 @@ jump_map_destroy(struct pl_map *map)
 
 	jmap = pl_map2jmap(map);
 
+	jm_layout_cache_destroy(jmap);
 	if (jmap->jmp_map.pl_poolmap)
 		pool_map_decref(jmap->jmp_map.pl_poolmap);
 
@@ -897,6 +1069,12 @@ jump_map_create(struct pool_map *poolmap, struct pl_map_init_attr *mia,
 		D_ERROR("cannot find active targets: %d\n", rc);
 		goto ERR;
 	}
+
+	rc = jm_layout_cache_create(jmap);
+	if (rc) {
+		D_ERROR("cannot create layout cache: "DF_RC"\n", DP_RC(rc));
+		goto ERR;
+	}
 	*mapp = &jmap->jmp_map;
 	return DER_SUCCESS;
 ERR:
@@ -1149,6 +1327,121 @@ out:
 	return rc < 0 ? rc : idx;
 }
 
+/* Reset a layout for reusing it with another object, grow the shard array if needed */
+static int
+jm_layout_reset(struct pl_obj_layout *layout, unsigned int *shard_cap,
+		struct jm_obj_placement *jmop)
+{
+	unsigned int	shard_nr = jmop->jmop_grp_size * jmop->jmop_grp_nr;
+
+	if (shard_nr > *shard_cap) {
+		D_FREE(layout->ol_shards);
+		*shard_cap = 0;
+		D_ALLOC_ARRAY(layout->ol_shards, shard_nr);
+		if (layout->ol_shards == NULL)
+			return -DER_NOMEM;
+		*shard_cap = shard_nr;
+	} else {
+		memset(layout->ol_shards, 0, sizeof(*layout->ol_shards) * shard_nr);
+	}
+
+	layout->ol_ver = 0;
+	layout->ol_nr = shard_nr;
+	layout->ol_grp_nr = jmop->jmop_grp_nr;
+	layout->ol_grp_size = jmop->jmop_grp_size;
+	return 0;
+}
+
+/**
+ * Batched jump_map_obj_find_diff() for rebuild scanning. The map version is
+ * checked once, the two layouts are reused across objects instead of being
+ * allocated per object, and consecutive identical objects (shards of the same
+ * object stored on one target) share the result.
+ *
+ * Jump consistent hashing walks the domain tree with a key chain depending on
+ * the previous selection of the same object, so the per object hashing itself
+ * cannot be vectorized across objects.
+ */
+static int
+jump_map_obj_find_diff_batch(struct pl_map *map, uint32_t layout_ver, struct daos_obj_md *mds,
+			     unsigned int md_nr, uint32_t reint_ver, uint32_t *tgt_rank,
+			     uint32_t *shard_id, unsigned int array_size,
+			     struct pl_rebuild_range *ranges)
+{
+	struct pl_jump_map	*jmap = pl_map2jmap(map);
+	struct pl_obj_layout	 layout = { 0 };
+	struct pl_obj_layout	 reint_layout = { 0 };
+	unsigned int		 layout_cap = 0;
+	unsigned int		 reint_cap = 0;
+	struct jm_obj_placement	 jop;
+	d_list_t		 reint_list;
+	unsigned int		 i;
+	int			 start;
+	int			 idx = 0;
+	int			 rc = 0;
+
+	D_DEBUG(DB_PL, "Finding Rebuild shards of %u objects at version: %u\n", md_nr,
+		reint_ver);
+
+	/* Caller should guarantee the pl_map is up-to-date */
+	if (pl_map_version(map) < reint_ver) {
+		D_ERROR("pl_map version(%u) < rebuild version(%u)\n",
+			pl_map_version(map), reint_ver);
+		return -DER_INVAL;
+	}
+
+	D_INIT_LIST_HEAD(&reint_list);
+	for (i = 0; i < md_nr; i++) {
+		struct daos_obj_md *md = &mds[i];
+
+		if (i > 0 && memcmp(md, &mds[i - 1], sizeof(*md)) == 0) {
+			ranges[i] = ranges[i - 1];
+			continue;
+		}
+
+		rc = jm_obj_placement_init(jmap, md, NULL, &jop);
+		if (rc) {
+			D_ERROR("jm_obj_placement_init failed, rc %d.\n", rc);
+			break;
+		}
+
+		rc = jm_layout_reset(&layout, &layout_cap, &jop);
+		if (rc == 0)
+			rc = jm_layout_reset(&reint_layout, &reint_cap, &jop);
+		if (rc == 0)
+			rc = obj_layout_get(jmap, layout_ver, &jop, md, reint_ver, PRE_REBUILD,
+					    &layout, NULL, NULL);
+		if (rc == 0)
+			rc = obj_layout_get(jmap, layout_ver, &jop, md, reint_ver, POST_REBUILD,
+					    &reint_layout, NULL, NULL);
+		if (rc == 0) {
+			layout_find_diff(jmap, &layout, &reint_layout, &reint_list, true);
+			start = idx;
+			rc = remap_list_fill(map, md, NULL, reint_ver, tgt_rank, shard_id,
+					     array_size, &idx, &reint_layout, &reint_list, false);
+			if (rc == 0) {
+				ranges[i].prr_start = start;
+				ranges[i].prr_nr = idx - start;
+			} else {
+				idx = start;
+			}
+		}
+		jm_obj_placement_fini(&jop);
+		remap_list_free_all(&reint_list);
+		if (rc)
+			break;
+	}
+
+	D_FREE(layout.ol_shards);
+	D_FREE(reint_layout.ol_shards);
+
+	/* Partial result, let the caller consume it and come back for the rest */
+	if (rc == -DER_REC2BIG && i > 0)
+		return i;
+
+	return rc < 0 ? rc : i;
+}
+
 /** API for generic placement map functionality */
 struct pl_map_ops       jump_map_ops = {
 	.o_create               = jump_map_create,
@@ -1157,4 +1450,5 @@ struct pl_map_ops       jump_map_ops = {
 	.o_print                = jump_map_print,
 	.o_obj_place            = jump_map_obj_place,
 	.o_obj_find_rebuild     = jump_map_obj_find_diff,
+	.o_obj_find_rebuild_batch = jump_map_obj_find_diff_batch,
 };
@@ -33,6 +33,29 @@ struct jm_obj_placement {
 	struct pool_domain	 *jmop_pd_ptrs_inline[JMOP_PD_INLINE];
 };
 
+/** Key of a cached object layout, all the inputs of get_object_layout() */
+struct jm_layout_key {
+	struct daos_obj_md	jlk_md;
+	uint32_t		jlk_layout_ver;
+	uint32_t		jlk_allow_ver;
+	uint32_t		jlk_gen_mode;
+	uint32_t		jlk_map_ver;
+	uint32_t		jlk_grp_size;
+	uint32_t		jlk_grp_nr;
+};
+
+/** One slot of the direct-mapped layout cache */
+struct jm_layout_slot {
+	pthread_spinlock_t	 jls_lock;
+	/* The slot holds a valid layout */
+	uint32_t		 jls_valid:1,
+				 jls_extending:1;
+	uint32_t		 jls_ver;
+	uint32_t		 jls_shard_cap;
+	struct jm_layout_key	 jls_key;
+	struct pl_obj_shard	*jls_shards;
+};
+
 /**
  * jump_map Placement map structure used to place objects.
  * The map is returned as a struct pl_map and then converted back into a
@@ -50,6 +73,10 @@ struct pl_jump_map {
 	unsigned int		jmp_target_nr;
 	/* The dom that will contain no colocated shards */
 	pool_comp_type_t	jmp_redundant_dom;
+	/* Number of layout cache slots minus one, cache disabled if jmp_cache is NULL */
+	uint32_t		jmp_cache_mask;
+	/* Computed object layouts, only valid for the pool map version of this map */
+	struct jm_layout_slot	*jmp_cache;
 };
 
 struct pool_domain *
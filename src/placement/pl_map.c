@@ -157,6 +157,65 @@ pl_obj_find_rebuild(struct pl_map *map, uint32_t layout_gl_version, struct daos_
 					       tgt_rank, shard_id, array_size);
 }
 
+/**
+ * Batched version of pl_obj_find_rebuild() for scanning many objects, the
+ * placement map can amortize the per-call setup and reuse the result for
+ * consecutive identical objects.
+ *
+ * \param[in]  map		pl_map this check is performed on
+ * \param[in]  mds		metadata of the objects
+ * \param[in]  md_nr		number of objects in \a mds
+ * \param[in]  rebuild_ver	current rebuild version
+ * \param[out] tgt_rank		spare target ranks of all objects
+ * \param[out] shard_id		shard ids to be rebuilt of all objects
+ * \param[in]  array_size	array size of tgt_rank & shard_id
+ * \param[out] ranges		per object range in tgt_rank & shard_id, ranges
+ *				of identical objects may overlap.
+ *
+ * \return      > 0     number of objects processed from the head of \a mds,
+ *                      can be less than \a md_nr if the arrays are full.
+ *              -DER_REC2BIG  the arrays cannot hold the first object.
+ *              -ve     other error code.
+ */
+int
+pl_obj_find_rebuild_batch(struct pl_map *map, uint32_t layout_gl_version,
+			  struct daos_obj_md *mds, unsigned int md_nr,
+			  uint32_t rebuild_ver, uint32_t *tgt_rank,
+			  uint32_t *shard_id, unsigned int array_size,
+			  struct pl_rebuild_range *ranges)
+{
+	unsigned int	used = 0;
+	unsigned int	i;
+	int		rc;
+
+	D_ASSERT(map->pl_ops != NULL);
+	D_ASSERT(md_nr > 0);
+
+	if (map->pl_ops->o_obj_find_rebuild_batch)
+		return map->pl_ops->o_obj_find_rebuild_batch(map, layout_gl_version, mds, md_nr,
+							     rebuild_ver, tgt_rank, shard_id,
+							     array_size, ranges);
+
+	if (!map->pl_ops->o_obj_find_rebuild)
+		return -DER_NOSYS;
+
+	for (i = 0; i < md_nr; i++) {
+		rc = map->pl_ops->o_obj_find_rebuild(map, layout_gl_version, &mds[i], NULL,
+						     rebuild_ver, tgt_rank + used,
+						     shard_id + used, array_size - used);
+		if (rc == -DER_REC2BIG && i > 0)
+			break;
+		if (rc < 0)
+			return rc;
+
+		ranges[i].prr_start = used;
+		ranges[i].prr_nr = rc;
+		used += rc;
+	}
+
+	return i;
+}
+
 void
 pl_obj_layout_free(struct pl_obj_layout *layout)
 {
@@ -49,6 +49,16 @@ struct pl_map_ops {
 				  uint32_t *tgt_rank,
 				  uint32_t *shard_id,
 				  unsigned int array_size);
+	/** see \a pl_obj_find_rebuild_batch, optional */
+	int (*o_obj_find_rebuild_batch)(struct pl_map *map,
+					uint32_t layout_gl_version,
+					struct daos_obj_md *mds,
+					unsigned int md_nr,
+					uint32_t rebuild_ver,
+					uint32_t *tgt_rank,
+					uint32_t *shard_id,
+					unsigned int array_size,
+					struct pl_rebuild_range *ranges);
 };
 
 unsigned int pl_obj_shard2grp_head(struct daos_obj_shard_md *shard_md,
@@ -13,6 +13,9 @@
 /* Gain some internal knowledge of pool server */
 #include "../../pool/rpc.h"
 #include "../../pool/srv_pool_map.h"
+/* And of the jump map layout cache */
+#include "../pl_map.h"
+#include "../jump_map.h"
 
 bool g_verbose;
 
@@ -2299,6 +2302,226 @@ fail_multiple_ranks(void **state)
 	jtc_fini(&ctx);
 }
 
+/*
+ * ------------------------------------------------
+ * Layout cache
+ * ------------------------------------------------
+ */
+#define JM_CACHE_POISON	0xdeadbeef
+
+static void
+jm_cache_md(struct jm_test_ctx *ctx, struct daos_obj_md *md)
+{
+	/* The cache compares the keys bytewise, padding included */
+	memset(md, 0, sizeof(*md));
+	md->omd_id = ctx->oid;
+	md->omd_ver = ctx->ver;
+}
+
+/* Return the slot caching the layout of \a md for the current pool map version */
+static struct jm_layout_slot *
+jm_cache_slot_find(struct pl_map *pl_map, struct daos_obj_md *md)
+{
+	struct pl_jump_map	*jmap = container_of(pl_map, struct pl_jump_map, jmp_map);
+	struct jm_layout_slot	*slot;
+	uint32_t		 i;
+
+	assert_non_null(jmap->jmp_cache);
+	for (i = 0; i <= jmap->jmp_cache_mask; i++) {
+		slot = &jmap->jmp_cache[i];
+		if (slot->jls_valid &&
+		    slot->jls_key.jlk_map_ver == pool_map_get_version(pl_map->pl_poolmap) &&
+		    memcmp(&slot->jls_key.jlk_md, md, sizeof(*md)) == 0)
+			return slot;
+	}
+	return NULL;
+}
+
+/* Create a placement map like \a like, but without layout cache */
+static struct pl_map *
+jm_cache_fresh_map(struct pl_map *like)
+{
+	struct pl_map_init_attr	 mia = {0};
+	struct pl_map		*pl_map;
+
+	assert_success(d_setenv("DAOS_PL_LAYOUT_CACHE", "0", 1));
+	mia.ia_type = PL_TYPE_JUMP_MAP;
+	mia.ia_jump_map.domain = container_of(like, struct pl_jump_map, jmp_map)->jmp_redundant_dom;
+	assert_success(pl_map_create(like->pl_poolmap, &mia, &pl_map));
+	assert_success(d_unsetenv("DAOS_PL_LAYOUT_CACHE"));
+
+	assert_null(container_of(pl_map, struct pl_jump_map, jmp_map)->jmp_cache);
+	return pl_map;
+}
+
+static void
+jm_cache_layout_equal(struct pl_obj_layout *lo_1, struct pl_obj_layout *lo_2)
+{
+	struct pl_obj_shard	*s_1;
+	struct pl_obj_shard	*s_2;
+	int			 i;
+
+	assert_int_equal(lo_1->ol_ver, lo_2->ol_ver);
+	assert_int_equal(lo_1->ol_nr, lo_2->ol_nr);
+	assert_int_equal(lo_1->ol_grp_nr, lo_2->ol_grp_nr);
+	assert_int_equal(lo_1->ol_grp_size, lo_2->ol_grp_size);
+	for (i = 0; i < lo_1->ol_nr; i++) {
+		s_1 = &lo_1->ol_shards[i];
+		s_2 = &lo_2->ol_shards[i];
+		assert_int_equal(s_1->po_shard, s_2->po_shard);
+		assert_int_equal(s_1->po_target, s_2->po_target);
+		assert_int_equal(s_1->po_fseq, s_2->po_fseq);
+		assert_int_equal(s_1->po_rank, s_2->po_rank);
+		assert_int_equal(s_1->po_index, s_2->po_index);
+		assert_int_equal(s_1->po_rebuilding, s_2->po_rebuilding);
+		assert_int_equal(s_1->po_reintegrating, s_2->po_reintegrating);
+	}
+}
+
+static void
+layout_cache_hit(void **state)
+{
+	struct jm_test_ctx	 ctx;
+	struct daos_obj_md	 md;
+	struct pl_obj_layout	*layout = NULL;
+	struct pl_obj_layout	*cached = NULL;
+	struct jm_layout_slot	*slot;
+	uint32_t		 tgt;
+
+	jtc_init(&ctx, 4, 1, 8, OC_RP_3G2, g_verbose);
+	jm_cache_md(&ctx, &md);
+	assert_null(jm_cache_slot_find(ctx.pl_map, &md));
+
+	/* The first placement computes the layout and caches it */
+	assert_success(pl_obj_place(ctx.pl_map, PLT_LAYOUT_VERSION, &md, 0, NULL, &layout));
+	slot = jm_cache_slot_find(ctx.pl_map, &md);
+	assert_non_null(slot);
+	assert_true(slot->jls_shard_cap >= layout->ol_nr);
+	assert_int_equal(slot->jls_ver, layout->ol_ver);
+	assert_memory_equal(slot->jls_shards, layout->ol_shards,
+			    sizeof(*layout->ol_shards) * layout->ol_nr);
+
+	/* The next one is served from the cache, as the tampered slot shows */
+	tgt = slot->jls_shards[0].po_target;
+	slot->jls_shards[0].po_target = JM_CACHE_POISON;
+	assert_success(pl_obj_place(ctx.pl_map, PLT_LAYOUT_VERSION, &md, 0, NULL, &cached));
+	assert_int_equal(cached->ol_shards[0].po_target, JM_CACHE_POISON);
+	slot->jls_shards[0].po_target = tgt;
+	cached->ol_shards[0].po_target = tgt;
+	jm_cache_layout_equal(cached, layout);
+
+	pl_obj_layout_free(cached);
+	pl_obj_layout_free(layout);
+	jtc_fini(&ctx);
+}
+
+static void
+layout_cache_map_version(void **state)
+{
+	struct jm_test_ctx	 ctx;
+	struct daos_obj_md	 md;
+	struct pl_obj_layout	*layout = NULL;
+	struct pl_obj_layout	*fresh_layout = NULL;
+	struct pl_map		*pl_map;
+	struct pl_map		*fresh;
+	struct jm_layout_slot	*slot;
+
+	jtc_init(&ctx, 4, 1, 8, OC_RP_3G2, g_verbose);
+	jm_cache_md(&ctx, &md);
+	assert_success(pl_obj_place(ctx.pl_map, PLT_LAYOUT_VERSION, &md, 0, NULL, &layout));
+	slot = jm_cache_slot_find(ctx.pl_map, &md);
+	assert_non_null(slot);
+	slot->jls_shards[0].po_target = JM_CACHE_POISON;
+
+	/*
+	 * The pool map changes under the placement map, which is kept in use. The layout
+	 * cached for the previous version is not returned any more, even for the same
+	 * object metadata.
+	 */
+	jtc_set_status_on_target(&ctx, DOWN, layout->ol_shards[0].po_target);
+	assert_null(jm_cache_slot_find(ctx.pl_map, &md));
+	pl_obj_layout_free(layout);
+	layout = NULL;
+	assert_success(pl_obj_place(ctx.pl_map, PLT_LAYOUT_VERSION, &md, 0, NULL, &layout));
+	assert_int_not_equal(layout->ol_shards[0].po_target, JM_CACHE_POISON);
+	assert_non_null(jm_cache_slot_find(ctx.pl_map, &md));
+
+	fresh = jm_cache_fresh_map(ctx.pl_map);
+	assert_success(pl_obj_place(fresh, PLT_LAYOUT_VERSION, &md, 0, NULL, &fresh_layout));
+	jm_cache_layout_equal(layout, fresh_layout);
+	pl_obj_layout_free(fresh_layout);
+	pl_obj_layout_free(layout);
+	pl_map_decref(fresh);
+	fresh_layout = NULL;
+	layout = NULL;
+
+	/* The placement map created for the new version starts with an empty cache */
+	pl_map = pl_map_find(ctx.pl_uuid, ctx.oid);
+	assert_non_null(pl_map);
+	assert_ptr_not_equal(pl_map, ctx.pl_map);
+	assert_int_equal(pl_map_version(pl_map), ctx.ver);
+	assert_null(jm_cache_slot_find(pl_map, &md));
+	assert_success(pl_obj_place(pl_map, PLT_LAYOUT_VERSION, &md, 0, NULL, &layout));
+	assert_non_null(jm_cache_slot_find(pl_map, &md));
+
+	fresh = jm_cache_fresh_map(pl_map);
+	assert_success(pl_obj_place(fresh, PLT_LAYOUT_VERSION, &md, 0, NULL, &fresh_layout));
+	jm_cache_layout_equal(layout, fresh_layout);
+
+	pl_obj_layout_free(fresh_layout);
+	pl_obj_layout_free(layout);
+	pl_map_decref(fresh);
+	pl_map_decref(pl_map);
+	jtc_fini(&ctx);
+}
+
+static void
+layout_cache_matches_fresh(void **state)
+{
+	struct jm_test_ctx	 ctx;
+	daos_oclass_id_t	 classes[] = {OC_S4, OC_RP_3G2, OC_EC_4P2G1, OC_RP_2GX};
+	struct daos_obj_md	 md;
+	struct pl_obj_layout	*layout;
+	struct pl_obj_layout	*cached;
+	struct pl_obj_layout	*fresh_layout;
+	struct pl_map		*fresh;
+	int			 round;
+	int			 i;
+	int			 j;
+
+	jtc_init(&ctx, 8, 1, 4, OC_S1, g_verbose);
+
+	/* Healthy, then with a target being rebuilt */
+	for (round = 0; round < 2; round++) {
+		if (round == 1)
+			jtc_set_status_on_target(&ctx, DOWN, 0);
+
+		fresh = jm_cache_fresh_map(ctx.pl_map);
+		for (i = 0; i < ARRAY_SIZE(classes); i++) {
+			for (j = 0; j < 32; j++) {
+				jtc_set_object_meta(&ctx, classes[i], j + 1, UINT64_MAX);
+				jm_cache_md(&ctx, &md);
+				layout = cached = fresh_layout = NULL;
+				assert_success(pl_obj_place(ctx.pl_map, PLT_LAYOUT_VERSION, &md, 0,
+							    NULL, &layout));
+				assert_non_null(jm_cache_slot_find(ctx.pl_map, &md));
+				assert_success(pl_obj_place(ctx.pl_map, PLT_LAYOUT_VERSION, &md, 0,
+							    NULL, &cached));
+				assert_success(pl_obj_place(fresh, PLT_LAYOUT_VERSION, &md, 0,
+							    NULL, &fresh_layout));
+				jm_cache_layout_equal(layout, fresh_layout);
+				jm_cache_layout_equal(cached, fresh_layout);
+				pl_obj_layout_free(layout);
+				pl_obj_layout_free(cached);
+				pl_obj_layout_free(fresh_layout);
+			}
+		}
+		pl_map_decref(fresh);
+	}
+
+	jtc_fini(&ctx);
+}
+
 /*
  * ------------------------------------------------
  * End Test Cases
@@ -2396,6 +2619,13 @@ static const struct CMUnitTest tests[] = {
 	  fail_shard_during_reintegration),
 	T("fail reintegrate ranks", fail_reintegrate_multiple_ranks),
 	T("fail multiple ranks", fail_multiple_ranks),
+	/* Layout cache */
+	T("A placed layout is cached and served from the cache the next time",
+	  layout_cache_hit),
+	T("A cached layout is not used after the pool map version changes",
+	  layout_cache_map_version),
+	T("Cached layouts match the ones computed without cache",
+	  layout_cache_matches_fresh),
 };
 
 int
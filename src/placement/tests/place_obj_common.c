@@ -513,6 +513,10 @@ plt_spare_tgts_get(uuid_t pl_uuid, daos_obj_id_t oid, uint32_t *failed_tgts,
 		   struct pool_map *po_map, struct pl_map *pl_map)
 {
 	struct daos_obj_md	md = { 0 };
+	struct daos_obj_md	batch_mds[2];
+	struct pl_rebuild_range	ranges[2];
+	uint32_t		*batch_tgts;
+	uint32_t		*batch_shards;
 	int			i;
 	int			rc;
 
@@ -535,6 +539,26 @@ plt_spare_tgts_get(uuid_t pl_uuid, daos_obj_id_t oid, uint32_t *failed_tgts,
 		D_PRINT("shard %d, spare target rank %d\n",
 			shard_ids[i], spare_tgt_ranks[i]);
 
+	/* The batched lookup must agree with the single object one */
+	D_ALLOC_ARRAY(batch_tgts, spare_max_nr);
+	D_ALLOC_ARRAY(batch_shards, spare_max_nr);
+	D_ASSERT(batch_tgts != NULL && batch_shards != NULL);
+	batch_mds[0] = md;
+	batch_mds[1] = md;
+	rc = pl_obj_find_rebuild_batch(pl_map, PLT_LAYOUT_VERSION, batch_mds, 2, *po_ver,
+				       batch_tgts, batch_shards, spare_max_nr, ranges);
+	assert_int_equal(rc, 2);
+	for (i = 0; i < 2; i++) {
+		assert_int_equal(ranges[i].prr_start, 0);
+		assert_int_equal(ranges[i].prr_nr, *spare_cnt);
+	}
+	for (i = 0; i < *spare_cnt; i++) {
+		assert_int_equal(batch_tgts[i], spare_tgt_ranks[i]);
+		assert_int_equal(batch_shards[i], shard_ids[i]);
+	}
+	D_FREE(batch_tgts);
+	D_FREE(batch_shards);
+
 	pl_map_decref(pl_map);
 	for (i = 0; i < failed_cnt; i++)
 		plt_reint_tgt_up(failed_tgts[i], po_ver, po_map, pl_debug_msg);
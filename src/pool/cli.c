@@ -98,8 +98,8 @@ dc_pool_metrics_alloc(uuid_t pool_uuid, struct dc_pool_metrics **metrics_p)
 	snprintf(metrics->dp_path, sizeof(metrics->dp_path), "pool/" DF_UUIDF,
 		 DP_UUID(metrics->dp_uuid));
 
-	/** create new shmem space for per-pool metrics */
-	size = daos_module_nr_pool_metrics() * PER_METRIC_BYTES;
+	/** create new shmem space for per-pool metrics, the counters are sharded */
+	size = daos_module_nr_pool_metrics() * (PER_METRIC_BYTES + D_TM_SHARDS_BYTES);
 	rc   = d_tm_add_ephemeral_dir(NULL, size, metrics->dp_path);
 	if (rc != 0) {
 		D_WARN(DF_UUID ": failed to create metrics dir for pool: " DF_RC "\n",
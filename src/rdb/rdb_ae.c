@@ -0,0 +1,155 @@
+/**
+ * (C) Copyright 2024 Intel Corporation.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause-Patent
+ */
+/**
+ * rdb: AppendEntries Pipeline
+ *
+ * Raft only advances the next index of a follower when an AE reply arrives,
+ * so it keeps asking us to resend entries that are still in flight. The
+ * leader records, per follower, the range of every AE carrying entries that
+ * is in flight, oldest first, trims those entries from later AEs, and limits
+ * the number of such AEs. Heartbeats (AEs without entries) are not recorded.
+ *
+ * A follower also records here when the AEs it accepts make its state fresh
+ * enough for rdb_tx_begin_stale.
+ *
+ * All functions here must be called with d_raft_mutex held.
+ */
+
+#define D_LOGFAC	DD_FAC(rdb)
+
+#include <daos_srv/rdb.h>
+
+#include "rdb_internal.h"
+
+/*
+ * Return the number of AEs with entries in flight to \a rdb_node. The AEs are
+ * forgotten if they were sent in an earlier term or if the oldest one has not
+ * been replied within \a timeout_ms, in which case it is presumed lost.
+ */
+unsigned int
+rdb_ae_inflight(struct rdb_raft_node *rdb_node, uint64_t term, uint64_t now_ms,
+		uint64_t timeout_ms)
+{
+	if (rdb_node->dn_ae_inflight > 0 &&
+	    (rdb_node->dn_ae_term != term ||
+	     now_ms - rdb_node->dn_ae[0].dra_sent_ms >= timeout_ms))
+		rdb_node->dn_ae_inflight = 0;
+	return rdb_node->dn_ae_inflight;
+}
+
+/*
+ * Trim the entries of \a ae that are in flight to \a rdb_node already. If all
+ * of them are, \a ae becomes a heartbeat, which still carries the leader
+ * commit index and renews the lease. Return false if \a ae still carries
+ * entries but \a max AEs with entries are in flight, in which case it shall be
+ * deferred.
+ */
+bool
+rdb_ae_prepare(struct rdb_raft_node *rdb_node, msg_appendentries_t *ae, unsigned int max,
+	       uint64_t now_ms, uint64_t timeout_ms)
+{
+	uint64_t skip;
+
+	if (rdb_ae_inflight(rdb_node, ae->term, now_ms, timeout_ms) == 0)
+		return true;
+
+	if (ae->n_entries > 0 && ae->prev_log_idx < rdb_node->dn_ae_sent) {
+		skip = rdb_node->dn_ae_sent - ae->prev_log_idx;
+		if (skip >= ae->n_entries) {
+			ae->entries = NULL;
+			ae->n_entries = 0;
+		} else {
+			ae->prev_log_idx = rdb_node->dn_ae_sent;
+			ae->prev_log_term = ae->entries[skip - 1].term;
+			ae->entries += skip;
+			ae->n_entries -= skip;
+		}
+	}
+
+	return ae->n_entries == 0 || rdb_node->dn_ae_inflight < max;
+}
+
+/* Record that \a ae has been sent to \a rdb_node. */
+void
+rdb_ae_sent(struct rdb_raft_node *rdb_node, const msg_appendentries_t *ae, uint64_t now_ms)
+{
+	struct rdb_raft_ae *sent;
+
+	if (ae->n_entries == 0)
+		return;
+
+	/* rdb_ae_prepare keeps dn_ae_inflight below the maximum. */
+	D_ASSERTF(rdb_node->dn_ae_inflight < RDB_AE_INFLIGHT_MAX, "%u\n",
+		  rdb_node->dn_ae_inflight);
+	if (rdb_node->dn_ae_inflight == 0)
+		rdb_node->dn_ae_term = ae->term;
+	sent = &rdb_node->dn_ae[rdb_node->dn_ae_inflight++];
+	sent->dra_start = ae->prev_log_idx + 1;
+	sent->dra_end = ae->prev_log_idx + ae->n_entries;
+	sent->dra_sent_ms = now_ms;
+	rdb_node->dn_ae_sent = sent->dra_end;
+}
+
+/*
+ * Retire the AEs whose entries the follower has all appended according to
+ * \a resp. A heartbeat reply covers none of the AEs in flight, whose entries
+ * all come after the follower's next index, hence does not retire any. If the
+ * follower rejected an AE, or appended only part of one, forget all of them,
+ * so that raft resends whatever is missing.
+ */
+void
+rdb_ae_reply(struct rdb_raft_node *rdb_node, const msg_appendentries_response_t *resp)
+{
+	unsigned int	n = rdb_node->dn_ae_inflight;
+	unsigned int	i;
+
+	if (n == 0)
+		return;
+
+	if (!resp->success) {
+		rdb_node->dn_ae_inflight = 0;
+		return;
+	}
+
+	for (i = 0; i < n && rdb_node->dn_ae[i].dra_end <= resp->current_idx; i++)
+		;
+	if (i < n && resp->current_idx >= rdb_node->dn_ae[i].dra_start) {
+		rdb_node->dn_ae_inflight = 0;
+		return;
+	}
+
+	memmove(&rdb_node->dn_ae[0], &rdb_node->dn_ae[i], (n - i) * sizeof(rdb_node->dn_ae[0]));
+	rdb_node->dn_ae_inflight = n - i;
+}
+
+/*
+ * On a follower, note that \a in has been accepted according to \a resp at
+ * \a now_ms. If the leader held leadership leases from a majority when
+ * sending \a in, no other replica could have been leader then, so once we
+ * have applied up to the commit index in \a in, our state is at least as
+ * fresh as the leader's was when sending \a in. An AE from a deposed leader
+ * that has yet to learn of the new term does not carry RDB_AE_LEASED, as the
+ * new leader has been elected only after the leases had expired.
+ */
+void
+rdb_ae_refresh(struct rdb *db, const struct rdb_appendentries_in *in,
+	       const msg_appendentries_response_t *resp, uint64_t now_ms)
+{
+	if (resp->success && (in->aei_flags & RDB_AE_LEASED) &&
+	    db->d_applied >= in->aei_msg.leader_commit)
+		db->d_fresh_ms = now_ms;
+}
+
+/*
+ * Return true if, at \a now_ms, our state is at most \a staleness
+ * milliseconds older than the leader's, plus the delay of the AE that last
+ * refreshed it; see rdb_ae_refresh.
+ */
+bool
+rdb_ae_fresh(struct rdb *db, uint64_t staleness, uint64_t now_ms)
+{
+	return db->d_fresh_ms != 0 && now_ms - db->d_fresh_ms <= staleness;
+}
@@ -69,7 +69,8 @@ struct rdb_chkpt_record {
  *  d_mutex: for RPC mgmt and ref count:
  *    d_requests, d_replies/cv, d_ref/cv
  *  d_raft_mutex: for raft state
- *    d_lc_record, d_applied/cv, d_events[]/cv, d_nevents, d_compact_cv
+ *    d_lc_record, d_applied/cv, d_events[]/cv, d_nevents, d_compact_cv,
+ *    d_appends, d_appending, d_lease_waiters, d_fresh_ms
  *
  * TODO: locking for d_stop
  */
@@ -106,6 +107,10 @@ struct rdb {
 	uint64_t		d_debut;	/* first entry in a term */
 	ABT_cond		d_applied_cv;	/* for d_applied updates */
 	struct d_hash_table	d_results;	/* rdb_raft_result hash */
+	d_list_t		d_appends;	/* rdb_raft_append queue */
+	bool			d_appending;	/* a ULT is appending d_appends */
+	int			d_lease_waiters;/* in rdb_raft_renew_leases */
+	uint64_t		d_fresh_ms;	/* see rdb_ae_refresh */
 	d_list_t		d_requests;	/* RPCs waiting for replies */
 	d_list_t		d_replies;	/* RPCs received replies */
 	ABT_cond		d_replies_cv;	/* for d_replies enqueues */
@@ -122,6 +127,8 @@ struct rdb {
 	ABT_thread		d_compactd;
 	size_t			d_ae_max_size;
 	unsigned int		d_ae_max_entries;
+	unsigned int		d_ae_max_inflight;
+	unsigned int		d_is_max_inflight;
 };
 
 /* thresholds of free space for a leader to avoid appending new log entries (4 MiB)
@@ -161,12 +168,28 @@ struct rdb *rdb_lookup(const uuid_t uuid);
  * Per-raft_node_t INSTALLSNAPSHOT state
  *
  * dis_seq and dis_anchor track the last chunk successfully received by the
- * follower.
+ * follower. dis_inflight counts the chunks of generation dis_gen in flight;
+ * see rdb_is.c.
  */
 struct rdb_raft_is {
 	uint64_t		dis_index;	/* snapshot index */
 	uint64_t		dis_seq;	/* last sequence number */
 	struct rdb_anchor	dis_anchor;	/* last anchor */
+	uint64_t		dis_sent_seq;	/* last sequence number sent */
+	struct rdb_anchor	dis_sent_anchor;/* last anchor sent */
+	uint64_t		dis_sent_ms;	/* when the last chunk was sent */
+	uint64_t		dis_gen;	/* generation of chunks in flight */
+	unsigned int		dis_inflight;	/* chunks in flight */
+};
+
+/* Upper bound of RDB_AE_MAX_INFLIGHT */
+#define RDB_AE_INFLIGHT_MAX	16
+
+/* AE carrying entries [dra_start, dra_end] in flight to a follower */
+struct rdb_raft_ae {
+	uint64_t		dra_start;	/* first index */
+	uint64_t		dra_end;	/* last index */
+	uint64_t		dra_sent_ms;	/* when it was sent */
 };
 
 /* Per-raft_node_t data */
@@ -176,6 +199,10 @@ struct rdb_raft_node {
 	/* Leader fields */
 	uint64_t		dn_term;	/* of leader */
 	struct rdb_raft_is	dn_is;
+	uint64_t		dn_ae_term;	/* of AEs in flight */
+	uint64_t		dn_ae_sent;	/* last index in AEs in flight */
+	unsigned int		dn_ae_inflight;	/* AEs with entries in flight */
+	struct rdb_raft_ae	dn_ae[RDB_AE_INFLIGHT_MAX]; /* oldest first */
 };
 
 void rdb_raft_module_init(void);
@@ -190,6 +217,7 @@ void rdb_raft_resign(struct rdb *db, uint64_t term);
 int rdb_raft_campaign(struct rdb *db);
 int rdb_raft_ping(struct rdb *db, uint64_t caller_term);
 int rdb_raft_verify_leadership(struct rdb *db);
+int rdb_raft_check_freshness(struct rdb *db, uint64_t staleness);
 int rdb_raft_load_replicas(daos_handle_t lc, uint64_t index, d_rank_list_t **replicas);
 int rdb_raft_add_replica(struct rdb *db, d_rank_t rank);
 int rdb_raft_remove_replica(struct rdb *db, d_rank_t rank);
@@ -204,6 +232,30 @@ void rdb_raft_process_reply(struct rdb *db, crt_rpc_t *rpc);
 void rdb_raft_free_request(struct rdb *db, crt_rpc_t *rpc);
 int rdb_raft_trigger_compaction(struct rdb *db, bool compact_all, uint64_t *idx);
 
+/* rdb_ae.c *******************************************************************/
+
+struct rdb_appendentries_in;
+
+unsigned int rdb_ae_inflight(struct rdb_raft_node *rdb_node, uint64_t term, uint64_t now_ms,
+			     uint64_t timeout_ms);
+bool rdb_ae_prepare(struct rdb_raft_node *rdb_node, msg_appendentries_t *ae, unsigned int max,
+		    uint64_t now_ms, uint64_t timeout_ms);
+void rdb_ae_sent(struct rdb_raft_node *rdb_node, const msg_appendentries_t *ae, uint64_t now_ms);
+void rdb_ae_reply(struct rdb_raft_node *rdb_node, const msg_appendentries_response_t *resp);
+void rdb_ae_refresh(struct rdb *db, const struct rdb_appendentries_in *in,
+		    const msg_appendentries_response_t *resp, uint64_t now_ms);
+bool rdb_ae_fresh(struct rdb *db, uint64_t staleness, uint64_t now_ms);
+
+/* rdb_is.c *******************************************************************/
+
+void rdb_is_start(struct rdb_raft_node *rdb_node, uint64_t term, uint64_t index);
+unsigned int rdb_is_prepare(struct rdb_raft_node *rdb_node, uint64_t now_ms, uint64_t timeout_ms);
+void rdb_is_sent(struct rdb_raft_node *rdb_node, uint64_t seq, const struct rdb_anchor *anchor,
+		 uint64_t now_ms);
+void rdb_is_reply(struct rdb_raft_node *rdb_node, uint64_t term, uint64_t gen,
+		  const msg_installsnapshot_response_t *resp, bool success, uint64_t seq,
+		  const struct rdb_anchor *anchor);
+
 /* rdb_rpc.c ******************************************************************/
 
 /*
@@ -212,7 +264,7 @@ int rdb_raft_trigger_compaction(struct rdb *db, bool compact_all, uint64_t *idx)
  * These are for daos_rpc::dr_opc and DAOS_RPC_OPCODE(opc, ...) rather than
  * crt_req_create(..., opc, ...). See src/include/daos/rpc.h.
  */
-#define DAOS_RDB_VERSION 4
+#define DAOS_RDB_VERSION 5
 /* LIST of internal RPCS in form of:
  * OPCODE, flags, FMT, handler, corpc_hdlr,
  */
@@ -250,9 +302,14 @@ CRT_RPC_DECLARE(rdb_op, DAOS_ISEQ_RDB_OP, DAOS_OSEQ_RDB_OP)
 CRT_RPC_DECLARE(rdb_requestvote, DAOS_ISEQ_RDB_REQUESTVOTE,
 		DAOS_OSEQ_RDB_REQUESTVOTE)
 
+/* aei_flags bits */
+#define RDB_AE_LEASED	(1U << 0)	/* leader held majority leases when sending */
+
 #define DAOS_ISEQ_RDB_APPENDENTRIES /* input fields */		 \
 	((struct rdb_op_in)	(aei_op)		CRT_VAR) \
-	((msg_appendentries_t)	(aei_msg)		CRT_VAR)
+	((msg_appendentries_t)	(aei_msg)		CRT_VAR) \
+	((uint32_t)		(aei_flags)		CRT_VAR) \
+	((uint32_t)		(aei_padding)		CRT_VAR)
 
 #define DAOS_OSEQ_RDB_APPENDENTRIES /* output fields */		 \
 	((struct rdb_op_out)	(aeo_op)		CRT_VAR) \
@@ -262,8 +319,9 @@ CRT_RPC_DECLARE(rdb_appendentries, DAOS_ISEQ_RDB_APPENDENTRIES,
 		DAOS_OSEQ_RDB_APPENDENTRIES)
 
 struct rdb_local {
-	d_iov_t	rl_kds_iov;	/* isi_kds buffer */
-	d_iov_t	rl_data_iov;	/* isi_data buffer */
+	d_iov_t		rl_kds_iov;	/* isi_kds buffer */
+	d_iov_t		rl_data_iov;	/* isi_data buffer */
+	uint64_t	rl_is_gen;	/* generation of the chunk sent */
 };
 
 #define DAOS_ISEQ_RDB_INSTALLSNAPSHOT /* input fields */	 \
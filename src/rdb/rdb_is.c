@@ -0,0 +1,138 @@
+/**
+ * (C) Copyright 2024 Intel Corporation.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause-Patent
+ */
+/**
+ * rdb: InstallSnapshot Pipeline
+ *
+ * The leader streams a snapshot to a follower in chunks, each starting from
+ * the anchor at which the previous one sent ended, and keeps several of them
+ * in flight. If the follower fails to store a chunk, or no reply arrives in
+ * time, the leader forgets the chunks in flight and rewinds to the last chunk
+ * acknowledged by the follower. The chunks sent after a rewind reuse the
+ * sequence numbers of the forgotten ones, so every chunk is tagged with the
+ * generation of the pipeline, which a rewind bumps, and only the replies to
+ * the chunks of the current generation count as chunks no longer in flight.
+ *
+ * All functions here must be called with d_raft_mutex held.
+ */
+
+#define D_LOGFAC	DD_FAC(rdb)
+
+#include <daos_srv/rdb.h>
+
+#include "rdb_internal.h"
+
+/* Forget the chunks in flight, whose replies will no longer be counted. */
+static void
+rdb_is_forget(struct rdb_raft_is *is)
+{
+	is->dis_inflight = 0;
+	is->dis_gen++;
+}
+
+/*
+ * Start transferring snapshot \a index to \a rdb_node in \a term from the
+ * beginning, unless doing so already.
+ */
+void
+rdb_is_start(struct rdb_raft_node *rdb_node, uint64_t term, uint64_t index)
+{
+	struct rdb_raft_is *is = &rdb_node->dn_is;
+
+	if (rdb_node->dn_term == term && is->dis_index == index)
+		return;
+
+	rdb_node->dn_term = term;
+	is->dis_index = index;
+	is->dis_seq = 0;
+	rdb_anchor_set_zero(&is->dis_anchor);
+	rdb_is_forget(is);
+}
+
+/*
+ * Prepare to send more chunks to \a rdb_node. If none of the chunks in flight
+ * has been replied within \a timeout_ms, forget them. If no chunk is in
+ * flight, (re)start from the last chunk acknowledged by the follower. Return
+ * the number of chunks in flight.
+ */
+unsigned int
+rdb_is_prepare(struct rdb_raft_node *rdb_node, uint64_t now_ms, uint64_t timeout_ms)
+{
+	struct rdb_raft_is *is = &rdb_node->dn_is;
+
+	if (is->dis_inflight > 0 && now_ms - is->dis_sent_ms >= timeout_ms) {
+		D_DEBUG(DB_TRACE, "rank %u: rewinding is from "DF_U64" to "DF_U64"\n",
+			rdb_node->dn_rank, is->dis_sent_seq, is->dis_seq);
+		rdb_is_forget(is);
+	}
+	if (is->dis_inflight == 0) {
+		is->dis_sent_seq = is->dis_seq;
+		is->dis_sent_anchor = is->dis_anchor;
+	}
+	return is->dis_inflight;
+}
+
+/*
+ * Record that chunk \a seq, ending at \a anchor, has been sent to \a rdb_node
+ * with generation dis_gen.
+ */
+void
+rdb_is_sent(struct rdb_raft_node *rdb_node, uint64_t seq, const struct rdb_anchor *anchor,
+	    uint64_t now_ms)
+{
+	struct rdb_raft_is *is = &rdb_node->dn_is;
+
+	D_ASSERTF(seq == is->dis_sent_seq + 1, DF_U64" != "DF_U64" + 1\n", seq,
+		  is->dis_sent_seq);
+	is->dis_sent_seq = seq;
+	is->dis_sent_anchor = *anchor;
+	is->dis_sent_ms = now_ms;
+	is->dis_inflight++;
+}
+
+/*
+ * Process the reply from \a rdb_node to a chunk of generation \a gen. On
+ * \a success, the follower reports the last chunk it has stored, \a seq and
+ * \a anchor, which is taken whatever the generation. A reply to a chunk of an
+ * earlier generation does not change the chunks in flight. Otherwise, if the
+ * follower failed to store the chunk, or has stored all the chunks sent,
+ * forget the chunks in flight, so that the next ones continue from the last
+ * chunk acknowledged by the follower.
+ */
+void
+rdb_is_reply(struct rdb_raft_node *rdb_node, uint64_t term, uint64_t gen,
+	     const msg_installsnapshot_response_t *resp, bool success, uint64_t seq,
+	     const struct rdb_anchor *anchor)
+{
+	struct rdb_raft_is *is = &rdb_node->dn_is;
+
+	/* If no longer transferring this snapshot, ignore this reply. */
+	if (rdb_node->dn_term != term || is->dis_index != resp->last_idx)
+		return;
+
+	if (success && seq > is->dis_seq) {
+		is->dis_seq = seq;
+		is->dis_anchor = *anchor;
+	}
+
+	if (gen != is->dis_gen) {
+		D_DEBUG(DB_TRACE, "rank %u: stale generation "DF_U64" != "DF_U64"\n",
+			rdb_node->dn_rank, gen, is->dis_gen);
+		return;
+	}
+
+	if (is->dis_inflight > 0)
+		is->dis_inflight--;
+
+	/*
+	 * If the whole snapshot is complete, the follower already matches up
+	 * the log to the index of this snapshot, and nothing more is sent.
+	 */
+	if (!success && resp->complete)
+		return;
+
+	if (!success || is->dis_seq >= is->dis_sent_seq)
+		rdb_is_forget(is);
+}
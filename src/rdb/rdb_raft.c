@@ -178,12 +178,21 @@ rdb_raft_clone_ae(struct rdb *db, const msg_appendentries_t *ae, msg_appendentri
 	return 0;
 }
 
+/* Number of AEs with entries in flight to rdb_node. See rdb_ae.c. */
+static unsigned int
+rdb_raft_ae_inflight(struct rdb *db, struct rdb_raft_node *rdb_node)
+{
+	return rdb_ae_inflight(rdb_node, raft_get_current_term(db->d_raft), daos_getmtime_coarse(),
+			       raft_get_request_timeout(db->d_raft));
+}
+
 static int
 rdb_raft_cb_send_appendentries(raft_server_t *raft, void *arg,
 			       raft_node_t *node, msg_appendentries_t *msg)
 {
 	struct rdb		       *db = arg;
 	struct rdb_raft_node	       *rdb_node = raft_node_get_udata(node);
+	msg_appendentries_t		ae = *msg;
 	crt_rpc_t		       *rpc;
 	struct rdb_appendentries_in    *in;
 	int				rc;
@@ -196,6 +205,14 @@ rdb_raft_cb_send_appendentries(raft_server_t *raft, void *arg,
 	if (DAOS_FAIL_CHECK(DAOS_RDB_SKIP_APPENDENTRIES_FAIL))
 		D_GOTO(err, rc = 0);
 
+	/* Only send the entries that are not in flight yet. See rdb_ae.c. */
+	if (!rdb_ae_prepare(rdb_node, &ae, db->d_ae_max_inflight, daos_getmtime_coarse(),
+			    raft_get_request_timeout(db->d_raft))) {
+		D_DEBUG(DB_TRACE, DF_DB": deferring ae to rank %u: %u in flight\n",
+			DP_DB(db), rdb_node->dn_rank, rdb_node->dn_ae_inflight);
+		return 0;
+	}
+
 	rc = rdb_create_raft_rpc(RDB_APPENDENTRIES, node, &rpc);
 	if (rc != 0) {
 		D_ERROR(DF_DB": failed to create AE RPC to node %d: %d\n",
@@ -204,7 +221,10 @@ rdb_raft_cb_send_appendentries(raft_server_t *raft, void *arg,
 	}
 	in = crt_req_get(rpc);
 	uuid_copy(in->aei_op.ri_uuid, db->d_uuid);
-	rc = rdb_raft_clone_ae(db, msg, &in->aei_msg);
+	/* See rdb_ae_refresh. */
+	if (db->d_use_leases && raft_has_majority_leases(db->d_raft))
+		in->aei_flags |= RDB_AE_LEASED;
+	rc = rdb_raft_clone_ae(db, &ae, &in->aei_msg);
 	if (rc != 0) {
 		D_ERROR(DF_DB": failed to allocate entry array\n", DP_DB(db));
 		D_GOTO(err_rpc, rc);
@@ -216,6 +236,8 @@ rdb_raft_cb_send_appendentries(raft_server_t *raft, void *arg,
 			DP_DB(db), raft_node_get_id(node), rc);
 		D_GOTO(err_in, rc);
 	}
+
+	rdb_ae_sent(rdb_node, &in->aei_msg, daos_getmtime_coarse());
 	return 0;
 
 err_in:
@@ -226,6 +248,69 @@ err:
 	return rc;
 }
 
+/*
+ * Without waiting for the AEs in flight to be replied, send the entries
+ * appended after \a prev_idx to every replica that either has AEs in flight or
+ * was up to date before those entries were appended. Caller must hold
+ * d_raft_mutex.
+ */
+static void
+rdb_raft_push_ae(struct rdb *db, uint64_t prev_idx)
+{
+	uint64_t	current = raft_get_current_idx(db->d_raft);
+	msg_entry_t    *entries;
+	int		i;
+
+	D_ALLOC_ARRAY(entries, db->d_ae_max_entries);
+	if (entries == NULL)
+		return;
+
+	for (i = 0; i < raft_get_num_nodes(db->d_raft); i++) {
+		raft_node_t	       *node = raft_get_node_from_idx(db->d_raft, i);
+		struct rdb_raft_node   *rdb_node = raft_node_get_udata(node);
+		msg_appendentries_t	ae = {};
+		raft_entry_t	       *e;
+		uint64_t		base;
+
+		if (rdb_node->dn_rank == dss_self_rank())
+			continue;
+		if (rdb_raft_ae_inflight(db, rdb_node) > 0)
+			base = rdb_node->dn_ae_sent;
+		else if (raft_node_get_next_idx(node) > prev_idx)
+			base = raft_node_get_next_idx(node) - 1;
+		else
+			continue;
+		if (base >= current)
+			continue;
+
+		/* The entry at the base may have been compacted into the snapshot. */
+		if (base == db->d_lc_record.dlr_base) {
+			ae.prev_log_term = db->d_lc_record.dlr_base_term;
+		} else {
+			e = raft_get_entry_from_idx(db->d_raft, base);
+			if (e == NULL)
+				continue;
+			ae.prev_log_term = e->term;
+		}
+		ae.term = raft_get_current_term(db->d_raft);
+		ae.prev_log_idx = base;
+		ae.leader_commit = raft_get_commit_idx(db->d_raft);
+		ae.entries = entries;
+		while (ae.n_entries < db->d_ae_max_entries && base + ae.n_entries < current) {
+			e = raft_get_entry_from_idx(db->d_raft, base + ae.n_entries + 1);
+			if (e == NULL)
+				break;
+			entries[ae.n_entries++] = *e;
+		}
+		if (ae.n_entries == 0)
+			continue;
+
+		rdb_raft_cb_send_appendentries(db->d_raft, db, node, &ae);
+	}
+
+	D_FREE(entries);
+}
+
 static int
 rdb_raft_store_replicas(daos_handle_t lc, uint64_t index, const d_rank_list_t *replicas,
 			rdb_vos_tx_t vtx)
@@ -377,7 +462,7 @@ rdb_raft_unload_snapshot(struct rdb *db)
 }
 
 static int
-rdb_raft_pack_chunk(daos_handle_t lc, struct rdb_raft_is *is, d_iov_t *kds,
+rdb_raft_pack_chunk(daos_handle_t lc, uint64_t index, struct rdb_anchor *from, d_iov_t *kds,
 		    d_iov_t *data, struct rdb_anchor *anchor)
 {
 	d_sg_list_t			sgl;
@@ -387,14 +472,14 @@ rdb_raft_pack_chunk(daos_handle_t lc, struct rdb_raft_is *is, d_iov_t *kds,
 	int				rc;
 
 	/*
-	 * Set up the iteration for everything in the log container at
-	 * is->dis_index.
+	 * Set up the iteration for everything in the log container at index,
+	 * starting from the from anchor.
 	 */
 	param.ip_hdl = lc;
-	rdb_anchor_to_hashes(&is->dis_anchor, &anchors.ia_obj, &anchors.ia_dkey,
+	rdb_anchor_to_hashes(from, &anchors.ia_obj, &anchors.ia_dkey,
 			     &anchors.ia_akey, &anchors.ia_ev, &anchors.ia_sv);
-	param.ip_epr.epr_lo = is->dis_index;
-	param.ip_epr.epr_hi = is->dis_index;
+	param.ip_epr.epr_lo = index;
+	param.ip_epr.epr_hi = index;
 	param.ip_epc_expr = VOS_IT_EPC_LE;
 	arg.chk_key2big = true;	/* see fill_key() & fill_rec() */
 
@@ -433,11 +518,10 @@ rdb_raft_pack_chunk(daos_handle_t lc, struct rdb_raft_is *is, d_iov_t *kds,
 	return 0;
 }
 
+/* Pack and send the chunk following the last one sent to node. */
 static int
-rdb_raft_cb_send_installsnapshot(raft_server_t *raft, void *arg,
-				 raft_node_t *node, msg_installsnapshot_t *msg)
+rdb_raft_send_is_chunk(struct rdb *db, raft_node_t *node, msg_installsnapshot_t *msg)
 {
-	struct rdb		       *db = arg;
 	struct rdb_raft_node	       *rdb_node = raft_node_get_udata(node);
 	struct rdb_raft_is	       *is = &rdb_node->dn_is;
 	crt_rpc_t		       *rpc;
@@ -467,31 +551,25 @@ rdb_raft_cb_send_installsnapshot(raft_server_t *raft, void *arg,
 	kds.iov_buf_len = 4 * 1024;
 	kds.iov_len = 0;
 	D_ALLOC(kds.iov_buf, kds.iov_buf_len);
-	if (kds.iov_buf == NULL)
+	if (kds.iov_buf == NULL) {
+		rc = -DER_NOMEM;
 		goto err_rpc;
+	}
 	data.iov_buf_len = 1 * 1024 * 1024;
 	data.iov_len = 0;
 	D_ALLOC(data.iov_buf, data.iov_buf_len);
-	if (data.iov_buf == NULL)
+	if (data.iov_buf == NULL) {
+		rc = -DER_NOMEM;
 		goto err_kds;
-
-	/*
-	 * If the INSTALLSNAPSHOT state tracks a different term or snapshot,
-	 * reinitialize it for the current term and snapshot.
-	 */
-	if (rdb_node->dn_term != raft_get_current_term(raft) ||
-	    is->dis_index != msg->last_idx) {
-		rdb_node->dn_term = raft_get_current_term(raft);
-		is->dis_index = msg->last_idx;
-		is->dis_seq = 0;
-		rdb_anchor_set_zero(&is->dis_anchor);
 	}
 
 	/* Pack the chunk's data, anchor, and seq. */
-	rc = rdb_raft_pack_chunk(db->d_lc, is, &kds, &data, &in->isi_anchor);
+	rc = rdb_raft_pack_chunk(db->d_lc, is->dis_index, &is->dis_sent_anchor, &kds, &data,
+				 &in->isi_anchor);
 	if (rc != 0)
 		goto err_data;
-	in->isi_seq = is->dis_seq + 1;
+	in->isi_seq = is->dis_sent_seq + 1;
+	in->isi_local.rl_is_gen = is->dis_gen;
 
 	/*
 	 * Create bulks for the buffers. crt_bulk_create looks at iov_buf_len
@@ -528,10 +606,12 @@ rdb_raft_cb_send_installsnapshot(raft_server_t *raft, void *arg,
 
 	D_DEBUG(DB_TRACE,
 		DF_DB": sent is to node %u rank %u: term=%ld last_idx=%ld seq="
-		DF_U64" kds.len="DF_U64" data.len="DF_U64"\n",
+		DF_U64" kds.len="DF_U64" data.len="DF_U64" inflight=%u\n",
 		DP_DB(db), raft_node_get_id(node), rdb_node->dn_rank,
 		in->isi_msg.term, in->isi_msg.last_idx, in->isi_seq,
-		kds.iov_len, data.iov_len);
+		kds.iov_len, data.iov_len, is->dis_inflight + 1);
+
+	rdb_is_sent(rdb_node, in->isi_seq, &in->isi_anchor, daos_getmtime_coarse());
 	return 0;
 
 err_data_bulk:
@@ -548,6 +628,35 @@ err:
 	return rc;
 }
 
+/*
+ * Stream the snapshot to node, keeping up to d_is_max_inflight chunks in
+ * flight. Each chunk starts from the anchor at which the previous one sent
+ * ended, so the follower needs to store them in order; see
+ * rdb_raft_wait_is_chunk.
+ */
+static int
+rdb_raft_cb_send_installsnapshot(raft_server_t *raft, void *arg,
+				 raft_node_t *node, msg_installsnapshot_t *msg)
+{
+	struct rdb		       *db = arg;
+	struct rdb_raft_node	       *rdb_node = raft_node_get_udata(node);
+	struct rdb_raft_is	       *is = &rdb_node->dn_is;
+	int				rc;
+
+	rdb_is_start(rdb_node, raft_get_current_term(raft), msg->last_idx);
+	rdb_is_prepare(rdb_node, daos_getmtime_coarse(), raft_get_request_timeout(raft));
+
+	while (is->dis_inflight < db->d_is_max_inflight &&
+	       (is->dis_inflight == 0 || !rdb_anchor_is_eof(&is->dis_sent_anchor))) {
+		rc = rdb_raft_send_is_chunk(db, node, msg);
+		if (rc != 0)
+			/* Only an error if nothing is in flight. */
+			return is->dis_inflight == 0 ? rc : 0;
+	}
+
+	return 0;
+}
+
 struct rdb_raft_bulk {
 	ABT_eventual	drb_eventual;
 	int		drb_n;
@@ -844,7 +953,7 @@ rdb_raft_cb_recv_installsnapshot(raft_server_t *raft, void *arg,
 		out->iso_anchor = slc_record->dlr_anchor;
 		return 0;
 	} else if (in->isi_seq > slc_record->dlr_seq + 1) {
-		/* Chunks are sent one by one for now. */
+		/* See rdb_raft_wait_is_chunk. */
 		D_ERROR(DF_DB": might have lost chunks: "DF_U64" > "DF_U64"\n",
 			DP_DB(db), in->isi_seq, slc_record->dlr_seq);
 		return -DER_IO;
@@ -902,6 +1011,7 @@ rdb_raft_cb_recv_installsnapshot(raft_server_t *raft, void *arg,
 		out->iso_success = 1;
 		out->iso_seq = lc_record->dlr_seq;
 		out->iso_anchor = lc_record->dlr_anchor;
+		ABT_cond_broadcast(db->d_applied_cv);
 
 		/* Load this snapshot. */
 		rc = rdb_raft_load_snapshot(db);
@@ -937,6 +1047,7 @@ rdb_raft_cb_recv_installsnapshot(raft_server_t *raft, void *arg,
 		out->iso_success = 1;
 		out->iso_seq = slc_record->dlr_seq;
 		out->iso_anchor = slc_record->dlr_anchor;
+		ABT_cond_broadcast(db->d_applied_cv);
 	}
 
 	return rc;
@@ -965,6 +1076,11 @@ rdb_raft_cb_recv_installsnapshot_resp(raft_server_t *raft, void *arg,
 		return 0;
 	}
 
+	/*
+	 * The chunks in flight have been accounted for by rdb_is_reply, called
+	 * from rdb_raft_process_reply.
+	 */
+
 	/* If this chunk isn't successfully stored, ... */
 	if (!out->iso_success) {
 		/*
@@ -979,8 +1095,8 @@ rdb_raft_cb_recv_installsnapshot_resp(raft_server_t *raft, void *arg,
 		}
 
 		/*
-		 * ... and the snapshot is not complete, return a generic error so
-		 * that raft will not retry too eagerly.
+		 * ... and the snapshot is not complete, return a generic error
+		 * so that raft will not retry too eagerly.
 		 */
 		D_DEBUG(DB_TRACE,
 			DF_DB": rank %u: unsuccessful chunk %ld/"DF_U64"("
@@ -989,24 +1105,10 @@ rdb_raft_cb_recv_installsnapshot_resp(raft_server_t *raft, void *arg,
 		return -DER_MISC;
 	}
 
-	/* Ignore this stale response. */
-	if (out->iso_seq <= is->dis_seq) {
-		D_DEBUG(DB_TRACE,
-			DF_DB": rank %u: stale chunk %ld/"DF_U64"("DF_U64")\n",
-			DP_DB(db), rdb_node->dn_rank, resp->last_idx,
-			out->iso_seq, is->dis_seq);
-		return 0;
-	}
-
 	D_DEBUG(DB_TRACE,
-		DF_DB": rank %u: completed chunk %ld/"DF_U64"("DF_U64")\n",
+		DF_DB": rank %u: completed chunk %ld/"DF_U64"("DF_U64") inflight=%u\n",
 		DP_DB(db), rdb_node->dn_rank, resp->last_idx, out->iso_seq,
-		is->dis_seq);
-
-	/* Update the last sequence number and anchor. */
-	is->dis_seq = out->iso_seq;
-	is->dis_anchor = out->iso_anchor;
-
+		is->dis_seq, is->dis_inflight);
 	return 0;
 }
 
@@ -1307,11 +1409,151 @@ out_vtx:
 	return 0;
 }
 
+/* Maximum number of VOS TX operations in one rdb_raft_log_offer_batch VOS TX */
+#define RDB_RAFT_BATCH_NVOPS_MAX 4096
+
+/*
+ * Persist and apply a prefix of the n normal entries starting at \a entries
+ * in a single VOS TX, so that they share one commit. The prefix is limited by
+ * RDB_RAFT_BATCH_NVOPS_MAX and db->d_ae_max_size. Return the number of
+ * entries stored, or 0 if the prefix is too short to be worth a batch. If an
+ * error occurs, nothing is stored, and the caller shall fall back to
+ * rdb_raft_log_offer_single, which handles errors entry by entry.
+ */
+static int
+rdb_raft_log_offer_batch(struct rdb *db, raft_entry_t *entries, uint64_t index, int n)
+{
+	rdb_vos_tx_t     vtx;
+	void           **bufs;
+	d_iov_t          keys[2];
+	d_iov_t          values[2];
+	struct rdb_entry header;
+	size_t           size = 0;
+	int              nvops = 1 /* log tail */;
+	int              m;
+	int              i;
+	bool             dirtied_kvss = false;
+	int              rc;
+
+	/* Determine the prefix. Configuration changes are left to rdb_raft_log_offer_single. */
+	for (m = 0; m < n; m++) {
+		raft_entry_t *entry = &entries[m];
+
+		if (entry->type != RAFT_LOGTYPE_NORMAL)
+			break;
+		if (m > 0 && size + entry->data.len > db->d_ae_max_size)
+			break;
+		rc = rdb_raft_entry_count_vops(db, entry);
+		if (rc < 0)
+			break;
+		if (nvops + rc > RDB_RAFT_BATCH_NVOPS_MAX)
+			break;
+		nvops += rc;
+		size += entry->data.len;
+	}
+	if (m < 2)
+		return 0;
+
+	D_ALLOC_ARRAY(bufs, m);
+	if (bufs == NULL)
+		return -DER_NOMEM;
+
+	rc = rdb_vos_tx_begin(db, nvops, &vtx);
+	if (rc != 0) {
+		DL_ERROR(rc, DF_DB ": failed to begin VOS TX for entries [" DF_U64 ", " DF_U64 "]",
+			 DP_DB(db), index, index + m - 1);
+		goto out;
+	}
+
+	/* As in rdb_raft_log_offer_single, update the MC first. */
+	D_ASSERTF(index == db->d_lc_record.dlr_tail, DF_U64 " == " DF_U64 "\n", index,
+		  db->d_lc_record.dlr_tail);
+	db->d_lc_record.dlr_tail = index + m;
+	d_iov_set(&values[0], &db->d_lc_record, sizeof(db->d_lc_record));
+	rc = rdb_mc_update(db->d_mc, RDB_MC_ATTRS, 1 /* n */, &rdb_mc_lc, &values[0], vtx);
+	if (rc != 0) {
+		DL_ERROR(rc, DF_DB ": failed to update log tail " DF_U64, DP_DB(db),
+			 db->d_lc_record.dlr_tail);
+		goto out_vtx;
+	}
+
+	for (i = 0; i < m; i++) {
+		raft_entry_t *entry = &entries[i];
+		bool          crit = true;
+
+		rc = rdb_tx_apply(db, index + i, entry->data.buf, entry->data.len,
+				  rdb_raft_lookup_result(db, index + i), &crit, vtx);
+		if (rc == RDB_TX_APPLY_ERR_DETERMINISTIC) {
+			D_DEBUG(DB_TRACE, DF_DB ": deterministic error for entry " DF_U64 " in batch\n",
+				DP_DB(db), index + i);
+			rc = -DER_AGAIN;
+			goto out_vtx;
+		} else if (rc != 0) {
+			DL_ERROR(rc, DF_DB ": failed to apply entry " DF_U64, DP_DB(db), index + i);
+			goto out_vtx;
+		}
+		dirtied_kvss = true;
+
+		header.dre_term = entry->term;
+		header.dre_type = entry->type;
+		header.dre_size = entry->data.len;
+		keys[0] = rdb_lc_entry_header;
+		d_iov_set(&values[0], &header, sizeof(header));
+		if (entry->data.len > 0) {
+			keys[1] = rdb_lc_entry_data;
+			d_iov_set(&values[1], entry->data.buf, entry->data.len);
+		}
+		rc = rdb_lc_update(db->d_lc, index + i, RDB_LC_ATTRS, crit,
+				   entry->data.len > 0 ? 2 : 1, keys, values, vtx);
+		if (rc != 0) {
+			DL_ERROR(rc, DF_DB ": failed to persist entry " DF_U64, DP_DB(db),
+				 index + i);
+			goto out_vtx;
+		}
+
+		/* Replace entry->data.buf only after the VOS TX commits. */
+		bufs[i] = NULL;
+		if (entry->data.len > 0) {
+			d_iov_set(&values[0], NULL, entry->data.len);
+			rc = rdb_lc_lookup(db->d_lc, index + i, RDB_LC_ATTRS, &rdb_lc_entry_data,
+					   &values[0]);
+			if (rc != 0) {
+				DL_ERROR(rc, DF_DB ": failed to look up entry " DF_U64 " data",
+					 DP_DB(db), index + i);
+				goto out_vtx;
+			}
+			bufs[i] = values[0].iov_buf;
+		}
+	}
+
+out_vtx:
+	rc = rdb_vos_tx_end(db, vtx, rc);
+	if (rc != 0) {
+		if (dirtied_kvss)
+			rdb_kvs_cache_evict(db->d_kvss);
+		db->d_lc_record.dlr_tail = index;
+		if (rc != -DER_AGAIN)
+			DL_ERROR(rc, DF_DB ": failed to end VOS TX for entries [" DF_U64 ", " DF_U64 "]",
+				 DP_DB(db), index, index + m - 1);
+		goto out;
+	}
+
+	for (i = 0; i < m; i++)
+		entries[i].data.buf = bufs[i];
+	rc = m;
+	D_DEBUG(DB_TRACE, DF_DB ": appended entries [" DF_U64 ", " DF_U64 "]: term=%ld\n",
+		DP_DB(db), index, index + m - 1, entries[m - 1].term);
+out:
+	D_FREE(bufs);
+	return rc;
+}
+
 static int
 rdb_raft_cb_log_offer(raft_server_t *raft, void *arg, raft_entry_t *entries, raft_index_t index,
 		      int *n_entries)
 {
 	struct rdb *db = arg;
+	bool        batch = true;
 	int         i;
 	int         rc = 0;
 
@@ -1319,15 +1561,27 @@ rdb_raft_cb_log_offer(raft_server_t *raft, void *arg, raft_entry_t *entries, raf
 		return 0;
 
 	/*
-	 * Conservatively employ one VOS TX for each entry for now, so that if
-	 * an entry encounters an error, we still end up making some progress
-	 * by not rolling back prior entries in the batch. Once VOS supports
-	 * batching TXs, we can optimize this process further.
+	 * Store as many entries as possible in each VOS TX, so that a multi-entry
+	 * offer costs one commit rather than one per entry. If a batch fails,
+	 * employ one VOS TX for each of the remaining entries, so that if an
+	 * entry encounters an error, we still end up making some progress by
+	 * not rolling back prior entries.
 	 */
-	for (i = 0; i < *n_entries; i++) {
+	for (i = 0; i < *n_entries;) {
+		if (batch) {
+			rc = rdb_raft_log_offer_batch(db, &entries[i], index + i, *n_entries - i);
+			if (rc > 0) {
+				i += rc;
+				rc = 0;
+				continue;
+			} else if (rc < 0) {
+				batch = false;
+			}
+		}
 		rc = rdb_raft_log_offer_single(db, &entries[i], index + i);
 		if (rc != 0)
 			break;
+		i++;
 	}
 	*n_entries = i;
 
@@ -2131,24 +2385,285 @@ rdb_raft_remove_replica(struct rdb *db, d_rank_t rank)
 	return (rc != 0) ? rc : result;
 }
 
-/* Caller must hold d_raft_mutex. */
+/* Normal entry queued in rdb::d_appends by rdb_raft_append_apply */
+struct rdb_raft_append {
+	d_list_t	dra_entry;	/* in rdb::d_appends */
+	msg_entry_t	dra_mentry;
+	void	       *dra_result;
+	uint64_t	dra_index;	/* assigned by rdb_raft_append_batch */
+	uint64_t	dra_term;	/* assigned by rdb_raft_append_batch */
+	int		dra_rc;
+	bool		dra_done;	/* dra_index, dra_term, and dra_rc are valid */
+};
+
+/*
+ * Append up to db->d_ae_max_entries queued entries from db->d_appends. All but
+ * the last entry are appended with one raft_append_entries call, so that they
+ * are persisted by one log offer. The last one goes through raft_recv_entry,
+ * which also commits the whole batch if we are the only voting replica. The
+ * new entries are then pushed to the followers. Caller must hold d_raft_mutex.
+ */
+static void
+rdb_raft_append_batch(struct rdb *db)
+{
+	struct rdb_raft_append *append;
+	struct rdb_raft_append *tmp;
+	struct rdb_raft_append *last;
+	struct rdb_raft_state	state;
+	msg_entry_response_t	mresponse;
+	msg_entry_t	       *mentries = NULL;
+	d_list_t		batch;
+	uint64_t		prev = raft_get_current_idx(db->d_raft);
+	uint64_t		term = raft_get_current_term(db->d_raft);
+	unsigned int		n = 0;
+	unsigned int		i;
+	int			m = 0;
+	int			rc = 0;
+
+	D_INIT_LIST_HEAD(&batch);
+	d_list_for_each_entry(append, &db->d_appends, dra_entry) {
+		if (++n == db->d_ae_max_entries)
+			break;
+	}
+	if (n > 1) {
+		D_ALLOC_ARRAY(mentries, n - 1);
+		if (mentries == NULL)
+			n = 1;
+	}
+	for (i = 0; i < n; i++) {
+		append = d_list_entry(db->d_appends.next, struct rdb_raft_append, dra_entry);
+		d_list_move_tail(&append->dra_entry, &batch);
+		append->dra_index = prev + 1 + i;
+		append->dra_term = term;
+	}
+	last = append;
+
+	/* Register the results before any entry gets applied. */
+	d_list_for_each_entry(append, &batch, dra_entry) {
+		if (append->dra_result == NULL)
+			continue;
+		rc = rdb_raft_register_result(db, append->dra_index, append->dra_result);
+		if (rc != 0)
+			break;
+	}
+	if (rc != 0) {
+		d_list_for_each_entry(tmp, &batch, dra_entry) {
+			if (tmp == append)
+				break;
+			if (tmp->dra_result != NULL)
+				rdb_raft_unregister_result(db, tmp->dra_index);
+		}
+		d_list_for_each_entry(tmp, &batch, dra_entry)
+			tmp->dra_result = NULL;
+		goto out;
+	}
+
+	if (n > 1) {
+		if (!raft_is_leader(db->d_raft)) {
+			rc = -DER_NOTLEADER;
+			goto out;
+		}
+		d_list_for_each_entry(append, &batch, dra_entry) {
+			if (append == last)
+				break;
+			mentries[m] = append->dra_mentry;
+			mentries[m].term = term;
+			m++;
+		}
+		rdb_raft_save_state(db, &state);
+		rc = raft_append_entries(db->d_raft, mentries, &m);
+		rc = rdb_raft_check_state(db, &state, rc);
+		if (rc != 0) {
+			if (rc != -DER_NOTLEADER)
+				DL_ERROR(rc, DF_DB ": failed to append %d of %u entries", DP_DB(db),
+					 n - 1 - m, n - 1);
+			goto out;
+		}
+	}
+
+	rdb_raft_save_state(db, &state);
+	rc = raft_recv_entry(db->d_raft, &last->dra_mentry, &mresponse);
+	rc = rdb_raft_check_state(db, &state, rc);
+	if (rc != 0) {
+		if (rc != -DER_NOTLEADER)
+			D_ERROR(DF_DB ": failed to append entry: " DF_RC "\n", DP_DB(db),
+				DP_RC(rc));
+		goto out;
+	}
+	/* The actual index must match the expected index. */
+	D_ASSERTF(mresponse.idx == last->dra_index, "%ld == " DF_U64 "\n", mresponse.idx,
+		  last->dra_index);
+	last->dra_term = mresponse.term;
+	m++;
+
+	if (n > 1)
+		rdb_raft_push_ae(db, prev);
+out:
+	/* The first m entries have been appended; the others fail with rc. */
+	d_list_for_each_entry_safe(append, tmp, &batch, dra_entry) {
+		if (m > 0) {
+			append->dra_rc = 0;
+			m--;
+		} else {
+			if (append->dra_result != NULL)
+				rdb_raft_unregister_result(db, append->dra_index);
+			append->dra_rc = rc;
+		}
+		append->dra_done = true;
+		d_list_del_init(&append->dra_entry);
+	}
+	D_FREE(mentries);
+	ABT_cond_broadcast(db->d_applied_cv);
+}
+
+/*
+ * Append and wait for \a entry to be applied. Concurrent callers are
+ * coalesced: the caller that finds no appender active becomes the appender,
+ * yields d_raft_mutex once to let the others queue their entries, and appends
+ * all queued entries in batches. Caller must hold d_raft_mutex.
+ */
 int
 rdb_raft_append_apply(struct rdb *db, void *entry, size_t size, void *result)
 {
-	msg_entry_t	 mentry = {};
+	struct rdb_raft_append	append = {};
+	int			rc;
 
-	mentry.type = RAFT_LOGTYPE_NORMAL;
-	mentry.data.buf = entry;
-	mentry.data.len = size;
-	return rdb_raft_append_apply_internal(db, &mentry, result);
+	append.dra_mentry.type = RAFT_LOGTYPE_NORMAL;
+	append.dra_mentry.data.buf = entry;
+	append.dra_mentry.data.len = size;
+	append.dra_result = result;
+	d_list_add_tail(&append.dra_entry, &db->d_appends);
+
+	while (!append.dra_done) {
+		if (db->d_appending) {
+			ABT_cond_wait(db->d_applied_cv, db->d_raft_mutex);
+			continue;
+		}
+		db->d_appending = true;
+		ABT_mutex_unlock(db->d_raft_mutex);
+		ABT_thread_yield();
+		ABT_mutex_lock(db->d_raft_mutex);
+		while (!d_list_empty(&db->d_appends))
+			rdb_raft_append_batch(db);
+		db->d_appending = false;
+	}
+
+	rc = append.dra_rc;
+	if (rc != 0)
+		return rc;
+
+	rc = rdb_raft_wait_applied(db, append.dra_index, append.dra_term);
+	raft_apply_all(db->d_raft);
+
+	if (append.dra_result != NULL)
+		rdb_raft_unregister_result(db, append.dra_index);
+	return rc;
+}
+
+/*
+ * Send a heartbeat AE to every follower, so that their replies renew our
+ * leadership leases. Caller must hold d_raft_mutex.
+ */
+static void
+rdb_raft_send_heartbeats(struct rdb *db)
+{
+	int i;
+
+	for (i = 0; i < raft_get_num_nodes(db->d_raft); i++) {
+		raft_node_t	       *node = raft_get_node_from_idx(db->d_raft, i);
+		struct rdb_raft_node   *rdb_node = raft_node_get_udata(node);
+		msg_appendentries_t	ae = {};
+		raft_entry_t	       *e;
+
+		if (rdb_node->dn_rank == dss_self_rank())
+			continue;
+
+		ae.prev_log_idx = raft_node_get_next_idx(node) - 1;
+		if (ae.prev_log_idx == db->d_lc_record.dlr_base) {
+			ae.prev_log_term = db->d_lc_record.dlr_base_term;
+		} else {
+			e = raft_get_entry_from_idx(db->d_raft, ae.prev_log_idx);
+			if (e == NULL)
+				continue;
+			ae.prev_log_term = e->term;
+		}
+		ae.term = raft_get_current_term(db->d_raft);
+		ae.leader_commit = raft_get_commit_idx(db->d_raft);
+
+		rdb_raft_cb_send_appendentries(db->d_raft, db, node, &ae);
+	}
+}
+
+/* Set deadline to timeout milliseconds from now, for ABT_cond_timedwait. */
+static void
+rdb_raft_set_deadline(struct timespec *deadline, int timeout)
+{
+	/* ABT_cond_timedwait uses CLOCK_REALTIME. */
+	clock_gettime(CLOCK_REALTIME, deadline);
+	deadline->tv_sec += timeout / 1000;
+	deadline->tv_nsec += (timeout % 1000) * 1000000L;
+	if (deadline->tv_nsec >= 1000000000L) {
+		deadline->tv_sec++;
+		deadline->tv_nsec -= 1000000000L;
+	}
 }
 
-/* Verify the leadership with a majority. */
+/*
+ * Wait for a majority of leadership leases after sending a round of
+ * heartbeats, for at most one request timeout. Concurrent callers share one
+ * round. Caller must hold d_raft_mutex.
+ */
+static int
+rdb_raft_renew_leases(struct rdb *db)
+{
+	uint64_t	term = raft_get_current_term(db->d_raft);
+	int		timeout = raft_get_request_timeout(db->d_raft);
+	struct timespec	deadline;
+	int		rc = 0;
+
+	if (!raft_is_leader(db->d_raft))
+		return -DER_NOTLEADER;
+
+	rdb_raft_set_deadline(&deadline, timeout);
+	if (db->d_lease_waiters++ == 0)
+		rdb_raft_send_heartbeats(db);
+	while (!raft_has_majority_leases(db->d_raft)) {
+		if (db->d_stop) {
+			rc = -DER_CANCELED;
+			break;
+		}
+		if (term != raft_get_current_term(db->d_raft) || !raft_is_leader(db->d_raft)) {
+			rc = -DER_NOTLEADER;
+			break;
+		}
+		if (ABT_cond_timedwait(db->d_applied_cv, db->d_raft_mutex, &deadline) ==
+		    ABT_ERR_COND_TIMEDOUT) {
+			rc = -DER_TIMEDOUT;
+			break;
+		}
+	}
+	db->d_lease_waiters--;
+	return rc;
+}
+
+/* Verify the leadership with a majority. Caller must hold d_raft_mutex. */
 int
 rdb_raft_verify_leadership(struct rdb *db)
 {
-	if (db->d_use_leases && raft_has_majority_leases(db->d_raft))
-		return 0;
+	int rc;
+
+	if (db->d_use_leases) {
+		if (raft_has_majority_leases(db->d_raft))
+			return 0;
+		/*
+		 * Try to renew the leases with heartbeats, which, unlike an
+		 * entry, do not have to be persisted by any replica.
+		 */
+		rc = rdb_raft_renew_leases(db);
+		if (rc != -DER_TIMEDOUT)
+			return rc;
+		D_DEBUG(DB_MD, DF_DB ": failed to renew leases in time\n", DP_DB(db));
+	}
 
 	/*
 	 * Since raft does not provide a function for verifying leadership via
@@ -2157,6 +2672,25 @@ rdb_raft_verify_leadership(struct rdb *db)
 	return rdb_raft_append_apply(db, NULL /* entry */, 0 /* size */, NULL /* result */);
 }
 
+/*
+ * Check that our state is at most \a staleness milliseconds older than the
+ * leader's, that is, that we have applied all entries that the leader had
+ * committed when sending, with majority leases, an AE that we accepted no more
+ * than \a staleness milliseconds ago. The delay of that AE is not accounted
+ * for. Without leases, followers are never fresh. Caller must hold
+ * d_raft_mutex.
+ */
+int
+rdb_raft_check_freshness(struct rdb *db, uint64_t staleness)
+{
+	if (!rdb_ae_fresh(db, staleness, daos_getmtime_coarse())) {
+		D_DEBUG(DB_TRACE, DF_DB ": not fresh enough: fresh=" DF_U64 " staleness=" DF_U64
+			"\n", DP_DB(db), db->d_fresh_ms, staleness);
+		return -DER_NOTLEADER;
+	}
+	return 0;
+}
+
 /* Generate a random double in [0.0, 1.0]. */
 static double
 rdb_raft_rand(void)
@@ -2600,6 +3134,37 @@ rdb_raft_get_ae_max_entries(void)
 	return value;
 }
 
+static unsigned int
+rdb_raft_get_ae_max_inflight(void)
+{
+	char	       *name = "RDB_AE_MAX_INFLIGHT";
+	unsigned int	default_value = 4;
+	unsigned int	value = default_value;
+
+	d_getenv_uint(name, &value);
+	if (value == 0 || value > RDB_AE_INFLIGHT_MAX) {
+		D_WARN("%s not in (0, %u] (defaulting to %u)\n", name, RDB_AE_INFLIGHT_MAX,
+		       default_value);
+		value = default_value;
+	}
+	return value;
+}
+
+static unsigned int
+rdb_raft_get_is_max_inflight(void)
+{
+	char	       *name = "RDB_IS_MAX_INFLIGHT";
+	unsigned int	default_value = 4;
+	unsigned int	value = default_value;
+
+	d_getenv_uint(name, &value);
+	if (value == 0) {
+		D_WARN("%s not in (0, %u] (defaulting to %u)\n", name, UINT_MAX, default_value);
+		value = default_value;
+	}
+	return value;
+}
+
 static size_t
 rdb_raft_get_ae_max_size(void)
 {
@@ -2742,9 +3307,12 @@ rdb_raft_open(struct rdb *db, uint64_t caller_term)
 
 	D_INIT_LIST_HEAD(&db->d_requests);
 	D_INIT_LIST_HEAD(&db->d_replies);
+	D_INIT_LIST_HEAD(&db->d_appends);
 	db->d_compact_thres = rdb_raft_get_compact_thres();
 	db->d_ae_max_size = rdb_raft_get_ae_max_size();
 	db->d_ae_max_entries = rdb_raft_get_ae_max_entries();
+	db->d_ae_max_inflight = rdb_raft_get_ae_max_inflight();
+	db->d_is_max_inflight = rdb_raft_get_is_max_inflight();
 
 	rc = d_hash_table_create_inplace(D_HASH_FT_NOLOCK, 4 /* bits */,
 					 NULL /* priv */,
@@ -2970,9 +3538,10 @@ rdb_raft_start(struct rdb *db)
 	D_DEBUG(DB_MD,
 		DF_DB": raft started: election_timeout=%dms request_timeout=%dms "
 		"lease_maintenance_grace=%dms compact_thres="DF_U64" ae_max_entries=%u "
-		"ae_max_size="DF_U64"\n", DP_DB(db), election_timeout, request_timeout,
-		lease_maintenance_grace, db->d_compact_thres, db->d_ae_max_entries,
-		db->d_ae_max_size);
+		"ae_max_size="DF_U64" ae_max_inflight=%u is_max_inflight=%u\n", DP_DB(db),
+		election_timeout, request_timeout, lease_maintenance_grace, db->d_compact_thres,
+		db->d_ae_max_entries, db->d_ae_max_size, db->d_ae_max_inflight,
+		db->d_is_max_inflight);
 	return 0;
 
 err_callbackd:
@@ -3272,6 +3841,8 @@ rdb_appendentries_handler(crt_rpc_t *rpc)
 				     raft_get_node(db->d_raft, srcrank),
 				     &in->aei_msg, &out->aeo_msg);
 	rc = rdb_raft_check_state(db, &state, rc);
+	if (rc == 0)
+		rdb_ae_refresh(db, in, &out->aeo_msg, daos_getmtime_coarse());
 	ABT_mutex_unlock(db->d_raft_mutex);
 	if (rc != 0) {
 		D_ERROR(DF_DB": failed to process APPENDENTRIES from rank %u: "
@@ -3291,6 +3862,41 @@ out:
 			srcrank, rc);
 }
 
+/*
+ * As the leader may keep several chunks of a snapshot in flight, they may
+ * arrive out of order. Wait, for at most one request timeout, for the
+ * preceding chunks to be stored before passing the one described by in to
+ * raft. Caller must hold d_raft_mutex.
+ */
+static void
+rdb_raft_wait_is_chunk(struct rdb *db, struct rdb_installsnapshot_in *in)
+{
+	struct rdb_lc_record   *slc_record = &db->d_slc_record;
+	struct timespec		deadline;
+
+	rdb_raft_set_deadline(&deadline, raft_get_request_timeout(db->d_raft));
+	while (in->isi_seq > 1 && !db->d_stop) {
+		uint64_t seq = 0;
+
+		/* Stale, or already installed? Let raft sort it out. */
+		if (in->isi_msg.term < raft_get_current_term(db->d_raft) ||
+		    in->isi_msg.last_idx <= db->d_lc_record.dlr_base)
+			break;
+
+		if (daos_handle_is_valid(db->d_slc) && slc_record->dlr_term == in->isi_msg.term &&
+		    slc_record->dlr_base == in->isi_msg.last_idx)
+			seq = slc_record->dlr_seq;
+		if (in->isi_seq <= seq + 1)
+			break;
+
+		D_DEBUG(DB_TRACE, DF_DB": waiting for is chunks before %ld/"DF_U64": "DF_U64"\n",
+			DP_DB(db), in->isi_msg.last_idx, in->isi_seq, seq);
+		if (ABT_cond_timedwait(db->d_applied_cv, db->d_raft_mutex, &deadline) ==
+		    ABT_ERR_COND_TIMEDOUT)
+			break;
+	}
+}
+
 void
 rdb_installsnapshot_handler(crt_rpc_t *rpc)
 {
@@ -3328,6 +3934,7 @@ rdb_installsnapshot_handler(crt_rpc_t *rpc)
 	}
 
 	ABT_mutex_lock(db->d_raft_mutex);
+	rdb_raft_wait_is_chunk(db, in);
 	rdb_raft_save_state(db, &state);
 	rc = raft_recv_installsnapshot(db->d_raft,
 				       raft_get_node(db->d_raft, srcrank),
@@ -3364,6 +3971,7 @@ rdb_raft_process_reply(struct rdb *db, crt_rpc_t *rpc)
 	void			       *out = crt_reply_get(rpc);
 	struct rdb_requestvote_out     *out_rv;
 	struct rdb_appendentries_out   *out_ae;
+	struct rdb_installsnapshot_in  *in_is;
 	struct rdb_installsnapshot_out *out_is;
 	d_rank_t			rank;
 	raft_node_t		       *node;
@@ -3424,10 +4032,17 @@ rdb_raft_process_reply(struct rdb *db, crt_rpc_t *rpc)
 		break;
 	case RDB_APPENDENTRIES:
 		out_ae = out;
+		rdb_ae_reply(raft_node_get_udata(node), &out_ae->aeo_msg);
 		rc = raft_recv_appendentries_response(db->d_raft, node, &out_ae->aeo_msg);
+		if (db->d_lease_waiters > 0 && raft_has_majority_leases(db->d_raft))
+			ABT_cond_broadcast(db->d_applied_cv);
 		break;
 	case RDB_INSTALLSNAPSHOT:
+		in_is = crt_req_get(rpc);
 		out_is = out;
+		rdb_is_reply(raft_node_get_udata(node), raft_get_current_term(db->d_raft),
+			     in_is->isi_local.rl_is_gen, &out_is->iso_msg, out_is->iso_success,
+			     out_is->iso_seq, &out_is->iso_anchor);
 		rc = raft_recv_installsnapshot_response(db->d_raft, node, &out_is->iso_msg);
 		break;
 	default:
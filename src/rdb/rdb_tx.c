@@ -24,6 +24,7 @@
 
 /* Flags for rdb_tx.dt_flags */
 #define RDB_TX_LOCAL	(1U << 0)	/* local and query-only */
+#define RDB_TX_STALE	(1U << 1)	/* bounded-staleness and query-only */
 
 /* Check leadership locally. Caller must hold d_raft_mutex lock. */
 static inline int
@@ -85,6 +86,49 @@ rdb_tx_begin(struct rdb *db, uint64_t term, struct rdb_tx *tx)
 	return 0;
 }
 
+/**
+ * Initialize and begin a query-only \a tx that may be served by a follower.
+ * May Argobots-block. The resulting \a tx sees all updates committed more than
+ * \a staleness milliseconds, plus the network delay of one AE, before this
+ * call, but may miss some of those committed afterward. A follower only
+ * serves \a tx if it recently accepted an AE sent while the leader held
+ * majority leases, so this requires RDB_USE_LEASES. If this replica is the
+ * leader, \a tx is equivalent to one begun with rdb_tx_begin, except that
+ * queries in \a tx do not fail when this replica loses its leadership later.
+ *
+ * \param[in]	db		database
+ * \param[in]	staleness	maximum staleness in milliseconds
+ * \param[out]	tx		transaction
+ *
+ * \retval -DER_NOTLEADER	this replica neither leader nor fresh enough
+ */
+int
+rdb_tx_begin_stale(struct rdb *db, uint64_t staleness, struct rdb_tx *tx)
+{
+	struct rdb_tx	t = {};
+	uint64_t	term;
+	int		rc;
+
+	ABT_mutex_lock(db->d_raft_mutex);
+	term = raft_get_current_term(db->d_raft);
+	if (raft_is_leader(db->d_raft)) {
+		rc = rdb_raft_wait_applied(db, db->d_debut, term);
+		if (rc == 0)
+			rc = rdb_raft_verify_leadership(db);
+	} else {
+		rc = rdb_raft_check_freshness(db, staleness);
+	}
+	ABT_mutex_unlock(db->d_raft_mutex);
+	if (rc != 0)
+		return rc;
+	rdb_get(db);
+	t.dt_db = db;
+	t.dt_term = term;
+	t.dt_flags = RDB_TX_STALE;
+	*tx = t;
+	return 0;
+}
+
 /**
  * Initialize and begin a local, query-only \a tx. The resulting \a tx sees the
  * latest DB contents that may contain uncommitted updates. This is mainly
@@ -318,7 +362,7 @@ rdb_tx_append(struct rdb_tx *tx, struct rdb_tx_op *op, bool is_critical)
 	const size_t		RDB_TX_CRITICAL_OPS_LIMIT = 8;
 	int			rc;
 
-	D_ASSERT(!(tx->dt_flags & RDB_TX_LOCAL));
+	D_ASSERT(!(tx->dt_flags & (RDB_TX_LOCAL | RDB_TX_STALE)));
 	D_ASSERTF((tx->dt_entry == NULL && tx->dt_entry_cap == 0 &&
 		   tx->dt_entry_len == 0) ||
 		  (tx->dt_entry != NULL && tx->dt_entry_cap > 0 &&
@@ -393,7 +437,7 @@ rdb_tx_append(struct rdb_tx *tx, struct rdb_tx_op *op, bool is_critical)
 void
 rdb_tx_discard(struct rdb_tx *tx)
 {
-	D_ASSERT(!(tx->dt_flags & RDB_TX_LOCAL));
+	D_ASSERT(!(tx->dt_flags & (RDB_TX_LOCAL | RDB_TX_STALE)));
 	D_ASSERTF((tx->dt_entry == NULL && tx->dt_entry_cap == 0 && tx->dt_entry_len == 0) ||
 		      (tx->dt_entry != NULL && tx->dt_entry_cap > 0 &&
 		       tx->dt_entry_len <= tx->dt_entry_cap),
@@ -1106,6 +1150,8 @@ rdb_tx_query_pre(struct rdb_tx *tx, const rdb_path_t *path,
 	ABT_mutex_lock(tx->dt_db->d_raft_mutex);
 	if (tx->dt_flags & RDB_TX_LOCAL) {
 		i = tx->dt_db->d_lc_record.dlr_tail - 1;
+	} else if (tx->dt_flags & RDB_TX_STALE) {
+		i = tx->dt_db->d_applied;
 	} else {
 		i = tx->dt_db->d_applied;
 		rc = rdb_tx_leader_check(tx);
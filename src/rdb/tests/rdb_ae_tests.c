@@ -0,0 +1,297 @@
+/*
+ * (C) Copyright 2024 Intel Corporation.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause-Patent
+ */
+
+/**
+ * Unit tests for the AppendEntries pipeline state kept by the leader for each
+ * follower. A fake leader asks for AEs the way raft does, that is, always from
+ * the next index of the follower, and feeds the follower's replies back. Also
+ * tests the freshness a follower derives from the AEs it accepts.
+ */
+
+#include <stdarg.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <setjmp.h>
+#include <cmocka.h>
+#include <daos/tests_lib.h>
+#include <daos_srv/rdb.h>
+#include "../rdb_internal.h"
+
+#define T_TERM		2
+#define T_MAX_INFLIGHT	4
+#define T_TIMEOUT	3000
+#define T_BATCH		8
+#define T_LOG_MAX	256
+
+struct t_leader {
+	msg_entry_t		tl_entries[T_LOG_MAX + 1];	/* [1, tl_current] */
+	uint64_t		tl_current;	/* last index */
+	uint64_t		tl_next;	/* next index of the follower */
+	uint64_t		tl_now;		/* in ms */
+	struct rdb_raft_node	tl_node;
+};
+
+static void
+t_init(struct t_leader *l)
+{
+	memset(l, 0, sizeof(*l));
+	l->tl_next = 1;
+	l->tl_now = 1000;
+}
+
+static void
+t_append(struct t_leader *l, int n)
+{
+	int i;
+
+	assert_true(l->tl_current + n <= T_LOG_MAX);
+	for (i = 0; i < n; i++)
+		l->tl_entries[++l->tl_current].term = T_TERM;
+}
+
+/*
+ * Prepare and send an AE from the next index of the follower, with all the
+ * entries after it unless heartbeat is true. Return false if it is deferred.
+ */
+static bool
+t_send(struct t_leader *l, bool heartbeat, msg_appendentries_t *ae)
+{
+	memset(ae, 0, sizeof(*ae));
+	ae->term = T_TERM;
+	ae->prev_log_idx = l->tl_next - 1;
+	ae->prev_log_term = ae->prev_log_idx == 0 ? 0 : T_TERM;
+	if (!heartbeat && l->tl_current >= l->tl_next) {
+		ae->entries = &l->tl_entries[l->tl_next];
+		ae->n_entries = l->tl_current - l->tl_next + 1;
+	}
+
+	if (!rdb_ae_prepare(&l->tl_node, ae, T_MAX_INFLIGHT, l->tl_now, T_TIMEOUT))
+		return false;
+	rdb_ae_sent(&l->tl_node, ae, l->tl_now);
+	return true;
+}
+
+/* Feed back a reply saying the follower has appended up to current_idx. */
+static void
+t_reply(struct t_leader *l, bool success, uint64_t current_idx)
+{
+	msg_appendentries_response_t resp = {};
+
+	resp.term = T_TERM;
+	resp.success = success;
+	resp.current_idx = current_idx;
+	rdb_ae_reply(&l->tl_node, &resp);
+
+	/* What raft does with the reply */
+	if (success && current_idx >= l->tl_next)
+		l->tl_next = current_idx + 1;
+}
+
+/* Heartbeats and their replies must not make room in the pipeline. */
+static void
+rdb_ae_test_heartbeats(void **state)
+{
+	struct t_leader		l;
+	msg_appendentries_t	ae;
+	int			i;
+
+	t_init(&l);
+
+	for (i = 0; i < T_MAX_INFLIGHT; i++) {
+		t_append(&l, T_BATCH);
+		assert_true(t_send(&l, false /* heartbeat */, &ae));
+		assert_int_equal(ae.prev_log_idx, i * T_BATCH);
+		assert_int_equal(ae.n_entries, T_BATCH);
+		assert_int_equal(l.tl_node.dn_ae_inflight, i + 1);
+
+		assert_true(t_send(&l, true /* heartbeat */, &ae));
+		assert_int_equal(ae.n_entries, 0);
+		t_reply(&l, true /* success */, ae.prev_log_idx);
+		assert_int_equal(l.tl_node.dn_ae_inflight, i + 1);
+	}
+
+	/* The pipeline is full, however many heartbeats are replied. */
+	t_append(&l, T_BATCH);
+	for (i = 0; i < 2 * T_MAX_INFLIGHT; i++) {
+		assert_false(t_send(&l, false /* heartbeat */, &ae));
+		assert_true(t_send(&l, true /* heartbeat */, &ae));
+		t_reply(&l, true /* success */, ae.prev_log_idx);
+		assert_int_equal(l.tl_node.dn_ae_inflight, T_MAX_INFLIGHT);
+	}
+
+	/* The reply to the first AE makes room for one more. */
+	t_reply(&l, true /* success */, T_BATCH);
+	assert_int_equal(l.tl_node.dn_ae_inflight, T_MAX_INFLIGHT - 1);
+	assert_true(t_send(&l, false /* heartbeat */, &ae));
+	assert_int_equal(ae.prev_log_idx, T_MAX_INFLIGHT * T_BATCH);
+	assert_int_equal(ae.n_entries, T_BATCH);
+	assert_int_equal(l.tl_node.dn_ae_inflight, T_MAX_INFLIGHT);
+
+	/* The reply to the last AE retires all of them... */
+	t_reply(&l, true /* success */, l.tl_current);
+	assert_int_equal(l.tl_node.dn_ae_inflight, 0);
+
+	/* ...and the late replies to the others do not matter. */
+	t_reply(&l, true /* success */, 2 * T_BATCH);
+	assert_int_equal(l.tl_node.dn_ae_inflight, 0);
+}
+
+/* Entries in flight are trimmed from the AEs raft asks for. */
+static void
+rdb_ae_test_trim(void **state)
+{
+	struct t_leader		l;
+	msg_appendentries_t	ae;
+
+	t_init(&l);
+
+	t_append(&l, T_BATCH);
+	assert_true(t_send(&l, false /* heartbeat */, &ae));
+	assert_int_equal(l.tl_node.dn_ae_sent, T_BATCH);
+
+	/* All entries in flight already, send a heartbeat instead. */
+	assert_true(t_send(&l, false /* heartbeat */, &ae));
+	assert_int_equal(ae.n_entries, 0);
+	assert_int_equal(ae.prev_log_idx, 0);
+	assert_int_equal(l.tl_node.dn_ae_inflight, 1);
+
+	/* Only the new entries are sent. */
+	t_append(&l, T_BATCH);
+	assert_true(t_send(&l, false /* heartbeat */, &ae));
+	assert_int_equal(ae.prev_log_idx, T_BATCH);
+	assert_int_equal(ae.prev_log_term, T_TERM);
+	assert_ptr_equal(ae.entries, &l.tl_entries[T_BATCH + 1]);
+	assert_int_equal(ae.n_entries, T_BATCH);
+	assert_int_equal(l.tl_node.dn_ae_inflight, 2);
+	assert_int_equal(l.tl_node.dn_ae_sent, 2 * T_BATCH);
+	assert_int_equal(l.tl_node.dn_ae[1].dra_start, T_BATCH + 1);
+	assert_int_equal(l.tl_node.dn_ae[1].dra_end, 2 * T_BATCH);
+}
+
+/* Rejected or partially appended AEs empty the pipeline. */
+static void
+rdb_ae_test_reset(void **state)
+{
+	struct t_leader		l;
+	msg_appendentries_t	ae;
+
+	t_init(&l);
+
+	t_append(&l, T_BATCH);
+	assert_true(t_send(&l, false /* heartbeat */, &ae));
+	t_append(&l, T_BATCH);
+	assert_true(t_send(&l, false /* heartbeat */, &ae));
+	assert_int_equal(l.tl_node.dn_ae_inflight, 2);
+
+	/* Only half of the first AE appended */
+	t_reply(&l, true /* success */, T_BATCH / 2);
+	assert_int_equal(l.tl_node.dn_ae_inflight, 0);
+
+	/* Everything from the next index goes in one AE again. */
+	assert_true(t_send(&l, false /* heartbeat */, &ae));
+	assert_int_equal(ae.prev_log_idx, T_BATCH / 2);
+	assert_int_equal(ae.n_entries, 2 * T_BATCH - T_BATCH / 2);
+	assert_int_equal(l.tl_node.dn_ae_inflight, 1);
+
+	t_reply(&l, false /* success */, 0);
+	assert_int_equal(l.tl_node.dn_ae_inflight, 0);
+}
+
+/* AEs of an earlier term or without replies in time are forgotten. */
+static void
+rdb_ae_test_expire(void **state)
+{
+	struct t_leader		l;
+	msg_appendentries_t	ae;
+
+	t_init(&l);
+
+	t_append(&l, T_BATCH);
+	assert_true(t_send(&l, false /* heartbeat */, &ae));
+	l.tl_now += T_TIMEOUT / 2;
+	t_append(&l, T_BATCH);
+	assert_true(t_send(&l, false /* heartbeat */, &ae));
+	assert_int_equal(rdb_ae_inflight(&l.tl_node, T_TERM, l.tl_now, T_TIMEOUT), 2);
+
+	/* The oldest AE expires first. */
+	l.tl_now += T_TIMEOUT / 2;
+	assert_int_equal(rdb_ae_inflight(&l.tl_node, T_TERM, l.tl_now, T_TIMEOUT), 0);
+
+	assert_true(t_send(&l, false /* heartbeat */, &ae));
+	assert_int_equal(ae.prev_log_idx, 0);
+	assert_int_equal(ae.n_entries, 2 * T_BATCH);
+	assert_int_equal(rdb_ae_inflight(&l.tl_node, T_TERM, l.tl_now, T_TIMEOUT), 1);
+	assert_int_equal(rdb_ae_inflight(&l.tl_node, T_TERM + 1, l.tl_now, T_TIMEOUT), 0);
+}
+
+/* Only AEs sent with majority leases and fully applied refresh a follower. */
+static void
+rdb_ae_test_refresh(void **state)
+{
+	static struct rdb		db;
+	struct rdb_appendentries_in	in = {};
+	msg_appendentries_response_t	resp = {};
+	uint64_t			now = 1000;
+
+	memset(&db, 0, sizeof(db));
+	db.d_applied = 10;
+	in.aei_msg.term = T_TERM;
+	in.aei_msg.leader_commit = 10;
+	resp.term = T_TERM;
+	resp.success = 1;
+
+	/* Never refreshed */
+	assert_false(rdb_ae_fresh(&db, T_TIMEOUT, now));
+
+	/* From a leader without majority leases, possibly a deposed one */
+	rdb_ae_refresh(&db, &in, &resp, now);
+	assert_false(rdb_ae_fresh(&db, T_TIMEOUT, now));
+
+	/* Rejected */
+	in.aei_flags = RDB_AE_LEASED;
+	resp.success = 0;
+	rdb_ae_refresh(&db, &in, &resp, now);
+	assert_false(rdb_ae_fresh(&db, T_TIMEOUT, now));
+
+	/* Not applied up to the leader commit index yet */
+	resp.success = 1;
+	in.aei_msg.leader_commit = 11;
+	rdb_ae_refresh(&db, &in, &resp, now);
+	assert_false(rdb_ae_fresh(&db, T_TIMEOUT, now));
+
+	in.aei_msg.leader_commit = 10;
+	rdb_ae_refresh(&db, &in, &resp, now);
+	assert_true(rdb_ae_fresh(&db, T_TIMEOUT, now));
+	assert_true(rdb_ae_fresh(&db, T_TIMEOUT, now + T_TIMEOUT));
+
+	/* Too stale */
+	assert_false(rdb_ae_fresh(&db, T_TIMEOUT, now + T_TIMEOUT + 1));
+	assert_false(rdb_ae_fresh(&db, 0, now + 1));
+
+	/* A later AE from a deposed leader does not extend the freshness. */
+	in.aei_flags = 0;
+	rdb_ae_refresh(&db, &in, &resp, now + T_TIMEOUT);
+	assert_false(rdb_ae_fresh(&db, T_TIMEOUT, now + T_TIMEOUT + 1));
+	in.aei_flags = RDB_AE_LEASED;
+	rdb_ae_refresh(&db, &in, &resp, now + T_TIMEOUT);
+	assert_true(rdb_ae_fresh(&db, T_TIMEOUT, now + T_TIMEOUT + 1));
+}
+
+int
+main(void)
+{
+	/* clang-format off */
+	const struct CMUnitTest tests[] = {
+		cmocka_unit_test(rdb_ae_test_heartbeats),
+		cmocka_unit_test(rdb_ae_test_trim),
+		cmocka_unit_test(rdb_ae_test_reset),
+		cmocka_unit_test(rdb_ae_test_expire),
+		cmocka_unit_test(rdb_ae_test_refresh)
+	};
+	/* clang-format on */
+
+	return cmocka_run_group_tests(tests, NULL, NULL);
+}
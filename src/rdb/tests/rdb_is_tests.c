@@ -0,0 +1,255 @@
+/*
+ * (C) Copyright 2024 Intel Corporation.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause-Patent
+ */
+
+/**
+ * Unit tests for the InstallSnapshot pipeline state kept by the leader for
+ * each follower. A fake leader sends chunks the way rdb_raft_cb_send_installsnapshot
+ * does and feeds back the follower's replies, each reporting the last chunk
+ * stored by the follower.
+ */
+
+#include <stdarg.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <setjmp.h>
+#include <cmocka.h>
+#include <daos/tests_lib.h>
+#include <daos_srv/rdb.h>
+#include "../rdb_internal.h"
+
+#define T_TERM		2
+#define T_INDEX		10
+#define T_MAX_INFLIGHT	4
+#define T_TIMEOUT	3000
+
+/* rdb_util.c brings in VOS, which is not needed here. */
+void
+rdb_anchor_set_zero(struct rdb_anchor *anchor)
+{
+	memset(anchor, 0, sizeof(*anchor));
+}
+
+struct t_chunk {
+	uint64_t	tc_seq;
+	uint64_t	tc_gen;
+};
+
+struct t_leader {
+	struct rdb_raft_node	tl_node;
+	uint64_t		tl_now;		/* in ms */
+	uint64_t		tl_follower;	/* last seq stored by the follower */
+};
+
+/* Anchors are identified by the seq of the chunk that ends at them. */
+static void
+t_anchor(struct rdb_anchor *anchor, uint64_t seq)
+{
+	memset(anchor, 0, sizeof(*anchor));
+	anchor->da_object.da_sub_anchors = seq;
+}
+
+static void
+t_init(struct t_leader *l)
+{
+	memset(l, 0, sizeof(*l));
+	l->tl_node.dn_rank = 1;
+	l->tl_now = 1000;
+	rdb_is_start(&l->tl_node, T_TERM, T_INDEX);
+}
+
+/* Send chunks until T_MAX_INFLIGHT are in flight, and return the number sent. */
+static int
+t_send(struct t_leader *l, struct t_chunk *chunks)
+{
+	struct rdb_raft_is     *is = &l->tl_node.dn_is;
+	struct rdb_anchor	anchor;
+	int			n = 0;
+
+	rdb_is_start(&l->tl_node, T_TERM, T_INDEX);
+	rdb_is_prepare(&l->tl_node, l->tl_now, T_TIMEOUT);
+	while (is->dis_inflight < T_MAX_INFLIGHT) {
+		chunks[n].tc_seq = is->dis_sent_seq + 1;
+		chunks[n].tc_gen = is->dis_gen;
+		t_anchor(&anchor, chunks[n].tc_seq);
+		rdb_is_sent(&l->tl_node, chunks[n].tc_seq, &anchor, l->tl_now);
+		n++;
+	}
+	return n;
+}
+
+/*
+ * Feed back the reply to chunk c. If stored is true, the follower stores the
+ * chunk if it follows the last one stored; otherwise, it fails to store it.
+ */
+static void
+t_reply(struct t_leader *l, const struct t_chunk *c, bool stored)
+{
+	msg_installsnapshot_response_t	resp = {};
+	struct rdb_anchor		anchor;
+
+	if (stored && c->tc_seq == l->tl_follower + 1)
+		l->tl_follower = c->tc_seq;
+	resp.term = T_TERM;
+	resp.last_idx = T_INDEX;
+	t_anchor(&anchor, l->tl_follower);
+	rdb_is_reply(&l->tl_node, T_TERM, c->tc_gen, &resp, stored, l->tl_follower, &anchor);
+}
+
+/* Replies in order retire the chunks one by one. */
+static void
+rdb_is_test_pipeline(void **state)
+{
+	struct t_leader		l;
+	struct rdb_raft_is     *is = &l.tl_node.dn_is;
+	struct t_chunk		chunks[T_MAX_INFLIGHT];
+	int			i;
+
+	t_init(&l);
+
+	assert_int_equal(t_send(&l, chunks), T_MAX_INFLIGHT);
+	for (i = 0; i < T_MAX_INFLIGHT; i++)
+		assert_int_equal(chunks[i].tc_seq, i + 1);
+
+	t_reply(&l, &chunks[0], true /* stored */);
+	assert_int_equal(is->dis_seq, 1);
+	assert_int_equal(is->dis_inflight, T_MAX_INFLIGHT - 1);
+
+	/* One more chunk continues from the last one sent. */
+	assert_int_equal(t_send(&l, chunks), 1);
+	assert_int_equal(chunks[0].tc_seq, T_MAX_INFLIGHT + 1);
+	assert_int_equal(is->dis_sent_seq, T_MAX_INFLIGHT + 1);
+	assert_int_equal(is->dis_sent_anchor.da_object.da_sub_anchors, T_MAX_INFLIGHT + 1);
+}
+
+/* Late replies to the chunks forgotten by a rewind do not retire new chunks. */
+static void
+rdb_is_test_rewind(void **state)
+{
+	struct t_leader		l;
+	struct rdb_raft_is     *is = &l.tl_node.dn_is;
+	struct t_chunk		old[T_MAX_INFLIGHT];
+	struct t_chunk		new[T_MAX_INFLIGHT];
+	int			i;
+
+	t_init(&l);
+
+	assert_int_equal(t_send(&l, old), T_MAX_INFLIGHT);
+
+	/* No reply in time; rewind to the start. */
+	l.tl_now += T_TIMEOUT;
+	assert_int_equal(t_send(&l, new), T_MAX_INFLIGHT);
+	assert_int_equal(new[0].tc_seq, 1);
+	assert_int_not_equal(new[0].tc_gen, old[0].tc_gen);
+
+	/* The old chunks arrive after all. */
+	for (i = 0; i < T_MAX_INFLIGHT - 1; i++) {
+		t_reply(&l, &old[i], true /* stored */);
+		assert_int_equal(is->dis_seq, i + 1);
+		assert_int_equal(is->dis_inflight, T_MAX_INFLIGHT);
+	}
+
+	/* Even one covering every new chunk does not empty the pipeline. */
+	t_reply(&l, &old[T_MAX_INFLIGHT - 1], true /* stored */);
+	assert_int_equal(is->dis_seq, T_MAX_INFLIGHT);
+	assert_true(is->dis_seq >= is->dis_sent_seq);
+	assert_int_equal(is->dis_inflight, T_MAX_INFLIGHT);
+	assert_int_equal(t_send(&l, new), 0);
+
+	/*
+	 * The follower has all the new chunks already. The first reply to
+	 * them empties the pipeline; the others are late ones.
+	 */
+	t_reply(&l, &new[0], true /* stored */);
+	assert_int_equal(is->dis_inflight, 0);
+	for (i = 1; i < T_MAX_INFLIGHT; i++) {
+		t_reply(&l, &new[i], true /* stored */);
+		assert_int_equal(is->dis_inflight, 0);
+	}
+
+	/* The next chunks continue from the follower. */
+	assert_int_equal(t_send(&l, new), T_MAX_INFLIGHT);
+	assert_int_equal(new[0].tc_seq, T_MAX_INFLIGHT + 1);
+	assert_int_equal(is->dis_inflight, T_MAX_INFLIGHT);
+}
+
+/* Only a failure to store a chunk of the current generation rewinds. */
+static void
+rdb_is_test_failure(void **state)
+{
+	struct t_leader		l;
+	struct rdb_raft_is     *is = &l.tl_node.dn_is;
+	struct t_chunk		old[T_MAX_INFLIGHT];
+	struct t_chunk		new[T_MAX_INFLIGHT];
+
+	t_init(&l);
+
+	assert_int_equal(t_send(&l, old), T_MAX_INFLIGHT);
+	t_reply(&l, &old[0], true /* stored */);
+	t_reply(&l, &old[1], false /* stored */);
+	assert_int_equal(is->dis_seq, 1);
+	assert_int_equal(is->dis_inflight, 0);
+
+	/* Rewind to the chunk after the last one stored. */
+	assert_int_equal(t_send(&l, new), T_MAX_INFLIGHT);
+	assert_int_equal(new[0].tc_seq, 2);
+
+	/* Failures of the forgotten chunks do not matter. */
+	t_reply(&l, &old[2], false /* stored */);
+	t_reply(&l, &old[3], false /* stored */);
+	assert_int_equal(is->dis_inflight, T_MAX_INFLIGHT);
+
+	t_reply(&l, &new[0], true /* stored */);
+	assert_int_equal(is->dis_seq, 2);
+	assert_int_equal(is->dis_inflight, T_MAX_INFLIGHT - 1);
+}
+
+/* Replies for an earlier term or snapshot are ignored. */
+static void
+rdb_is_test_restart(void **state)
+{
+	struct t_leader			l;
+	struct rdb_raft_is	       *is = &l.tl_node.dn_is;
+	struct t_chunk			chunks[T_MAX_INFLIGHT];
+	msg_installsnapshot_response_t	resp = {};
+	struct rdb_anchor		anchor;
+
+	t_init(&l);
+
+	assert_int_equal(t_send(&l, chunks), T_MAX_INFLIGHT);
+
+	/* A new snapshot starts from the beginning. */
+	rdb_is_start(&l.tl_node, T_TERM, T_INDEX + 1);
+	assert_int_equal(is->dis_seq, 0);
+	assert_int_equal(is->dis_inflight, 0);
+
+	resp.last_idx = T_INDEX;
+	t_anchor(&anchor, 1);
+	rdb_is_reply(&l.tl_node, T_TERM, chunks[0].tc_gen, &resp, true /* success */, 1, &anchor);
+	assert_int_equal(is->dis_seq, 0);
+
+	/* So does a new term. */
+	resp.last_idx = T_INDEX + 1;
+	rdb_is_start(&l.tl_node, T_TERM + 1, T_INDEX + 1);
+	rdb_is_reply(&l.tl_node, T_TERM, is->dis_gen, &resp, true /* success */, 1, &anchor);
+	assert_int_equal(is->dis_seq, 0);
+	rdb_is_reply(&l.tl_node, T_TERM + 1, is->dis_gen, &resp, true /* success */, 1, &anchor);
+	assert_int_equal(is->dis_seq, 1);
+}
+
+int
+main(void)
+{
+	/* clang-format off */
+	const struct CMUnitTest tests[] = {
+		cmocka_unit_test(rdb_is_test_pipeline),
+		cmocka_unit_test(rdb_is_test_rewind),
+		cmocka_unit_test(rdb_is_test_failure),
+		cmocka_unit_test(rdb_is_test_restart)
+	};
+	/* clang-format on */
+
+	return cmocka_run_group_tests(tests, NULL, NULL);
+}
@@ -210,6 +210,10 @@ struct rebuild_global {
 	ABT_cond	rg_stop_cond;
 	/* how many pools is being rebuilt */
 	unsigned int	rg_inflight;
+	/* Number of ULTs scanning the containers of a target in parallel */
+	unsigned int	rg_scan_ults;
+	/* Max objects queued by the scanners of a target but not sent yet */
+	unsigned int	rg_scan_inflight_max;
 	unsigned int	rg_rebuild_running:1,
 			rg_abort:1;
 };
@@ -245,6 +249,10 @@ struct rebuild_pool_tls {
 	d_list_t	rebuild_pool_list;
 	uint64_t	rebuild_pool_obj_count;
 	uint64_t	rebuild_pool_reclaim_obj_count;
+	/* Objects in rebuild_tree_hdl not sent yet, bounded by rg_scan_inflight_max */
+	uint64_t	rebuild_pool_obj_inflight;
+	/* Objects scanned, for the scan rate metric */
+	uint64_t	rebuild_pool_scanned;
 	unsigned int	rebuild_pool_ver;
 	uint32_t	rebuild_pool_gen;
 	uint64_t	rebuild_pool_leader_term;
@@ -303,6 +311,19 @@ struct rebuild_iv {
 #define SCAN_YIELD_FREQ		4096
 #define SCAN_OBJ_YIELD_CNT	128
 
+#define SCAN_ULTS_DEF		4
+#define SCAN_ULTS_MAX		64
+#define SCAN_INFLIGHT_DEF	(64 << 10)
+
+/* Per pool per target rebuild metrics */
+struct rebuild_pool_metrics {
+	struct d_tm_node_t	*rpm_scanned_objs;
+	struct d_tm_node_t	*rpm_scan_rate;
+	struct d_tm_node_t	*rpm_inflight_objs;
+};
+
+extern struct daos_module_metrics rebuild_metrics;
+
 extern struct dss_module_key rebuild_module_key;
 static inline struct rebuild_tls *
 rebuild_tls_get()
@@ -37,6 +37,7 @@ struct rebuild_send_arg {
 	unsigned int			*shards;
 	int				count;
 	unsigned int			tgt_id;
+	struct rebuild_pool_tls		*tls;
 };
 
 struct rebuild_obj_val {
@@ -134,6 +135,9 @@ rebuild_obj_send_cb(struct tree_cache_root *root, struct rebuild_send_arg *arg)
 		dss_sleep(daos_rpc_rand_delay(max_delay) << 10);
 	}
 out:
+	/* The objects have been removed from the tree, return the credits to the scanners */
+	D_ASSERT(arg->tls->rebuild_pool_obj_inflight >= arg->count);
+	arg->tls->rebuild_pool_obj_inflight -= arg->count;
 	return rc;
 }
 
@@ -293,6 +297,7 @@ rebuild_objects_send_ult(void *data)
 	arg.ephs = ephs;
 	arg.punched_ephs = punched_ephs;
 	arg.rpt = rpt;
+	arg.tls = tls;
 	while (!tls->rebuild_pool_scan_done || !dbtree_is_empty(tls->rebuild_tree_hdl)) {
 		if (rpt->rt_stable_epoch == 0) {
 			dss_sleep(0);
@@ -347,12 +352,12 @@ rebuild_scan_done(void *data)
 
 /**
  * The rebuild objects will be gathered into a global objects array by
- * target id.
+ * target id. \a waited is set if the insert had to wait for credits.
  **/
 static int
 rebuild_object_insert(struct rebuild_tgt_pool_tracker *rpt, uuid_t co_uuid,
 		      daos_unit_oid_t oid, unsigned int tgt_id, unsigned int shard,
-		      daos_epoch_t epoch, daos_epoch_t punched_epoch)
+		      daos_epoch_t epoch, daos_epoch_t punched_epoch, bool *waited)
 {
 	struct rebuild_pool_tls *tls;
 	struct rebuild_obj_val	val;
@@ -364,6 +369,19 @@ rebuild_object_insert(struct rebuild_tgt_pool_tracker *rpt, uuid_t co_uuid,
 	D_ASSERT(tls != NULL);
 	D_ASSERT(daos_handle_is_valid(tls->rebuild_tree_hdl));
 
+	/*
+	 * Credit based flow control: the scanners are throttled once too many objects
+	 * are waiting in the tree, the send ULT returns the credits after shipping them.
+	 */
+	while (tls->rebuild_pool_obj_inflight >= rebuild_gst.rg_scan_inflight_max) {
+		if (rpt->rt_abort)
+			return 1;
+		if (tls->rebuild_pool_status != 0)
+			return tls->rebuild_pool_status;
+		*waited = true;
+		dss_sleep(0);
+	}
+
 	tls->rebuild_pool_obj_count++;
 	val.eph = epoch;
 	val.punched_eph = punched_epoch;
@@ -381,6 +399,8 @@ rebuild_object_insert(struct rebuild_tgt_pool_tracker *rpt, uuid_t co_uuid,
 			DP_UUID(co_uuid), DP_UOID(oid), tgt_id);
 		rc = 0;
 	} else {
+		if (rc == 0)
+			tls->rebuild_pool_obj_inflight++;
 		D_DEBUG(DB_REBUILD, "insert "DF_UOID"/"DF_UUID" tgt %u "DF_U64"/"DF_U64": "
 			DF_RC"\n", DP_UOID(oid), DP_UUID(co_uuid), tgt_id, epoch,
 			punched_epoch, DP_RC(rc));
@@ -391,7 +411,45 @@ rebuild_object_insert(struct rebuild_tgt_pool_tracker *rpt, uuid_t co_uuid,
 
 #define LOCAL_ARRAY_SIZE	128
 #define NUM_SHARDS_STEP_INCREASE	10
-/* The structure for scan per xstream */
+/* Number of objects placed together by pl_obj_find_rebuild_batch() */
+#define REBUILD_SCAN_BATCH	64
+
+/* Object found by the scanner and waiting for the batched placement */
+struct rebuild_scan_obj {
+	daos_unit_oid_t		rso_oid;
+	daos_epoch_t		rso_epoch;
+	uint32_t		rso_vis_flags;
+	uint32_t		rso_grp_size;
+};
+
+struct rebuild_scan_batch {
+	struct rebuild_scan_obj		 rsb_objs[REBUILD_SCAN_BATCH];
+	struct daos_obj_md		 rsb_mds[REBUILD_SCAN_BATCH];
+	struct pl_rebuild_range		 rsb_ranges[REBUILD_SCAN_BATCH];
+	uint32_t			*rsb_tgts;
+	uint32_t			*rsb_shards;
+	unsigned int			 rsb_array_size;
+	int				 rsb_nr;
+};
+
+/*
+ * Containers of the target, shared by the scanner ULTs of the target. All of them
+ * run on the same xstream, so no lock is needed.
+ */
+struct rebuild_scan_conts {
+	uuid_t				*rsc_uuids;
+	int				 rsc_nr;
+	int				 rsc_cap;
+	/* Next container to be scanned */
+	int				 rsc_next;
+	/* First failure (or 1 for abort) of the scanner ULTs */
+	int				 rsc_status;
+	daos_handle_t			 rsc_poh;
+	struct rebuild_pool_tls		*rsc_tls;
+	struct rebuild_pool_metrics	*rsc_metrics;
+};
+
+/* The structure for scan per ULT */
 struct rebuild_scan_arg {
 	struct rebuild_tgt_pool_tracker *rpt;
 	uuid_t				co_uuid;
@@ -400,85 +458,13 @@ struct rebuild_scan_arg {
 	uint32_t			yield_freq;
 	int32_t				obj_yield_cnt;
 	struct ds_cont_child		*cont_child;
+	/* Only for RB_OP_REBUILD */
+	struct rebuild_scan_batch	*batch;
+	struct rebuild_scan_conts	*conts;
+	/* Yielded while waiting for credits, the VOS iterator must revalidate */
+	bool				insert_waited;
 };
 
-/**
- * Invoke placement to find the object shards that need rebuilding
- *
- * This is an optimized function - it first tries to use the provided stack
- * arrays to avoid allocating buffers to fill.
- *
- * It's possible that placement might return -DER_REC2BIG, in which case a
- * larger buffer will be allocated and the request repeated until it succeeds.
- *
- * \param[in]	map			placement map
- * \param[in]	gl_layout_ver		global layout version from pool/container.
- * \param[in]	md			object metadata
- * \param[in]	num_rebuild_tgts	the number of targets being rebuilt now
- * \param[in]	rebuild_op		the rebuild operation
- * \param[in]	rebuild_ver		the rebuild version
- * \param[in]	myrank			this system's rank
- * \param[out]	tgts			filled remap list, caller must free if
- *					it is re-allocated.
- * \param[out]	shards			filled remap list, caller must free if
- *					it is re-allocated.
- * \param[in]   orig_array_size		original size of tgts and shards
- *
- * \retval	>= 0	Success
- * \retval	> 0	number of filled entries in tgts and shards needs to be remapped
- * \retval	< 0	-DER_* error. Will not return -DER_REC2BIG
- */
-static int
-find_rebuild_shards(struct pl_map *map, uint32_t gl_layout_ver, struct daos_obj_md *md,
-		    uint32_t num_rebuild_tgts, daos_rebuild_opc_t rebuild_op,
-		    uint32_t rebuild_ver, d_rank_t myrank, unsigned int **tgts,
-		    unsigned int **shards, uint32_t orig_array_size)
-{
-	uint32_t max_shards_size = orig_array_size;
-	int	rc = 0;
-
-retry:
-	rc = pl_obj_find_rebuild(map, gl_layout_ver, md, NULL, rebuild_ver,
-				 *tgts, *shards, max_shards_size);
-	if (rc == -DER_REC2BIG) {
-		/*
-		 * The last attempt failed because there was not enough
-		 * room for all the remapped shards.
-		 *
-		 * Need to allocate more space and try again
-		 */
-		if (max_shards_size != orig_array_size && *tgts != NULL)
-			D_FREE(*tgts);
-		if (max_shards_size != orig_array_size && *shards != NULL)
-			D_FREE(*shards);
-
-		/* Increase by the step size */
-		max_shards_size += NUM_SHARDS_STEP_INCREASE;
-		D_DEBUG(DB_REBUILD, "Got REC2BIG, increase rebuild array size by %u to %u",
-			NUM_SHARDS_STEP_INCREASE, max_shards_size);
-		D_ALLOC_ARRAY(*tgts, max_shards_size);
-		D_ALLOC_ARRAY(*shards, max_shards_size);
-		if (*tgts == NULL || *shards == NULL)
-			D_GOTO(out, rc = -DER_NOMEM);
-
-		goto retry;
-	}
-
-out:
-	if (rc < 0) {
-		/*
-		 * Free any non-stack buffers that were allocated
-		 * on the last attempt
-		 */
-		if (max_shards_size != orig_array_size && *tgts != NULL)
-			D_FREE(*tgts);
-		if (max_shards_size != orig_array_size && *shards != NULL)
-			D_FREE(*shards);
-	}
-
-	return rc;
-}
-
 static int
 obj_reclaim(struct pl_map *map, uint32_t layout_ver, uint32_t new_layout_ver,
 	    struct daos_obj_md *md, struct rebuild_tgt_pool_tracker *rpt,
@@ -618,7 +604,8 @@ rebuild_object_local(struct rebuild_tgt_pool_tracker *rpt, uuid_t co_uuid,
 
 static int
 rebuild_object(struct rebuild_tgt_pool_tracker *rpt, uuid_t co_uuid, daos_unit_oid_t oid,
-	       unsigned int tgt, uint32_t shard, d_rank_t myrank, vos_iter_entry_t *ent)
+	       unsigned int tgt, uint32_t shard, d_rank_t myrank, daos_epoch_t epoch,
+	       uint32_t vis_flags, bool *waited)
 {
 	uint32_t		mytarget = dss_get_module_info()->dmi_tgt_id;
 	struct pool_target	*target;
@@ -637,11 +624,11 @@ rebuild_object(struct rebuild_tgt_pool_tracker *rpt, uuid_t co_uuid, daos_unit_o
 		return 0;
 	}
 
-	if (ent->ie_vis_flags & VOS_VIS_FLAG_COVERED) {
+	if (vis_flags & VOS_VIS_FLAG_COVERED) {
 		eph = 0;
-		punched_eph = ent->ie_epoch;
+		punched_eph = epoch;
 	} else {
-		eph = ent->ie_epoch;
+		eph = epoch;
 		punched_eph = 0;
 	}
 
@@ -649,7 +636,155 @@ rebuild_object(struct rebuild_tgt_pool_tracker *rpt, uuid_t co_uuid, daos_unit_o
 		rc = rebuild_object_local(rpt, co_uuid, oid, target->ta_comp.co_index, shard,
 					  eph, punched_eph);
 	else
-		rc = rebuild_object_insert(rpt, co_uuid, oid, tgt, shard, eph, punched_eph);
+		rc = rebuild_object_insert(rpt, co_uuid, oid, tgt, shard, eph, punched_eph,
+					   waited);
+
+	return rc;
+}
+
+/* Rebuild the shards returned by placement which are in the same group of @oid */
+static int
+rebuild_obj_shards(struct rebuild_scan_arg *arg, daos_unit_oid_t oid, daos_epoch_t epoch,
+		   uint32_t vis_flags, uint32_t grp_size, unsigned int *tgts,
+		   unsigned int *shards, int rebuild_nr, d_rank_t myrank)
+{
+	struct rebuild_tgt_pool_tracker	*rpt = arg->rpt;
+	int				 i;
+	int				 rc;
+
+	D_DEBUG(DB_REBUILD, "rebuild obj "DF_UOID" rebuild_nr %d\n", DP_UOID(oid), rebuild_nr);
+	for (i = 0; i < rebuild_nr; i++) {
+		D_DEBUG(DB_REBUILD, "rebuild obj "DF_UOID"/"DF_UUID"/"DF_UUID
+			"on %d for shard %d eph "DF_U64" visible %s\n", DP_UOID(oid),
+			DP_UUID(rpt->rt_pool_uuid), DP_UUID(arg->co_uuid),
+			tgts[i], shards[i], epoch,
+			vis_flags & VOS_VIS_FLAG_COVERED ? "no" : "yes");
+
+		/* Ignore the shard if it is not in the same group of failure shard */
+		if ((int)tgts[i] == -1 || oid.id_shard / grp_size != shards[i] / grp_size) {
+			D_DEBUG(DB_REBUILD, "i %d stale object "DF_UOID" shards %u grp_size %u tgt %d\n",
+				i, DP_UOID(oid), shards[i], grp_size, (int)tgts[i]);
+			continue;
+		}
+
+		rc = rebuild_object(rpt, arg->co_uuid, oid, tgts[i], shards[i], myrank, epoch,
+				    vis_flags, &arg->insert_waited);
+		if (rc)
+			return rc;
+
+		arg->obj_yield_cnt--;
+	}
+
+	return 0;
+}
+
+static void
+rebuild_scan_batch_free(struct rebuild_scan_batch *batch)
+{
+	D_FREE(batch->rsb_tgts);
+	D_FREE(batch->rsb_shards);
+	D_FREE(batch);
+}
+
+static int
+rebuild_scan_batch_alloc(struct rebuild_scan_batch **batch_p)
+{
+	struct rebuild_scan_batch	*batch;
+
+	D_ALLOC_PTR(batch);
+	if (batch == NULL)
+		return -DER_NOMEM;
+
+	batch->rsb_array_size = LOCAL_ARRAY_SIZE;
+	D_ALLOC_ARRAY(batch->rsb_tgts, batch->rsb_array_size);
+	D_ALLOC_ARRAY(batch->rsb_shards, batch->rsb_array_size);
+	if (batch->rsb_tgts == NULL || batch->rsb_shards == NULL) {
+		rebuild_scan_batch_free(batch);
+		return -DER_NOMEM;
+	}
+
+	*batch_p = batch;
+	return 0;
+}
+
+/*
+ * Find the rebuild shards of all the objects queued by rebuild_obj_scan_cb() with
+ * one placement call per batch, then queue the shards for migration.
+ */
+static int
+rebuild_scan_batch_flush(struct rebuild_scan_arg *arg)
+{
+	struct rebuild_tgt_pool_tracker	*rpt = arg->rpt;
+	struct rebuild_scan_batch	*batch = arg->batch;
+	struct pl_map			*map;
+	d_rank_t			 myrank;
+	int				 done = 0;
+	int				 nr;
+	int				 i;
+	int				 rc = 0;
+
+	if (batch == NULL || batch->rsb_nr == 0)
+		return 0;
+
+	map = pl_map_find(rpt->rt_pool_uuid, batch->rsb_objs[0].rso_oid.id_pub);
+	if (map == NULL) {
+		D_ERROR(DF_UUID ": Cannot find valid placement map\n",
+			DP_UUID(rpt->rt_pool_uuid));
+		D_GOTO(out, rc = -DER_INVAL);
+	}
+
+	crt_group_rank(rpt->rt_pool->sp_group, &myrank);
+	while (done < batch->rsb_nr) {
+		if (rpt->rt_abort || arg->cont_child->sc_stopping) {
+			D_DEBUG(DB_REBUILD, "rebuild is aborted\n");
+			D_GOTO(out, rc = 1);
+		}
+
+		nr = pl_obj_find_rebuild_batch(map, arg->co_props.dcp_obj_version,
+					       &batch->rsb_mds[done], batch->rsb_nr - done,
+					       rpt->rt_rebuild_ver, batch->rsb_tgts,
+					       batch->rsb_shards, batch->rsb_array_size,
+					       batch->rsb_ranges);
+		if (nr == -DER_REC2BIG) {
+			/* Not enough room for a single object, grow the arrays and retry */
+			D_FREE(batch->rsb_tgts);
+			D_FREE(batch->rsb_shards);
+			batch->rsb_array_size += NUM_SHARDS_STEP_INCREASE;
+			D_DEBUG(DB_REBUILD, "Got REC2BIG, increase rebuild array size to %u\n",
+				batch->rsb_array_size);
+			D_ALLOC_ARRAY(batch->rsb_tgts, batch->rsb_array_size);
+			D_ALLOC_ARRAY(batch->rsb_shards, batch->rsb_array_size);
+			if (batch->rsb_tgts == NULL || batch->rsb_shards == NULL)
+				D_GOTO(out, rc = -DER_NOMEM);
+			continue;
+		}
+		if (nr < 0) {
+			DL_ERROR(nr, DF_UUID " rebuild shards", DP_UUID(rpt->rt_pool_uuid));
+			D_GOTO(out, rc = nr);
+		}
+
+		for (i = 0; i < nr; i++) {
+			struct rebuild_scan_obj	*obj = &batch->rsb_objs[done + i];
+			struct pl_rebuild_range	*range = &batch->rsb_ranges[i];
+
+			if (range->prr_nr == 0)
+				continue;
+
+			rc = rebuild_obj_shards(arg, obj->rso_oid, obj->rso_epoch,
+						obj->rso_vis_flags, obj->rso_grp_size,
+						&batch->rsb_tgts[range->prr_start],
+						&batch->rsb_shards[range->prr_start],
+						range->prr_nr, myrank);
+			if (rc)
+				D_GOTO(out, rc);
+		}
+		done += nr;
+	}
+
+out:
+	batch->rsb_nr = 0;
+	if (map != NULL)
+		pl_map_decref(map);
 
 	return rc;
 }
@@ -661,6 +796,8 @@ rebuild_obj_scan_cb(daos_handle_t ch, vos_iter_entry_t *ent,
 {
 	struct rebuild_scan_arg		*arg = data;
 	struct rebuild_tgt_pool_tracker *rpt = arg->rpt;
+	struct rebuild_scan_batch	*batch = arg->batch;
+	struct rebuild_scan_conts	*conts = arg->conts;
 	struct pl_map			*map = NULL;
 	struct daos_obj_md		md;
 	daos_unit_oid_t			oid = ent->ie_oid;
@@ -670,9 +807,7 @@ rebuild_obj_scan_cb(daos_handle_t ch, vos_iter_entry_t *ent,
 	unsigned int			*shards = NULL;
 	struct daos_oclass_attr		*oc_attr;
 	uint32_t			grp_size;
-	int				rebuild_nr = 0;
 	d_rank_t			myrank;
-	int				i;
 	int				rc = 0;
 
 	if (rpt->rt_abort || arg->cont_child->sc_stopping) {
@@ -680,15 +815,13 @@ rebuild_obj_scan_cb(daos_handle_t ch, vos_iter_entry_t *ent,
 		return 1;
 	}
 
+	conts->rsc_tls->rebuild_pool_scanned++;
+	if (conts->rsc_metrics != NULL)
+		d_tm_inc_counter(conts->rsc_metrics->rpm_scanned_objs, 1);
+
 	/* If the OID is invisible, then snapshots must be created on the object. */
 	D_ASSERTF(!(ent->ie_vis_flags & VOS_VIS_FLAG_COVERED) || arg->snapshot_cnt > 0,
 		  "flags %x snapshot_cnt %d\n", ent->ie_vis_flags, arg->snapshot_cnt);
-	map = pl_map_find(rpt->rt_pool_uuid, oid.id_pub);
-	if (map == NULL) {
-		D_ERROR(DF_UOID ": Cannot find valid placement map" DF_UUID "\n", DP_UOID(oid),
-			DP_UUID(rpt->rt_pool_uuid));
-		D_GOTO(out, rc = -DER_INVAL);
-	}
 
 	oc_attr = daos_oclass_attr_find(oid.id_pub, NULL);
 	if (oc_attr == NULL) {
@@ -700,20 +833,35 @@ rebuild_obj_scan_cb(daos_handle_t ch, vos_iter_entry_t *ent,
 	grp_size = daos_oclass_grp_size(oc_attr);
 
 	dc_obj_fetch_md(oid.id_pub, &md);
-	crt_group_rank(rpt->rt_pool->sp_group, &myrank);
 	md.omd_ver = rpt->rt_rebuild_ver;
 	md.omd_fdom_lvl = arg->co_props.dcp_redun_lvl;
 	md.omd_pdom_lvl = arg->co_props.dcp_perf_domain;
 	md.omd_pda = daos_cont_props2pda(&arg->co_props, daos_oclass_is_ec(oc_attr));
+
+	/* Queue the object, placement is done for the whole batch by the flush */
+	if (rpt->rt_rebuild_op == RB_OP_REBUILD) {
+		D_ASSERT(batch != NULL);
+		batch->rsb_objs[batch->rsb_nr].rso_oid = oid;
+		batch->rsb_objs[batch->rsb_nr].rso_epoch = ent->ie_epoch;
+		batch->rsb_objs[batch->rsb_nr].rso_vis_flags = ent->ie_vis_flags;
+		batch->rsb_objs[batch->rsb_nr].rso_grp_size = grp_size;
+		batch->rsb_mds[batch->rsb_nr] = md;
+		if (++batch->rsb_nr == REBUILD_SCAN_BATCH)
+			rc = rebuild_scan_batch_flush(arg);
+		D_GOTO(out, rc);
+	}
+
+	map = pl_map_find(rpt->rt_pool_uuid, oid.id_pub);
+	if (map == NULL) {
+		D_ERROR(DF_UOID ": Cannot find valid placement map" DF_UUID "\n", DP_UOID(oid),
+			DP_UUID(rpt->rt_pool_uuid));
+		D_GOTO(out, rc = -DER_INVAL);
+	}
+
+	crt_group_rank(rpt->rt_pool->sp_group, &myrank);
 	tgts = tgt_array;
 	shards = shard_array;
 	switch (rpt->rt_rebuild_op) {
-	case RB_OP_REBUILD:
-		rc = find_rebuild_shards(map, arg->co_props.dcp_obj_version, &md,
-					 rpt->rt_tgts_num, rpt->rt_rebuild_op,
-					 rpt->rt_rebuild_ver, myrank,
-					 &tgts, &shards, LOCAL_ARRAY_SIZE);
-		break;
 	case RB_OP_RECLAIM:
 	case RB_OP_FAIL_RECLAIM:
 		rc = obj_reclaim(map, arg->co_props.dcp_obj_version, rpt->rt_new_layout_ver,
@@ -743,30 +891,8 @@ rebuild_obj_scan_cb(daos_handle_t ch, vos_iter_entry_t *ent,
 		D_GOTO(out, rc);
 	}
 
-	D_DEBUG(DB_REBUILD, "rebuild obj "DF_UOID" rebuild_nr %d\n", DP_UOID(oid), rc);
-	rebuild_nr = rc;
-	rc = 0;
-	for (i = 0; i < rebuild_nr; i++) {
-		D_DEBUG(DB_REBUILD, "rebuild obj "DF_UOID"/"DF_UUID"/"DF_UUID
-			"on %d for shard %d eph "DF_U64" visible %s\n", DP_UOID(oid),
-			DP_UUID(rpt->rt_pool_uuid), DP_UUID(arg->co_uuid),
-			tgts[i], shards[i], ent->ie_epoch,
-			ent->ie_vis_flags & VOS_VIS_FLAG_COVERED ? "no" : "yes");
-
-		/* Ignore the shard if it is not in the same group of failure shard */
-		if ((int)tgts[i] == -1 || oid.id_shard / grp_size != shards[i] / grp_size) {
-			D_DEBUG(DB_REBUILD, "i %d stale object "DF_UOID" shards %u grp_size %u tgt %d\n",
-				i, DP_UOID(oid), shards[i], grp_size, (int)tgts[i]);
-			continue;
-		}
-
-		rc = rebuild_object(rpt, arg->co_uuid, oid, tgts[i], shards[i], myrank, ent);
-		if (rc)
-			D_GOTO(out, rc);
-
-		arg->obj_yield_cnt--;
-	}
-
+	rc = rebuild_obj_shards(arg, oid, ent->ie_epoch, ent->ie_vis_flags, grp_size, tgts,
+				shards, rc, myrank);
 out:
 	if (tgts != tgt_array && tgts != NULL)
 		D_FREE(tgts);
@@ -777,11 +903,19 @@ out:
 	if (map != NULL)
 		pl_map_decref(map);
 
+	if (arg->insert_waited) {
+		arg->insert_waited = false;
+		*acts |= VOS_ITER_CB_YIELD;
+	}
+
 	if (--arg->yield_freq == 0 || arg->obj_yield_cnt <= 0) {
 		D_DEBUG(DB_REBUILD, DF_UUID" rebuild yield: %d\n",
 			DP_UUID(rpt->rt_pool_uuid), rc);
 		arg->yield_freq = SCAN_YIELD_FREQ;
 		arg->obj_yield_cnt = SCAN_OBJ_YIELD_CNT;
+		if (conts->rsc_metrics != NULL)
+			d_tm_set_gauge(conts->rsc_metrics->rpm_inflight_objs,
+				       conts->rsc_tls->rebuild_pool_obj_inflight);
 		if (rc == 0)
 			dss_sleep(0);
 		*acts |= VOS_ITER_CB_YIELD;
@@ -791,11 +925,8 @@ out:
 }
 
 static int
-rebuild_container_scan_cb(daos_handle_t ih, vos_iter_entry_t *entry,
-			  vos_iter_type_t type, vos_iter_param_t *iter_param,
-			  void *data, unsigned *acts)
+rebuild_container_scan(struct rebuild_scan_arg *arg, daos_handle_t poh, uuid_t co_uuid)
 {
-	struct rebuild_scan_arg		*arg = data;
 	struct rebuild_tgt_pool_tracker *rpt = arg->rpt;
 	struct dtx_handle		*dth = NULL;
 	vos_iter_param_t		param = { 0 };
@@ -808,35 +939,29 @@ rebuild_container_scan_cb(daos_handle_t ih, vos_iter_entry_t *entry,
 	int				snapshot_cnt = 0;
 	int				rc;
 
-	if (uuid_compare(arg->co_uuid, entry->ie_couuid) == 0) {
-		D_DEBUG(DB_REBUILD, DF_UUID" already scan\n",
-			DP_UUID(arg->co_uuid));
-		return 0;
-	}
-
-	rc = vos_cont_open(iter_param->ip_hdl, entry->ie_couuid, &coh);
+	rc = vos_cont_open(poh, co_uuid, &coh);
 	if (rc == -DER_NONEXIST) {
-		D_DEBUG(DB_REBUILD, DF_UUID" already destroyed\n", DP_UUID(arg->co_uuid));
+		D_DEBUG(DB_REBUILD, DF_UUID" already destroyed\n", DP_UUID(co_uuid));
 		return 0;
 	}
 
 	if (rc != 0) {
 		D_ERROR("Open container "DF_UUID" failed: "DF_RC"\n",
-			DP_UUID(entry->ie_couuid), DP_RC(rc));
+			DP_UUID(co_uuid), DP_RC(rc));
 		return rc;
 	}
 
-	rc = ds_cont_child_lookup(rpt->rt_pool_uuid, entry->ie_couuid, &cont_child);
+	rc = ds_cont_child_lookup(rpt->rt_pool_uuid, co_uuid, &cont_child);
 	if (rc == -DER_NONEXIST || rc == -DER_SHUTDOWN) {
 		D_DEBUG(DB_REBUILD, DF_UUID" already destroyed or destroying\n",
-			DP_UUID(arg->co_uuid));
+			DP_UUID(co_uuid));
 		rc = 0;
 		D_GOTO(close, rc);
 	}
 
 	if (rc != 0) {
 		D_ERROR("Container "DF_UUID", ds_cont_child_lookup failed: "DF_RC"\n",
-			DP_UUID(entry->ie_couuid), DP_RC(rc));
+			DP_UUID(co_uuid), DP_RC(rc));
 		D_GOTO(close, rc);
 	}
 
@@ -852,18 +977,18 @@ rebuild_container_scan_cb(daos_handle_t ih, vos_iter_entry_t *entry,
 
 	cont_child->sc_rebuilding = 1;
 
-	rc = ds_cont_fetch_snaps(rpt->rt_pool->sp_iv_ns, entry->ie_couuid, NULL,
+	rc = ds_cont_fetch_snaps(rpt->rt_pool->sp_iv_ns, co_uuid, NULL,
 				 &snapshot_cnt);
 	if (rc) {
 		D_ERROR("Container "DF_UUID", ds_cont_fetch_snaps failed: "DF_RC"\n",
-			DP_UUID(entry->ie_couuid), DP_RC(rc));
+			DP_UUID(co_uuid), DP_RC(rc));
 		D_GOTO(close, rc);
 	}
 
-	rc = ds_cont_get_props(&arg->co_props, rpt->rt_pool->sp_uuid, entry->ie_couuid);
+	rc = ds_cont_get_props(&arg->co_props, rpt->rt_pool->sp_uuid, co_uuid);
 	if (rc) {
 		D_ERROR("Container "DF_UUID", ds_cont_get_props failed: "DF_RC"\n",
-			DP_UUID(entry->ie_couuid), DP_RC(rc));
+			DP_UUID(co_uuid), DP_RC(rc));
 		D_GOTO(close, rc);
 	}
 
@@ -874,15 +999,14 @@ rebuild_container_scan_cb(daos_handle_t ih, vos_iter_entry_t *entry,
 		D_ASSERTF(rpt->rt_pool->sp_rebuilding >= 0, DF_UUID" rebuilding %d\n",
 			  DP_UUID(rpt->rt_pool_uuid), rpt->rt_pool->sp_rebuilding);
 			/* Wait for EC aggregation to abort before discard the object */
-		D_INFO(DF_UUID" wait for ec agg abort.\n", DP_UUID(entry->ie_couuid));
+		D_INFO(DF_UUID" wait for ec agg abort.\n", DP_UUID(co_uuid));
 		dss_sleep(1000);
 		if (rpt->rt_abort || rpt->rt_finishing) {
 			D_DEBUG(DB_REBUILD, DF_CONT" rebuild op %s ver %u abort %u/%u.\n",
-				DP_CONT(rpt->rt_pool_uuid, entry->ie_couuid),
+				DP_CONT(rpt->rt_pool_uuid, co_uuid),
 				RB_OP_STR(rpt->rt_rebuild_op), rpt->rt_rebuild_ver,
 				rpt->rt_abort, rpt->rt_finishing);
-			*acts |= VOS_ITER_CB_ABORT;
-			D_GOTO(close, rc);
+			D_GOTO(close, rc = 1);
 		}
 	}
 
@@ -895,7 +1019,7 @@ rebuild_container_scan_cb(daos_handle_t ih, vos_iter_entry_t *entry,
 	param.ip_epr.epr_lo = 0;
 	param.ip_epr.epr_hi = DAOS_EPOCH_MAX;
 	param.ip_flags = VOS_IT_FOR_MIGRATION;
-	uuid_copy(arg->co_uuid, entry->ie_couuid);
+	uuid_copy(arg->co_uuid, co_uuid);
 	arg->snapshot_cnt = snapshot_cnt;
 	arg->cont_child = cont_child;
 
@@ -908,6 +1032,12 @@ rebuild_container_scan_cb(daos_handle_t ih, vos_iter_entry_t *entry,
 
 	rc = vos_iterate(&param, VOS_ITER_OBJ, false, &anchor,
 			 rebuild_obj_scan_cb, NULL, arg, dth);
+	if (rc == 0)
+		rc = rebuild_scan_batch_flush(arg);
+	else if (arg->batch != NULL)
+		arg->batch->rsb_nr = 0;
+	/* The final flush runs outside of the iteration, there is nothing to revalidate */
+	arg->insert_waited = false;
 	dtx_end(dth, NULL, rc);
 
 close:
@@ -920,12 +1050,49 @@ close:
 	}
 
 	D_DEBUG(DB_REBUILD, DF_UUID"/"DF_UUID" iterate cont done: "DF_RC"\n",
-		DP_UUID(rpt->rt_pool_uuid), DP_UUID(entry->ie_couuid),
+		DP_UUID(rpt->rt_pool_uuid), DP_UUID(co_uuid),
 		DP_RC(rc));
 
 	return rc;
 }
 
+static int
+rebuild_cont_collect_cb(daos_handle_t ih, vos_iter_entry_t *entry, vos_iter_type_t type,
+			vos_iter_param_t *iter_param, void *data, unsigned *acts)
+{
+	struct rebuild_scan_conts	*conts = data;
+	uuid_t				*uuids;
+	int				 cap;
+
+	if (conts->rsc_nr == conts->rsc_cap) {
+		cap = max(conts->rsc_cap * 2, 16);
+		D_REALLOC_ARRAY(uuids, conts->rsc_uuids, conts->rsc_cap, cap);
+		if (uuids == NULL)
+			return -DER_NOMEM;
+		conts->rsc_uuids = uuids;
+		conts->rsc_cap = cap;
+	}
+
+	uuid_copy(conts->rsc_uuids[conts->rsc_nr++], entry->ie_couuid);
+	return 0;
+}
+
+/* Scanner ULT, keep picking the next unscanned container of the target */
+static void
+rebuild_cont_scan_ult(void *data)
+{
+	struct rebuild_scan_arg		*arg = data;
+	struct rebuild_scan_conts	*conts = arg->conts;
+	int				 rc;
+
+	while (conts->rsc_status == 0 && conts->rsc_next < conts->rsc_nr) {
+		rc = rebuild_container_scan(arg, conts->rsc_poh,
+					    conts->rsc_uuids[conts->rsc_next++]);
+		if (rc != 0 && conts->rsc_status == 0)
+			conts->rsc_status = rc;
+	}
+}
+
 bool
 is_rebuild_scanning_tgt(struct rebuild_tgt_pool_tracker *rpt)
 {
@@ -961,7 +1128,9 @@ is_rebuild_scanning_tgt(struct rebuild_tgt_pool_tracker *rpt)
 int
 rebuild_scanner(void *data)
 {
-	struct rebuild_scan_arg		arg = { 0 };
+	struct rebuild_scan_conts	conts = { 0 };
+	struct rebuild_scan_arg		*args = NULL;
+	ABT_thread			*ults = NULL;
 	struct rebuild_tgt_pool_tracker *rpt = data;
 	struct ds_pool_child		*child;
 	struct rebuild_pool_tls		*tls;
@@ -969,6 +1138,10 @@ rebuild_scanner(void *data)
 	struct vos_iter_anchors		anchor = { 0 };
 	ABT_thread			ult_send = ABT_THREAD_NULL;
 	struct umem_attr		uma;
+	uint64_t			start;
+	uint64_t			elapsed;
+	int				ult_nr = 0;
+	int				i;
 	int				rc = 0;
 
 	tls = rebuild_pool_tls_lookup(rpt->rt_pool_uuid, rpt->rt_rebuild_ver,
@@ -1015,19 +1188,75 @@ rebuild_scanner(void *data)
 	if (child == NULL)
 		D_GOTO(out, rc = -DER_NONEXIST);
 
+	conts.rsc_poh = child->spc_hdl;
+	conts.rsc_tls = tls;
+	conts.rsc_metrics = child->spc_metrics[DAOS_REBUILD_MODULE];
 	param.ip_hdl = child->spc_hdl;
 	param.ip_flags = VOS_IT_FOR_MIGRATION;
-	arg.rpt = rpt;
-	arg.yield_freq = SCAN_YIELD_FREQ;
-	arg.obj_yield_cnt = SCAN_OBJ_YIELD_CNT;
 	rc = vos_iterate(&param, VOS_ITER_COUUID, false, &anchor,
-			 rebuild_container_scan_cb, NULL, &arg, NULL);
-	if (rc < 0)
+			 rebuild_cont_collect_cb, NULL, &conts, NULL);
+	if (rc < 0 || conts.rsc_nr == 0)
 		D_GOTO(put, rc);
-	rc = 0; /* rc might be 1 if rebuild is aborted */
+
+	/* Scan the containers with several ULTs to overlap the VOS iteration and placement */
+	ult_nr = min(rebuild_gst.rg_scan_ults, conts.rsc_nr);
+	D_ALLOC_ARRAY(args, ult_nr);
+	D_ALLOC_ARRAY(ults, ult_nr);
+	if (args == NULL || ults == NULL)
+		D_GOTO(put, rc = -DER_NOMEM);
+
+	for (i = 0; i < ult_nr; i++) {
+		args[i].rpt = rpt;
+		args[i].conts = &conts;
+		args[i].yield_freq = SCAN_YIELD_FREQ;
+		args[i].obj_yield_cnt = SCAN_OBJ_YIELD_CNT;
+		if (rpt->rt_rebuild_op == RB_OP_REBUILD) {
+			rc = rebuild_scan_batch_alloc(&args[i].batch);
+			if (rc != 0)
+				D_GOTO(put, rc);
+		}
+		ults[i] = ABT_THREAD_NULL;
+	}
+
+	start = d_timeus_secdiff(0);
+	/* The current ULT works as the first scanner */
+	for (i = 1; i < ult_nr; i++) {
+		rc = dss_ult_create(rebuild_cont_scan_ult, &args[i], DSS_XS_SELF, 0,
+				    DSS_DEEP_STACK_SZ, &ults[i]);
+		if (rc != 0) {
+			DL_WARN(rc, DF_UUID " create scanner ULT %d", DP_UUID(rpt->rt_pool_uuid),
+				i);
+			rc = 0;
+			break;
+		}
+	}
+	rebuild_cont_scan_ult(&args[0]);
+	for (i = 1; i < ult_nr; i++) {
+		if (ults[i] != ABT_THREAD_NULL)
+			ABT_thread_free(&ults[i]);
+	}
+
+	elapsed = max(d_timeus_secdiff(0) - start, 1);
+	if (conts.rsc_metrics != NULL)
+		d_tm_set_gauge(conts.rsc_metrics->rpm_scan_rate,
+			       tls->rebuild_pool_scanned * 1000000 / elapsed);
+	D_DEBUG(DB_REBUILD, DF_UUID" scanned "DF_U64" objects of %d containers in "DF_U64
+		" us with %d ULTs\n", DP_UUID(rpt->rt_pool_uuid), tls->rebuild_pool_scanned,
+		conts.rsc_nr, elapsed, ult_nr);
+
+	rc = conts.rsc_status;
+	if (rc > 0)
+		rc = 0; /* rc might be 1 if rebuild is aborted */
 put:
 	ds_pool_child_put(child);
 out:
+	for (i = 0; args != NULL && i < ult_nr; i++) {
+		if (args[i].batch != NULL)
+			rebuild_scan_batch_free(args[i].batch);
+	}
+	D_FREE(args);
+	D_FREE(ults);
+	D_FREE(conts.rsc_uuids);
 	tls->rebuild_pool_scan_done = 1;
 	if (ult_send != ABT_THREAD_NULL)
 		ABT_thread_free(&ult_send);
@@ -12,6 +12,7 @@
 
 #include <daos/rpc.h>
 #include <daos/pool.h>
+#include <daos/metrics.h>
 #include <daos_srv/daos_engine.h>
 #include <daos_srv/pool.h>
 #include <daos_srv/container.h>
@@ -2629,11 +2630,79 @@ struct dss_module_key rebuild_module_key = {
 	.dmk_fini = rebuild_tls_fini,
 };
 
+static void *
+rebuild_metrics_alloc(const char *path, int tgt_id)
+{
+	struct rebuild_pool_metrics	*metrics;
+	int				 rc;
+
+	D_ASSERT(tgt_id >= 0);
+
+	D_ALLOC_PTR(metrics);
+	if (metrics == NULL)
+		return NULL;
+
+	rc = d_tm_add_metric(&metrics->rpm_scanned_objs, D_TM_COUNTER,
+			     "total objects scanned by rebuild", "objs",
+			     "%s/rebuild/scanned_objs/tgt_%u", path, tgt_id);
+	if (rc != DER_SUCCESS)
+		D_WARN("Failed to create rebuild scanned objs metric: "DF_RC"\n", DP_RC(rc));
+
+	rc = d_tm_add_metric(&metrics->rpm_scan_rate, D_TM_GAUGE,
+			     "objects scanned per second by the last rebuild scan", "objs/s",
+			     "%s/rebuild/scan_rate/tgt_%u", path, tgt_id);
+	if (rc != DER_SUCCESS)
+		D_WARN("Failed to create rebuild scan rate metric: "DF_RC"\n", DP_RC(rc));
+
+	rc = d_tm_add_metric(&metrics->rpm_inflight_objs, D_TM_GAUGE,
+			     "objects found by rebuild scan and not sent yet", "objs",
+			     "%s/rebuild/inflight_objs/tgt_%u", path, tgt_id);
+	if (rc != DER_SUCCESS)
+		D_WARN("Failed to create rebuild inflight objs metric: "DF_RC"\n", DP_RC(rc));
+
+	return metrics;
+}
+
+static void
+rebuild_metrics_free(void *data)
+{
+	D_FREE(data);
+}
+
+static int
+rebuild_metrics_count(void)
+{
+	return (sizeof(struct rebuild_pool_metrics) / sizeof(struct d_tm_node_t *));
+}
+
+struct daos_module_metrics rebuild_metrics = {
+    .dmm_tags       = DAOS_TGT_TAG,
+    .dmm_init       = rebuild_metrics_alloc,
+    .dmm_fini       = rebuild_metrics_free,
+    .dmm_nr_metrics = rebuild_metrics_count,
+};
+
 static int
 init(void)
 {
 	int rc;
 
+	rebuild_gst.rg_scan_ults = SCAN_ULTS_DEF;
+	d_getenv_uint("DAOS_REBUILD_SCAN_ULTS", &rebuild_gst.rg_scan_ults);
+	if (rebuild_gst.rg_scan_ults == 0 || rebuild_gst.rg_scan_ults > SCAN_ULTS_MAX) {
+		D_WARN("Invalid rebuild scan ULTs %u, the valid range is [1, %u], "
+		       "use the default value %u\n", rebuild_gst.rg_scan_ults, SCAN_ULTS_MAX,
+		       SCAN_ULTS_DEF);
+		rebuild_gst.rg_scan_ults = SCAN_ULTS_DEF;
+	}
+
+	rebuild_gst.rg_scan_inflight_max = SCAN_INFLIGHT_DEF;
+	d_getenv_uint("DAOS_REBUILD_SCAN_INFLIGHT", &rebuild_gst.rg_scan_inflight_max);
+	if (rebuild_gst.rg_scan_inflight_max == 0)
+		rebuild_gst.rg_scan_inflight_max = SCAN_INFLIGHT_DEF;
+	D_INFO("Rebuild scan ULTs %u, max inflight objects %u per target\n",
+	       rebuild_gst.rg_scan_ults, rebuild_gst.rg_scan_inflight_max);
+
 	D_INIT_LIST_HEAD(&rebuild_gst.rg_tgt_tracker_list);
 	D_INIT_LIST_HEAD(&rebuild_gst.rg_global_tracker_list);
 	D_INIT_LIST_HEAD(&rebuild_gst.rg_completed_list);
@@ -2687,4 +2756,5 @@ struct dss_module rebuild_module = {
     .sm_cli_count   = {0},
     .sm_handlers    = {rebuild_handlers},
     .sm_key         = &rebuild_module_key,
+    .sm_metrics     = &rebuild_metrics,
 };
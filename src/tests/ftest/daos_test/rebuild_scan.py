@@ -0,0 +1,34 @@
+'''
+  (C) Copyright 2024 Intel Corporation.
+
+  SPDX-License-Identifier: BSD-2-Clause-Patent
+'''
+
+from daos_core_base import DaosCoreBase
+
+
+class DaosCoreTestRebuildScan(DaosCoreBase):
+    """Run the daos_test rebuild tests with more scanner ULTs per target and
+    a minimal in-flight object limit.
+
+    :avocado: recursive
+    """
+
+    def test_rebuild_scan_credits(self):
+        """Jira ID: DAOS-2770
+
+        Test Description:
+            Run daos_test -r -s3 -u subtests=0-10 with DAOS_REBUILD_SCAN_ULTS=8 and
+            DAOS_REBUILD_SCAN_INFLIGHT=1, so that the scanner ULTs of a target share
+            the containers and every object insert waits for the send ULT.
+
+        Use cases:
+            Rebuild scan with multiple ULTs and credit based flow control
+
+        :avocado: tags=all,full_regression
+        :avocado: tags=hw,medium
+        :avocado: tags=unittest,rebuild
+        :avocado: tags=DaosCoreTestRebuildScan,daos_test,daos_core_test_rebuild
+        :avocado: tags=test_rebuild_scan_credits
+        """
+        self.run_subtest()
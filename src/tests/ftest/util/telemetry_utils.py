@@ -84,6 +84,7 @@ class TelemetryUtils():
         ENGINE_POOL_OPS_DKEY_PUNCH_METRICS,
         "engine_pool_ops_compound",
         "engine_pool_ops_dtx_abort",
+        "engine_pool_ops_dtx_batch_commit",
         "engine_pool_ops_dtx_check",
         "engine_pool_ops_dtx_coll_abort",
         "engine_pool_ops_dtx_coll_check",
@@ -110,6 +111,10 @@ class TelemetryUtils():
         "engine_pool_ops_pool_evict",
         "engine_pool_ops_pool_query",
         "engine_pool_ops_pool_query_space"]
+    ENGINE_POOL_REBUILD_METRICS = [
+        "engine_pool_rebuild_scanned_objs",
+        "engine_pool_rebuild_scan_rate",
+        "engine_pool_rebuild_inflight_objs"]
     ENGINE_POOL_SCRUBBER_METRICS = [
         "engine_pool_scrubber_busy_time",
         "engine_pool_scrubber_bytes_scrubbed_current",
@@ -149,7 +154,8 @@ class TelemetryUtils():
         *_gen_stats_metrics("engine_pool_vos_wal_wal_sz"),
         *_gen_stats_metrics("engine_pool_vos_wal_wal_qd"),
         *_gen_stats_metrics("engine_pool_vos_wal_wal_waiters"),
-        *_gen_stats_metrics("engine_pool_vos_wal_wal_dur")]
+        *_gen_stats_metrics("engine_pool_vos_wal_wal_dur"),
+        *_gen_stats_metrics("engine_pool_vos_wal_wal_batch")]
     ENGINE_POOL_VOS_WAL_REPLAY_METRICS = [
         "engine_pool_vos_wal_replay_count",
         "engine_pool_vos_wal_replay_entries",
@@ -171,6 +177,7 @@ class TelemetryUtils():
         ENGINE_POOL_EC_UPDATE_METRICS +\
         ENGINE_POOL_ENTRIES_METRICS +\
         ENGINE_POOL_OPS_METRICS +\
+        ENGINE_POOL_REBUILD_METRICS +\
         ENGINE_POOL_SCRUBBER_METRICS +\
         ENGINE_POOL_VOS_AGGREGATION_METRICS +\
         ENGINE_POOL_VOS_SPACE_METRICS + \
@@ -304,6 +311,19 @@ class TelemetryUtils():
         _gen_stats_metrics("engine_io_ops_tgt_update_active")
     ENGINE_IO_OPS_UPDATE_ACTIVE_METRICS = \
         _gen_stats_metrics("engine_io_ops_update_active")
+    ENGINE_IO_VOS_OBJ_CACHE_METRICS = [
+        "engine_io_vos_obj_cache_front_hit",
+        "engine_io_vos_obj_cache_front_miss",
+        "engine_io_vos_obj_cache_front_evict"]
+    ENGINE_IO_VOS_TS_METRICS = [
+        "engine_io_vos_ts_container_false_conflict",
+        "engine_io_vos_ts_container_entries",
+        "engine_io_vos_ts_object_false_conflict",
+        "engine_io_vos_ts_object_entries",
+        "engine_io_vos_ts_dkey_false_conflict",
+        "engine_io_vos_ts_dkey_entries",
+        "engine_io_vos_ts_akey_false_conflict",
+        "engine_io_vos_ts_akey_entries"]
     ENGINE_IO_METRICS = ENGINE_IO_DTX_COMMITTABLE_METRICS +\
         ENGINE_IO_DTX_COMMITTED_METRICS +\
         ENGINE_IO_LATENCY_FETCH_METRICS +\
@@ -355,7 +375,9 @@ class TelemetryUtils():
         ENGINE_IO_OPS_TGT_PUNCH_ACTIVE_METRICS +\
         ENGINE_IO_OPS_TGT_PUNCH_LATENCY_METRICS +\
         ENGINE_IO_OPS_TGT_UPDATE_ACTIVE_METRICS +\
-        ENGINE_IO_OPS_UPDATE_ACTIVE_METRICS
+        ENGINE_IO_OPS_UPDATE_ACTIVE_METRICS +\
+        ENGINE_IO_VOS_OBJ_CACHE_METRICS +\
+        ENGINE_IO_VOS_TS_METRICS
     ENGINE_NET_METRICS = [
         "engine_net_glitch",
         "engine_net_failed_addr",
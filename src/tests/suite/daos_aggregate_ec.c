@@ -999,6 +999,164 @@ re_test:
 	cleanup_ec_agg_tests(&ctx);
 }
 
+/**
+ * Overwrite parts of an aggregated 4+1 stripe with extents that leave holes
+ * inside the cells, and with one extent that crosses a cell boundary, so that
+ * aggregation updates the parity with the delta of the replicated spans.
+ * Cell 0 is left untouched so the delta of each cell has to be applied to the
+ * right cell index. The parity is then compared with the one of the full
+ * stripe re-encoded on the client.
+ */
+static void
+partial_span_delta_parity(void **statep)
+{
+	test_arg_t		*arg = *statep;
+	struct ec_agg_test_ctx	 ctx = { 0 };
+	struct daos_oclass_attr	*oca;
+	struct obj_ec_codec	*codec;
+	tse_task_t		*task = NULL;
+	unsigned char		*data[OBJ_EC_MAX_K];
+	unsigned char		*parity[OBJ_EC_MAX_P];
+	daos_recx_t		 exts[4];
+	daos_recx_t		 iom_recx;
+	daos_iom_t		 iom;
+	d_iov_t			 dkey;
+	d_sg_list_t		 sgl;
+	d_iov_t			 sg_iov;
+	daos_iod_t		 iod;
+	daos_recx_t		 recx;
+	char			*stripe;
+	char			*wbuf;
+	char			*rbuf;
+	uint32_t		 p_shard;
+	uint32_t		 cs, ss, k, p;
+	int			 i, rc;
+
+	if (!test_runable(arg, 5))
+		skip();
+
+	FAULT_INJECTION_REQUIRED();
+
+	daos_pool_set_prop(arg->pool.pool_uuid, "reclaim", "time");
+	setup_ec_agg_tests(statep, &ctx);
+	ec_setup_cont_obj(&ctx, OC_EC_4P1G1);
+	assert_int_equal(oid_is_ec(ctx.oid, &oca), true);
+	k = oca->u.ec.e_k;
+	p = oca->u.ec.e_p;
+	cs = TEST_EC_CELL_SZ;
+	ss = cs * k;
+
+	/* holes before, between and after the extents of cell 1, an extent
+	 * across the boundary of cells 1 and 2, and a short one in cell 3.
+	 */
+	exts[0].rx_idx = cs + 16;
+	exts[0].rx_nr = 48;
+	exts[1].rx_idx = cs + cs / 2;
+	exts[1].rx_nr = 64;
+	exts[2].rx_idx = 2 * cs - 100;
+	exts[2].rx_nr = 200;
+	exts[3].rx_idx = 3 * cs + cs / 4;
+	exts[3].rx_nr = 128;
+
+	D_ALLOC(stripe, ss);
+	assert_non_null(stripe);
+	D_ALLOC(wbuf, ss);
+	assert_non_null(wbuf);
+	D_ALLOC(rbuf, cs);
+	assert_non_null(rbuf);
+	for (i = 0; i < p; i++) {
+		D_ALLOC(parity[i], cs);
+		assert_non_null(parity[i]);
+	}
+
+	d_iov_set(&dkey, "dkey", strlen("dkey"));
+	d_iov_set(&iod.iod_name, "akey", strlen("akey"));
+	sgl.sg_nr = 1;
+	sgl.sg_nr_out = 0;
+	sgl.sg_iovs = &sg_iov;
+	iod.iod_nr = 1;
+	iod.iod_size = 1;
+	iod.iod_recxs = &recx;
+	iod.iod_type = DAOS_IOD_ARRAY;
+
+	/* full stripe, written with its parity */
+	dts_buf_render(stripe, ss);
+	d_iov_set(&sg_iov, stripe, ss);
+	recx.rx_idx = 0;
+	recx.rx_nr = ss;
+	rc = daos_obj_update(ctx.oh, DAOS_TX_NONE, 0, &dkey, 1, &iod, &sgl,
+			     NULL);
+	assert_rc_equal(rc, 0);
+
+	/* partial overwrites, replicated to the parity target */
+	for (i = 0; i < ARRAY_SIZE(exts); i++) {
+		dts_buf_render(wbuf, exts[i].rx_nr);
+		memcpy(&stripe[exts[i].rx_idx], wbuf, exts[i].rx_nr);
+		d_iov_set(&sg_iov, wbuf, exts[i].rx_nr);
+		recx = exts[i];
+		rc = daos_obj_update(ctx.oh, DAOS_TX_NONE, 0, &dkey, 1, &iod,
+				     &sgl, NULL);
+		assert_rc_equal(rc, 0);
+	}
+
+	daos_debug_set_params(arg->group, -1, DMG_KEY_FAIL_LOC,
+			      DAOS_FORCE_EC_AGG | DAOS_FAIL_ALWAYS, 0, NULL);
+	print_message("sleep 30 seconds for aggregation ...\n");
+	sleep(30);
+
+	for (i = 0; i < k; i++)
+		data[i] = (unsigned char *)&stripe[i * cs];
+	codec = obj_ec_codec_get(daos_obj_id2class(ctx.oid));
+	assert_non_null(codec);
+	ec_encode_data(cs, k, p, codec->ec_gftbls, data, parity);
+
+	p_shard = test_ec_get_parity_off(&dkey, oca);
+	memset(&iom, 0, sizeof(iom));
+	iom.iom_flags = DAOS_IOMF_DETAIL;
+	iom.iom_recxs = &iom_recx;
+	iom.iom_nr = 1;
+
+	/* the replicas were aggregated into the parity */
+	d_iov_set(&sg_iov, wbuf, ss);
+	recx.rx_idx = 0;
+	recx.rx_nr = ss;
+	rc = dc_obj_fetch_task_create(ctx.oh, DAOS_TX_NONE, 0, &dkey, 1,
+				      DIOF_TO_SPEC_SHARD, &iod, &sgl, &iom,
+				      &p_shard, NULL, NULL, NULL, &task);
+	assert_rc_equal(rc, 0);
+	rc = dc_task_schedule(task, true);
+	assert_rc_equal(rc, 0);
+	assert_int_equal(iom.iom_nr_out, 0);
+
+	/* and the parity is the one of the whole new stripe */
+	task = NULL;
+	memset(&iom, 0, sizeof(iom));
+	iom.iom_flags = DAOS_IOMF_DETAIL;
+	iom.iom_recxs = &iom_recx;
+	iom.iom_nr = 1;
+	d_iov_set(&sg_iov, rbuf, cs);
+	recx.rx_idx = 0 | PARITY_INDICATOR;
+	recx.rx_nr = cs;
+	rc = dc_obj_fetch_task_create(ctx.oh, DAOS_TX_NONE, 0, &dkey, 1,
+				      DIOF_TO_SPEC_SHARD, &iod, &sgl, &iom,
+				      &p_shard, NULL, NULL, NULL, &task);
+	assert_rc_equal(rc, 0);
+	rc = dc_task_schedule(task, true);
+	assert_rc_equal(rc, 0);
+	assert_int_equal(iom.iom_nr_out, 1);
+	assert_memory_equal(rbuf, parity[0], cs);
+
+	daos_debug_set_params(arg->group, -1, DMG_KEY_FAIL_LOC, 0, 0, NULL);
+	for (i = 0; i < p; i++)
+		D_FREE(parity[i]);
+	D_FREE(rbuf);
+	D_FREE(wbuf);
+	D_FREE(stripe);
+	rc = daos_obj_close(ctx.oh, NULL);
+	assert_rc_equal(rc, 0);
+	cleanup_ec_agg_tests(&ctx);
+}
+
 #define NUM_SERVERS 5
 static int
 ec_setup(void **statep)
@@ -1012,6 +1170,8 @@ static const struct CMUnitTest ec_agg_tests[] = {
 	  incremental_fill, test_case_teardown},
 	{"DAOS_ECAG01: test fetch snapshot lower than vos agg boundary",
 	  fetch_snap_with_agg, async_disable, test_case_teardown},
+	{"DAOS_ECAG02: test delta parity of partially replicated cells",
+	  partial_span_delta_parity, async_disable, test_case_teardown},
 };
 
 int run_daos_aggregation_ec_test(int rank, int size, int *sub_tests,
@@ -86,6 +86,8 @@ struct evt_context {
 	uint32_t                         tc_creds    : 30;
 	/** credits is enabled */
 	uint32_t                         tc_creds_on : 1;
+	/** result of the last evt_find() can't be cached, see struct evt_vis_slot */
+	uint32_t                         tc_vis_uncached : 1;
 	/** cached number of bytes per entry */
 	uint32_t			 tc_inob;
 	/** cached tree feature bits (reduce PMEM access) */
@@ -151,10 +153,16 @@ int
 evt_desc_log_status(struct evt_context *tcx, daos_epoch_t epoch,
 		    struct evt_desc *desc, int intent);
 
+void
+evt_vis_cache_evict(struct evt_root *root);
+
 /** Helper function for starting a PMDK transaction, if applicable */
 static inline int
 evt_tx_begin(struct evt_context *tcx)
 {
+	/* Any modification of the tree invalidates the cached visible extents */
+	evt_vis_cache_evict(tcx->tc_root);
+
 	if (!evt_has_tx(tcx))
 		return 0;
 
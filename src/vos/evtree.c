@@ -2629,6 +2629,11 @@ evt_ent_array_fill(struct evt_context *tcx, enum evt_find_opc find_opc,
 			if (evt_filter_rect(filter, &rtmp, leaf)) {
 				V_TRACE(DB_TRACE, "Filtered "DF_RECT" filter=("
 					DF_FILTER")\n", DP_RECT(&rtmp), DP_FILTER(filter));
+				/* Newer extents in range, see struct evt_vis_slot */
+				if (rtmp.rc_epc > filter->fr_epoch &&
+				    rtmp.rc_ex.ex_lo <= filter->fr_ex.ex_hi &&
+				    rtmp.rc_ex.ex_hi >= filter->fr_ex.ex_lo)
+					tcx->tc_vis_uncached = 1;
 				if (find_opc == EVT_FIND_OVERWRITE && !has_agg) {
 					if (agg_check(&filter->fr_ex, &rtmp.rc_ex))
 						has_agg = true;
@@ -2664,8 +2669,11 @@ evt_ent_array_fill(struct evt_context *tcx, enum evt_find_opc find_opc,
 			switch (time_overlap) {
 			default:
 				D_ASSERT(0);
-			case RT_OVERLAP_NO:
 			case RT_OVERLAP_UNDER:
+				/* Newer extents in range, see struct evt_vis_slot */
+				tcx->tc_vis_uncached = 1;
+				/* fall through */
+			case RT_OVERLAP_NO:
 				continue; /* skip, no overlap */
 			case RT_OVERLAP_OVER:
 			case RT_OVERLAP_SAME:
@@ -2683,6 +2691,8 @@ evt_ent_array_fill(struct evt_context *tcx, enum evt_find_opc find_opc,
 				"\n", DP_RECT(&rtmp));
 
 			desc = evt_node_desc_at(tcx, node, i);
+			if (desc->dc_dtx != DTX_LID_COMMITTED)
+				tcx->tc_vis_uncached = 1;
 			rc = evt_desc_log_status(tcx, rtmp.rc_epc, desc,
 						 intent);
 			/* Skip the unavailable record. */
@@ -2833,6 +2843,152 @@ struct evt_max_rect {
 	bool			mr_punched;
 };
 
+/** Number of slots of the per-xstream visible extent cache, must be power of 2 */
+#define EVT_VIS_CACHE_SLOTS	256
+/** Results with more visible extents than this are not cached */
+#define EVT_VIS_CACHE_ENT_MAX	64
+
+bool evt_vis_cache_enabled = true;
+
+/**
+ * Visible extents returned by the last evt_find() against a tree. It's only kept
+ * when all the extents in the searched range are committed and none of them is
+ * newer than the read epoch, so the same result applies to any later read of the
+ * range until the tree is modified, see evt_tx_begin().
+ */
+struct evt_vis_slot {
+	/** the tree the result belongs to, NULL for an empty slot */
+	struct evt_root		*vs_root;
+	/** the searched range */
+	struct evt_extent	 vs_ex;
+	/** low bound of the read epoch range */
+	daos_epoch_t		 vs_epoch_lo;
+	/** highest epoch of extents in the range, the result applies to reads above it */
+	daos_epoch_t		 vs_epoch_hi;
+	/** punch epoch of the parent key */
+	daos_epoch_t		 vs_punch_epc;
+	uint16_t		 vs_punch_minor_epc;
+	/** number of cached entries */
+	uint32_t		 vs_ent_nr;
+	/** allocated size of vs_ents */
+	uint32_t		 vs_ent_size;
+	struct evt_entry	*vs_ents;
+};
+
+/** Visible extent cache of the xstream, allocated on first use */
+static __thread struct evt_vis_slot	*evt_vis_cache;
+
+static struct evt_vis_slot *
+evt_vis_cache_slot(struct evt_root *root)
+{
+	uint64_t	hash;
+
+	hash = d_hash_murmur64((unsigned char *)&root, sizeof(root), 0);
+	return &evt_vis_cache[hash & (EVT_VIS_CACHE_SLOTS - 1)];
+}
+
+void
+evt_vis_cache_evict(struct evt_root *root)
+{
+	struct evt_vis_slot	*slot;
+
+	if (evt_vis_cache == NULL || root == NULL)
+		return;
+
+	slot = evt_vis_cache_slot(root);
+	if (slot->vs_root == root)
+		slot->vs_root = NULL;
+}
+
+void
+evt_vis_cache_fini(void)
+{
+	int	i;
+
+	if (evt_vis_cache == NULL)
+		return;
+
+	for (i = 0; i < EVT_VIS_CACHE_SLOTS; i++)
+		D_FREE(evt_vis_cache[i].vs_ents);
+	D_FREE(evt_vis_cache);
+}
+
+/** Fill \a ent_array from the cache, returns 1 on cache hit, 0 on miss */
+static int
+evt_vis_cache_lookup(struct evt_context *tcx, const struct evt_filter *filter,
+		     struct evt_entry_array *ent_array)
+{
+	struct evt_vis_slot	*slot;
+	struct evt_entry	*ent;
+	uint32_t		 i;
+	int			 rc;
+
+	if (evt_vis_cache == NULL)
+		return 0;
+
+	slot = evt_vis_cache_slot(tcx->tc_root);
+	if (slot->vs_root != tcx->tc_root || filter->fr_epoch < slot->vs_epoch_hi ||
+	    !evt_same_extent(&slot->vs_ex, &filter->fr_ex) ||
+	    slot->vs_epoch_lo != filter->fr_epr.epr_lo ||
+	    slot->vs_punch_epc != filter->fr_punch_epc ||
+	    slot->vs_punch_minor_epc != filter->fr_punch_minor_epc)
+		return 0;
+
+	ent_array->ea_inob = tcx->tc_inob;
+	for (i = 0; i < slot->vs_ent_nr; i++) {
+		rc = ent_array_alloc(tcx, ent_array, &ent, false);
+		if (rc != 0) {
+			ent_array->ea_ent_nr = 0;
+			return rc;
+		}
+		*ent = slot->vs_ents[i];
+	}
+
+	D_DEBUG(DB_TRACE, "Found %u visible extents in cache, filter "DF_FILTER"\n",
+		slot->vs_ent_nr, DP_FILTER(filter));
+	return 1;
+}
+
+static void
+evt_vis_cache_insert(struct evt_context *tcx, const struct evt_filter *filter,
+		     struct evt_entry_array *ent_array, daos_epoch_t epoch_hi)
+{
+	struct evt_vis_slot	*slot;
+	struct evt_entry	*ents;
+	uint32_t		 i;
+
+	if (!evt_vis_cache_enabled || tcx->tc_vis_uncached || tcx->tc_root->tr_depth == 0 ||
+	    ent_array->ea_ent_nr > EVT_VIS_CACHE_ENT_MAX)
+		return;
+
+	if (evt_vis_cache == NULL) {
+		D_ALLOC_ARRAY(evt_vis_cache, EVT_VIS_CACHE_SLOTS);
+		if (evt_vis_cache == NULL)
+			return;
+	}
+
+	slot = evt_vis_cache_slot(tcx->tc_root);
+	slot->vs_root = NULL;
+	if (ent_array->ea_ent_nr > slot->vs_ent_size) {
+		D_REALLOC_ARRAY(ents, slot->vs_ents, slot->vs_ent_size, ent_array->ea_ent_nr);
+		if (ents == NULL)
+			return;
+		slot->vs_ents = ents;
+		slot->vs_ent_size = ent_array->ea_ent_nr;
+	}
+
+	for (i = 0; i < ent_array->ea_ent_nr; i++)
+		slot->vs_ents[i] = *evt_ent_array_get(ent_array, i);
+
+	slot->vs_ent_nr = ent_array->ea_ent_nr;
+	slot->vs_ex = filter->fr_ex;
+	slot->vs_epoch_lo = filter->fr_epr.epr_lo;
+	slot->vs_epoch_hi = epoch_hi;
+	slot->vs_punch_epc = filter->fr_punch_epc;
+	slot->vs_punch_minor_epc = filter->fr_punch_minor_epc;
+	slot->vs_root = tcx->tc_root;
+}
+
 /**
  * Find all versioned extents intercepting with the input rectangle \a rect
  * and return their data pointers.
@@ -2844,7 +3000,9 @@ evt_find(daos_handle_t toh, const struct evt_filter *filter,
 	 struct evt_entry_array *ent_array)
 {
 	struct evt_context	*tcx;
+	struct evt_entry	*ent;
 	struct evt_rect		 rect;
+	daos_epoch_t		 epoch_hi = 0;
 	int			 rc;
 
 	D_ASSERT(filter != NULL);
@@ -2854,15 +3012,26 @@ evt_find(daos_handle_t toh, const struct evt_filter *filter,
 	if (tcx == NULL)
 		return -DER_NO_HDL;
 
+	rc = evt_vis_cache_lookup(tcx, filter, ent_array);
+	if (rc != 0)
+		return rc < 0 ? rc : 0;
+
 	rect.rc_ex = filter->fr_ex;
 	rect.rc_epc = filter->fr_epoch;
 	rect.rc_minor_epc = EVT_MINOR_EPC_MAX;
 
+	tcx->tc_vis_uncached = 0;
 	rc = evt_ent_array_fill(tcx, EVT_FIND_ALL, DAOS_INTENT_DEFAULT,
 				filter, &rect, ent_array);
+	if (rc != 0)
+		return rc;
+
+	evt_ent_array_for_each(ent, ent_array)
+		epoch_hi = max(epoch_hi, ent->en_epoch);
 
+	rc = evt_ent_array_sort(tcx, ent_array, filter, EVT_ITER_VISIBLE);
 	if (rc == 0)
-		rc = evt_ent_array_sort(tcx, ent_array, filter, EVT_ITER_VISIBLE);
+		evt_vis_cache_insert(tcx, filter, ent_array, epoch_hi);
 
 	return rc;
 }
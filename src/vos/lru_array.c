@@ -361,6 +361,29 @@ lrua_array_free(struct lru_array *array)
 	D_FREE(array);
 }
 
+void
+lrua_array_walk(struct lru_array *array,
+		void (*cb)(void *payload, uint32_t idx, void *arg), void *arg)
+{
+	struct lru_sub		*sub;
+	struct lru_entry	*entry;
+	uint32_t		 ent_idx;
+	uint32_t		 i;
+
+	for (i = 0; i < array->la_array_nr; i++) {
+		sub = &array->la_sub[i];
+		if (sub->ls_table == NULL || sub->ls_lru == LRU_NO_IDX)
+			continue;
+
+		ent_idx = sub->ls_lru;
+		do {
+			entry = &sub->ls_table[ent_idx];
+			cb(entry->le_payload, ent2idx(array, sub, ent_idx), arg);
+			ent_idx = entry->le_next_idx;
+		} while (ent_idx != sub->ls_lru);
+	}
+}
+
 void
 lrua_array_aggregate(struct lru_array *array)
 {
@@ -491,6 +491,17 @@ lrua_array_alloc(struct lru_array **array, uint32_t nr_ent, uint32_t nr_arrays,
 void
 lrua_array_free(struct lru_array *array);
 
+/** Visit every in-use entry of the LRU array, from LRU to MRU within each
+ *  sub array.  The callback must not modify the array.
+ *
+ * \param	array[in]	The LRU array
+ * \param	cb[in]		Called with the payload and index of each entry
+ * \param	arg[in]		Argument passed to \p cb
+ */
+void
+lrua_array_walk(struct lru_array *array,
+		void (*cb)(void *payload, uint32_t idx, void *arg), void *arg);
+
 /** Aggregate the LRU array
  *
  * Frees up extraneous unused subarrays.   Only applies to arrays with more
@@ -24,6 +24,43 @@ ut_fini(struct bio_ut_args *args)
 	daos_debug_fini();
 }
 
+void
+ut_mc_fini(struct bio_ut_args *args)
+{
+	int	rc;
+
+	rc = bio_mc_close(args->bua_mc);
+	if (rc)
+		D_ERROR("UT MC close failed. "DF_RC"\n", DP_RC(rc));
+
+	rc = bio_mc_destroy(args->bua_xs_ctxt, args->bua_pool_id, 0);
+	if (rc)
+		D_ERROR("UT MC destroy failed. "DF_RC"\n", DP_RC(rc));
+}
+
+int
+ut_mc_init(struct bio_ut_args *args, uint64_t meta_sz, uint64_t wal_sz, uint64_t data_sz)
+{
+	int	rc, ret;
+
+	uuid_generate(args->bua_pool_id);
+	rc = bio_mc_create(args->bua_xs_ctxt, args->bua_pool_id, meta_sz, wal_sz, data_sz, 0);
+	if (rc) {
+		D_ERROR("UT MC create failed. "DF_RC"\n", DP_RC(rc));
+		return rc;
+	}
+
+	rc = bio_mc_open(args->bua_xs_ctxt, args->bua_pool_id, 0, &args->bua_mc);
+	if (rc) {
+		D_ERROR("UT MC open failed. "DF_RC"\n", DP_RC(rc));
+		ret = bio_mc_destroy(args->bua_xs_ctxt, args->bua_pool_id, 0);
+		if (ret)
+			D_ERROR("UT MC destroy failed. "DF_RC"\n", DP_RC(ret));
+	}
+
+	return rc;
+}
+
 #define BIO_UT_NUMA_NODE	-1
 #define BIO_UT_MEM_SIZE		1024	/* MB */
 #define BIO_UT_HUGEPAGE_SZ	2	/* MB */
@@ -90,6 +127,7 @@ int main(int argc, char **argv)
 
 	fprintf(stdout, "Run all BIO unit tests with rand seed:%u\n", ut_args.bua_seed);
 	rc = run_wal_tests();
+	rc += run_prefetch_tests();
 
 	return rc;
 }
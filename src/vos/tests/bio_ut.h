@@ -39,8 +39,13 @@ struct bio_ut_args {
 extern struct bio_ut_args	ut_args;
 void ut_fini(struct bio_ut_args *args);
 int ut_init(struct bio_ut_args *args);
+void ut_mc_fini(struct bio_ut_args *args);
+int ut_mc_init(struct bio_ut_args *args, uint64_t meta_sz, uint64_t wal_sz, uint64_t data_sz);
 
 /* wal_ut.c */
 int run_wal_tests(void);
 
+/* prefetch_ut.c */
+int run_prefetch_tests(void);
+
 #endif /* __BIO_UT_H__ */
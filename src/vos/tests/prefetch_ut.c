@@ -0,0 +1,236 @@
+/**
+ * (C) Copyright 2024 Intel Corporation.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause-Patent
+ */
+
+#define D_LOGFAC	DD_FAC(tests)
+
+#include "bio_ut.h"
+#include "../../bio/bio_internal.h"
+
+#define PF_SGL_NR	4
+#define PF_IOV_SZ	(64UL << 10)	/* 64 KB */
+/* Leave a gap between the extents, so that each one gets its own DMA region */
+#define PF_GAP		(1UL << 20)	/* 1 MB */
+
+static uint64_t
+pf_off(int i)
+{
+	/* Skip the first MB, which may hold the blob header */
+	return (i + 1) * PF_GAP;
+}
+
+static void
+pf_write(struct bio_io_context *ioc, char **bufs)
+{
+	bio_addr_t	addr = { 0 };
+	d_iov_t		iov;
+	int		i, rc;
+
+	for (i = 0; i < PF_SGL_NR; i++) {
+		D_ALLOC(bufs[i], PF_IOV_SZ);
+		assert_non_null(bufs[i]);
+		dts_buf_render(bufs[i], PF_IOV_SZ);
+
+		bio_addr_set(&addr, DAOS_MEDIA_NVME, pf_off(i));
+		d_iov_set(&iov, bufs[i], PF_IOV_SZ);
+		rc = bio_write(ioc, addr, &iov);
+		assert_rc_equal(rc, 0);
+	}
+}
+
+static struct bio_desc *
+pf_fetch_alloc(struct bio_io_context *ioc)
+{
+	struct bio_desc		*biod;
+	struct bio_sglist	*bsgl;
+	bio_addr_t		 addr = { 0 };
+	int			 i, rc;
+
+	biod = bio_iod_alloc(ioc, NULL, PF_SGL_NR, BIO_IOD_TYPE_FETCH);
+	assert_non_null(biod);
+
+	for (i = 0; i < PF_SGL_NR; i++) {
+		bsgl = bio_iod_sgl(biod, i);
+		rc = bio_sgl_init(bsgl, 1);
+		assert_rc_equal(rc, 0);
+
+		bio_addr_set(&addr, DAOS_MEDIA_NVME, pf_off(i));
+		bio_iov_set(&bsgl->bs_iovs[0], addr, PF_IOV_SZ);
+		bsgl->bs_nr_out = 1;
+	}
+
+	return biod;
+}
+
+static void
+pf_check_sgl(struct bio_desc *biod, int idx, char **bufs)
+{
+	struct bio_sglist	*bsgl = bio_iod_sgl(biod, idx);
+
+	assert_non_null(bio_iov2buf(&bsgl->bs_iovs[0]));
+	assert_memory_equal(bio_iov2buf(&bsgl->bs_iovs[0]), bufs[idx], PF_IOV_SZ);
+}
+
+/*
+ * Wait for the SG lists one by one. Nothing is polled before the first wait, so
+ * the reads of the later SG lists are still in flight when the first one is
+ * waited for, and each wait must stop at the regions of its own SG list.
+ */
+static void
+pf_ut_wait_each(void **state)
+{
+	struct bio_ut_args	*args = *state;
+	struct bio_io_context	*ioc;
+	struct bio_desc		*biod;
+	struct bio_rsrvd_dma	*rsrvd;
+	char			*bufs[PF_SGL_NR] = { 0 };
+	int			 i, rc;
+
+	rc = ut_mc_init(args, (128ULL << 20), (128ULL << 20), (128ULL << 20));
+	assert_rc_equal(rc, 0);
+
+	ioc = bio_mc2ioc(args->bua_mc, SMD_DEV_TYPE_DATA);
+	assert_non_null(ioc);
+	pf_write(ioc, bufs);
+
+	biod = pf_fetch_alloc(ioc);
+	rc = bio_iod_prefetch(biod, BIO_CHK_TYPE_IO, NULL, 0);
+	assert_rc_equal(rc, 0);
+
+	rsrvd = &biod->bd_rsrvd;
+	assert_int_equal(rsrvd->brd_rg_cnt, PF_SGL_NR);
+	for (i = 0; i < PF_SGL_NR; i++)
+		assert_int_equal(biod->bd_sgl_rg_end[i], i + 1);
+	assert_true(rsrvd->brd_regions[PF_SGL_NR - 1].brr_inflights > 0);
+
+	for (i = 0; i < PF_SGL_NR; i++) {
+		rc = bio_iod_wait(biod, i);
+		assert_rc_equal(rc, 0);
+		assert_int_equal(biod->bd_rg_landed, biod->bd_sgl_rg_end[i]);
+		assert_int_equal(rsrvd->brd_regions[i].brr_inflights, 0);
+		pf_check_sgl(biod, i, bufs);
+	}
+
+	rc = bio_iod_post(biod, 0);
+	assert_rc_equal(rc, 0);
+	bio_iod_free(biod);
+
+	for (i = 0; i < PF_SGL_NR; i++)
+		D_FREE(bufs[i]);
+	ut_mc_fini(args);
+}
+
+/* Waiting for the last SG list first lands all of them */
+static void
+pf_ut_wait_last(void **state)
+{
+	struct bio_ut_args	*args = *state;
+	struct bio_io_context	*ioc;
+	struct bio_desc		*biod;
+	char			*bufs[PF_SGL_NR] = { 0 };
+	int			 i, rc;
+
+	rc = ut_mc_init(args, (128ULL << 20), (128ULL << 20), (128ULL << 20));
+	assert_rc_equal(rc, 0);
+
+	ioc = bio_mc2ioc(args->bua_mc, SMD_DEV_TYPE_DATA);
+	assert_non_null(ioc);
+	pf_write(ioc, bufs);
+
+	biod = pf_fetch_alloc(ioc);
+	rc = bio_iod_prefetch(biod, BIO_CHK_TYPE_IO, NULL, 0);
+	assert_rc_equal(rc, 0);
+
+	rc = bio_iod_wait(biod, PF_SGL_NR - 1);
+	assert_rc_equal(rc, 0);
+	assert_int_equal(biod->bd_rg_landed, biod->bd_rsrvd.brd_rg_cnt);
+	for (i = 0; i < PF_SGL_NR; i++)
+		pf_check_sgl(biod, i, bufs);
+
+	/* Already landed, must return immediately */
+	rc = bio_iod_wait(biod, 0);
+	assert_rc_equal(rc, 0);
+
+	rc = bio_iod_post(biod, 0);
+	assert_rc_equal(rc, 0);
+	bio_iod_free(biod);
+
+	for (i = 0; i < PF_SGL_NR; i++)
+		D_FREE(bufs[i]);
+	ut_mc_fini(args);
+}
+
+/* Post drains the reads still in flight before releasing the DMA buffer */
+static void
+pf_ut_post_inflight(void **state)
+{
+	struct bio_ut_args	*args = *state;
+	struct bio_io_context	*ioc;
+	struct bio_desc		*biod;
+	char			*bufs[PF_SGL_NR] = { 0 };
+	int			 i, rc;
+
+	rc = ut_mc_init(args, (128ULL << 20), (128ULL << 20), (128ULL << 20));
+	assert_rc_equal(rc, 0);
+
+	ioc = bio_mc2ioc(args->bua_mc, SMD_DEV_TYPE_DATA);
+	assert_non_null(ioc);
+	pf_write(ioc, bufs);
+
+	biod = pf_fetch_alloc(ioc);
+	rc = bio_iod_prefetch(biod, BIO_CHK_TYPE_IO, NULL, 0);
+	assert_rc_equal(rc, 0);
+
+	rc = bio_iod_wait(biod, 0);
+	assert_rc_equal(rc, 0);
+	pf_check_sgl(biod, 0, bufs);
+
+	rc = bio_iod_post(biod, 0);
+	assert_rc_equal(rc, 0);
+	assert_int_equal(ioc->bic_inflight_dmas, 0);
+	assert_int_equal(biod->bd_rsrvd.brd_rg_cnt, 0);
+	bio_iod_free(biod);
+
+	for (i = 0; i < PF_SGL_NR; i++)
+		D_FREE(bufs[i]);
+	ut_mc_fini(args);
+}
+
+static const struct CMUnitTest prefetch_uts[] = {
+	{ "wait for each SG list in order", pf_ut_wait_each, NULL, NULL},
+	{ "wait for the last SG list first", pf_ut_wait_last, NULL, NULL},
+	{ "post with reads in flight", pf_ut_post_inflight, NULL, NULL},
+};
+
+static int
+prefetch_ut_teardown(void **state)
+{
+	struct bio_ut_args	*args = *state;
+
+	ut_fini(args);
+	return 0;
+}
+
+static int
+prefetch_ut_setup(void **state)
+{
+	int	rc;
+
+	rc = ut_init(&ut_args);
+	if (rc) {
+		D_ERROR("UT init failed. "DF_RC"\n", DP_RC(rc));
+		return rc;
+	}
+
+	*state = &ut_args;
+	return 0;
+}
+
+int
+run_prefetch_tests(void)
+{
+	return cmocka_run_group_tests_name("Prefetch unit tests", prefetch_uts,
+					   prefetch_ut_setup, prefetch_ut_teardown);
+}
@@ -0,0 +1,771 @@
+/**
+ * (C) Copyright 2024 Intel Corporation.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause-Patent
+ */
+/**
+ * Microbenchmark for dbtree and evtree.
+ *
+ * Runs insert/probe/iterate/delete against a dbtree and insert/find/iterate/
+ * delete against an evtree, outside of VOS, on either volatile or persistent
+ * umem.  Workloads are generated from a seeded PRNG so a run is reproducible.
+ * Each phase reports nanoseconds and, when the PMU is available, cache misses
+ * per operation, either as a table or as one JSON object per line.
+ *
+ * vos/tests/tree_perf.c
+ */
+#define D_LOGFAC	DD_FAC(tests)
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <getopt.h>
+#include <math.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <linux/perf_event.h>
+
+#include <daos/btree.h>
+#include <daos/dtx.h>
+#include <daos_srv/evtree.h>
+#include <daos_srv/bio.h>
+#include <daos_pool.h>
+#include <utest_common.h>
+
+#define TP_CLASS_UINT		100
+#define TP_CLASS_HASH		101
+
+#define TP_ORDER_DEF		16
+#define TP_NR_DEF		(1 << 20)
+#define TP_POOL_SIZE		(4ULL << 30)
+
+/** Records per extent */
+#define TP_EXT_SIZE		16
+/** Versions stacked on the same range for the "full" overlap pattern */
+#define TP_STACK_DEPTH		8
+/** Extents covered by one find query */
+#define TP_FIND_WIDTH		8
+/** Skew of the Zipf distribution, same as YCSB */
+#define TP_ZIPF_THETA		0.99
+
+enum tp_dist {
+	TP_DIST_SEQ,
+	TP_DIST_RAND,
+	TP_DIST_ZIPF,
+};
+
+enum tp_pattern {
+	TP_PAT_NONE,
+	TP_PAT_PARTIAL,
+	TP_PAT_FULL,
+};
+
+static const char * const tp_dist_strs[] = {"seq", "rand", "zipf"};
+static const char * const tp_pat_strs[] = {"none", "partial", "full"};
+
+struct tp_args {
+	const char		*ta_pmem;
+	uint64_t		 ta_seed;
+	uint32_t		 ta_nr;
+	int			 ta_order;
+	enum tp_dist		 ta_dist;
+	enum tp_pattern		 ta_pattern;
+	bool			 ta_hash_key;
+	bool			 ta_json;
+	bool			 ta_btree;
+	bool			 ta_evtree;
+};
+
+static struct tp_args	tp_args = {
+	.ta_seed	= 1,
+	.ta_nr		= TP_NR_DEF,
+	.ta_order	= TP_ORDER_DEF,
+	.ta_dist	= TP_DIST_RAND,
+	.ta_pattern	= TP_PAT_NONE,
+	.ta_btree	= true,
+	.ta_evtree	= true,
+};
+
+/** PRNG state, splitmix64 so the workload does not depend on libc */
+static uint64_t	tp_rand_state;
+/** Cumulative distribution for Zipf draws */
+static double	*tp_zipf_cdf;
+/** Cache miss counter, -1 if the PMU is not available */
+static int	tp_perf_fd = -1;
+
+static uint64_t
+tp_rand(void)
+{
+	uint64_t	z;
+
+	z = (tp_rand_state += 0x9e3779b97f4a7c15ULL);
+	z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+	z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+	return z ^ (z >> 31);
+}
+
+static inline double
+tp_rand_unit(void)
+{
+	return (tp_rand() >> 11) * (1.0 / (1ULL << 53));
+}
+
+static int
+tp_zipf_init(uint32_t nr)
+{
+	double		sum = 0;
+	uint32_t	i;
+
+	D_ALLOC_ARRAY(tp_zipf_cdf, nr);
+	if (tp_zipf_cdf == NULL)
+		return -DER_NOMEM;
+
+	for (i = 0; i < nr; i++) {
+		sum += 1.0 / pow(i + 1, TP_ZIPF_THETA);
+		tp_zipf_cdf[i] = sum;
+	}
+	for (i = 0; i < nr; i++)
+		tp_zipf_cdf[i] /= sum;
+
+	return 0;
+}
+
+static uint32_t
+tp_zipf_draw(uint32_t nr)
+{
+	double		u = tp_rand_unit();
+	uint32_t	lo = 0;
+	uint32_t	hi = nr - 1;
+	uint32_t	mid;
+
+	while (lo < hi) {
+		mid = lo + (hi - lo) / 2;
+		if (tp_zipf_cdf[mid] < u)
+			lo = mid + 1;
+		else
+			hi = mid;
+	}
+	return lo;
+}
+
+/** Fill \a seq with \a nr slots in [0, nr) following \a dist.  Zipf ranks are
+ *  mapped through a random permutation so the hot slots are spread over the
+ *  key space rather than clustered at its start.
+ */
+static void
+tp_gen_seq(uint32_t *seq, uint32_t *perm, uint32_t nr, enum tp_dist dist)
+{
+	uint32_t	i;
+	uint32_t	j;
+	uint32_t	tmp;
+
+	for (i = 0; i < nr; i++)
+		perm[i] = i;
+	for (i = nr - 1; i > 0; i--) {
+		j = tp_rand() % (i + 1);
+		tmp = perm[i];
+		perm[i] = perm[j];
+		perm[j] = tmp;
+	}
+
+	for (i = 0; i < nr; i++) {
+		switch (dist) {
+		case TP_DIST_SEQ:
+			seq[i] = i;
+			break;
+		case TP_DIST_RAND:
+			seq[i] = perm[i];
+			break;
+		case TP_DIST_ZIPF:
+			seq[i] = perm[tp_zipf_draw(nr)];
+			break;
+		}
+	}
+}
+
+static void
+tp_perf_init(void)
+{
+	struct perf_event_attr	attr = {0};
+
+	attr.type		= PERF_TYPE_HARDWARE;
+	attr.size		= sizeof(attr);
+	attr.config		= PERF_COUNT_HW_CACHE_MISSES;
+	attr.disabled		= 1;
+	attr.exclude_kernel	= 1;
+	attr.exclude_hv		= 1;
+
+	tp_perf_fd = syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0);
+	if (tp_perf_fd < 0)
+		D_PRINT("Cache miss counter is not available, reporting time only\n");
+}
+
+struct tp_phase {
+	struct timespec		tp_start;
+	const char		*tp_tree;
+	const char		*tp_op;
+};
+
+static void
+tp_phase_begin(struct tp_phase *phase, const char *tree, const char *op)
+{
+	phase->tp_tree = tree;
+	phase->tp_op = op;
+	if (tp_perf_fd >= 0) {
+		ioctl(tp_perf_fd, PERF_EVENT_IOC_RESET, 0);
+		ioctl(tp_perf_fd, PERF_EVENT_IOC_ENABLE, 0);
+	}
+	d_gettime(&phase->tp_start);
+}
+
+static void
+tp_phase_end(struct tp_phase *phase, uint64_t ops)
+{
+	struct timespec	end;
+	uint64_t	misses = 0;
+	double		ns_per_op;
+	double		miss_per_op = -1;
+
+	d_gettime(&end);
+	if (tp_perf_fd >= 0) {
+		ioctl(tp_perf_fd, PERF_EVENT_IOC_DISABLE, 0);
+		if (read(tp_perf_fd, &misses, sizeof(misses)) == sizeof(misses) && ops != 0)
+			miss_per_op = (double)misses / ops;
+	}
+
+	if (ops == 0)
+		ops = 1;
+	ns_per_op = (double)d_timediff_ns(&phase->tp_start, &end) / ops;
+
+	if (tp_args.ta_json) {
+		printf("{\"tree\":\"%s\",\"key\":\"%s\",\"mem\":\"%s\",\"order\":%d,"
+		       "\"dist\":\"%s\",\"pattern\":\"%s\",\"seed\":"DF_U64",\"op\":\"%s\","
+		       "\"ops\":"DF_U64",\"ns_per_op\":%.1f,\"misses_per_op\":%.3f}\n",
+		       phase->tp_tree, tp_args.ta_hash_key ? "hash" : "uint",
+		       tp_args.ta_pmem ? "pmem" : "vmem", tp_args.ta_order,
+		       tp_dist_strs[tp_args.ta_dist], tp_pat_strs[tp_args.ta_pattern],
+		       tp_args.ta_seed, phase->tp_op, ops, ns_per_op, miss_per_op);
+	} else {
+		printf("%-7s %-8s %10"PRIu64" ops %10.1f ns/op", phase->tp_tree,
+		       phase->tp_op, ops, ns_per_op);
+		if (miss_per_op >= 0)
+			printf(" %8.2f misses/op", miss_per_op);
+		printf("\n");
+	}
+	fflush(stdout);
+}
+
+static int
+tp_utx_create(size_t root_size, struct utest_context **utx)
+{
+	if (tp_args.ta_pmem == NULL)
+		return utest_vmem_create(root_size, utx);
+
+	unlink(tp_args.ta_pmem);
+	return utest_pmem_create(tp_args.ta_pmem, TP_POOL_SIZE, root_size, NULL, utx);
+}
+
+/** dbtree record, the key is kept for the hashed key class */
+struct tp_rec {
+	uint64_t	tr_key;
+	uint64_t	tr_val;
+};
+
+static int
+tp_hkey_size(void)
+{
+	return sizeof(uint64_t);
+}
+
+static void
+tp_hkey_gen(struct btr_instance *tins, d_iov_t *key_iov, void *hkey)
+{
+	uint64_t	hash = d_hash_mix64(*(uint64_t *)key_iov->iov_buf);
+
+	memcpy(hkey, &hash, sizeof(hash));
+}
+
+static int
+tp_key_cmp(struct btr_instance *tins, struct btr_record *rec, d_iov_t *key_iov)
+{
+	struct tp_rec	*trec = umem_off2ptr(&tins->ti_umm, rec->rec_off);
+	uint64_t	 key = *(uint64_t *)key_iov->iov_buf;
+
+	if (trec->tr_key < key)
+		return BTR_CMP_LT;
+	return trec->tr_key > key ? BTR_CMP_GT : BTR_CMP_EQ;
+}
+
+static int
+tp_rec_alloc(struct btr_instance *tins, d_iov_t *key_iov, d_iov_t *val_iov,
+	     struct btr_record *rec, d_iov_t *val_out)
+{
+	struct tp_rec	*trec;
+	umem_off_t	 off;
+
+	off = umem_zalloc(&tins->ti_umm, sizeof(*trec));
+	if (UMOFF_IS_NULL(off))
+		return -DER_NOSPACE;
+
+	trec = umem_off2ptr(&tins->ti_umm, off);
+	trec->tr_key = *(uint64_t *)key_iov->iov_buf;
+	trec->tr_val = *(uint64_t *)val_iov->iov_buf;
+	rec->rec_off = off;
+	return 0;
+}
+
+static int
+tp_rec_free(struct btr_instance *tins, struct btr_record *rec, void *args)
+{
+	return umem_free(&tins->ti_umm, rec->rec_off);
+}
+
+static int
+tp_rec_fetch(struct btr_instance *tins, struct btr_record *rec,
+	     d_iov_t *key_iov, d_iov_t *val_iov)
+{
+	struct tp_rec	*trec = umem_off2ptr(&tins->ti_umm, rec->rec_off);
+
+	if (key_iov != NULL)
+		d_iov_set(key_iov, &trec->tr_key, sizeof(trec->tr_key));
+	if (val_iov != NULL) {
+		if (val_iov->iov_buf == NULL)
+			d_iov_set(val_iov, &trec->tr_val, sizeof(trec->tr_val));
+		else
+			memcpy(val_iov->iov_buf, &trec->tr_val, sizeof(trec->tr_val));
+	}
+	return 0;
+}
+
+static int
+tp_rec_update(struct btr_instance *tins, struct btr_record *rec,
+	      d_iov_t *key, d_iov_t *val_iov, d_iov_t *val_out)
+{
+	struct tp_rec	*trec = umem_off2ptr(&tins->ti_umm, rec->rec_off);
+	int		 rc;
+
+	rc = umem_tx_add_ptr(&tins->ti_umm, &trec->tr_val, sizeof(trec->tr_val));
+	if (rc != 0)
+		return rc;
+
+	trec->tr_val = *(uint64_t *)val_iov->iov_buf;
+	return 0;
+}
+
+static btr_ops_t tp_btr_ops = {
+	.to_hkey_size	= tp_hkey_size,
+	.to_hkey_gen	= tp_hkey_gen,
+	.to_key_cmp	= tp_key_cmp,
+	.to_rec_alloc	= tp_rec_alloc,
+	.to_rec_free	= tp_rec_free,
+	.to_rec_fetch	= tp_rec_fetch,
+	.to_rec_update	= tp_rec_update,
+};
+
+static int
+tp_btree_run(uint32_t *seq, uint32_t *perm)
+{
+	struct utest_context	*utx;
+	struct tp_phase		 phase;
+	daos_handle_t		 toh;
+	daos_handle_t		 ih;
+	d_iov_t			 key_iov;
+	d_iov_t			 val_iov;
+	uint64_t		 key;
+	uint64_t		 val;
+	uint64_t		 ops;
+	uint32_t		 nr = tp_args.ta_nr;
+	uint32_t		 i;
+	int			 rc;
+
+	rc = tp_utx_create(sizeof(struct btr_root), &utx);
+	if (rc != 0) {
+		D_PRINT("Failed to create umem pool: "DF_RC"\n", DP_RC(rc));
+		return rc;
+	}
+
+	rc = dbtree_create_inplace(tp_args.ta_hash_key ? TP_CLASS_HASH : TP_CLASS_UINT,
+				   tp_args.ta_hash_key ? 0 : BTR_FEAT_UINT_KEY,
+				   tp_args.ta_order, utest_utx2uma(utx),
+				   utest_utx2root(utx), &toh);
+	if (rc != 0) {
+		D_PRINT("Failed to create btree: "DF_RC"\n", DP_RC(rc));
+		goto out_utx;
+	}
+
+	d_iov_set(&key_iov, &key, sizeof(key));
+	d_iov_set(&val_iov, &val, sizeof(val));
+
+	/* Zipf inserts hit the same keys repeatedly, turning them into updates */
+	tp_gen_seq(seq, perm, nr, tp_args.ta_dist);
+	tp_phase_begin(&phase, "btree", "insert");
+	for (i = 0; i < nr; i++) {
+		key = seq[i];
+		val = i;
+		rc = dbtree_update(toh, &key_iov, &val_iov);
+		if (rc != 0) {
+			D_PRINT("Insert failed: "DF_RC"\n", DP_RC(rc));
+			goto out_tree;
+		}
+	}
+	tp_phase_end(&phase, nr);
+
+	tp_gen_seq(seq, perm, nr, tp_args.ta_dist);
+	tp_phase_begin(&phase, "btree", "probe");
+	for (i = 0; i < nr; i++) {
+		key = seq[i];
+		rc = dbtree_lookup(toh, &key_iov, &val_iov);
+		if (rc != 0 && rc != -DER_NONEXIST) {
+			D_PRINT("Probe failed: "DF_RC"\n", DP_RC(rc));
+			goto out_tree;
+		}
+	}
+	tp_phase_end(&phase, nr);
+
+	rc = dbtree_iter_prepare(toh, BTR_ITER_EMBEDDED, &ih);
+	if (rc != 0) {
+		D_PRINT("Iterator prepare failed: "DF_RC"\n", DP_RC(rc));
+		goto out_tree;
+	}
+	ops = 0;
+	tp_phase_begin(&phase, "btree", "iterate");
+	rc = dbtree_iter_probe(ih, BTR_PROBE_FIRST, DAOS_INTENT_DEFAULT, NULL, NULL);
+	while (rc == 0) {
+		rc = dbtree_iter_fetch(ih, NULL, &val_iov, NULL);
+		if (rc != 0)
+			break;
+		ops++;
+		rc = dbtree_iter_next(ih);
+	}
+	tp_phase_end(&phase, ops);
+	dbtree_iter_finish(ih);
+	if (rc != -DER_NONEXIST) {
+		D_PRINT("Iteration failed: "DF_RC"\n", DP_RC(rc));
+		goto out_tree;
+	}
+
+	/* Delete every key once, in random order unless sequential was asked */
+	tp_gen_seq(seq, perm, nr, tp_args.ta_dist == TP_DIST_SEQ ? TP_DIST_SEQ : TP_DIST_RAND);
+	tp_phase_begin(&phase, "btree", "delete");
+	for (i = 0; i < nr; i++) {
+		key = seq[i];
+		rc = dbtree_delete(toh, BTR_PROBE_EQ, &key_iov, NULL);
+		if (rc != 0 && rc != -DER_NONEXIST) {
+			D_PRINT("Delete failed: "DF_RC"\n", DP_RC(rc));
+			goto out_tree;
+		}
+	}
+	tp_phase_end(&phase, nr);
+	rc = 0;
+out_tree:
+	dbtree_destroy(toh, NULL);
+out_utx:
+	utest_utx_destroy(utx);
+	return rc;
+}
+
+static int
+tp_evt_bio_nofree(struct umem_instance *umm, struct evt_desc *desc,
+		  daos_size_t nob, void *args)
+{
+	/* Extents point to fake addresses, nothing to free */
+	return 0;
+}
+
+static struct evt_desc_cbs	tp_evt_desc_cbs = {
+	.dc_bio_free_cb		= tp_evt_bio_nofree,
+};
+
+/** Place extent \a i, written to \a slot, according to the overlap pattern */
+static void
+tp_evt_rect(struct evt_rect *rect, uint32_t slot, uint32_t i)
+{
+	uint32_t	span;
+
+	switch (tp_args.ta_pattern) {
+	case TP_PAT_NONE:
+		rect->rc_ex.ex_lo = (uint64_t)slot * TP_EXT_SIZE;
+		break;
+	case TP_PAT_PARTIAL:
+		rect->rc_ex.ex_lo = (uint64_t)slot * TP_EXT_SIZE / 2;
+		break;
+	case TP_PAT_FULL:
+		span = max(tp_args.ta_nr / TP_STACK_DEPTH, 1);
+		rect->rc_ex.ex_lo = (uint64_t)(slot % span) * TP_EXT_SIZE;
+		break;
+	}
+	rect->rc_ex.ex_hi = rect->rc_ex.ex_lo + TP_EXT_SIZE - 1;
+	rect->rc_epc = i + 1;
+	rect->rc_minor_epc = 0;
+}
+
+static int
+tp_evtree_run(uint32_t *seq, uint32_t *perm)
+{
+	struct utest_context	*utx;
+	struct evt_rect		*rects;
+	struct evt_entry_in	 entry = {0};
+	struct evt_filter	 filter = {0};
+	struct evt_entry	 ent;
+	struct tp_phase		 phase;
+	EVT_ENT_ARRAY_LG_PTR(ent_array);
+	daos_handle_t		 toh;
+	daos_handle_t		 ih;
+	uint64_t		 ops;
+	uint32_t		 nr = tp_args.ta_nr;
+	uint32_t		 inob;
+	uint32_t		 i;
+	int			 rc;
+
+	D_ALLOC_ARRAY(rects, nr);
+	if (rects == NULL)
+		return -DER_NOMEM;
+
+	rc = tp_utx_create(sizeof(struct evt_root), &utx);
+	if (rc != 0) {
+		D_PRINT("Failed to create umem pool: "DF_RC"\n", DP_RC(rc));
+		goto out_rects;
+	}
+
+	rc = evt_create(utest_utx2root(utx), EVT_FEAT_DEFAULT | EVT_FEAT_DYNAMIC_ROOT,
+			tp_args.ta_order, utest_utx2uma(utx), &tp_evt_desc_cbs, &toh);
+	if (rc != 0) {
+		D_PRINT("Failed to create evtree: "DF_RC"\n", DP_RC(rc));
+		goto out_utx;
+	}
+
+	/* Every extent gets its own epoch, so Zipf draws stack versions */
+	tp_gen_seq(seq, perm, nr, tp_args.ta_dist);
+	entry.ei_inob = 1;
+	tp_phase_begin(&phase, "evtree", "insert");
+	for (i = 0; i < nr; i++) {
+		tp_evt_rect(&rects[i], seq[i], i);
+		entry.ei_rect = rects[i];
+		entry.ei_bound = rects[i].rc_epc;
+		bio_addr_set(&entry.ei_addr, DAOS_MEDIA_SCM, (uint64_t)(i + 1) * TP_EXT_SIZE);
+		rc = evt_insert(toh, &entry, NULL);
+		if (rc < 0) {
+			D_PRINT("Insert failed: "DF_RC"\n", DP_RC(rc));
+			goto out_tree;
+		}
+	}
+	tp_phase_end(&phase, nr);
+
+	/* Visible extents of a window of TP_FIND_WIDTH extents at the last epoch */
+	tp_gen_seq(seq, perm, nr, tp_args.ta_dist);
+	filter.fr_epr.epr_hi = nr;
+	filter.fr_epoch = nr;
+	ops = 0;
+	tp_phase_begin(&phase, "evtree", "find");
+	for (i = 0; i < nr; i++) {
+		tp_evt_rect(&entry.ei_rect, seq[i], i);
+		filter.fr_ex.ex_lo = entry.ei_rect.rc_ex.ex_lo;
+		filter.fr_ex.ex_hi = filter.fr_ex.ex_lo + TP_FIND_WIDTH * TP_EXT_SIZE - 1;
+		evt_ent_array_init(ent_array, 0);
+		rc = evt_find(toh, &filter, ent_array);
+		evt_ent_array_fini(ent_array);
+		if (rc != 0) {
+			D_PRINT("Find failed: "DF_RC"\n", DP_RC(rc));
+			goto out_tree;
+		}
+		ops++;
+	}
+	tp_phase_end(&phase, ops);
+
+	filter.fr_ex.ex_lo = 0;
+	filter.fr_ex.ex_hi = ~0ULL;
+	rc = evt_iter_prepare(toh, EVT_ITER_VISIBLE | EVT_ITER_SKIP_HOLES, &filter, &ih);
+	if (rc != 0) {
+		D_PRINT("Iterator prepare failed: "DF_RC"\n", DP_RC(rc));
+		goto out_tree;
+	}
+	ops = 0;
+	tp_phase_begin(&phase, "evtree", "iterate");
+	rc = evt_iter_probe(ih, EVT_ITER_FIRST, NULL, NULL);
+	while (rc == 0) {
+		rc = evt_iter_fetch(ih, &inob, &ent, NULL);
+		if (rc != 0)
+			break;
+		ops++;
+		rc = evt_iter_next(ih);
+	}
+	tp_phase_end(&phase, ops);
+	evt_iter_finish(ih);
+	if (rc != -DER_NONEXIST) {
+		D_PRINT("Iteration failed: "DF_RC"\n", DP_RC(rc));
+		goto out_tree;
+	}
+
+	tp_gen_seq(seq, perm, nr, tp_args.ta_dist == TP_DIST_SEQ ? TP_DIST_SEQ : TP_DIST_RAND);
+	tp_phase_begin(&phase, "evtree", "delete");
+	for (i = 0; i < nr; i++) {
+		rc = evt_delete(toh, &rects[seq[i]], NULL);
+		if (rc != 0) {
+			D_PRINT("Delete failed: "DF_RC"\n", DP_RC(rc));
+			goto out_tree;
+		}
+	}
+	tp_phase_end(&phase, nr);
+	rc = 0;
+out_tree:
+	evt_destroy(toh);
+out_utx:
+	utest_utx_destroy(utx);
+out_rects:
+	D_FREE(rects);
+	return rc;
+}
+
+static void
+tp_usage(const char *prog)
+{
+	printf("Usage: %s [OPTIONS]\n"
+	       "  -t, --tree=btree|evtree|all   Trees to run (default all)\n"
+	       "  -k, --key=uint|hash           dbtree key class (default uint)\n"
+	       "  -o, --order=N                 Tree order (default %d)\n"
+	       "  -n, --nr=N                    Records per phase (default %d)\n"
+	       "  -d, --dist=seq|rand|zipf      Key distribution (default rand)\n"
+	       "  -p, --pattern=none|partial|full\n"
+	       "                                evtree extent overlap (default none)\n"
+	       "  -P, --pmem=PATH               Use a persistent umem pool at PATH\n"
+	       "  -s, --seed=N                  PRNG seed (default 1)\n"
+	       "  -j, --json                    One JSON object per result line\n",
+	       prog, TP_ORDER_DEF, TP_NR_DEF);
+}
+
+static int
+tp_str2idx(const char *str, const char * const *strs, int nr)
+{
+	int	i;
+
+	for (i = 0; i < nr; i++) {
+		if (strcmp(str, strs[i]) == 0)
+			return i;
+	}
+	return -1;
+}
+
+static struct option tp_opts[] = {
+	{ "tree",	required_argument,	NULL,	't' },
+	{ "key",	required_argument,	NULL,	'k' },
+	{ "order",	required_argument,	NULL,	'o' },
+	{ "nr",		required_argument,	NULL,	'n' },
+	{ "dist",	required_argument,	NULL,	'd' },
+	{ "pattern",	required_argument,	NULL,	'p' },
+	{ "pmem",	required_argument,	NULL,	'P' },
+	{ "seed",	required_argument,	NULL,	's' },
+	{ "json",	no_argument,		NULL,	'j' },
+	{ "help",	no_argument,		NULL,	'h' },
+	{ NULL,		0,			NULL,	0 },
+};
+
+int
+main(int argc, char **argv)
+{
+	uint32_t	*seq = NULL;
+	uint32_t	*perm = NULL;
+	int		 idx;
+	int		 opt;
+	int		 rc;
+
+	while ((opt = getopt_long(argc, argv, "t:k:o:n:d:p:P:s:jh", tp_opts, NULL)) != -1) {
+		switch (opt) {
+		case 't':
+			tp_args.ta_btree = strcmp(optarg, "evtree") != 0;
+			tp_args.ta_evtree = strcmp(optarg, "btree") != 0;
+			break;
+		case 'k':
+			tp_args.ta_hash_key = strcmp(optarg, "hash") == 0;
+			break;
+		case 'o':
+			tp_args.ta_order = atoi(optarg);
+			break;
+		case 'n':
+			tp_args.ta_nr = strtoul(optarg, NULL, 0);
+			break;
+		case 'd':
+			idx = tp_str2idx(optarg, tp_dist_strs, ARRAY_SIZE(tp_dist_strs));
+			if (idx < 0)
+				goto usage;
+			tp_args.ta_dist = idx;
+			break;
+		case 'p':
+			idx = tp_str2idx(optarg, tp_pat_strs, ARRAY_SIZE(tp_pat_strs));
+			if (idx < 0)
+				goto usage;
+			tp_args.ta_pattern = idx;
+			break;
+		case 'P':
+			tp_args.ta_pmem = optarg;
+			break;
+		case 's':
+			tp_args.ta_seed = strtoull(optarg, NULL, 0);
+			break;
+		case 'j':
+			tp_args.ta_json = true;
+			break;
+		case 'h':
+		default:
+			goto usage;
+		}
+	}
+
+	if (tp_args.ta_nr < 2 ||
+	    (tp_args.ta_btree && (tp_args.ta_order < BTR_ORDER_MIN ||
+				  tp_args.ta_order > BTR_ORDER_MAX)) ||
+	    (tp_args.ta_evtree && (tp_args.ta_order < EVT_ORDER_MIN ||
+				   tp_args.ta_order > EVT_ORDER_MAX)))
+		goto usage;
+
+	rc = daos_debug_init(DAOS_LOG_DEFAULT);
+	if (rc != 0)
+		return rc;
+
+	rc = dbtree_class_register(TP_CLASS_UINT, BTR_FEAT_UINT_KEY | BTR_FEAT_DYNAMIC_ROOT,
+				   &tp_btr_ops);
+	if (rc == 0)
+		rc = dbtree_class_register(TP_CLASS_HASH, BTR_FEAT_DYNAMIC_ROOT, &tp_btr_ops);
+	if (rc != 0)
+		goto out;
+
+	D_ALLOC_ARRAY(seq, tp_args.ta_nr);
+	D_ALLOC_ARRAY(perm, tp_args.ta_nr);
+	if (seq == NULL || perm == NULL)
+		D_GOTO(out, rc = -DER_NOMEM);
+
+	if (tp_args.ta_dist == TP_DIST_ZIPF) {
+		rc = tp_zipf_init(tp_args.ta_nr);
+		if (rc != 0)
+			goto out;
+	}
+
+	tp_perf_init();
+	if (!tp_args.ta_json)
+		printf("order=%d nr=%u dist=%s pattern=%s key=%s mem=%s seed="DF_U64"\n",
+		       tp_args.ta_order, tp_args.ta_nr, tp_dist_strs[tp_args.ta_dist],
+		       tp_pat_strs[tp_args.ta_pattern], tp_args.ta_hash_key ? "hash" : "uint",
+		       tp_args.ta_pmem ? "pmem" : "vmem", tp_args.ta_seed);
+
+	tp_rand_state = tp_args.ta_seed;
+	if (tp_args.ta_btree) {
+		rc = tp_btree_run(seq, perm);
+		if (rc != 0)
+			goto out;
+	}
+
+	tp_rand_state = tp_args.ta_seed;
+	if (tp_args.ta_evtree)
+		rc = tp_evtree_run(seq, perm);
+out:
+	if (tp_perf_fd >= 0)
+		close(tp_perf_fd);
+	D_FREE(tp_zipf_cdf);
+	D_FREE(perm);
+	D_FREE(seq);
+	daos_debug_fini();
+	return rc == 0 ? 0 : 1;
+usage:
+	tp_usage(argv[0]);
+	return 1;
+}
@@ -2428,6 +2428,102 @@ io_fetch_hole(void **state)
 	assert_memory_equal(ground_truth, fetch_buf, 3 * 1024);
 }
 
+#define CACHED_EXT_SIZE	4096
+
+static void
+cached_ext_update(struct io_test_args *arg, daos_key_t *dkey, daos_key_t *akey,
+		  daos_epoch_t epoch, uint64_t idx, uint64_t nr, char val)
+{
+	char		buf[CACHED_EXT_SIZE];
+	daos_recx_t	recx = { .rx_idx = idx, .rx_nr = nr };
+	daos_iod_t	iod = { 0 };
+	d_sg_list_t	sgl = { 0 };
+	d_iov_t		iov;
+	int		rc;
+
+	memset(buf, val, nr);
+	iod.iod_type = DAOS_IOD_ARRAY;
+	iod.iod_size = 1;
+	iod.iod_name = *akey;
+	iod.iod_recxs = &recx;
+	iod.iod_nr = 1;
+	d_iov_set(&iov, buf, nr);
+	sgl.sg_iovs = &iov;
+	sgl.sg_nr = 1;
+
+	rc = vos_obj_update(arg->ctx.tc_co_hdl, arg->oid, epoch, 0, 0, dkey, 1,
+			    &iod, NULL, &sgl);
+	assert_rc_equal(rc, 0);
+}
+
+static void
+cached_ext_fetch(struct io_test_args *arg, daos_key_t *dkey, daos_key_t *akey,
+		 daos_epoch_t epoch, const char *ground_truth)
+{
+	char		buf[CACHED_EXT_SIZE];
+	daos_recx_t	recx = { .rx_idx = 0, .rx_nr = CACHED_EXT_SIZE };
+	daos_iod_t	iod = { 0 };
+	d_sg_list_t	sgl = { 0 };
+	d_iov_t		iov;
+	int		rc;
+
+	memset(buf, 0, sizeof(buf));
+	iod.iod_type = DAOS_IOD_ARRAY;
+	iod.iod_size = 1;
+	iod.iod_name = *akey;
+	iod.iod_recxs = &recx;
+	iod.iod_nr = 1;
+	d_iov_set(&iov, buf, sizeof(buf));
+	sgl.sg_iovs = &iov;
+	sgl.sg_nr = 1;
+
+	rc = vos_obj_fetch(arg->ctx.tc_co_hdl, arg->oid, epoch, 0, dkey, 1,
+			   &iod, &sgl);
+	assert_rc_equal(rc, 0);
+	assert_memory_equal(ground_truth, buf, CACHED_EXT_SIZE);
+}
+
+/* Repeated fetch of fragmented extents, served from the evtree visible extent cache */
+static void
+io_fetch_cached_extents(void **state)
+{
+	struct io_test_args	*arg = *state;
+	daos_key_t		 dkey;
+	daos_key_t		 akey;
+	char			 dkey_buf[UPDATE_DKEY_SIZE];
+	char			 akey_buf[UPDATE_AKEY_SIZE];
+	char			 old_truth[CACHED_EXT_SIZE];
+	char			 ground_truth[CACHED_EXT_SIZE];
+
+	vts_key_gen(&dkey_buf[0], arg->dkey_size, true, arg);
+	vts_key_gen(&akey_buf[0], arg->akey_size, false, arg);
+	set_iov(&dkey, &dkey_buf[0], is_daos_obj_type_set(arg->otype, DAOS_OT_DKEY_UINT64));
+	set_iov(&akey, &akey_buf[0], is_daos_obj_type_set(arg->otype, DAOS_OT_AKEY_UINT64));
+
+	cached_ext_update(arg, &dkey, &akey, 10, 0, CACHED_EXT_SIZE, 'a');
+	memset(old_truth, 'a', CACHED_EXT_SIZE);
+
+	cached_ext_update(arg, &dkey, &akey, 20, 1024, 1024, 'b');
+	cached_ext_update(arg, &dkey, &akey, 30, 3000, 10, 'c');
+	memcpy(ground_truth, old_truth, CACHED_EXT_SIZE);
+	memset(&ground_truth[1024], 'b', 1024);
+	memset(&ground_truth[3000], 'c', 10);
+
+	/* The second fetch at a different epoch should hit the cache */
+	cached_ext_fetch(arg, &dkey, &akey, 40, ground_truth);
+	cached_ext_fetch(arg, &dkey, &akey, 50, ground_truth);
+
+	/* Read below the newest extent can't use the cached result */
+	cached_ext_fetch(arg, &dkey, &akey, 15, old_truth);
+	cached_ext_fetch(arg, &dkey, &akey, 50, ground_truth);
+
+	/* Update must invalidate the cached result */
+	cached_ext_update(arg, &dkey, &akey, 60, 512, 1024, 'd');
+	memset(&ground_truth[512], 'd', 1024);
+	cached_ext_fetch(arg, &dkey, &akey, 70, ground_truth);
+	cached_ext_fetch(arg, &dkey, &akey, 70, ground_truth);
+}
+
 static void
 io_pool_overflow_test(void **state)
 {
@@ -3035,6 +3131,7 @@ static const struct CMUnitTest io_tests[] = {
     {"VOS206: Simple scatter-gather list test, multiple update buffers", io_sgl_update, NULL, NULL},
     {"VOS207: Simple scatter-gather list test, multiple fetch buffers", io_sgl_fetch, NULL, NULL},
     {"VOS208: Extent hole test", io_fetch_hole, NULL, NULL},
+    {"VOS209: Repeated fetch of fragmented extents", io_fetch_cached_extents, NULL, NULL},
     {"VOS220: 100K update/fetch/verify test", io_multiple_dkey, NULL, NULL},
     {"VOS222: overwrite test", io_idx_overwrite, NULL, NULL},
     {"VOS245.0: Object iter test (for oid)", oid_iter_test, oid_iter_test_setup, NULL},
@@ -223,6 +223,74 @@ ilog_test_ts_get(void **state)
 
 }
 
+static void
+ts_resize_realloc_set(struct ts_test_arg *ts_arg, uint32_t type, uint32_t count)
+{
+	struct vos_ts_table	*ts_table = vos_ts_table_get(true);
+	struct vos_ts_info	*info = &ts_table->tt_type_info[type];
+	struct dtx_handle	 dth = {0};
+	int			 rc;
+
+	/** Resize is applied when a set is allocated and no other is in use */
+	vos_ts_set_free(ts_arg->ta_ts_set);
+	assert_int_equal(ts_table->tt_sets_active, 0);
+	info->ti_count_target = count;
+	ts_table->tt_resize = true;
+
+	daos_dti_gen_unique(&dth.dth_xid);
+	rc = vos_ts_set_allocate(&ts_arg->ta_ts_set, 0, 0, 1, &dth, true);
+	assert_rc_equal(rc, 0);
+	assert_int_equal(info->ti_count, count);
+	assert_false(ts_table->tt_resize);
+}
+
+static void
+ts_resize_test(void **state)
+{
+	struct ts_test_arg	*ts_arg = *state;
+	struct vos_ts_entry	*entry;
+	struct dtx_id		 tx_id = {0};
+	uint32_t		 type = VOS_TS_TYPE_CONT;
+	uint32_t		 count = ts_arg->ta_counts[type];
+	uint32_t		 idx;
+	bool			 found;
+
+	for (idx = 0; idx < count; idx++) {
+		vos_ts_set_reset(ts_arg->ta_ts_set, type, 0);
+		entry = vos_ts_alloc(ts_arg->ta_ts_set, &ts_arg->ta_records[type][idx], idx);
+		assert_non_null(entry);
+		assert_true(entry->te_inherited);
+	}
+	vos_ts_rh_update(entry, 100, &tx_id);
+	assert_false(entry->te_inherited);
+
+	/** Growing keeps every entry and its timestamps */
+	ts_resize_realloc_set(ts_arg, type, count * 2);
+	for (idx = 0; idx < count; idx++) {
+		vos_ts_set_reset(ts_arg->ta_ts_set, type, 0);
+		found = vos_ts_lookup(ts_arg->ta_ts_set, &ts_arg->ta_records[type][idx], false,
+				      &entry);
+		assert_true(found);
+	}
+	assert_int_equal(entry->te_ts.tp_ts_rh, 100);
+	assert_false(entry->te_inherited);
+
+	/** Shrinking drops the entries beyond the new size */
+	ts_resize_realloc_set(ts_arg, type, count / 2);
+	for (idx = 0; idx < count; idx++) {
+		vos_ts_set_reset(ts_arg->ta_ts_set, type, 0);
+		found = vos_ts_lookup(ts_arg->ta_ts_set, &ts_arg->ta_records[type][idx], false,
+				      &entry);
+		if (idx < count / 2)
+			assert_true(found);
+		else
+			assert_false(found);
+	}
+
+	/** Evicted timestamps went to the global entry */
+	assert_true(ts_arg->ta_ts_set->ts_table->tt_ts_rh >= 100);
+}
+
 static int
 alloc_ts_cache(void **state)
 {
@@ -775,6 +843,8 @@ static const struct CMUnitTest ts_tests[] = {
 		init_lru_multi_test, finalize_lru_test},
 	{ "VOS600.4: VOS timestamp allocation test", ilog_test_ts_get,
 		ts_test_init, ts_test_fini},
+	{ "VOS600.5: VOS timestamp cache resize", ts_resize_test,
+		ts_test_init, ts_test_fini},
 };
 
 int
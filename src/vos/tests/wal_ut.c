@@ -9,43 +9,6 @@
 #include "bio_ut.h"
 #include "../../bio/bio_wal.h"
 
-static void
-ut_mc_fini(struct bio_ut_args *args)
-{
-	int	rc;
-
-	rc = bio_mc_close(args->bua_mc);
-	if (rc)
-		D_ERROR("UT MC close failed. "DF_RC"\n", DP_RC(rc));
-
-	rc = bio_mc_destroy(args->bua_xs_ctxt, args->bua_pool_id, 0);
-	if (rc)
-		D_ERROR("UT MC destroy failed. "DF_RC"\n", DP_RC(rc));
-}
-
-static int
-ut_mc_init(struct bio_ut_args *args, uint64_t meta_sz, uint64_t wal_sz, uint64_t data_sz)
-{
-	int	rc, ret;
-
-	uuid_generate(args->bua_pool_id);
-	rc = bio_mc_create(args->bua_xs_ctxt, args->bua_pool_id, meta_sz, wal_sz, data_sz, 0);
-	if (rc) {
-		D_ERROR("UT MC create failed. "DF_RC"\n", DP_RC(rc));
-		return rc;
-	}
-
-	rc = bio_mc_open(args->bua_xs_ctxt, args->bua_pool_id, 0, &args->bua_mc);
-	if (rc) {
-		D_ERROR("UT MC open failed. "DF_RC"\n", DP_RC(rc));
-		ret = bio_mc_destroy(args->bua_xs_ctxt, args->bua_pool_id, 0);
-		if (ret)
-			D_ERROR("UT MC destroy failed. "DF_RC"\n", DP_RC(ret));
-	}
-
-	return rc;
-}
-
 struct ut_fake_tx {
 	uint32_t		ft_act_max;
 	uint32_t		ft_buf_sz;
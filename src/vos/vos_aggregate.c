@@ -170,6 +170,8 @@ struct vos_agg_param {
 	daos_epoch_t		 ap_max_epoch;
 	/* EV tree: Merge window for evtree aggregation */
 	struct agg_merge_window	 ap_window;
+	/* EV tree: Moving average of the logical extent size read on flush */
+	daos_size_t		 ap_ext_avg;
 	bool			 ap_skip_akey;
 	bool			 ap_skip_dkey;
 	bool			 ap_skip_obj;
@@ -1083,32 +1085,29 @@ verify_and_recalc(struct bio_sglist *bsgl, struct evt_entry_in *ent_in,
 	return args.cra_rc;
 }
 
+/*
+ * Set up the source IOVs and reserve the target extent of one segment, the data
+ * transfer is done for all the segments of the window at once by fill_segments().
+ */
 static int
-fill_one_segment(daos_handle_t ih, struct agg_merge_window *mw,
-		 struct agg_lgc_seg *lgc_seg, unsigned int *acts)
+fill_one_segment(daos_handle_t ih, struct agg_merge_window *mw, struct agg_lgc_seg *lgc_seg,
+		 struct bio_sglist *bsgl, struct bio_sglist *bsgl_dst)
 {
 	struct vos_obj_iter	*oiter = vos_hdl2oiter(ih);
 	struct vos_object	*obj = oiter->it_obj;
 	struct agg_io_context	*io = &mw->mw_io_ctxt;
 	struct evt_entry_in	*ent_in = &lgc_seg->ls_ent_in;
 	struct agg_phy_ent	*phy_ent;
-	struct bio_io_context	*bio_ctxt;
-	struct bio_sglist	 bsgl = { 0 }, bsgl_dst = { 0 };
 	bio_addr_t		 addr_src;
 	daos_size_t		 seg_size, copy_size, read_size = 0;
 	struct evt_extent	 ext = { 0 };
 	daos_off_t		 phy_lo = 0;
-	unsigned int		 i, seg_count, biov_idx = 0;
-	struct bio_copy_desc	*copy_desc;
-	struct umem_instance	*umem;
+	unsigned int		 i, biov_idx = bsgl->bs_nr_out;
 	int			 rc;
 
 	D_ASSERT(obj != NULL);
 	D_ASSERT(mw->mw_rsize > 0);
 
-	if (bio_addr_is_hole(&ent_in->ei_addr))
-		return 0;
-
 	seg_size = evt_rect_width(&ent_in->ei_rect) * mw->mw_rsize;
 	D_ASSERTF(seg_size > 0, "seg_size:"DF_U64"\n", seg_size);
 
@@ -1116,36 +1115,6 @@ fill_one_segment(daos_handle_t ih, struct agg_merge_window *mw,
 	D_ASSERT(lgc_seg->ls_idx_start <= lgc_seg->ls_idx_end);
 	D_ASSERT(lgc_seg->ls_idx_end < mw->mw_lgc_cnt);
 
-	bio_ctxt = vos_data_ioctxt(obj->obj_cont->vc_pool);
-	umem = &obj->obj_cont->vc_pool->vp_umm;
-
-	seg_count = lgc_seg->ls_idx_end - lgc_seg->ls_idx_start + 1;
-	rc = bio_sgl_init(&bsgl, seg_count);
-	if (rc) {
-		D_ERROR("Init bsgl error: "DF_RC"\n", DP_RC(rc));
-		return rc;
-	}
-
-	rc = bio_sgl_init(&bsgl_dst, 1);
-	if (rc) {
-		D_ERROR("Init bsgl_dst error: "DF_RC"\n", DP_RC(rc));
-		bio_sgl_fini(&bsgl);
-		return rc;
-	}
-
-	if (mw->mw_csum_type && seg_count > io->ic_csum_recalc_cnt) {
-		void *buffer;
-
-		/* An array of recalc structs (one per output segment). */
-		D_REALLOC_ARRAY(buffer, io->ic_csum_recalcs,
-				io->ic_csum_recalc_cnt, seg_count);
-		if (buffer == NULL)
-			D_GOTO(out, rc = -DER_NOMEM);
-
-		io->ic_csum_recalcs = buffer;
-		io->ic_csum_recalc_cnt = seg_count;
-	}
-
 	i = lgc_seg->ls_idx_start;
 	while (i <= lgc_seg->ls_idx_end) {
 		if (lgc_seg->ls_phy_ent != NULL) {
@@ -1176,11 +1145,11 @@ fill_one_segment(daos_handle_t ih, struct agg_merge_window *mw,
 
 		D_ASSERT(!bio_addr_is_hole(&addr_src));
 
-		D_ASSERT(biov_idx < bsgl.bs_nr);
-		bio_iov_set(&bsgl.bs_iovs[biov_idx], addr_src, copy_size);
+		D_ASSERT(biov_idx < bsgl->bs_nr);
+		bio_iov_set(&bsgl->bs_iovs[biov_idx], addr_src, copy_size);
 
 		if (mw->mw_csum_type) {
-			csum_widen_biov(&bsgl.bs_iovs[biov_idx], phy_ent, &ext,
+			csum_widen_biov(&bsgl->bs_iovs[biov_idx], phy_ent, &ext,
 					ent_in->ei_inob, phy_lo);
 
 			csum_add_recalcs(&io->ic_csum_recalcs, phy_ent, &ext, biov_idx);
@@ -1194,60 +1163,39 @@ fill_one_segment(daos_handle_t ih, struct agg_merge_window *mw,
 	if (rc) {
 		DL_CDEBUG(rc == -DER_NOSPACE, DB_EPC, DLOG_ERR, rc,
 			  "Reserve " DF_U64 " segment error", seg_size);
-		goto out;
+		return rc;
 	}
 	D_ASSERT(!bio_addr_is_hole(&ent_in->ei_addr));
-	bio_iov_set(&bsgl_dst.bs_iovs[0], ent_in->ei_addr, seg_size);
 
-	rc = bio_copy_prep(bio_ctxt, umem, &bsgl, &bsgl_dst, &copy_desc);
-	if (rc) {
-		D_ERROR("Failed to Prepare source & target SGLs for copy. "DF_RC"\n", DP_RC(rc));
-		goto out;
-	}
+	D_ASSERT(bsgl_dst->bs_nr_out < bsgl_dst->bs_nr);
+	bio_iov_set(&bsgl_dst->bs_iovs[bsgl_dst->bs_nr_out], ent_in->ei_addr, seg_size);
+	bsgl_dst->bs_nr_out++;
+	bsgl->bs_nr_out = biov_idx;
 
-	if (mw->mw_csum_type) {
-		/* Verify prior data, calculate csums for output range. */
-		rc = verify_and_recalc(bio_copy_get_sgl(copy_desc, true), ent_in,
-				       io->ic_csum_recalcs, seg_count);
-		if (rc) {
-			D_ERROR("CSUM verify error: "DF_RC"\n", DP_RC(rc));
-			goto post;
-		}
-	}
-
-	rc = bio_copy_run(copy_desc, seg_size, NULL);
-	if (rc)
-		D_ERROR("Copy to "DF_RECT" error "DF_RC"\n",
-			DP_RECT(&ent_in->ei_rect), DP_RC(rc));
-post:
-	rc = bio_copy_post(copy_desc, rc);
-	if (rc) {
-		D_ERROR("Write to "DF_RECT" error "DF_RC"\n",
-			DP_RECT(&ent_in->ei_rect), DP_RC(rc));
-	} else {
-		struct vos_agg_metrics	*vam = agg_cont2metrics(obj->obj_cont);
-
-		if (vam) {
-			if (vam->vam_merge_recs)
-				d_tm_inc_counter(vam->vam_merge_recs, seg_count);
-			if (vam->vam_merge_size)
-				d_tm_inc_counter(vam->vam_merge_size, seg_size);
-		}
-	}
-out:
-	bio_sgl_fini(&bsgl);
-	bio_sgl_fini(&bsgl_dst);
-	return rc;
+	return 0;
 }
 
+/*
+ * Transfer the data of all the segments in the merge window with a single copy
+ * descriptor, so that the reads (and then the writes) of all the segments are in
+ * flight together instead of waiting for each segment in turn.
+ */
 static int
 fill_segments(daos_handle_t ih, struct vos_agg_param *agg_param, unsigned int *acts)
 {
 	struct agg_merge_window	*mw = &agg_param->ap_window;
 	struct agg_io_context	*io = &mw->mw_io_ctxt;
 	struct umem_instance	*umm = agg_param->ap_umm;
+	struct vos_obj_iter	*oiter = vos_hdl2oiter(ih);
+	struct vos_object	*obj = oiter->it_obj;
 	struct agg_lgc_seg	*lgc_seg;
-	unsigned int		 i, scm_max;
+	struct bio_sglist	 bsgl = { 0 }, bsgl_dst = { 0 };
+	struct bio_sglist	 seg_bsgl;
+	struct bio_sglist	*bsgl_src;
+	struct bio_copy_desc	*copy_desc;
+	daos_size_t		 total_size = 0;
+	unsigned int		 i, scm_max, src_cnt = 0, dst_cnt = 0;
+	unsigned int		 src_idx, seg_cnt;
 	int			 rc = 0;
 
 	if (io->ic_seg_cnt == 0) {
@@ -1263,21 +1211,119 @@ fill_segments(daos_handle_t ih, struct vos_agg_param *agg_param, unsigned int *a
 
 	for (i = 0; i < io->ic_seg_cnt; i++) {
 		lgc_seg = &io->ic_segs[i];
+		if (bio_addr_is_hole(&lgc_seg->ls_ent_in.ei_addr))
+			continue;
+		src_cnt += lgc_seg->ls_idx_end - lgc_seg->ls_idx_start + 1;
+		dst_cnt++;
+	}
+
+	/* Only punch records in the window */
+	if (dst_cnt == 0)
+		return 0;
+
+	rc = bio_sgl_init(&bsgl, src_cnt);
+	if (rc) {
+		D_ERROR("Init bsgl error: "DF_RC"\n", DP_RC(rc));
+		return rc;
+	}
+
+	rc = bio_sgl_init(&bsgl_dst, dst_cnt);
+	if (rc) {
+		D_ERROR("Init bsgl_dst error: "DF_RC"\n", DP_RC(rc));
+		bio_sgl_fini(&bsgl);
+		return rc;
+	}
+
+	if (mw->mw_csum_type && src_cnt > io->ic_csum_recalc_cnt) {
+		void *buffer;
+
+		/* An array of recalc structs (one per input extent). */
+		D_REALLOC_ARRAY(buffer, io->ic_csum_recalcs,
+				io->ic_csum_recalc_cnt, src_cnt);
+		if (buffer == NULL)
+			D_GOTO(out, rc = -DER_NOMEM);
+
+		io->ic_csum_recalcs = buffer;
+		io->ic_csum_recalc_cnt = src_cnt;
+	}
+
+	for (i = 0; i < io->ic_seg_cnt; i++) {
+		lgc_seg = &io->ic_segs[i];
+		if (bio_addr_is_hole(&lgc_seg->ls_ent_in.ei_addr))
+			continue;
 
 		D_DEBUG(DB_EPC, "Fill segment: %u-%u "DF_RECT"\n",
 			lgc_seg->ls_idx_start, lgc_seg->ls_idx_end,
 			DP_RECT(&lgc_seg->ls_ent_in.ei_rect));
 
-		rc = fill_one_segment(ih, mw, lgc_seg, acts);
+		rc = fill_one_segment(ih, mw, lgc_seg, &bsgl, &bsgl_dst);
 		if (rc) {
 			DL_CDEBUG(rc == -DER_NOSPACE, DB_EPC, DLOG_ERR, rc,
 				  "Fill seg %u-%u %p " DF_RECT " error", lgc_seg->ls_idx_start,
 				  lgc_seg->ls_idx_end, lgc_seg->ls_phy_ent,
 				  DP_RECT(&lgc_seg->ls_ent_in.ei_rect));
-			break;
+			goto out;
+		}
+		total_size += evt_rect_width(&lgc_seg->ls_ent_in.ei_rect) * mw->mw_rsize;
+	}
+	D_ASSERT(bsgl.bs_nr_out == src_cnt && bsgl_dst.bs_nr_out == dst_cnt);
+
+	rc = bio_copy_prep(vos_data_ioctxt(obj->obj_cont->vc_pool), &obj->obj_cont->vc_pool->vp_umm,
+			   &bsgl, &bsgl_dst, &copy_desc);
+	if (rc) {
+		D_ERROR("Failed to Prepare source & target SGLs for copy. "DF_RC"\n", DP_RC(rc));
+		goto out;
+	}
+
+	if (mw->mw_csum_type) {
+		/* Verify prior data, calculate csums for each output segment. */
+		bsgl_src = bio_copy_get_sgl(copy_desc, true);
+		for (i = 0, src_idx = 0; i < io->ic_seg_cnt; i++) {
+			lgc_seg = &io->ic_segs[i];
+			if (bio_addr_is_hole(&lgc_seg->ls_ent_in.ei_addr))
+				continue;
+
+			seg_cnt = lgc_seg->ls_idx_end - lgc_seg->ls_idx_start + 1;
+			seg_bsgl.bs_iovs = &bsgl_src->bs_iovs[src_idx];
+			seg_bsgl.bs_nr = seg_cnt;
+			seg_bsgl.bs_nr_out = seg_cnt;
+			rc = verify_and_recalc(&seg_bsgl, &lgc_seg->ls_ent_in,
+					       &io->ic_csum_recalcs[src_idx], seg_cnt);
+			if (rc) {
+				D_ERROR("CSUM verify error: "DF_RC"\n", DP_RC(rc));
+				goto post;
+			}
+			src_idx += seg_cnt;
 		}
 	}
 
+	rc = bio_copy_run(copy_desc, total_size, NULL);
+	if (rc)
+		D_ERROR("Copy to "DF_EXT" error "DF_RC"\n", DP_EXT(&mw->mw_ext), DP_RC(rc));
+post:
+	rc = bio_copy_post(copy_desc, rc);
+	if (rc) {
+		D_ERROR("Write to "DF_EXT" error "DF_RC"\n", DP_EXT(&mw->mw_ext), DP_RC(rc));
+	} else {
+		struct vos_agg_metrics	*vam = agg_cont2metrics(obj->obj_cont);
+
+		if (vam) {
+			if (vam->vam_merge_recs)
+				d_tm_inc_counter(vam->vam_merge_recs, src_cnt);
+			if (vam->vam_merge_size)
+				d_tm_inc_counter(vam->vam_merge_size, total_size);
+		}
+
+		/* Track how fragmented the data is, see agg_window_thresh() */
+		if (agg_param->ap_ext_avg == 0)
+			agg_param->ap_ext_avg = total_size / src_cnt;
+		else
+			agg_param->ap_ext_avg = (agg_param->ap_ext_avg * 7 +
+						 total_size / src_cnt) / 8;
+	}
+out:
+	bio_sgl_fini(&bsgl);
+	bio_sgl_fini(&bsgl_dst);
 	return rc;
 }
 
@@ -2155,9 +2201,31 @@ out:
 	return rc;
 }
 
+/*
+ * Size the merge window to keep about VOS_MW_QUEUE_DEPTH reads in flight on each
+ * flush: heavily fragmented data (small extents) gets smaller windows so that a
+ * flush doesn't stall the xstream for too long, large extents get windows large
+ * enough to keep the NVMe queue busy.
+ */
+static daos_size_t
+agg_window_thresh(struct vos_agg_param *agg_param)
+{
+	daos_size_t	thresh, thresh_min;
+
+	if (agg_param->ap_ext_avg == 0)
+		return VOS_MW_FLUSH_THRESH;
+
+	thresh_min = max(VOS_MW_FLUSH_THRESH / 8,
+			 2 * (daos_size_t)vos_agg_nvme_thresh * VOS_BLK_SZ);
+	thresh = agg_param->ap_ext_avg * VOS_MW_QUEUE_DEPTH;
+
+	return min(max(thresh, thresh_min), VOS_MW_FLUSH_THRESH);
+}
+
 static int
-set_window_size(struct agg_merge_window *mw, vos_iter_entry_t *entry)
+set_window_size(struct vos_agg_param *agg_param, vos_iter_entry_t *entry)
 {
+	struct agg_merge_window	*mw = &agg_param->ap_window;
 	struct dcs_csum_info	*csum_info = &entry->ie_csum;
 	daos_size_t		 rsize = entry->ie_rsize;
 
@@ -2179,7 +2247,7 @@ set_window_size(struct agg_merge_window *mw, vos_iter_entry_t *entry)
 			D_INFO("Set flush threshold to: "DF_U64"\n",
 			       mw->mw_flush_thresh);
 		} else if (rsize < (VOS_MW_FLUSH_THRESH / 2)) {
-			mw->mw_flush_thresh = VOS_MW_FLUSH_THRESH;
+			mw->mw_flush_thresh = max(agg_window_thresh(agg_param), rsize * 2);
 		} else {
 			mw->mw_flush_thresh = (rsize < VOS_MW_FLUSH_THRESH) ?
 						rsize * 2 : rsize;
@@ -2265,7 +2333,7 @@ vos_agg_ev(daos_handle_t ih, vos_iter_entry_t *entry,
 		DP_EXT(&phy_ext), entry->ie_epoch, entry->ie_minor_epc,
 		entry->ie_vis_flags, evt_vis2dbg(entry->ie_vis_flags));
 
-	rc = set_window_size(mw, entry);
+	rc = set_window_size(agg_param, entry);
 	if (rc)
 		goto out;
 
@@ -466,6 +466,8 @@ vos_tls_fini(int tags, void *data)
 	if (tls->vtl_ocache)
 		vos_obj_cache_destroy(tls->vtl_ocache);
 
+	evt_vis_cache_fini();
+
 	if (tls->vtl_pool_hhash)
 		d_uhash_destroy(tls->vtl_pool_hhash);
 
@@ -556,6 +558,7 @@ vos_tls_init(int tags, int xs_id, int tgt_id)
 			D_ERROR("Error in creating timestamp table: %d\n", rc);
 			goto failed;
 		}
+		vos_ts_metrics_init(tls->vtl_ts_table, tgt_id);
 	}
 
 	rc = d_tm_add_metric(&tls->vtl_committed, D_TM_STATS_GAUGE,
@@ -589,6 +592,24 @@ vos_tls_init(int tags, int xs_id, int tgt_id)
 		if (rc)
 			D_WARN("Failed to create vos obj cnt: "DF_RC"\n", DP_RC(rc));
 
+		rc = d_tm_add_metric(&tls->vtl_obj_fc_hit, D_TM_COUNTER,
+				     "Object front cache hits", "hits",
+				     "io/vos/obj_cache/front_hit/tgt_%u", tgt_id);
+		if (rc)
+			D_WARN("Failed to create obj cache hit: "DF_RC"\n", DP_RC(rc));
+
+		rc = d_tm_add_metric(&tls->vtl_obj_fc_miss, D_TM_COUNTER,
+				     "Object front cache misses", "misses",
+				     "io/vos/obj_cache/front_miss/tgt_%u", tgt_id);
+		if (rc)
+			D_WARN("Failed to create obj cache miss: "DF_RC"\n", DP_RC(rc));
+
+		rc = d_tm_add_metric(&tls->vtl_obj_fc_evict, D_TM_COUNTER,
+				     "Objects evicted from front cache", "evictions",
+				     "io/vos/obj_cache/front_evict/tgt_%u", tgt_id);
+		if (rc)
+			D_WARN("Failed to create obj cache evict: "DF_RC"\n", DP_RC(rc));
+
 	}
 
 	rc = d_tm_add_metric(&tls->vtl_lru_alloc_size, D_TM_GAUGE,
@@ -679,9 +700,16 @@ vos_mod_init(void)
 	D_INFO("Set aggregate NVMe record threshold to %u blocks (blk_sz:%lu).\n",
 	       vos_agg_nvme_thresh, VOS_BLK_SZ);
 
+	d_getenv_bool("DAOS_EVT_VIS_CACHE", &evt_vis_cache_enabled);
+	D_INFO("Extent tree visible extent cache is %s\n", evt_vis_cache_enabled ? "enabled" : "disabled");
+
 	d_getenv_bool("DAOS_DKEY_PUNCH_PROPAGATE", &vos_dkey_punch_propagate);
 	D_INFO("DKEY punch propagation is %s\n", vos_dkey_punch_propagate ? "enabled" : "disabled");
 
+	d_getenv_uint("DAOS_VOS_TS_MEM_MB", &vos_ts_mem_mb);
+	D_INFO("Timestamp cache memory budget is %s\n",
+	       vos_ts_mem_mb ? "set by DAOS_VOS_TS_MEM_MB" : "the default footprint");
+
 
 	return rc;
 }
@@ -110,6 +110,12 @@ enum {
  */
 #define VOS_MW_FLUSH_THRESH	(1UL << 23)	/* 8MB */
 
+/*
+ * Number of logical extents aggregation aims to read in parallel on each merge
+ * window flush, it's used to size the merge window from the average extent size.
+ */
+#define VOS_MW_QUEUE_DEPTH	64
+
 /*
  * Default size (in blocks) threshold for merging NVMe records, we choose
  * 256 blocks as default value since the default DFS chunk size is 1MB.
@@ -141,7 +147,12 @@ enum {
 #define VOS_NOSPC_ERROR_INTVL	60	/* seconds */
 
 extern unsigned int vos_agg_nvme_thresh;
+extern bool evt_vis_cache_enabled;
 extern bool vos_dkey_punch_propagate;
+extern unsigned int vos_ts_mem_mb;
+
+/** Release the visible extent cache of the calling xstream, see evt_find() */
+void evt_vis_cache_fini(void);
 
 static inline uint32_t vos_byte2blkcnt(uint64_t bytes)
 {
@@ -232,6 +243,7 @@ struct vos_wal_metrics {
 	struct d_tm_node_t *vwm_wal_qd;       /* WAL transaction queue depth */
 	struct d_tm_node_t *vwm_wal_waiters;  /* Waiters for WAL reclaiming */
 	struct d_tm_node_t *vwm_wal_dur;      /* WAL commit duration */
+	struct d_tm_node_t *vwm_wal_batch;    /* Transactions in WAL commit group */
 	struct d_tm_node_t *vwm_replay_size;  /* WAL replay size in bytes */
 	struct d_tm_node_t *vwm_replay_time;  /* WAL replay time in us */
 	struct d_tm_node_t *vwm_replay_count; /* Total replay count */
@@ -370,6 +382,11 @@ struct vos_container {
 				vc_cmt_dtx_indexed:1;
 	unsigned int		vc_obj_discard_count;
 	unsigned int		vc_open_count;
+	/* Object front cache stats, hits are reported to telemetry in batch */
+	uint64_t		vc_obj_fc_hit;
+	uint64_t		vc_obj_fc_miss;
+	uint64_t		vc_obj_fc_evict;
+	uint32_t		vc_obj_fc_hit_pending;
 };
 
 struct vos_dtx_act_ent {
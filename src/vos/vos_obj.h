@@ -23,6 +23,8 @@
 #include "vos_ts.h"
 
 #define LRU_CACHE_BITS 16
+/** Direct-mapped front cache in front of the object LRU cache */
+#define LRU_FRONT_BITS 8
 
 /* Internal container handle structure */
 struct vos_container;
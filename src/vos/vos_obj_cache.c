@@ -38,6 +38,47 @@ struct obj_lru_key {
 	daos_unit_oid_t		 olk_oid;
 };
 
+/* Hits of object front cache are reported to telemetry in batch */
+#define OBJ_FC_HIT_BATCH	1024
+
+/* Front cache slot hint for the object, it has to be cheap */
+static inline uint32_t
+obj_front_hint(struct vos_container *cont, daos_unit_oid_t *oid)
+{
+	uint64_t	hint;
+
+	hint = oid->id_pub.lo ^ oid->id_pub.hi ^ ((uint64_t)oid->id_shard << 32) ^
+	       (uint64_t)(uintptr_t)cont;
+	/* Fibonacci hashing, the high bits are well mixed */
+	return (uint32_t)((hint * 0x9E3779B97F4A7C15ULL) >> 32);
+}
+
+static inline void
+obj_front_hit(struct vos_container *cont)
+{
+	cont->vc_obj_fc_hit++;
+	if (++cont->vc_obj_fc_hit_pending < OBJ_FC_HIT_BATCH)
+		return;
+
+	d_tm_inc_counter(vos_tls_get(cont->vc_pool->vp_sysdb)->vtl_obj_fc_hit,
+			 cont->vc_obj_fc_hit_pending);
+	cont->vc_obj_fc_hit_pending = 0;
+}
+
+static inline void
+obj_front_miss(struct vos_container *cont)
+{
+	cont->vc_obj_fc_miss++;
+	d_tm_inc_counter(vos_tls_get(cont->vc_pool->vp_sysdb)->vtl_obj_fc_miss, 1);
+}
+
+static inline void
+obj_front_evict(struct vos_container *cont)
+{
+	cont->vc_obj_fc_evict++;
+	d_tm_inc_counter(vos_tls_get(cont->vc_pool->vp_sysdb)->vtl_obj_fc_evict, 1);
+}
+
 static inline void
 init_object(struct vos_object *obj, daos_unit_oid_t oid, struct vos_container *cont)
 {
@@ -163,8 +204,17 @@ vos_obj_cache_create(int32_t cache_size, struct daos_lru_cache **occ)
 	D_DEBUG(DB_TRACE, "Creating an object cache %d\n", (1 << cache_size));
 	rc = daos_lru_cache_create(cache_size, D_HASH_FT_NOLOCK,
 				   &obj_lru_ops, occ);
-	if (rc)
+	if (rc) {
 		D_ERROR("Error in creating lru cache: "DF_RC"\n", DP_RC(rc));
+		return rc;
+	}
+
+	rc = daos_lru_front_create(*occ, LRU_FRONT_BITS);
+	if (rc) {
+		D_ERROR("Error in creating front cache: "DF_RC"\n", DP_RC(rc));
+		daos_lru_cache_destroy(*occ);
+		*occ = NULL;
+	}
 	return rc;
 }
 
@@ -192,6 +242,17 @@ void
 vos_obj_cache_evict(struct daos_lru_cache *cache, struct vos_container *cont)
 {
 	daos_lru_cache_evict(cache, obj_cache_evict_cond, cont);
+	if (cont == NULL)
+		return;
+
+	if (cont->vc_obj_fc_hit_pending != 0) {
+		d_tm_inc_counter(vos_tls_get(cont->vc_pool->vp_sysdb)->vtl_obj_fc_hit,
+				 cont->vc_obj_fc_hit_pending);
+		cont->vc_obj_fc_hit_pending = 0;
+	}
+	D_DEBUG(DB_TRACE, "cont="DF_UUID" object front cache hit "DF_U64" miss "DF_U64
+		" evict "DF_U64"\n", DP_UUID(cont->vc_id), cont->vc_obj_fc_hit,
+		cont->vc_obj_fc_miss, cont->vc_obj_fc_evict);
 }
 
 /**
@@ -314,6 +375,7 @@ vos_obj_hold(struct daos_lru_cache *occ, struct vos_container *cont,
 	int			 rc = 0;
 	int			 tmprc;
 	uint32_t		 cond_mask = 0;
+	uint32_t		 hint;
 	bool			 create;
 	void			*create_flag = NULL;
 	bool                     visible_only;
@@ -344,7 +406,18 @@ vos_obj_hold(struct daos_lru_cache *occ, struct vos_container *cont,
 	lkey.olk_cont = cont;
 	lkey.olk_oid = oid;
 
-	rc = daos_lru_ref_hold(occ, &lkey, sizeof(lkey), create_flag, &lret);
+	/* Hot objects are found in front cache without hash lookup or LRU relinking */
+	hint = obj_front_hint(cont, &oid);
+	lret = daos_lru_front_hold(occ, hint, &lkey, sizeof(lkey));
+	if (lret != NULL) {
+		obj_front_hit(cont);
+		rc = 0;
+	} else {
+		if (occ->dlc_front != NULL)
+			obj_front_miss(cont);
+		rc = daos_lru_ref_hold(occ, &lkey, sizeof(lkey), create_flag, &lret);
+	}
+
 	if (rc == -DER_NONEXIST) {
 		D_ASSERT(obj_local.obj_cont == NULL);
 		if (flags & VOS_OBJ_NO_HOLD) {
@@ -523,6 +596,10 @@ out:
 		obj->obj_aggregate = 1;
 	else if (flags & VOS_OBJ_DISCARD)
 		obj->obj_discard = 1;
+
+	/* Promote to front cache, the replaced one goes back to LRU */
+	if (!obj->obj_zombie && daos_lru_front_insert(occ, hint, &obj->obj_llink))
+		obj_front_evict(cont);
 	*obj_p = obj;
 
 	return 0;
@@ -300,6 +300,7 @@ vos_meta_flush_post(daos_handle_t fh, int err)
 void
 vos_wal_metrics_init(struct vos_wal_metrics *vw_metrics, const char *path, int tgt_id)
 {
+	char	batch_path[D_TM_MAX_NAME_LEN];
 	int	rc;
 
 	/* Initialize metrics for WAL stats */
@@ -323,6 +324,16 @@ vos_wal_metrics_init(struct vos_wal_metrics *vw_metrics, const char *path, int t
 	if (rc)
 		D_WARN("Failed to create WAL commit duration telemetry: " DF_RC "\n", DP_RC(rc));
 
+	snprintf(batch_path, sizeof(batch_path), "%s/%s/wal_batch/tgt_%d", path, VOS_WAL_DIR,
+		 tgt_id);
+	rc = d_tm_add_metric(&vw_metrics->vwm_wal_batch, D_TM_STATS_GAUGE,
+			     "WAL commit group size", "transactions", "%s", batch_path);
+	if (rc == 0)
+		/* Buckets: [0..1], [2..5], [6..13], [14..29], [30..61], [62..] */
+		rc = d_tm_init_histogram(vw_metrics->vwm_wal_batch, batch_path, 6, 2, 2);
+	if (rc)
+		D_WARN("Failed to create WAL commit group telemetry: "DF_RC"\n", DP_RC(rc));
+
 	/* Initialize metrics for WAL replay */
 	rc = d_tm_add_metric(&vw_metrics->vwm_replay_count, D_TM_COUNTER, "Number of WAL replays",
 			     NULL, "%s/%s/replay_count/tgt_%u", path, VOS_WAL_DIR, tgt_id);
@@ -424,6 +435,8 @@ vos_wal_commit(struct umem_store *store, struct umem_wal_tx *wal_tx, void *data_
 	} else if (vwm != NULL) {
 		d_tm_set_gauge(vwm->vwm_wal_sz, ws.ws_size);
 		d_tm_set_gauge(vwm->vwm_wal_qd, ws.ws_qd);
+		if (ws.ws_batch != 0)
+			d_tm_set_gauge(vwm->vwm_wal_batch, ws.ws_batch);
 	}
 
 	pool = store->vos_priv;
@@ -889,6 +902,9 @@ pool_hop_free(struct d_ulink *hlink)
 				pool->vp_size, pool->vp_umm.umm_base);
 	}
 
+	/* Another pool may be mapped to the same address later */
+	evt_vis_cache_fini();
+
 	if (pool->vp_uma.uma_pool)
 		vos_pmemobj_close(pool->vp_uma.uma_pool);
 
@@ -64,6 +64,9 @@ struct vos_tls {
 	};
 	struct d_tm_node_t		 *vtl_committed;
 	struct d_tm_node_t		 *vtl_obj_cnt;
+	struct d_tm_node_t		 *vtl_obj_fc_hit;
+	struct d_tm_node_t		 *vtl_obj_fc_miss;
+	struct d_tm_node_t		 *vtl_obj_fc_evict;
 	struct d_tm_node_t		 *vtl_dtx_cmt_ent_cnt;
 	struct d_tm_node_t		 *vtl_lru_alloc_size;
 };
@@ -13,6 +13,9 @@
 
 #include "vos_internal.h"
 
+/** Memory budget in MB for the positive entries, 0 for the default sizes */
+unsigned int vos_ts_mem_mb;
+
 #define DEFINE_TS_STR(type, desc, count)	desc,
 
 /** Strings corresponding to timestamp types */
@@ -29,6 +32,17 @@ static const uint32_t type_counts[] = {
 #define DKEY_MISS_SIZE (1 << 16)
 #define AKEY_MISS_SIZE (1 << 16)
 
+/** Memory used by one positive entry, including the LRU bookkeeping */
+#define TS_ENTRY_SIZE (sizeof(struct lru_entry) + sizeof(struct vos_ts_entry))
+/** A type may shrink to 1/4 and grow to 4x its default size */
+#define TS_RESIZE_SHIFT	2
+/** Cache sizes are evaluated once per this many allocations */
+#define TS_ADAPT_INTERVAL (64 * 1024)
+/** Inherited timestamp conflicts per window that make a type grow */
+#define TS_GROW_THRESH	16
+/** Quiet windows before a type above its default size shrinks */
+#define TS_IDLE_WINDOWS	8
+
 #define TS_TRACE(action, entry, idx, type)				\
 	D_DEBUG(DB_TRACE, "%s %s at idx %d(%p), read.hi="DF_U64		\
 		" read.lo="DF_U64"\n", action, type_strs[type], idx,	\
@@ -120,6 +134,62 @@ static const struct lru_callbacks lru_cbs = {
 	.lru_on_free = vos_lru_ts_free,
 };
 
+static inline uint64_t
+ts_table_mem(struct vos_ts_table *ts_table)
+{
+	uint64_t	size = 0;
+	int		i;
+
+	for (i = 0; i < VOS_TS_TYPE_COUNT; i++)
+		size += (uint64_t)ts_table->tt_type_info[i].ti_count_target * TS_ENTRY_SIZE;
+
+	return size;
+}
+
+/** Pick the initial size for each type.  Start from the defaults and halve
+ *  the largest types until they fit in the memory budget.
+ */
+static void
+ts_table_size_init(struct vos_ts_table *ts_table)
+{
+	struct vos_ts_info	*info;
+	struct vos_ts_info	*largest;
+	uint32_t		 i;
+
+	for (i = 0; i < VOS_TS_TYPE_COUNT; i++) {
+		info = &ts_table->tt_type_info[i];
+		info->ti_count_target = type_counts[i];
+		info->ti_count_min = type_counts[i] >> TS_RESIZE_SHIFT;
+		info->ti_count_max = type_counts[i] << TS_RESIZE_SHIFT;
+	}
+
+	ts_table->tt_mem_budget = (uint64_t)vos_ts_mem_mb << 20;
+	if (ts_table->tt_mem_budget == 0) {
+		/** Default to the footprint of the default sizes */
+		ts_table->tt_mem_budget = ts_table_mem(ts_table);
+		goto out;
+	}
+
+	while (ts_table_mem(ts_table) > ts_table->tt_mem_budget) {
+		largest = NULL;
+		for (i = 0; i < VOS_TS_TYPE_COUNT; i++) {
+			info = &ts_table->tt_type_info[i];
+			if (info->ti_count_target == info->ti_count_min)
+				continue;
+			if (largest == NULL || info->ti_count_target > largest->ti_count_target)
+				largest = info;
+		}
+		if (largest == NULL)
+			break;
+		largest->ti_count_target >>= 1;
+	}
+out:
+	for (i = 0; i < VOS_TS_TYPE_COUNT; i++) {
+		info = &ts_table->tt_type_info[i];
+		info->ti_count = info->ti_count_target;
+	}
+}
+
 int
 vos_ts_table_alloc(struct vos_ts_table **ts_tablep, struct vos_tls *tls)
 {
@@ -155,11 +225,11 @@ vos_ts_table_alloc(struct vos_ts_table **ts_tablep, struct vos_tls *tls)
 	uuid_clear(ts_table->tt_tx_rl.dti_uuid);
 	uuid_clear(ts_table->tt_tx_rh.dti_uuid);
 	miss_cursor = ts_table->tt_misses;
+	ts_table_size_init(ts_table);
 	for (i = 0; i < VOS_TS_TYPE_COUNT; i++) {
 		info = &ts_table->tt_type_info[i];
 
 		info->ti_type = i;
-		info->ti_count = type_counts[i];
 		info->ti_table = ts_table;
 		info->ti_tls = tls;
 		switch (i) {
@@ -225,6 +295,35 @@ free_table:
 	return rc;
 }
 
+void
+vos_ts_metrics_init(struct vos_ts_table *ts_table, int tgt_id)
+{
+	struct vos_ts_info	*info;
+	int			 i;
+	int			 rc;
+
+	for (i = 0; i < VOS_TS_TYPE_COUNT; i++) {
+		info = &ts_table->tt_type_info[i];
+
+		rc = d_tm_add_metric(&info->ti_tm_conflict, D_TM_COUNTER,
+				     "Read conflicts on timestamps inherited after eviction",
+				     "conflicts", "io/vos/ts/%s/false_conflict/tgt_%d",
+				     type_strs[i], tgt_id);
+		if (rc)
+			D_WARN("Failed to create %s ts conflict metric: "DF_RC"\n",
+			       type_strs[i], DP_RC(rc));
+
+		rc = d_tm_add_metric(&info->ti_tm_entries, D_TM_GAUGE,
+				     "Timestamp cache entries", "entries",
+				     "io/vos/ts/%s/entries/tgt_%d", type_strs[i], tgt_id);
+		if (rc)
+			D_WARN("Failed to create %s ts entries metric: "DF_RC"\n",
+			       type_strs[i], DP_RC(rc));
+
+		d_tm_set_gauge(info->ti_tm_entries, info->ti_count);
+	}
+}
+
 void
 vos_ts_table_free(struct vos_ts_table **ts_tablep, struct vos_tls *tls)
 {
@@ -244,6 +343,147 @@ vos_ts_table_free(struct vos_ts_table **ts_tablep, struct vos_tls *tls)
 	*ts_tablep = NULL;
 }
 
+/** Called once per adapt interval.  Grow the type that saw the most conflicts
+ *  on inherited timestamps, taking memory from types that have been quiet if
+ *  the budget requires it, and let types above their default size that have
+ *  been quiet for a while shrink back.  The new sizes take effect at the next
+ *  point where no timestamp set is in use.
+ */
+static void
+ts_table_adapt(struct vos_ts_table *ts_table)
+{
+	struct vos_ts_info	*info;
+	struct vos_ts_info	*hot = NULL;
+	struct vos_ts_info	*cold;
+	uint64_t		 grow;
+	int			 i;
+
+	for (i = 0; i < VOS_TS_TYPE_COUNT; i++) {
+		info = &ts_table->tt_type_info[i];
+
+		if (info->ti_conflicts == 0) {
+			info->ti_idle++;
+			if (info->ti_idle >= TS_IDLE_WINDOWS &&
+			    info->ti_count_target > type_counts[i]) {
+				info->ti_count_target >>= 1;
+				info->ti_idle = 0;
+			}
+			continue;
+		}
+
+		info->ti_idle = 0;
+		if (info->ti_conflicts >= TS_GROW_THRESH &&
+		    info->ti_count_target < info->ti_count_max &&
+		    (hot == NULL || info->ti_conflicts > hot->ti_conflicts))
+			hot = info;
+	}
+
+	if (hot == NULL)
+		goto out;
+
+	grow = (uint64_t)hot->ti_count_target * TS_ENTRY_SIZE;
+	while (ts_table_mem(ts_table) + grow > ts_table->tt_mem_budget) {
+		cold = NULL;
+		for (i = 0; i < VOS_TS_TYPE_COUNT; i++) {
+			info = &ts_table->tt_type_info[i];
+			if (info == hot || info->ti_idle == 0 ||
+			    info->ti_count_target == info->ti_count_min)
+				continue;
+			if (cold == NULL || info->ti_idle > cold->ti_idle)
+				cold = info;
+		}
+		if (cold == NULL)
+			goto out;
+		cold->ti_count_target >>= 1;
+	}
+
+	hot->ti_count_target <<= 1;
+out:
+	for (i = 0; i < VOS_TS_TYPE_COUNT; i++) {
+		info = &ts_table->tt_type_info[i];
+		info->ti_conflicts = 0;
+		if (info->ti_count_target != info->ti_count)
+			ts_table->tt_resize = true;
+	}
+}
+
+/** Move an entry from the old array into the new one at the same index so the
+ *  index saved with the record stays valid.  Walking the old array from LRU to
+ *  MRU keeps the recency order.  When shrinking, entries whose index is beyond
+ *  the new size are evicted into their negative entries as usual.
+ */
+static void
+ts_entry_move(void *payload, uint32_t idx, void *arg)
+{
+	struct lru_array	*array = arg;
+	struct vos_ts_entry	*entry = payload;
+	struct vos_ts_entry	*new_entry;
+	int			 rc;
+
+	if (entry->te_record_ptr == NULL)
+		return;
+
+	if (idx >= array->la_count) {
+		ts_update_on_evict(entry->te_info->ti_table, entry);
+		return;
+	}
+
+	rc = lrua_allocx_inplace(array, idx, (uint64_t)entry->te_record_ptr, &new_entry);
+	D_ASSERT(rc == 0);
+
+	new_entry->te_record_ptr = entry->te_record_ptr;
+	new_entry->te_negative = entry->te_negative;
+	new_entry->te_ts = entry->te_ts;
+	new_entry->te_w_cache = entry->te_w_cache;
+	new_entry->te_inherited = entry->te_inherited;
+}
+
+static void
+ts_info_resize(struct vos_ts_info *info)
+{
+	struct lru_array	*array;
+	uint32_t		 old_count = info->ti_count;
+	int			 rc;
+
+	rc = lrua_array_alloc(&array, info->ti_count_target, 1,
+			      sizeof(struct vos_ts_entry), 0, &lru_cbs, info);
+	if (rc != 0) {
+		D_WARN("Failed to resize %s timestamp cache to %u: "DF_RC"\n",
+		       type_strs[info->ti_type], info->ti_count_target, DP_RC(rc));
+		info->ti_count_target = info->ti_count;
+		return;
+	}
+
+	lrua_array_walk(info->ti_array, ts_entry_move, array);
+	lrua_array_free(info->ti_array);
+	info->ti_array = array;
+	info->ti_count = info->ti_count_target;
+	d_tm_set_gauge(info->ti_tm_entries, info->ti_count);
+
+	D_DEBUG(DB_TRACE, "Resized %s timestamp cache from %u to %u entries\n",
+		type_strs[info->ti_type], old_count, info->ti_count);
+}
+
+/** Apply pending resizes.  Only called when no timestamp set is in use so no
+ *  one holds a pointer into the arrays being replaced.
+ */
+static void
+ts_table_resize(struct vos_ts_table *ts_table)
+{
+	struct vos_ts_info	*info;
+	int			 i;
+
+	D_ASSERT(ts_table->tt_sets_active == 0);
+
+	for (i = 0; i < VOS_TS_TYPE_COUNT; i++) {
+		info = &ts_table->tt_type_info[i];
+		if (info->ti_count_target != info->ti_count)
+			ts_info_resize(info);
+	}
+
+	ts_table->tt_resize = false;
+}
+
 void
 vos_ts_evict_lru(struct vos_ts_table *ts_table, struct vos_ts_entry **entryp,
 		 uint32_t *idx, uint32_t hash_idx, uint32_t type)
@@ -260,6 +500,7 @@ vos_ts_evict_lru(struct vos_ts_table *ts_table, struct vos_ts_entry **entryp,
 		neg_entry = &info->ti_misses[hash_idx];
 
 	entry->te_negative = neg_entry;
+	entry->te_inherited = true;
 
 	if (neg_entry == NULL) {
 		/** Use global timestamps for the type to initialize it */
@@ -287,6 +528,11 @@ vos_ts_evict_lru(struct vos_ts_table *ts_table, struct vos_ts_entry **entryp,
 	D_ASSERT(type == info->ti_type);
 
 	*entryp = entry;
+
+	if (++ts_table->tt_allocs == TS_ADAPT_INTERVAL) {
+		ts_table->tt_allocs = 0;
+		ts_table_adapt(ts_table);
+	}
 }
 
 int
@@ -295,6 +541,7 @@ vos_ts_set_allocate(struct vos_ts_set **ts_set, uint64_t flags,
 		    const struct dtx_handle *dth, bool standalone)
 {
 	const struct dtx_id	*tx_id = NULL;
+	struct vos_ts_table	*ts_table;
 	uint32_t		 size;
 	uint64_t		 array_size;
 	uint64_t		 cond_mask = VOS_COND_FETCH_MASK |
@@ -324,12 +571,30 @@ vos_ts_set_allocate(struct vos_ts_set **ts_set, uint64_t flags,
 		(*ts_set)->ts_in_tx = true;
 		uuid_copy((*ts_set)->ts_tx_id.dti_uuid, tx_id->dti_uuid);
 		(*ts_set)->ts_tx_id.dti_hlc = tx_id->dti_hlc;
+
+		ts_table = vos_ts_table_get(false);
+		if (ts_table != NULL) {
+			if (ts_table->tt_resize && ts_table->tt_sets_active == 0)
+				ts_table_resize(ts_table);
+			ts_table->tt_sets_active++;
+			(*ts_set)->ts_table = ts_table;
+		}
 	} /* ts_in_tx is false by default */
 	vos_ts_set_append_cflags(*ts_set, cflags);
 
 	return 0;
 }
 
+void
+vos_ts_set_release(struct vos_ts_set *ts_set)
+{
+	if (!vos_ts_in_tx(ts_set) || ts_set->ts_table == NULL)
+		return;
+
+	D_ASSERT(ts_set->ts_table->tt_sets_active > 0);
+	ts_set->ts_table->tt_sets_active--;
+}
+
 void
 vos_ts_set_upgrade(struct vos_ts_set *ts_set)
 {
@@ -381,6 +646,24 @@ vos_ts_check_conflict(daos_epoch_t read_time, const struct dtx_id *read_id,
 	return uuid_compare(read_id->dti_uuid, write_id->dti_uuid) != 0;
 }
 
+/** A conflict on timestamps the entry inherited when it was allocated may be
+ *  caused by an earlier eviction rather than by a real read of the record.
+ */
+static inline bool
+ts_inherited_conflict(struct vos_ts_entry *entry, bool conflict)
+{
+	struct vos_ts_info	*info;
+
+	if (!conflict || !entry->te_inherited)
+		return conflict;
+
+	info = entry->te_info;
+	info->ti_conflicts++;
+	d_tm_inc_counter(info->ti_tm_conflict, 1);
+
+	return true;
+}
+
 bool
 vos_ts_check_read_conflict(struct vos_ts_set *ts_set, int idx,
 			   daos_epoch_t write_time)
@@ -411,6 +694,7 @@ vos_ts_check_read_conflict(struct vos_ts_set *ts_set, int idx,
 		/* check the low time */
 		conflict = vos_ts_check_conflict(entry->te_ts.tp_ts_rl, &entry->te_ts.tp_tx_rl,
 						 write_time, &ts_set->ts_tx_id);
+		conflict = ts_inherited_conflict(entry, conflict);
 
 		if (conflict || entry->te_negative == NULL)
 			return conflict;
@@ -423,6 +707,7 @@ vos_ts_check_read_conflict(struct vos_ts_set *ts_set, int idx,
 	/* check the high time */
 	conflict = vos_ts_check_conflict(entry->te_ts.tp_ts_rh, &entry->te_ts.tp_tx_rh, write_time,
 					 &ts_set->ts_tx_id);
+	conflict = ts_inherited_conflict(entry, conflict);
 
 	if (conflict || entry->te_negative == NULL)
 		return conflict;
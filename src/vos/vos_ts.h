@@ -33,8 +33,21 @@ struct vos_ts_info {
 	uint32_t		ti_type;
 	/** Mask for negative entry cache */
 	uint32_t		ti_cache_mask;
-	/** Number of entries in cache for type (for testing) */
+	/** Number of entries in cache for type */
 	uint32_t		ti_count;
+	/** Smallest and largest size the cache may be resized to */
+	uint32_t		ti_count_min;
+	uint32_t		ti_count_max;
+	/** Size to switch to at the next resize point */
+	uint32_t		ti_count_target;
+	/** Conflicts on inherited timestamps in the current window */
+	uint32_t		ti_conflicts;
+	/** Number of consecutive windows without such conflicts */
+	uint32_t		ti_idle;
+	/** Conflicts on inherited timestamps */
+	struct d_tm_node_t	*ti_tm_conflict;
+	/** Current number of entries */
+	struct d_tm_node_t	*ti_tm_entries;
 };
 
 struct vos_ts_pair {
@@ -65,6 +78,10 @@ struct vos_ts_entry {
 	struct vos_ts_pair	 te_ts;
 	/** Write timestamps for epoch bound check */
 	struct vos_wts_cache	 te_w_cache;
+	/** Read timestamps were inherited from a negative or global entry
+	 *  and have not been raised by a read of this record since.
+	 */
+	bool			 te_inherited;
 };
 
 /** Check/update flags for a ts set entry */
@@ -122,6 +139,8 @@ struct vos_ts_set {
 	uint32_t		 ts_set_size;
 	/** Number of initialized entries */
 	uint32_t		 ts_init_count;
+	/** Table the set was accounted against, NULL if not in a tx */
+	struct vos_ts_table	*ts_table;
 	/** timestamp entries */
 	struct vos_ts_set_entry	 ts_entries[0];
 };
@@ -154,6 +173,14 @@ struct vos_ts_table {
 	struct dtx_id		tt_tx_rh;
 	/** Negative entry cache */
 	struct vos_ts_entry	*tt_misses;
+	/** Memory budget for the positive entries of all types */
+	uint64_t		tt_mem_budget;
+	/** Allocations since the cache sizes were last evaluated */
+	uint32_t		tt_allocs;
+	/** Number of timestamp sets currently in use */
+	uint32_t		tt_sets_active;
+	/** A resize is pending until no set is in use */
+	bool			tt_resize;
 	/** Timestamp table pointers for a type */
 	struct vos_ts_info	tt_type_info[VOS_TS_TYPE_COUNT];
 };
@@ -631,6 +658,14 @@ int
 vos_ts_table_alloc(struct vos_ts_table **ts_table, struct vos_tls *tls);
 
 
+/** Register per type telemetry for the thread local timestamp cache
+ *
+ * \param[in]	ts_table	Thread local table
+ * \param[in]	tgt_id		Target id used in the metric path
+ */
+void
+vos_ts_metrics_init(struct vos_ts_table *ts_table, int tgt_id);
+
 /** Free the thread local timestamp cache and reset pointer to NULL
  *
  * \param[in,out]	ts_table	Thread local table pointer
@@ -663,6 +698,10 @@ vos_ts_set_allocate(struct vos_ts_set **ts_set, uint64_t flags,
 void
 vos_ts_set_upgrade(struct vos_ts_set *ts_set);
 
+/** Internal API: Drop the set from the count of sets in use */
+void
+vos_ts_set_release(struct vos_ts_set *ts_set);
+
 /** Free an allocated timestamp set
  *
  * Implemented as a macro to improve logging.
@@ -670,7 +709,11 @@ vos_ts_set_upgrade(struct vos_ts_set *ts_set);
  * \param[in]	ts_set	Set to free
  */
 
-#define vos_ts_set_free(ts_set) D_FREE(ts_set)
+#define vos_ts_set_free(ts_set)			\
+	do {					\
+		vos_ts_set_release(ts_set);	\
+		D_FREE(ts_set);			\
+	} while (0)
 
 /** Internal API to copy timestamp */
 static inline void
@@ -689,6 +732,7 @@ vos_ts_rl_update(struct vos_ts_entry *entry, daos_epoch_t read_time,
 	if (entry == NULL || read_time < entry->te_ts.tp_ts_rl)
 		return;
 
+	entry->te_inherited = false;
 	vos_ts_copy(&entry->te_ts.tp_ts_rl, &entry->te_ts.tp_tx_rl,
 		    read_time, tx_id);
 }
@@ -701,6 +745,7 @@ vos_ts_rh_update(struct vos_ts_entry *entry, daos_epoch_t read_time,
 	if (entry == NULL || read_time < entry->te_ts.tp_ts_rh)
 		return;
 
+	entry->te_inherited = false;
 	vos_ts_copy(&entry->te_ts.tp_ts_rh, &entry->te_ts.tp_tx_rh,
 		    read_time, tx_id);
 }
@@ -2273,6 +2273,152 @@ class PosixTests():
         assert len(data5) == 0
         assert raw_data1 == data6
 
+    @staticmethod
+    def _read_linear(file_name):
+        """Read a file sequentially in 128KiB requests"""
+        data = b''
+        with open(file_name, 'rb', buffering=0) as fd:
+            while True:
+                buf = fd.read(128 * 1024)
+                if not buf:
+                    break
+                data += buf
+        return data
+
+    def test_stream_read(self):
+        """Test streaming reads.
+
+        Read a file which is too large for pre-read sequentially, with caching on this should be
+        served from the stream and with caching off it should not.
+        """
+        raw_data = os.urandom(16 * 1024 * 1024)
+
+        dfuse = DFuse(self.server, self.conf, caching=True, container=self.container)
+        dfuse.start(v_hint='stream_read_0')
+
+        with open(join(dfuse.dir, 'file'), 'wb') as fd:
+            fd.write(raw_data)
+
+        if dfuse.stop():
+            self.fatal_errors = True
+
+        dfuse = DFuse(self.server, self.conf, caching=True, container=self.container)
+        dfuse.start(v_hint='stream_read_1')
+
+        data = self._read_linear(join(dfuse.dir, 'file'))
+        stats = dfuse.check_usage()['statistics']
+        print(stats)
+
+        if dfuse.stop():
+            self.fatal_errors = True
+        assert data == raw_data
+        assert stats.get('stream_read', 0) > 0, 'Stream not used with caching'
+
+        dfuse = DFuse(self.server, self.conf, caching=False, container=self.container)
+        dfuse.start(v_hint='stream_read_2')
+
+        data = self._read_linear(join(dfuse.dir, 'file'))
+        stats = dfuse.check_usage()['statistics']
+        print(stats)
+
+        if dfuse.stop():
+            self.fatal_errors = True
+        assert data == raw_data
+        assert 'stream_read' not in stats, 'Stream used without caching'
+
+    def test_stream_read_expire(self):
+        """Test streaming reads do not return data older than the data cache timeout.
+
+        Mount twice, with a short data cache timeout on the first mount and with caching disabled
+        on the second.  Start a streaming read on the first mount, then update the end of the file
+        through the second mount and check that the data read after the timeout is current.
+        """
+        self.container.set_attrs({'dfuse-data-cache': '2s'})
+
+        dfuse0 = DFuse(self.server, self.conf, caching=True, container=self.container)
+        dfuse0.start(v_hint='stream_expire_0')
+
+        dfuse1 = DFuse(self.server, self.conf, caching=False, container=self.container)
+        dfuse1.start(v_hint='stream_expire_1')
+
+        mib = 1024 * 1024
+        raw_data = bytearray(os.urandom(16 * mib))
+        with open(join(dfuse1.dir, 'file'), 'wb') as fd:
+            fd.write(raw_data)
+
+        with open(join(dfuse0.dir, 'file'), 'rb', buffering=0) as fd:
+            data = b''
+            while len(data) < 4 * mib:
+                data += fd.read(128 * 1024)
+
+            # Let the stream read ahead, then update the end of the file.
+            time.sleep(1)
+            new_data = os.urandom(mib)
+            with open(join(dfuse1.dir, 'file'), 'r+b') as fd1:
+                fd1.seek(15 * mib)
+                fd1.write(new_data)
+            raw_data[15 * mib:] = new_data
+
+            time.sleep(4)
+            while True:
+                buf = fd.read(128 * 1024)
+                if not buf:
+                    break
+                data += buf
+
+        if dfuse0.stop():
+            self.fatal_errors = True
+        if dfuse1.stop():
+            self.fatal_errors = True
+        assert data == raw_data, 'Stale data returned from stream'
+
+    def test_stream_read_wb(self):
+        """Test streaming reads with writes held in the write-back cache.
+
+        Read a file sequentially through one handle whilst small writes to it are being coalesced
+        through another, and check the data read includes the writes.
+        """
+        self.container.set_attrs({'dfuse-write-coalesce': 60})
+
+        dfuse = DFuse(self.server, self.conf, caching=True, container=self.container)
+        dfuse.start(v_hint='stream_wb_0')
+
+        mib = 1024 * 1024
+        file_name = join(dfuse.dir, 'file')
+        raw_data = bytearray(os.urandom(16 * mib))
+        with open(file_name, 'wb') as fd:
+            fd.write(raw_data)
+
+        if dfuse.stop():
+            self.fatal_errors = True
+
+        dfuse = DFuse(self.server, self.conf, caching=True, container=self.container)
+        dfuse.start(v_hint='stream_wb_1')
+
+        file_name = join(dfuse.dir, 'file')
+        with open(file_name, 'rb', buffering=0) as fd:
+            data = b''
+            while len(data) < 4 * mib:
+                data += fd.read(128 * 1024)
+
+            wfd = os.open(file_name, os.O_WRONLY)
+            for idx in range(8):
+                chunk = os.urandom(1000)
+                offset = 8 * mib + idx * 1000
+                assert os.pwrite(wfd, chunk, offset) == len(chunk)
+                raw_data[offset:offset + len(chunk)] = chunk
+
+            while True:
+                buf = fd.read(128 * 1024)
+                if not buf:
+                    break
+                data += buf
+            os.close(wfd)
+
+        if dfuse.stop():
+            self.fatal_errors = True
+        assert data == raw_data, 'Buffered writes not seen by stream'
+
     def test_two_mounts(self):
         """Create two mounts, and check that a file created in one can be read from the other"""
         dfuse0 = DFuse(self.server,
@@ -2398,6 +2544,135 @@ class PosixTests():
 
         assert stat_log2 == stat_log_oob, 'Contents not correct after timeout'
 
+    def _check_file_data(self, file_name, data):
+        """Check the contents of a file match data"""
+        with open(file_name, 'rb') as fd:
+            actual = fd.read()
+        print(f'Read {len(actual)} bytes from {file_name}, expected {len(data)}')
+        assert actual == data, f'Contents of {file_name} differ'
+
+    def test_write_coalesce(self):
+        """Test write coalescing on fsync and close.
+
+        Mount twice, with small writes being held for a minute on the first mount and with caching
+        disabled on the second, which shows what has been written to DAOS.  Check that small
+        appends are held back, then written on fsync and on close without waiting for the timeout.
+        """
+        hold_time = 60
+
+        self.container.set_attrs({'dfuse-write-coalesce': hold_time})
+
+        dfuse0 = DFuse(self.server, self.conf, caching=True, container=self.container)
+        dfuse0.start(v_hint='coalesce_0')
+
+        dfuse1 = DFuse(self.server, self.conf, caching=False, container=self.container)
+        dfuse1.start(v_hint='coalesce_1')
+
+        file0 = join(dfuse0.dir, 'file')
+        file1 = join(dfuse1.dir, 'file')
+        data = b''
+
+        fd = os.open(file0, os.O_WRONLY | os.O_CREAT)
+        for _ in range(64):
+            chunk = os.urandom(1000)
+            assert os.write(fd, chunk) == len(chunk)
+            data += chunk
+
+        # The writes are merged into one buffer which is still held.
+        assert os.stat(file1).st_size == 0, 'Data written before timeout'
+
+        start = time.perf_counter()
+        os.fsync(fd)
+        elapsed = time.perf_counter() - start
+        print(f'fsync took {elapsed:.1f} seconds')
+        assert elapsed < hold_time / 2, 'fsync waited for the coalescing timeout'
+        self._check_file_data(file1, data)
+
+        for _ in range(64):
+            chunk = os.urandom(1000)
+            assert os.write(fd, chunk) == len(chunk)
+            data += chunk
+
+        start = time.perf_counter()
+        os.close(fd)
+        elapsed = time.perf_counter() - start
+        print(f'close took {elapsed:.1f} seconds')
+        assert elapsed < hold_time / 2, 'close waited for the coalescing timeout'
+        self._check_file_data(file1, data)
+
+        if dfuse0.stop():
+            self.fatal_errors = True
+        if dfuse1.stop():
+            self.fatal_errors = True
+
+    def test_write_coalesce_expire(self):
+        """Test write coalescing timeouts and shutdown.
+
+        Check that data held in a coalescing buffer is written after the timeout whilst the file
+        remains open, and that data still held when dfuse shuts down is not lost.  The shutdown
+        case aborts the fuse connection so the kernel never sends a flush for the open file, if
+        that is not permitted the file is closed instead.
+        """
+        hold_time = 2
+
+        self.container.set_attrs({'dfuse-write-coalesce': hold_time})
+
+        dfuse0 = DFuse(self.server, self.conf, caching=True, container=self.container)
+        dfuse0.start(v_hint='coalesce_expire_0')
+
+        dfuse1 = DFuse(self.server, self.conf, caching=False, container=self.container)
+        dfuse1.start(v_hint='coalesce_expire_1')
+
+        data = os.urandom(4096)
+        fd = os.open(join(dfuse0.dir, 'file0'), os.O_WRONLY | os.O_CREAT)
+        assert os.write(fd, data) == len(data)
+
+        # The flush thread checks once a second.
+        time.sleep(hold_time + 3)
+        self._check_file_data(join(dfuse1.dir, 'file0'), data)
+        os.close(fd)
+
+        if dfuse0.stop():
+            self.fatal_errors = True
+
+        self.container.set_attrs({'dfuse-write-coalesce': '1h'})
+
+        dfuse0 = DFuse(self.server, self.conf, caching=True, container=self.container)
+        dfuse0.start(v_hint='coalesce_expire_2')
+
+        data = os.urandom(4096)
+        fd = os.open(join(dfuse0.dir, 'file1'), os.O_WRONLY | os.O_CREAT)
+        assert os.write(fd, data) == len(data)
+
+        conn = os.minor(os.stat(dfuse0.dir).st_dev)
+        try:
+            with open(f'/sys/fs/fuse/connections/{conn}/abort', 'w') as fd_abort:
+                fd_abort.write('1')
+            aborted = True
+        except OSError as error:
+            print(f'Unable to abort fuse connection {conn}: {error}')
+            aborted = False
+
+        if aborted:
+            # dfuse exits and flushes the buffer as part of shutdown.
+            try:
+                os.close(fd)
+            except OSError as error:
+                print(f'close failed after abort: {error}')
+            if umount(dfuse0.dir):
+                umount(dfuse0.dir, background=True)
+            self.server.remove_fuse(dfuse0)
+            dfuse0.wait_for_exit()
+        else:
+            os.close(fd)
+            if dfuse0.stop():
+                self.fatal_errors = True
+
+        self._check_file_data(join(dfuse1.dir, 'file1'), data)
+
+        if dfuse1.stop():
+            self.fatal_errors = True
+
     @needs_dfuse
     def test_readdir_basic(self):
         """Basic readdir test.
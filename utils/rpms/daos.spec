@@ -556,6 +556,7 @@ getent passwd daos_agent >/dev/null || useradd -s /sbin/nologin -r -g daos_agent
 %{_bindir}/ddb_tests
 %{_bindir}/obj_ctl
 %{_bindir}/vos_perf
+%{_bindir}/tree_perf
 
 %files devel
 %doc README.md